@@ -0,0 +1,246 @@
+/**
+ * @file AnalyseurNMEA.cpp
+ * @brief Implémentation de la classe AnalyseurNMEA.
+ * @details Contient la lecture caractère par caractère des phrases RMC et GGA, la
+ * vérification de leur somme de contrôle et le décodage de leurs champs.
+ */
+#include "AnalyseurNMEA.h"
+
+/// Longueur maximale d'une phrase selon la norme NMEA 0183 ("$" et fin de ligne compris), avec un peu de marge.
+static const uint8_t LONGUEUR_MAX_PHRASE = 90;
+
+/**
+ * @brief Convertit un chiffre hexadécimal en sa valeur.
+ * @return La valeur (0-15), ou 0xFF si le caractère n'est pas un chiffre hexadécimal.
+ */
+static uint8_t valeurHexa(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return 0xFF;
+}
+
+AnalyseurNMEA::AnalyseurNMEA()
+  : _etat(ETAT_HORS_PHRASE), _type(PHRASE_INCONNUE), _numeroChamp(0), _longueurChamp(0),
+    _somme(0), _sommeRecue(0), _chiffresSomme(0), _octetsPhrase(0),
+    _heureLue(false), _dateLue(false), _fixLu(false), _coordonneesLues(0), _satellitesLus(false),
+    _heureValide(false), _positionValide(false), _positionMiseAJour(false), _instantPosition(0),
+    _phrasesValides(0), _erreursSomme(0), _octetsPerdus(0) {
+  memset(&_attente, 0, sizeof(_attente));
+  memset(&_valeurs, 0, sizeof(_valeurs));
+}
+
+bool AnalyseurNMEA::encoder(char c) {
+  if (c == '$') {
+    // Début d'une nouvelle phrase : celle qui était en cours n'a jamais été terminée.
+    if (_etat != ETAT_HORS_PHRASE) abandonnerPhrase();
+    _etat = ETAT_CHAMPS;
+    _type = PHRASE_INCONNUE;
+    _numeroChamp = 0;
+    _longueurChamp = 0;
+    _somme = 0;
+    _sommeRecue = 0;
+    _chiffresSomme = 0;
+    _octetsPhrase = 1;
+    _heureLue = _dateLue = _fixLu = _satellitesLus = false;
+    _coordonneesLues = 0;
+    return false;
+  }
+
+  if (_etat == ETAT_HORS_PHRASE) {
+    // Les fins de ligne entre deux phrases sont normales ; tout le reste est perdu.
+    if (c != '\r' && c != '\n') _octetsPerdus++;
+    return false;
+  }
+
+  // Seules les phrases qui nous intéressent sont limitées en longueur : certaines
+  // phrases propriétaires, que l'on survole, dépassent la norme.
+  if (++_octetsPhrase > LONGUEUR_MAX_PHRASE && _type != PHRASE_INCONNUE) {
+    abandonnerPhrase();
+    return false;
+  }
+
+  if (_etat == ETAT_CHAMPS) {
+    if (c == ',' || c == '*') {
+      if (c == ',') _somme ^= c; // L'étoile ne fait pas partie de la somme de contrôle.
+      _champ[_longueurChamp] = '\0';
+      if (!traiterChamp()) {
+        abandonnerPhrase();
+        return false;
+      }
+      _numeroChamp++;
+      _longueurChamp = 0;
+      if (c == '*') _etat = ETAT_SOMME;
+    } else if (c == '\r' || c == '\n') {
+      // Fin de ligne avant la somme de contrôle : phrase mal formée.
+      abandonnerPhrase();
+    } else if (_type == PHRASE_INCONNUE && _numeroChamp > 0) {
+      // Phrase survolée : seule la somme de contrôle nous importe.
+      _somme ^= c;
+    } else if (_longueurChamp >= TAILLE_CHAMP - 1) {
+      abandonnerPhrase(); // Champ trop long pour une phrase RMC ou GGA.
+    } else {
+      _somme ^= c;
+      _champ[_longueurChamp++] = c;
+    }
+    return false;
+  }
+
+  // ETAT_SOMME : deux chiffres hexadécimaux.
+  uint8_t chiffre = valeurHexa(c);
+  if (chiffre == 0xFF) {
+    abandonnerPhrase();
+    return false;
+  }
+  _sommeRecue = (_sommeRecue << 4) | chiffre;
+  if (++_chiffresSomme < 2) return false;
+
+  _etat = ETAT_HORS_PHRASE;
+  if (_sommeRecue != _somme) {
+    _erreursSomme++;
+    return false;
+  }
+  if (_type == PHRASE_INCONNUE) return false;
+  retenirPhrase();
+  return true;
+}
+
+void AnalyseurNMEA::abandonnerPhrase() {
+  _octetsPerdus += _octetsPhrase;
+  _etat = ETAT_HORS_PHRASE;
+}
+
+bool AnalyseurNMEA::traiterChamp() {
+  if (_numeroChamp == 0) {
+    // "GPRMC", "GNGGA"... : seules les 3 dernières lettres donnent la sorte de phrase,
+    // les 2 premières indiquent la constellation.
+    if (_longueurChamp == 5 && strcmp(_champ + 2, "RMC") == 0) _type = PHRASE_RMC;
+    else if (_longueurChamp == 5 && strcmp(_champ + 2, "GGA") == 0) _type = PHRASE_GGA;
+    return true;
+  }
+  if (_type == PHRASE_INCONNUE) return true; // On survole les phrases qui ne nous intéressent pas.
+
+  // Numéros des champs de position : ils ne sont pas les mêmes dans RMC et GGA.
+  uint8_t champLatitude = (_type == PHRASE_RMC) ? 3 : 2;
+
+  if (_numeroChamp == 1) {
+    // L'heure, "hhmmss.ss". Un champ vide veut dire que le GPS ne la connaît pas encore.
+    if (_longueurChamp == 0) return true;
+    if (!lireDeuxChiffres(0, _attente.heure) || !lireDeuxChiffres(2, _attente.minute) ||
+        !lireDeuxChiffres(4, _attente.seconde)) return false;
+    _heureLue = true;
+  } else if (_type == PHRASE_RMC && _numeroChamp == 2) {
+    _fixLu = (_champ[0] == 'A'); // 'A' : position valide, 'V' : pas encore de position.
+  } else if (_type == PHRASE_GGA && _numeroChamp == 6) {
+    _fixLu = (_longueurChamp > 0 && _champ[0] != '0'); // Qualité de la position, 0 si aucune.
+  } else if (_type == PHRASE_GGA && _numeroChamp == 7) {
+    if (_longueurChamp == 0) return true;
+    _attente.satellites = (uint8_t)atoi(_champ);
+    _satellitesLus = true;
+  } else if (_type == PHRASE_RMC && _numeroChamp == 9) {
+    // La date, "jjmmaa".
+    if (_longueurChamp == 0) return true;
+    if (!lireDeuxChiffres(0, _attente.jour) || !lireDeuxChiffres(2, _attente.mois) ||
+        !lireDeuxChiffres(4, _attente.annee)) return false;
+    _dateLue = true;
+  } else if (_numeroChamp >= champLatitude && _numeroChamp < champLatitude + 4) {
+    if (_longueurChamp == 0) return true;
+    switch (_numeroChamp - champLatitude) {
+      case 0: if (!lireCoordonnee(_attente.latitude)) return false; break;
+      case 1: if (_champ[0] == 'S') _attente.latitude = -_attente.latitude; break;
+      case 2: if (!lireCoordonnee(_attente.longitude)) return false; break;
+      case 3: if (_champ[0] == 'W') _attente.longitude = -_attente.longitude; break;
+    }
+    _coordonneesLues++;
+  }
+  return true;
+}
+
+void AnalyseurNMEA::retenirPhrase() {
+  _phrasesValides++;
+  if (_heureLue) {
+    _valeurs.heure = _attente.heure;
+    _valeurs.minute = _attente.minute;
+    _valeurs.seconde = _attente.seconde;
+    _heureValide = true;
+  }
+  if (_dateLue) {
+    _valeurs.jour = _attente.jour;
+    _valeurs.mois = _attente.mois;
+    _valeurs.annee = _attente.annee;
+  }
+  if (_satellitesLus) {
+    _valeurs.satellites = _attente.satellites;
+  }
+  if (_fixLu && _coordonneesLues == 4) {
+    _valeurs.latitude = _attente.latitude;
+    _valeurs.longitude = _attente.longitude;
+    _positionValide = true;
+    _positionMiseAJour = true;
+    _instantPosition = millis();
+  }
+}
+
+bool AnalyseurNMEA::lireDeuxChiffres(uint8_t position, uint8_t& valeur) const {
+  if (position + 2 > _longueurChamp) return false;
+  char d = _champ[position], u = _champ[position + 1];
+  if (d < '0' || d > '9' || u < '0' || u > '9') return false;
+  valeur = (d - '0') * 10 + (u - '0');
+  return true;
+}
+
+bool AnalyseurNMEA::lireCoordonnee(long& resultat) const {
+  // Partie entière : degrés et minutes collés ("4851" pour 48° 51').
+  uint8_t i = 0;
+  unsigned long degresMinutes = 0;
+  for (; i < _longueurChamp && _champ[i] != '.'; i++) {
+    if (_champ[i] < '0' || _champ[i] > '9') return false;
+    degresMinutes = degresMinutes * 10 + (_champ[i] - '0');
+  }
+  if (i < 3) return false;
+
+  // Partie décimale des minutes, gardée sur 6 chiffres : les minutes sont ainsi
+  // comptées en millionièmes de minute.
+  unsigned long millioniemes = 0;
+  uint8_t chiffres = 0;
+  if (i < _longueurChamp) {
+    for (i++; i < _longueurChamp; i++) {
+      if (_champ[i] < '0' || _champ[i] > '9') return false;
+      if (chiffres < 6) {
+        millioniemes = millioniemes * 10 + (_champ[i] - '0');
+        chiffres++;
+      }
+    }
+  }
+  for (; chiffres < 6; chiffres++) millioniemes *= 10;
+
+  unsigned long degres = degresMinutes / 100;
+  unsigned long minutes = (degresMinutes % 100) * 1000000UL + millioniemes; // En millionièmes de minute.
+  if (degres > 180 || minutes >= 60000000UL) return false;
+  // 1 minute = 1/60 de degré : on arrondit au millionième de degré le plus proche.
+  resultat = (long)(degres * 1000000UL + (minutes + 30) / 60);
+  return true;
+}
+
+bool AnalyseurNMEA::heureValide() const { return _heureValide; }
+bool AnalyseurNMEA::positionValide() const { return _positionValide; }
+unsigned long AnalyseurNMEA::getAgePositionMs() const { return millis() - _instantPosition; }
+
+bool AnalyseurNMEA::positionMiseAJour() {
+  bool miseAJour = _positionMiseAJour;
+  _positionMiseAJour = false;
+  return miseAJour;
+}
+
+uint8_t AnalyseurNMEA::getHeure() const { return _valeurs.heure; }
+uint8_t AnalyseurNMEA::getMinute() const { return _valeurs.minute; }
+uint8_t AnalyseurNMEA::getSeconde() const { return _valeurs.seconde; }
+uint8_t AnalyseurNMEA::getJour() const { return _valeurs.jour; }
+uint8_t AnalyseurNMEA::getMois() const { return _valeurs.mois; }
+uint16_t AnalyseurNMEA::getAnnee() const { return 2000 + _valeurs.annee; }
+long AnalyseurNMEA::getLatitudeMicro() const { return _valeurs.latitude; }
+long AnalyseurNMEA::getLongitudeMicro() const { return _valeurs.longitude; }
+uint8_t AnalyseurNMEA::getSatellites() const { return _valeurs.satellites; }
+unsigned long AnalyseurNMEA::getPhrasesValides() const { return _phrasesValides; }
+unsigned long AnalyseurNMEA::getErreursSomme() const { return _erreursSomme; }
+unsigned long AnalyseurNMEA::getOctetsPerdus() const { return _octetsPerdus; }
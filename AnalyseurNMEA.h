@@ -0,0 +1,163 @@
+#ifndef ANALYSEUR_NMEA_H
+#define ANALYSEUR_NMEA_H
+
+#include <Arduino.h>
+
+/**
+ * @class AnalyseurNMEA
+ * @brief Le "lecteur" des phrases envoyées par le module GPS.
+ * @details Le module GPS envoie en continu des phrases de texte (trames NMEA) de
+ * plusieurs sortes. Deux seulement nous intéressent :
+ * - RMC, qui donne l'heure, la date et la position ;
+ * - GGA, qui donne l'heure, la position et le nombre de satellites utilisés.
+ *
+ * Les caractères sont lus un par un, au fil de leur arrivée, et chaque champ est
+ * décodé dès qu'il est complet : on ne garde jamais une phrase entière en mémoire.
+ * Les valeurs lues restent "en attente" jusqu'à la fin de la phrase, et ne sont
+ * retenues que si la somme de contrôle est juste. Les autres sortes de phrases sont
+ * simplement survolées.
+ *
+ * La position est gardée en entiers (millionièmes de degré), sans passer par les
+ * nombres à virgule, lents et peu précis sur l'Arduino.
+ *
+ * Trois compteurs permettent de surveiller la liaison avec le GPS : les phrases
+ * retenues, les sommes de contrôle fausses, et les octets perdus (reçus hors d'une
+ * phrase, ou appartenant à une phrase mal formée).
+ */
+class AnalyseurNMEA {
+public:
+  AnalyseurNMEA();
+
+  /**
+   * @brief Lit un caractère venant du GPS.
+   * @param c Le caractère reçu.
+   * @return `true` si ce caractère termine une phrase RMC ou GGA valide, qui vient d'être retenue.
+   */
+  bool encoder(char c);
+
+  /**
+   * @brief Permet de savoir si une heure a déjà été reçue.
+   */
+  bool heureValide() const;
+
+  /**
+   * @brief Permet de savoir si une position a déjà été reçue (avec un "fix" du GPS).
+   */
+  bool positionValide() const;
+
+  /**
+   * @brief Donne le temps écoulé depuis la dernière position reçue, en millisecondes.
+   */
+  unsigned long getAgePositionMs() const;
+
+  /**
+   * @brief Permet de savoir si la position a changé depuis la dernière question.
+   * @details La réponse est `true` une seule fois par nouvelle position reçue.
+   */
+  bool positionMiseAJour();
+
+  uint8_t getHeure() const;    ///< L'heure UTC (0-23).
+  uint8_t getMinute() const;   ///< Les minutes (0-59).
+  uint8_t getSeconde() const;  ///< Les secondes (0-59).
+  uint8_t getJour() const;     ///< Le jour du mois (1-31).
+  uint8_t getMois() const;     ///< Le mois (1-12).
+  uint16_t getAnnee() const;   ///< L'année sur 4 chiffres.
+
+  /**
+   * @brief Donne la latitude en millionièmes de degré (positive au Nord).
+   */
+  long getLatitudeMicro() const;
+
+  /**
+   * @brief Donne la longitude en millionièmes de degré (positive à l'Est).
+   */
+  long getLongitudeMicro() const;
+
+  /**
+   * @brief Donne le nombre de satellites utilisés pour la position (phrase GGA).
+   */
+  uint8_t getSatellites() const;
+
+  unsigned long getPhrasesValides() const; ///< Nombre de phrases RMC et GGA retenues.
+  unsigned long getErreursSomme() const;   ///< Nombre de phrases rejetées pour une somme de contrôle fausse.
+  unsigned long getOctetsPerdus() const;   ///< Nombre d'octets reçus hors d'une phrase ou dans une phrase mal formée.
+
+private:
+  /// Les sortes de phrases reconnues.
+  enum TypePhrase { PHRASE_INCONNUE, PHRASE_RMC, PHRASE_GGA };
+
+  /// Où en est la lecture de la phrase en cours.
+  enum Etat { ETAT_HORS_PHRASE, ETAT_CHAMPS, ETAT_SOMME };
+
+  /**
+   * @brief Les valeurs lues dans une phrase, avant de savoir si elle est valide.
+   */
+  struct Valeurs {
+    uint8_t heure, minute, seconde;
+    uint8_t jour, mois, annee;   ///< L'année sur 2 chiffres, comme dans la phrase.
+    long latitude, longitude;    ///< En millionièmes de degré.
+    uint8_t satellites;
+  };
+
+  /**
+   * @brief Interne : décode le champ qui vient de se terminer.
+   * @return `false` si le champ est mal formé : la phrase est alors abandonnée.
+   */
+  bool traiterChamp();
+
+  /**
+   * @brief Interne : abandonne la phrase en cours et compte ses octets comme perdus.
+   */
+  void abandonnerPhrase();
+
+  /**
+   * @brief Interne : retient les valeurs en attente, une fois la somme de contrôle vérifiée.
+   */
+  void retenirPhrase();
+
+  /**
+   * @brief Interne : lit un nombre de 2 chiffres dans le champ, à une position donnée.
+   */
+  bool lireDeuxChiffres(uint8_t position, uint8_t& valeur) const;
+
+  /**
+   * @brief Interne : lit une latitude ("ddmm.mmmm") ou une longitude ("dddmm.mmmm").
+   * @param resultat La coordonnée en millionièmes de degré, toujours positive à ce stade.
+   */
+  bool lireCoordonnee(long& resultat) const;
+
+  static const uint8_t TAILLE_CHAMP = 16; ///< Le plus long champ utile fait 11 caractères ("01131.00000").
+
+  // -- Lecture en cours --
+  Etat _etat;                  ///< Où en est la lecture.
+  TypePhrase _type;            ///< La sorte de la phrase en cours.
+  uint8_t _numeroChamp;        ///< Le numéro du champ en cours (0 pour le type de phrase).
+  char _champ[TAILLE_CHAMP];   ///< Les caractères du champ en cours.
+  uint8_t _longueurChamp;      ///< Le nombre de caractères du champ en cours.
+  uint8_t _somme;              ///< La somme de contrôle calculée au fil de la phrase.
+  uint8_t _sommeRecue;         ///< La somme de contrôle annoncée en fin de phrase.
+  uint8_t _chiffresSomme;      ///< Nombre de chiffres de la somme annoncée déjà lus.
+  uint16_t _octetsPhrase;      ///< Nombre d'octets de la phrase en cours (pour les compter s'ils sont perdus).
+
+  // -- Valeurs en attente de la fin de la phrase --
+  Valeurs _attente;            ///< Les valeurs lues dans la phrase en cours.
+  bool _heureLue;              ///< La phrase en cours contient une heure.
+  bool _dateLue;               ///< La phrase en cours contient une date.
+  bool _fixLu;                 ///< La phrase en cours annonce une position valide.
+  uint8_t _coordonneesLues;    ///< Champs de position lus dans la phrase en cours (4 quand tout y est).
+  bool _satellitesLus;         ///< La phrase en cours contient un nombre de satellites.
+
+  // -- Valeurs retenues --
+  Valeurs _valeurs;            ///< Les dernières valeurs valides.
+  bool _heureValide;           ///< Une heure a été retenue.
+  bool _positionValide;        ///< Une position a été retenue.
+  bool _positionMiseAJour;     ///< Une nouvelle position a été retenue depuis la dernière question.
+  unsigned long _instantPosition; ///< Instant (millis()) de la dernière position retenue.
+
+  // -- Compteurs --
+  unsigned long _phrasesValides;
+  unsigned long _erreursSomme;
+  unsigned long _octetsPerdus;
+};
+
+#endif
@@ -1,14 +1,11 @@
 #include "Balise.h"
 
-// Le constructeur prend les informations et les range soigneusement dans les "cases" de l'objet.
-Balise::Balise(const char* message, double frequencyMhz, int filterPin)
-  : _message(message), _filterPin(filterPin) {
-    // On convertit la fréquence de MHz en Hertz, car c'est le format que notre
-    // pilote de DDS attend.
-    _frequencyHz = (unsigned long)(frequencyMhz * 1000000.0);
-}
-
-// Les fonctions suivantes permettent simplement de récupérer les informations stockées.
-const char* Balise::getMessage() const { return _message; }
-unsigned long Balise::getFrequency() const { return _frequencyHz; }
-int Balise::getFilterPin() const { return _filterPin; }
\ No newline at end of file
+// Le constructeur et les fonctions de lecture sont dans Balise.h : le compilateur doit
+// pouvoir remplir et relire les fiches du plan de bandes. Ici, les fonctions qui
+// changent une fiche en cours de route.
+void Balise::setMessage(const char* message) { _message = message; }
+void Balise::setFrequency(unsigned long frequencyHz) { _frequencyHz = frequencyHz; }
+void Balise::setFilterPin(int filterPin) { _filterPin = filterPin; }
+void Balise::setMotAccord(uint32_t mot, uint8_t ton) { if (ton < NOMBRE_TONS) _motsAccord[ton] = mot; }
+void Balise::setActive(bool active) { _active = active; }
+void Balise::setMode(ModeBalise mode) { _mode = mode; }
\ No newline at end of file
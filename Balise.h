@@ -3,6 +3,16 @@
 
 #include <Arduino.h>
 
+/**
+ * @enum ModeBalise
+ * @brief La façon d'émettre le message d'une balise.
+ */
+enum ModeBalise {
+  MODE_CW = 0,   ///< Morse en tout-ou-rien : le PTT suit les points et les traits.
+  MODE_WSPR = 1, ///< WSPR : 162 symboles à 4 tons, le message est l'indicatif seul.
+  MODE_QRSS = 2, ///< Morse très lent en déplacement de fréquence (FSK-CW) : la porteuse ne s'interrompt pas.
+};
+
 /**
  * @class Balise
  * @brief Une "fiche de réglages" pour une émission.
@@ -10,37 +20,110 @@
  * une sorte de fiche cartonnée qui regroupe toutes les informations
  * nécessaires pour une émission sur une bande spécifique : le message, la
  * fréquence, et les broches à activer.
+ *
+ * Une fiche peut être remplie par le compilateur (`constexpr`) : le plan de bandes du
+ * programme est ainsi rangé tout prêt en mémoire flash, et vérifié avant même le
+ * téléversement. Les mots d'accord, eux, dépendent de l'horloge du DDS et de sa
+ * correction : ils sont calculés au démarrage (voir `setMotAccord()`).
  */
 class Balise {
 public:
+  /// Une fiche vierge, à remplir par `MemoirePersistante::appliquerBalises()`.
+  constexpr Balise() : Balise("", 0, -1, false) {}
+
   /**
    * @brief Remplit la "fiche de réglages".
+   * @details Les mots d'accord restent à 0 jusqu'au démarrage (voir `setMotAccord()`).
    * @param message Le texte à envoyer.
-   * @param frequencyMhz La fréquence à utiliser, en Mégahertz.
+   * @param frequencyHz La fréquence à utiliser, en Hertz (ex: 14099000).
    * @param filterPin La broche du filtre pour cette fréquence.
+   * @param active `false` pour garder la bande dans la liste sans l'émettre.
+   * @param mode La façon d'émettre le message (Morse par défaut).
    */
-  Balise(const char* message, double frequencyMhz, int filterPin);
+  constexpr Balise(const char* message, unsigned long frequencyHz, int filterPin, bool active = true, ModeBalise mode = MODE_CW)
+    : _message(message), _frequencyHz(frequencyHz), _filterPin(filterPin),
+      _motsAccord{ 0, 0, 0, 0 },
+      _active(active), _mode(mode) {}
+
+  /// Nombre de mots d'accord rangés sur la fiche : un par ton (4 pour WSPR).
+  static const uint8_t NOMBRE_TONS = 4;
 
   /**
    * @brief Permet de lire le message écrit sur la fiche.
    */
-  const char* getMessage() const;
+  constexpr const char* getMessage() const { return _message; }
 
   /**
    * @brief Permet de lire la fréquence écrite sur la fiche (en Hertz).
    */
-  unsigned long getFrequency() const;
+  constexpr unsigned long getFrequency() const { return _frequencyHz; }
 
   /**
    * @brief Permet de lire le numéro de la broche du filtre.
    */
-  int getFilterPin() const;
-  
+  constexpr int getFilterPin() const { return _filterPin; }
+
+  /**
+   * @brief Remplace le message de la fiche.
+   * @details Seul le pointeur est gardé : le texte doit rester valide (par exemple celui
+   * du carnet de la MemoirePersistante).
+   */
+  void setMessage(const char* message);
+
+  /**
+   * @brief Remplace la fréquence de la fiche (le mot d'accord est alors à recalculer).
+   */
+  void setFrequency(unsigned long frequencyHz);
+
+  /**
+   * @brief Remplace la broche du filtre de la fiche.
+   */
+  void setFilterPin(int filterPin);
+
+  /**
+   * @brief Range sur la fiche le mot d'accord du DDS d'un de ses tons.
+   * @details Calculés une fois pour toutes (voir `PiloteDDS::calculerMotAccordPrecis()`),
+   * il suffit ensuite de les charger dans le DDS pour changer de bande ou de ton. Le ton 0
+   * est la fréquence de la fiche : la porteuse en Morse, le ton le plus bas en WSPR ou en QRSS.
+   * @param mot Le mot d'accord.
+   * @param ton Le numéro du ton, de 0 à `NOMBRE_TONS` - 1.
+   */
+  void setMotAccord(uint32_t mot, uint8_t ton = 0);
+
+  /**
+   * @brief Permet de lire le mot d'accord du DDS d'un ton rangé sur la fiche.
+   */
+  constexpr uint32_t getMotAccord(uint8_t ton = 0) const { return ton < NOMBRE_TONS ? _motsAccord[ton] : 0; }
+
+  /**
+   * @brief Change la façon d'émettre le message (les mots d'accord sont alors à recalculer).
+   */
+  void setMode(ModeBalise mode);
+
+  /**
+   * @brief Permet de lire la façon d'émettre le message.
+   */
+  constexpr ModeBalise getMode() const { return _mode; }
+
+  /**
+   * @brief Active ou désactive cette balise dans le programme des émissions.
+   * @details Une balise désactivée est simplement sautée par le PlanningBalises
+   * (par exemple une bande sans antenne, ou fermée pour la journée).
+   */
+  void setActive(bool active);
+
+  /**
+   * @brief Permet de savoir si cette balise participe au programme des émissions.
+   */
+  constexpr bool isActive() const { return _active; }
 
 private:
   const char* _message;       ///< Le message à émettre.
   unsigned long _frequencyHz; ///< La fréquence, stockée en Hertz.
   int _filterPin;             ///< La broche du filtre.
+  uint32_t _motsAccord[NOMBRE_TONS]; ///< Les mots d'accord du DDS de chaque ton (0 tant qu'ils ne sont pas calculés).
+  bool _active;               ///< `true` si la balise participe au programme des émissions.
+  ModeBalise _mode;           ///< La façon d'émettre le message.
 };
 
 #endif
\ No newline at end of file
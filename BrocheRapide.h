@@ -0,0 +1,69 @@
+#ifndef BROCHE_RAPIDE_H
+#define BROCHE_RAPIDE_H
+
+#include <Arduino.h>
+#include <util/atomic.h>
+
+/**
+ * @class BrocheRapide
+ * @brief Une broche de sortie connue à la compilation, écrite en une seule instruction.
+ * @details `digitalWrite()` retrouve à chaque appel le port et le bit de la broche dans
+ * des tables en mémoire flash. Ici, le numéro de la broche est un paramètre du modèle :
+ * le registre et le masque sont des constantes, et chaque écriture devient une seule
+ * instruction `sbi` ou `cbi` (deux cycles), atomique, pour les ports A à G de la Mega.
+ * Les ports H à L sont hors de portée de ces instructions : leur écriture est protégée
+ * des interruptions, le temps d'une lecture-modification-écriture.
+ *
+ * La table des broches est celle de l'Arduino Mega 2560. Ailleurs (simulateur sur PC,
+ * autre carte), on revient à `digitalWrite()`, dont chaque front reste observable.
+ *
+ * @tparam BROCHE Le numéro Arduino de la broche (0 à 69).
+ */
+template <uint8_t BROCHE>
+class BrocheRapide {
+public:
+  static_assert(BROCHE < 70, "La Mega n'a que 70 broches (0 a 69)");
+
+  /// Le port de la broche, en lettre (ports de la Mega, dans l'ordre des numéros Arduino).
+  static constexpr char PORT = "EEEEGEHHHHBBBBJJHHDDDD" "AAAAAAAA" "CCCCCCCC" "DGGG" "LLLLLLLL" "BBBB" "FFFFFFFF" "KKKKKKKK"[BROCHE];
+  /// Le bit de la broche dans son port.
+  static constexpr uint8_t MASQUE = 1 << ("0145533456456710103210" "01234567" "76543210" "7210" "76543210" "3210" "01234567" "01234567"[BROCHE] - '0');
+  /// L'adresse du registre PORTx dans l'espace mémoire de l'ATmega2560.
+  static constexpr uint16_t ADRESSE = PORT <= 'G' ? 0x22 + 3 * (PORT - 'A') : 0x102 + 3 * (PORT == 'H' ? 0 : PORT - 'I');
+  /// `true` si `sbi` et `cbi` atteignent le registre (adresses 0x20 à 0x3F).
+  static constexpr bool ATOMIQUE = ADRESSE < 0x40;
+
+  /// Met la broche en sortie (à appeler une fois, au démarrage).
+  static void sortie() { pinMode(BROCHE, OUTPUT); }
+
+  static void haut() {
+#if defined(__AVR_ATmega2560__)
+    if (ATOMIQUE) {
+      *(volatile uint8_t*)ADRESSE |= MASQUE;
+    } else {
+      ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *(volatile uint8_t*)ADRESSE |= MASQUE; }
+    }
+#else
+    digitalWrite(BROCHE, HIGH);
+#endif
+  }
+
+  static void bas() {
+#if defined(__AVR_ATmega2560__)
+    if (ATOMIQUE) {
+      *(volatile uint8_t*)ADRESSE &= (uint8_t)~MASQUE;
+    } else {
+      ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *(volatile uint8_t*)ADRESSE &= (uint8_t)~MASQUE; }
+    }
+#else
+    digitalWrite(BROCHE, LOW);
+#endif
+  }
+
+  static void ecrire(bool niveau) {
+    if (niveau) haut();
+    else bas();
+  }
+};
+
+#endif
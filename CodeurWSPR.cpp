@@ -0,0 +1,144 @@
+/**
+ * @file CodeurWSPR.cpp
+ * @brief Implémentation de la classe CodeurWSPR.
+ * @details Contient le vecteur de synchronisation, la compression de l'indicatif et
+ * du locator, le code convolutif et l'entrelacement des 162 symboles.
+ */
+#include "CodeurWSPR.h"
+#include <string.h>
+
+/// Premier polynôme du code convolutif (bit de données de rang pair).
+static const uint32_t POLYNOME_1 = 0xF2D05351UL;
+/// Second polynôme du code convolutif (bit de données de rang impair).
+static const uint32_t POLYNOME_2 = 0xE4613C47UL;
+/// Nombre de bits du message : 28 pour l'indicatif, 22 pour le locator et la puissance.
+static const uint8_t BITS_MESSAGE = 50;
+
+/**
+ * @brief Vecteur de synchronisation, rangé en mémoire flash (PROGMEM).
+ * @details Les 162 bits de poids faible des symboles, huit par octet, le symbole 0 dans
+ * le bit de poids faible du premier octet.
+ */
+static const uint8_t SYNCHRO[] PROGMEM = {
+  0x03, 0x71, 0xA4, 0x07, 0xA4, 0x40, 0xB3, 0x58, 0x58, 0x95, 0x34,
+  0x56, 0x04, 0xC9, 0xCD, 0xE2, 0xA0, 0x0C, 0x58, 0x63, 0x00
+};
+
+/// La parité (nombre de bits à 1, modulo 2) d'un mot de 32 bits.
+static uint8_t parite(uint32_t mot) {
+  mot ^= mot >> 16;
+  mot ^= mot >> 8;
+  mot ^= mot >> 4;
+  mot ^= mot >> 2;
+  mot ^= mot >> 1;
+  return mot & 1;
+}
+
+/// Les 8 bits d'un octet, dans l'ordre inverse.
+static uint8_t inverserBits(uint8_t octet) {
+  octet = (octet & 0xF0) >> 4 | (octet & 0x0F) << 4;
+  octet = (octet & 0xCC) >> 2 | (octet & 0x33) << 2;
+  octet = (octet & 0xAA) >> 1 | (octet & 0x55) << 1;
+  return octet;
+}
+
+/// La valeur d'un caractère de l'indicatif : 0 à 9 pour les chiffres, 10 à 35 pour les lettres, 36 pour l'espace.
+static uint8_t valeurCaractere(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+  return 36;
+}
+
+CodeurWSPR::CodeurWSPR() {
+  memset(_symboles, 0, sizeof(_symboles));
+}
+
+bool CodeurWSPR::puissanceValide(int8_t puissanceDbm) {
+  if (puissanceDbm < 0 || puissanceDbm > 60) return false;
+  uint8_t unite = puissanceDbm % 10;
+  return unite == 0 || unite == 3 || unite == 7;
+}
+
+bool CodeurWSPR::compresserIndicatif(const char* indicatif, uint32_t& n) {
+  size_t longueur = strlen(indicatif);
+  if (longueur < 3 || longueur > 6) return false;
+
+  // Le chiffre doit tomber en troisième position : "K1ABC" devient " K1ABC".
+  char c[6];
+  memset(c, ' ', sizeof(c));
+  uint8_t debut;
+  if (isdigit(indicatif[2])) debut = 0;
+  else if (isdigit(indicatif[1]) && longueur <= 5) debut = 1;
+  else return false;
+  for (size_t i = 0; i < longueur; i++) {
+    char caractere = toupper(indicatif[i]);
+    if (!isdigit(caractere) && !(caractere >= 'A' && caractere <= 'Z')) return false;
+    c[debut + i] = caractere;
+  }
+  // Le suffixe (après le chiffre) ne contient que des lettres.
+  for (uint8_t i = 3; i < 6; i++) {
+    if (isdigit(c[i])) return false;
+  }
+
+  n = valeurCaractere(c[0]);
+  n = n * 36 + valeurCaractere(c[1]);
+  n = n * 10 + valeurCaractere(c[2]);
+  // Pour le suffixe, 27 valeurs : les 26 lettres, puis l'espace.
+  for (uint8_t i = 3; i < 6; i++) {
+    n = n * 27 + (valeurCaractere(c[i]) - 10);
+  }
+  return true;
+}
+
+bool CodeurWSPR::compresserLocator(const char* locator, int8_t puissanceDbm, uint32_t& m) {
+  if (strlen(locator) < 4) return false;
+  char l0 = toupper(locator[0]);
+  char l1 = toupper(locator[1]);
+  if (l0 < 'A' || l0 > 'R' || l1 < 'A' || l1 > 'R' || !isdigit(locator[2]) || !isdigit(locator[3])) return false;
+  m = (179UL - 10 * (l0 - 'A') - (locator[2] - '0')) * 180 + 10 * (l1 - 'A') + (locator[3] - '0');
+  m = m * 128 + puissanceDbm + 64;
+  return true;
+}
+
+bool CodeurWSPR::coder(const char* indicatif, const char* locator, int8_t puissanceDbm) {
+  uint32_t n, m;
+  if (!puissanceValide(puissanceDbm) || !compresserIndicatif(indicatif, n) ||
+      !compresserLocator(locator, puissanceDbm, m)) {
+    return false;
+  }
+
+  // Les bits codés sortent dans l'ordre de `p`, et l'entrelacement envoie le bit `p`
+  // au symbole `j` (rang `i` à l'envers). On parcourt donc les rangs `i` dans l'ordre :
+  // chaque bit est calculé juste au moment d'être rangé, sans tableau intermédiaire.
+  memset(_symboles, 0, sizeof(_symboles));
+  uint32_t registre = 0;
+  uint8_t p = 0;
+  uint8_t i = 0;
+  while (p < NOMBRE_SYMBOLES) {
+    uint8_t j = inverserBits(i++);
+    if (j >= NOMBRE_SYMBOLES) continue;
+
+    uint8_t bit;
+    if ((p & 1) == 0) {
+      // Un nouveau bit de données entre dans le registre : l'indicatif, puis le locator, puis les zéros de fin.
+      uint8_t rang = p / 2;
+      uint8_t donnee = 0;
+      if (rang < 28) donnee = (n >> (27 - rang)) & 1;
+      else if (rang < BITS_MESSAGE) donnee = (m >> (BITS_MESSAGE - 1 - rang)) & 1;
+      registre = (registre << 1) | donnee;
+      bit = parite(registre & POLYNOME_1);
+    } else {
+      bit = parite(registre & POLYNOME_2);
+    }
+    p++;
+
+    uint8_t synchro = (pgm_read_byte(&SYNCHRO[j / 8]) >> (j % 8)) & 1;
+    _symboles[j / 4] |= (synchro + 2 * bit) << (2 * (j % 4));
+  }
+  return true;
+}
+
+uint8_t CodeurWSPR::getSymbole(uint8_t rang) const {
+  if (rang >= NOMBRE_SYMBOLES) return 0;
+  return (_symboles[rang / 4] >> (2 * (rang % 4))) & 3;
+}
@@ -0,0 +1,91 @@
+#ifndef CODEUR_WSPR_H
+#define CODEUR_WSPR_H
+
+#include <Arduino.h>
+
+/**
+ * @class CodeurWSPR
+ * @brief Le "chiffreur" qui met un indicatif, un locator et une puissance au format WSPR.
+ * @details Un message WSPR standard (type 1) tient en 50 bits : 28 pour l'indicatif,
+ * 15 pour le locator à 4 caractères et 7 pour la puissance. `coder()` fait tout le
+ * chemin jusqu'aux 162 symboles à émettre :
+ * - compression de l'indicatif et du locator en deux entiers ;
+ * - code convolutif de rendement 1/2 et de longueur de contrainte 32 (polynômes
+ *   0xF2D05351 et 0xE4613C47), sur les 50 bits suivis de 31 zéros ;
+ * - entrelacement par inversion de l'ordre des bits du rang (sur 8 bits) ;
+ * - ajout du vecteur de synchronisation : symbole = synchro + 2 × bit de données.
+ *
+ * Chaque symbole (0 à 3) désigne l'un des quatre tons, espacés de 12000 / 8192 Hz.
+ * Le calcul se fait une fois par émission, et les 162 symboles sont rangés à raison
+ * de quatre par octet.
+ */
+class CodeurWSPR {
+public:
+  /// Nombre de symboles d'une émission WSPR.
+  static const uint8_t NOMBRE_SYMBOLES = 162;
+  /// Nombre de tons différents (4-FSK).
+  static const uint8_t NOMBRE_TONS = 4;
+  /// Écart entre deux tons voisins, en 1/256 de hertz : 12000 / 8192 Hz = 375 / 256 Hz.
+  static const uint16_t ECART_TONS_256E_HZ = 375;
+
+  CodeurWSPR();
+
+  /**
+   * @brief Calcule les 162 symboles d'un message.
+   * @param indicatif Un indicatif standard : 6 caractères au plus, dont un chiffre en
+   * deuxième ou troisième position (ex: "F5ZHM", "K1ABC", "G4JNT"). Les indicatifs
+   * composés ("F/G4JNT") demandent un autre type de message et sont refusés.
+   * @param locator Le locator ; seuls ses 4 premiers caractères sont émis (ex: "JN18").
+   * @param puissanceDbm La puissance en dBm, de 0 à 60 et finissant par 0, 3 ou 7.
+   * @return `false` si l'un des trois ne peut pas être codé (les symboles précédents restent alors en place).
+   */
+  bool coder(const char* indicatif, const char* locator, int8_t puissanceDbm);
+
+  /**
+   * @brief Donne un symbole du dernier message codé (0 à 3).
+   * @param rang Le rang du symbole, de 0 à `NOMBRE_SYMBOLES` - 1.
+   */
+  uint8_t getSymbole(uint8_t rang) const;
+
+  /**
+   * @brief Permet de savoir si une puissance fait partie des valeurs que WSPR sait émettre.
+   */
+  static bool puissanceValide(int8_t puissanceDbm);
+
+  /**
+   * @brief Permet de savoir si un indicatif est un indicatif standard, que `coder()` accepte.
+   * @details Utilisable par le compilateur, pour vérifier le plan de bandes.
+   */
+  static constexpr bool indicatifValide(const char* indicatif) {
+    return longueur(indicatif) >= 3 && longueur(indicatif) <= 6 && alphanumerique(indicatif) &&
+           (chiffre(indicatif[2]) ? sansChiffre(indicatif + 3)
+                                  : chiffre(indicatif[1]) && longueur(indicatif) <= 5 && sansChiffre(indicatif + 2));
+  }
+
+private:
+  /// Interne : versions pour le compilateur de strlen(), isdigit()...
+  static constexpr uint8_t longueur(const char* texte) { return *texte == '\0' ? 0 : 1 + longueur(texte + 1); }
+  static constexpr bool chiffre(char c) { return c >= '0' && c <= '9'; }
+  static constexpr bool lettre(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+  static constexpr bool alphanumerique(const char* texte) {
+    return *texte == '\0' || ((chiffre(*texte) || lettre(*texte)) && alphanumerique(texte + 1));
+  }
+  /// Interne : `true` si le suffixe (après le chiffre) ne contient que des lettres.
+  static constexpr bool sansChiffre(const char* texte) { return *texte == '\0' || (!chiffre(*texte) && sansChiffre(texte + 1)); }
+
+  /**
+   * @brief Interne : compresse un indicatif en un entier de 28 bits.
+   * @return `false` si l'indicatif n'est pas un indicatif standard.
+   */
+  static bool compresserIndicatif(const char* indicatif, uint32_t& n);
+
+  /**
+   * @brief Interne : compresse le locator et la puissance en un entier de 22 bits.
+   * @return `false` si le locator n'a pas la forme "AA00".
+   */
+  static bool compresserLocator(const char* locator, int8_t puissanceDbm, uint32_t& m);
+
+  uint8_t _symboles[(NOMBRE_SYMBOLES + 3) / 4]; ///< Les symboles, quatre par octet, le premier dans les bits de poids faible.
+};
+
+#endif
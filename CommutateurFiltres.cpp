@@ -0,0 +1,90 @@
+/**
+ * @file CommutateurFiltres.cpp
+ * @brief Implémentation de la classe CommutateurFiltres.
+ * @details Contient la petite machine à états qui relâche l'ancien relais, attend
+ * son ouverture, puis engage le nouveau et attend sa stabilisation.
+ */
+#include "CommutateurFiltres.h"
+
+CommutateurFiltres::CommutateurFiltres()
+  : _nombreFiltres(0), _demande(-1), _enService(-1), _etat(FILTRE_STABLE), _debutMs(0), _attenteMs(0) {}
+
+bool CommutateurFiltres::ajouterFiltre(int broche, uint16_t stabilisationMs) {
+  if (_nombreFiltres >= NOMBRE_MAX_FILTRES) return false;
+  _broches[_nombreFiltres] = broche;
+  _stabilisationMs[_nombreFiltres] = stabilisationMs > STABILISATION_MAX_MS ? STABILISATION_MAX_MS : stabilisationMs;
+  _nombreFiltres++;
+  digitalWrite(broche, LOW);
+  pinMode(broche, OUTPUT);
+  return true;
+}
+
+int8_t CommutateurFiltres::chercher(int broche) const {
+  for (uint8_t i = 0; i < _nombreFiltres; i++) {
+    if (_broches[i] == broche) return i;
+  }
+  return -1;
+}
+
+bool CommutateurFiltres::connait(int broche) const { return chercher(broche) >= 0; }
+
+bool CommutateurFiltres::selectionner(int broche) {
+  int8_t filtre = chercher(broche);
+  if (filtre < 0) return false;
+  if (filtre == _demande) return true;
+  _demande = filtre;
+
+  if (_enService >= 0) {
+    // Un relais est commandé (en place ou en train de se fermer) : on le relâche
+    // d'abord, et on attend qu'il soit ouvert avant d'engager le nouveau.
+    ouvrirRelais();
+  } else if (_etat != FILTRE_RELACHEMENT) {
+    // Rien n'est en service ni en train de s'ouvrir : on peut engager directement.
+    engager();
+  }
+  // Sinon, un relais est encore en train de s'ouvrir : mettreAJour() engagera le bon filtre ensuite.
+  return true;
+}
+
+void CommutateurFiltres::relacher() {
+  _demande = -1;
+  if (_enService >= 0) ouvrirRelais();
+}
+
+void CommutateurFiltres::ouvrirRelais() {
+  digitalWrite(_broches[_enService], LOW);
+  _etat = FILTRE_RELACHEMENT;
+  _debutMs = millis();
+  _attenteMs = _stabilisationMs[_enService];
+  _enService = -1;
+}
+
+void CommutateurFiltres::engager() {
+  if (_demande < 0) {
+    _etat = FILTRE_STABLE;
+    return;
+  }
+  digitalWrite(_broches[_demande], HIGH);
+  _enService = _demande;
+  _etat = FILTRE_ENGAGEMENT;
+  _debutMs = millis();
+  _attenteMs = _stabilisationMs[_demande];
+}
+
+void CommutateurFiltres::mettreAJour() {
+  if (_etat == FILTRE_STABLE) return;
+  if (millis() - _debutMs < _attenteMs) return;
+  if (_etat == FILTRE_RELACHEMENT) {
+    // L'ancien relais est ouvert : place au nouveau.
+    engager();
+  } else {
+    _etat = FILTRE_STABLE;
+  }
+}
+
+bool CommutateurFiltres::estPret() const {
+  return _etat == FILTRE_STABLE && _demande >= 0 && _enService == _demande;
+}
+
+bool CommutateurFiltres::estStable() const { return _etat == FILTRE_STABLE; }
+EtatCommutateur CommutateurFiltres::getEtat() const { return _etat; }
@@ -0,0 +1,114 @@
+#ifndef COMMUTATEUR_FILTRES_H
+#define COMMUTATEUR_FILTRES_H
+
+#include <Arduino.h>
+
+/**
+ * @enum EtatCommutateur
+ * @brief Où en est le changement de filtre.
+ */
+enum EtatCommutateur {
+  FILTRE_STABLE,      ///< Aucun relais ne bouge : le filtre demandé (s'il y en a un) est en place.
+  FILTRE_RELACHEMENT, ///< L'ancien relais vient d'être relâché : on attend qu'il soit bien ouvert.
+  FILTRE_ENGAGEMENT,  ///< Le nouveau relais vient d'être commandé : on attend que ses contacts soient stables.
+};
+
+/**
+ * @class CommutateurFiltres
+ * @brief L'"aiguilleur" qui commute les relais des filtres passe-bas.
+ * @details Un relais met quelques millisecondes à s'ouvrir ou à se fermer, et deux
+ * filtres ne doivent jamais être en service en même temps. Le commutateur :
+ * - relâche toujours l'ancien relais, attend qu'il soit ouvert, puis seulement engage
+ *   le nouveau ("break before make") ;
+ * - connaît, pour chaque broche de filtre, le temps de stabilisation de son relais ;
+ * - ne bloque jamais : `selectionner()` lance le changement, et `mettreAJour()`,
+ *   appelée régulièrement, le fait avancer.
+ *
+ * La bande suivante étant connue une minute à l'avance, le filtre peut ainsi être mis
+ * en place pendant le silence qui précède l'émission, et non au moment de manipuler.
+ */
+class CommutateurFiltres {
+public:
+  /// Nombre maximal de filtres gérés.
+  static const uint8_t NOMBRE_MAX_FILTRES = 12;
+  /// Temps de stabilisation maximal accepté pour un relais : un changement complet tient ainsi largement dans la dernière seconde de la minute.
+  static const uint16_t STABILISATION_MAX_MS = 250;
+
+  CommutateurFiltres();
+
+  /**
+   * @brief Déclare un filtre et le temps de stabilisation de son relais.
+   * @details La broche est mise en sortie, relais relâché.
+   * @param broche La broche qui commande le relais du filtre.
+   * @param stabilisationMs Le temps que met le relais à s'ouvrir ou à se fermer (au plus `STABILISATION_MAX_MS`).
+   * @return `false` si la liste des filtres est pleine.
+   */
+  bool ajouterFiltre(int broche, uint16_t stabilisationMs);
+
+  /**
+   * @brief Permet de savoir si une broche a été déclarée comme filtre.
+   */
+  bool connait(int broche) const;
+
+  /**
+   * @brief Demande la mise en service d'un filtre.
+   * @details Ne fait rien si ce filtre est déjà demandé. Sinon, le filtre en service est
+   * relâché tout de suite, et le nouveau sera engagé par `mettreAJour()` une fois l'ancien ouvert.
+   * @param broche La broche du filtre souhaité.
+   * @return `false` si cette broche n'a pas été déclarée avec `ajouterFiltre()`.
+   */
+  bool selectionner(int broche);
+
+  /**
+   * @brief Relâche le filtre en service, sans en engager d'autre.
+   */
+  void relacher();
+
+  /**
+   * @brief Fait avancer le changement de filtre en cours. À appeler souvent (toutes les millisecondes ou presque).
+   */
+  void mettreAJour();
+
+  /**
+   * @brief Permet de savoir si le filtre demandé est en place et ses contacts stables.
+   */
+  bool estPret() const;
+
+  /**
+   * @brief Permet de savoir si aucun relais n'est en train de bouger, qu'un filtre soit engagé ou non.
+   */
+  bool estStable() const;
+
+  /**
+   * @brief Donne l'étape du changement de filtre en cours.
+   */
+  EtatCommutateur getEtat() const;
+
+private:
+  /**
+   * @brief Interne : retrouve le numéro d'un filtre à partir de sa broche (-1 s'il est inconnu).
+   */
+  int8_t chercher(int broche) const;
+
+  /**
+   * @brief Interne : relâche le relais en service et commence l'attente de son ouverture.
+   */
+  void ouvrirRelais();
+
+  /**
+   * @brief Interne : commande le relais du filtre demandé et commence l'attente de sa stabilisation.
+   */
+  void engager();
+
+  int _broches[NOMBRE_MAX_FILTRES];           ///< La broche de chaque filtre.
+  uint16_t _stabilisationMs[NOMBRE_MAX_FILTRES]; ///< Le temps de stabilisation du relais de chaque filtre.
+  uint8_t _nombreFiltres;                     ///< Le nombre de filtres déclarés.
+
+  int8_t _demande;          ///< Le filtre souhaité (-1 : aucun).
+  int8_t _enService;        ///< Le filtre dont le relais est commandé (-1 : aucun).
+  EtatCommutateur _etat;    ///< L'étape du changement en cours.
+  unsigned long _debutMs;   ///< L'instant (millis()) du dernier mouvement de relais.
+  uint16_t _attenteMs;      ///< L'attente à respecter depuis ce mouvement.
+};
+
+#endif
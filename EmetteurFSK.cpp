@@ -0,0 +1,190 @@
+/**
+ * @file EmetteurFSK.cpp
+ * @brief Implémentation de la classe EmetteurFSK.
+ * @details Contient le découpage des émissions WSPR et QRSS en étapes du timer, et le
+ * préchargement du ton de chaque étape pendant l'étape précédente.
+ */
+#include "EmetteurFSK.h"
+
+/// Numérateur et dénominateur d'une unité WSPR, en secondes : un quart de symbole, 2048 / 12000 s.
+static const unsigned long NUMERATEUR_UNITE_WSPR = 128;
+static const unsigned long DENOMINATEUR_UNITE_WSPR = 750;
+/// Plus longue unité du timer utilisée en QRSS, en millisecondes (le timer déborde vers 262 ms).
+static const unsigned long UNITE_QRSS_MAX_MS = 250;
+/// Plus long point QRSS accepté, en millisecondes.
+static const unsigned long POINT_QRSS_MAX_MS = 30000;
+/// Plus longue étape du timer, en unités (7 bits au format de SequenceMorse).
+static const uint8_t DUREE_ETAPE_MAX = 0x7F;
+
+/// Le plus grand diviseur commun de deux entiers (algorithme d'Euclide).
+static unsigned long pgcd(unsigned long a, unsigned long b) {
+  while (b != 0) {
+    unsigned long reste = a % b;
+    a = b;
+    b = reste;
+  }
+  return a;
+}
+
+EmetteurFSK::EmetteurFSK(LiaisonDDS& dds)
+  : _dds(dds), _manipulateur(nullptr), _sequence(nullptr), _mots(),
+    _numerateurUnite(NUMERATEUR_UNITE_WSPR), _denominateurUnite(DENOMINATEUR_UNITE_WSPR), _unitesParPoint(1), _unitesTotal(0),
+    _etape(0), _unitesEnReserve(0), _tonEnReserve(0), _etapeEnAttente(false), _etapeAttente(0), _tonAttente(0),
+    _etapesAjoutees(0), _commenceesVues(0), _motPret(false), _retards(0),
+    _enCours(false), _departEnAttente(false), _debutMicros(0), _validation(nullptr) {}
+
+bool EmetteurFSK::utiliserTimer(ManipulateurTimer& manipulateur) {
+  // Le timer doit savoir battre le quart de symbole WSPR ; le rythme Morse est rétabli
+  // par l'EmetteurMorse avant chacune de ses émissions.
+  if (!manipulateur.setDureeUnite(NUMERATEUR_UNITE_WSPR, DENOMINATEUR_UNITE_WSPR)) return false;
+  _manipulateur = &manipulateur;
+  return true;
+}
+
+bool EmetteurFSK::estDisponible() const { return _manipulateur != nullptr; }
+
+bool EmetteurFSK::preparerWSPR(const Balise& balise, const char* indicatif, const char* locator, int8_t puissanceDbm) {
+  if (_manipulateur == nullptr || !_codeur.coder(indicatif, locator, puissanceDbm)) return false;
+  for (uint8_t ton = 0; ton < Balise::NOMBRE_TONS; ton++) _mots[ton] = balise.getMotAccord(ton);
+  _sequence = nullptr;
+  _numerateurUnite = NUMERATEUR_UNITE_WSPR;
+  _denominateurUnite = DENOMINATEUR_UNITE_WSPR;
+  _unitesTotal = (unsigned long)CodeurWSPR::NOMBRE_SYMBOLES * UNITES_PAR_SYMBOLE_WSPR;
+  return true;
+}
+
+bool EmetteurFSK::preparerQRSS(const Balise& balise, const SequenceMorse& sequence, unsigned long dureePointMs) {
+  if (_manipulateur == nullptr || dureePointMs == 0 || dureePointMs > POINT_QRSS_MAX_MS) return false;
+  for (uint8_t ton = 0; ton < Balise::NOMBRE_TONS; ton++) _mots[ton] = balise.getMotAccord(ton);
+  _sequence = &sequence;
+  // Un point de plusieurs secondes ne tient pas dans le compteur du timer : on le découpe
+  // en unités d'au plus 250 ms, de durée moyenne exacte (dureePointMs / 1000 / unités).
+  _unitesParPoint = (dureePointMs + UNITE_QRSS_MAX_MS - 1) / UNITE_QRSS_MAX_MS;
+  unsigned long denominateur = 1000UL * _unitesParPoint;
+  unsigned long diviseur = pgcd(dureePointMs, denominateur);
+  _numerateurUnite = dureePointMs / diviseur;
+  _denominateurUnite = denominateur / diviseur;
+  _unitesTotal = (unsigned long)sequence.getDureeUnites() * _unitesParPoint;
+  return _denominateurUnite <= 65535UL;
+}
+
+unsigned long EmetteurFSK::getDureeMs() const {
+  // Une fois par émission : le calcul sur 64 bits n'a pas à être rapide.
+  return (unsigned long)((uint64_t)_unitesTotal * _numerateurUnite * 1000 / _denominateurUnite);
+}
+
+void EmetteurFSK::startAt(unsigned long debutMicros, ActionDepart validation) {
+  if (_manipulateur == nullptr) return;
+  _etape = 0;
+  _unitesEnReserve = 0;
+  _etapeEnAttente = false;
+  _etapesAjoutees = 0;
+  _commenceesVues = 0;
+  _retards = 0;
+  _debutMicros = debutMicros;
+  _validation = validation;
+  _enCours = true;
+
+  _manipulateur->setDureeUnite(_numerateurUnite, _denominateurUnite);
+  _manipulateur->vider();
+  alimenterTimer();
+  // Le ton du premier symbole attend dans le DDS : il sera validé à l'heure du départ.
+  _motPret = false;
+  prechargerSuivant();
+  _departEnAttente = true;
+  demarrerTimerSiProche();
+}
+
+void EmetteurFSK::demarrerTimerSiProche() {
+  long reste = (long)(_debutMicros - micros());
+  if (reste > (long)ManipulateurTimer::DELAI_MAX_US) return; // Trop tôt : on réessaiera au prochain poll().
+  // La validation est rejouée au début de chaque étape : chaque symbole prend son ton à l'heure exacte.
+  _manipulateur->demarrer(reste > 0 ? (unsigned long)reste : 0, _validation, true);
+  _departEnAttente = false;
+}
+
+bool EmetteurFSK::etapeSuivante(uint8_t& etape, uint8_t& ton) {
+  if (_sequence == nullptr) {
+    // WSPR : un symbole par étape, tous de la même durée.
+    if (_etape >= CodeurWSPR::NOMBRE_SYMBOLES) return false;
+    ton = _codeur.getSymbole(_etape++);
+    etape = 0x80 | UNITES_PAR_SYMBOLE_WSPR;
+    return true;
+  }
+
+  // QRSS : chaque étape Morse, allongée à l'échelle du point, est découpée en étapes du
+  // timer d'au plus 127 unités. Le PTT reste appuyé : seul le ton change.
+  if (_unitesEnReserve == 0) {
+    if (_etape >= _sequence->getNombreEtapes()) return false;
+    uint8_t etapeMorse = _sequence->getEtape(_etape++);
+    _unitesEnReserve = (uint16_t)SequenceMorse::getDuree(etapeMorse) * _unitesParPoint;
+    _tonEnReserve = SequenceMorse::estSon(etapeMorse) ? 1 : 0;
+  }
+  uint8_t duree = _unitesEnReserve > DUREE_ETAPE_MAX ? DUREE_ETAPE_MAX : _unitesEnReserve;
+  _unitesEnReserve -= duree;
+  etape = 0x80 | duree;
+  ton = _tonEnReserve;
+  return true;
+}
+
+void EmetteurFSK::alimenterTimer() {
+  for (;;) {
+    if (!_etapeEnAttente) {
+      if (!etapeSuivante(_etapeAttente, _tonAttente)) {
+        _manipulateur->terminer();
+        return;
+      }
+      _etapeEnAttente = true;
+    }
+    if (!_manipulateur->ajouterEtape(_etapeAttente)) return; // File pleine : la suite au prochain poll().
+    // La file ne contient jamais plus de TAILLE_FILE - 1 étapes en attente : la case
+    // de cette étape n'est plus lue par prechargerSuivant().
+    _tons[_etapesAjoutees & (ManipulateurTimer::TAILLE_FILE - 1)] = _tonAttente;
+    _etapesAjoutees++;
+    _etapeEnAttente = false;
+  }
+}
+
+void EmetteurFSK::prechargerSuivant() {
+  uint16_t commencees = _manipulateur->getEtapesCommencees();
+  if (commencees != _commenceesVues) {
+    // Des étapes ont commencé depuis le dernier passage : seule la première a pu
+    // trouver son mot préchargé, les autres ont gardé le ton précédent.
+    uint16_t nouvelles = commencees - _commenceesVues;
+    _retards += _motPret ? nouvelles - 1 : nouvelles;
+    _commenceesVues = commencees;
+    _motPret = false;
+  }
+  if (_motPret || commencees >= _etapesAjoutees) return;
+
+  // Un seul chargement de 40 bits par étape, validé par l'interruption au début de l'étape.
+  _dds.prechargerMotAccord(_mots[_tons[commencees & (ManipulateurTimer::TAILLE_FILE - 1)]]);
+  _motPret = true;
+  uint16_t maintenant = _manipulateur->getEtapesCommencees();
+  if (maintenant != commencees) {
+    // L'étape a commencé pendant le chargement : le DDS a pu valider un mot incomplet, et
+    // garder un registre décalé. On recharge le mot de l'étape commencée et on le valide
+    // tout de suite, plutôt que de laisser un faux ton pendant tout le symbole.
+    _dds.prechargerMotAccord(_mots[_tons[(uint16_t)(maintenant - 1) & (ManipulateurTimer::TAILLE_FILE - 1)]]);
+    _dds.validerFrequence();
+    _retards++;
+    _commenceesVues = maintenant;
+    _motPret = false;
+  }
+}
+
+bool EmetteurFSK::poll() {
+  if (!_enCours) return false;
+  if (_departEnAttente) {
+    demarrerTimerSiProche();
+    if (_departEnAttente) return true;
+  }
+  alimenterTimer();
+  prechargerSuivant();
+  _enCours = _manipulateur->estActif();
+  return _enCours;
+}
+
+bool EmetteurFSK::isBusy() const { return _enCours; }
+uint16_t EmetteurFSK::getRetards() const { return _retards; }
+const CodeurWSPR& EmetteurFSK::getCodeur() const { return _codeur; }
@@ -0,0 +1,165 @@
+#ifndef EMETTEUR_FSK_H
+#define EMETTEUR_FSK_H
+
+#include <Arduino.h>
+#include "Balise.h"
+#include "CodeurWSPR.h"
+#include "LiaisonDDS.h"
+#include "ManipulateurTimer.h"
+#include "SequenceMorse.h"
+
+/**
+ * @class EmetteurFSK
+ * @brief Le "chanteur" qui émet en changeant de ton plutôt qu'en coupant la porteuse.
+ * @details Pour les modes WSPR et QRSS, le PTT reste appuyé pendant toute l'émission
+ * et c'est la fréquence du DDS qui porte l'information :
+ * - en WSPR, 162 symboles de 8192 / 12000 s, chacun sur l'un des quatre tons de la balise ;
+ * - en QRSS, du Morse très lent en déplacement de fréquence : le ton 1 pour les points
+ *   et les traits, le ton 0 pour les silences.
+ *
+ * Les mots d'accord des tons sont calculés d'avance, une fois par balise (voir
+ * `Balise::getMotAccord()`). Pendant l'émission, il n'y a plus ni calcul ni virgule
+ * flottante : chaque symbole ne coûte qu'un chargement de 40 bits dans le DDS, fait
+ * depuis `poll()` juste après le début du symbole précédent, et une impulsion FQ_UD
+ * donnée par l'interruption du ManipulateurTimer à l'instant exact où le symbole commence.
+ *
+ * Un symbole dont le mot n'a pas été chargé à temps (boucle retenue pendant presque
+ * tout un symbole) est émis sur le ton précédent : il est compté dans `getRetards()`.
+ * Si le symbole commence pendant le chargement de son mot, le mot est rechargé et validé
+ * aussitôt, avec quelques dizaines de microsecondes de retard : il est compté aussi.
+ *
+ * Sans Timer3, ces modes ne sont pas disponibles : `utiliserTimer()` renvoie `false`.
+ */
+class EmetteurFSK {
+public:
+  /// Nombre d'unités du timer par symbole WSPR (une unité dure 2048 / 12000 s, moins de 262 ms).
+  static const uint8_t UNITES_PAR_SYMBOLE_WSPR = 4;
+
+  /**
+   * @brief Construit notre "chanteur".
+   * @param dds Le pilote du DDS (PiloteDDS ou GestionnaireDDS), qui reçoit les mots d'accord des tons.
+   */
+  explicit EmetteurFSK(LiaisonDDS& dds);
+
+  /**
+   * @brief Confie le rythme des symboles au timer matériel (obligatoire pour ces modes).
+   * @param manipulateur Le manipulateur à utiliser, déjà préparé par `begin()` (voir EmetteurMorse).
+   * @return `false` si le timer n'est pas disponible.
+   */
+  bool utiliserTimer(ManipulateurTimer& manipulateur);
+
+  /**
+   * @brief Permet de savoir si les modes à déplacement de fréquence sont disponibles.
+   */
+  bool estDisponible() const;
+
+  /**
+   * @brief Prépare une émission WSPR : code le message et retient les tons de la balise.
+   * @param balise La balise, dont les quatre mots d'accord sont déjà calculés.
+   * @param indicatif L'indicatif à émettre (voir `CodeurWSPR::coder()`).
+   * @param locator Le locator de la station (seuls ses 4 premiers caractères sont émis).
+   * @param puissanceDbm La puissance annoncée, en dBm.
+   * @return `false` si le message ne peut pas être codé ou si le timer manque.
+   */
+  bool preparerWSPR(const Balise& balise, const char* indicatif, const char* locator, int8_t puissanceDbm);
+
+  /**
+   * @brief Prépare une émission QRSS à partir d'une séquence Morse déjà traduite.
+   * @details La séquence n'est pas recopiée : elle doit rester en place jusqu'à la fin
+   * de l'émission (celle de l'EmetteurMorse, par exemple, qui se tait pendant ce temps).
+   * @param balise La balise, dont les mots d'accord des tons 0 et 1 sont déjà calculés.
+   * @param sequence Le message traduit en étapes Morse.
+   * @param dureePointMs La durée d'un point, en millisecondes (3000 pour du QRSS3).
+   * @return `false` si la durée du point ne convient pas ou si le timer manque.
+   */
+  bool preparerQRSS(const Balise& balise, const SequenceMorse& sequence, unsigned long dureePointMs);
+
+  /**
+   * @brief Donne la durée de l'émission préparée, en millisecondes.
+   */
+  unsigned long getDureeMs() const;
+
+  /**
+   * @brief Programme l'émission préparée pour un instant précis.
+   * @details Le mot d'accord du premier symbole est chargé tout de suite dans le DDS ;
+   * il faut ensuite appeler `poll()` le plus souvent possible (voir `EmetteurMorse::startAt()`).
+   * @param debutMicros L'instant (au sens de `micros()`) du premier symbole.
+   * @param validation L'action qui valide le mot préchargé (impulsion FQ_UD), appelée
+   * sous interruption au début de chaque symbole.
+   */
+  void startAt(unsigned long debutMicros, ActionDepart validation);
+
+  /**
+   * @brief Complète la file du timer et précharge le ton du symbole suivant.
+   * @return `true` tant que l'émission n'est pas terminée, `false` ensuite.
+   */
+  bool poll();
+
+  /**
+   * @brief Permet de savoir si une émission est en cours.
+   */
+  bool isBusy() const;
+
+  /**
+   * @brief Donne le nombre de symboles de la dernière émission dont le ton n'était pas chargé à temps.
+   */
+  uint16_t getRetards() const;
+
+  /**
+   * @brief Donne accès au codeur, et donc aux symboles de la dernière émission WSPR.
+   */
+  const CodeurWSPR& getCodeur() const;
+
+private:
+  /**
+   * @brief Interne : calcule l'étape suivante du timer et son ton.
+   * @return `false` quand il n'y a plus d'étape.
+   */
+  bool etapeSuivante(uint8_t& etape, uint8_t& ton);
+
+  /**
+   * @brief Interne : ajoute à la file du manipulateur toutes les étapes qui y tiennent.
+   */
+  void alimenterTimer();
+
+  /**
+   * @brief Interne : précharge dans le DDS le ton de l'étape qui commencera la prochaine.
+   */
+  void prechargerSuivant();
+
+  /**
+   * @brief Interne : lance le timer si l'instant de départ est assez proche pour qu'il puisse l'attendre lui-même.
+   */
+  void demarrerTimerSiProche();
+
+  LiaisonDDS& _dds;                  ///< Le pilote du DDS.
+  ManipulateurTimer* _manipulateur;  ///< Le timer qui donne le rythme, ou `nullptr`.
+  CodeurWSPR _codeur;                ///< Les symboles de la dernière émission WSPR.
+  const SequenceMorse* _sequence;    ///< La séquence Morse d'une émission QRSS, ou `nullptr` en WSPR.
+  uint32_t _mots[Balise::NOMBRE_TONS]; ///< Les mots d'accord des tons de la balise en cours.
+
+  unsigned long _numerateurUnite;    ///< Durée d'une unité du timer : `_numerateurUnite / _denominateurUnite` s.
+  unsigned long _denominateurUnite;
+  uint8_t _unitesParPoint;           ///< En QRSS, le nombre d'unités du timer par point Morse.
+  unsigned long _unitesTotal;        ///< Durée de l'émission préparée, en unités du timer.
+
+  uint16_t _etape;                   ///< Prochain symbole (WSPR) ou prochaine étape Morse (QRSS) à mettre en file.
+  uint16_t _unitesEnReserve;         ///< En QRSS, les unités de l'étape Morse en cours pas encore mises en file.
+  uint8_t _tonEnReserve;             ///< En QRSS, le ton de l'étape Morse en cours.
+  bool _etapeEnAttente;              ///< `true` si une étape calculée attend une place dans la file.
+  uint8_t _etapeAttente;             ///< Cette étape, au format de SequenceMorse.
+  uint8_t _tonAttente;               ///< Et son ton.
+
+  uint8_t _tons[ManipulateurTimer::TAILLE_FILE]; ///< Le ton de chaque étape mise en file, rangé au rang de l'étape.
+  uint16_t _etapesAjoutees;          ///< Nombre d'étapes mises en file depuis le début.
+  uint16_t _commenceesVues;          ///< Nombre d'étapes commencées lors du dernier `poll()`.
+  bool _motPret;                     ///< `true` si le mot de l'étape `_commenceesVues` est préchargé.
+  uint16_t _retards;                 ///< Étapes commencées sans que leur mot soit préchargé.
+
+  bool _enCours;                     ///< `true` tant qu'une émission est en cours.
+  bool _departEnAttente;             ///< `true` tant que le timer n'a pas encore été lancé.
+  unsigned long _debutMicros;        ///< Instant (micros()) du premier symbole.
+  ActionDepart _validation;          ///< L'action qui valide le ton préchargé.
+};
+
+#endif
@@ -1,38 +1,14 @@
 #include "EmetteurMorse.h"
-#include <string.h> // On a besoin de cet outil pour calculer la longueur d'un message.
-
-/**
- * @brief Dictionnaire de traduction de l'alphabet latin vers le Morse.
- * @details Ce grand tableau est notre dictionnaire. L'astuce est que l'on peut
- * trouver directement le code morse d'un caractère en utilisant son code ASCII
- * comme numéro de case (indice) dans le tableau.
- */
-static const char* const MORSE_CODE[] = {
-    // Les premières cases sont vides car elles correspondent à des caractères non imprimables.
-    "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "",
-    // Cases 48 à 57 : Chiffres de '0' à '9'
-    /* '0' */ "-----",   /* '1' */ ".----",   /* '2' */ "..---",   /* '3' */ "...--",   /* '4' */ "....-",
-    /* '5' */ ".....",   /* '6' */ "-....",   /* '7' */ "--...",   /* '8' */ "---..",   /* '9' */ "----.",
-    "", "", "", "", "", "", "", // Autres cases vides pour les symboles entre les chiffres et les lettres.
-    // Cases 65 à 90 : Lettres de 'A' à 'Z'
-    /* 'A' */ ".-",      /* 'B' */ "-...",    /* 'C' */ "-.-.",    /* 'D' */ "-..",     /* 'E' */ ".",
-    /* 'F' */ "..-.",    /* 'G' */ "--.",     /* 'H' */ "....",    /* 'I' */ "..",      /* 'J' */ ".---",
-    /* 'K' */ "-.-",     /* 'L' */ ".-..",    /* 'M' */ "--",      /* 'N' */ "-.",      /* 'O' */ "---",
-    /* 'P' */ ".--.",    /* 'Q' */ "--.-",    /* 'R' */ ".-.",     /* 'S' */ "...",     /* 'T' */ "-",
-    /* 'U' */ "..-",     /* 'V' */ "...-",    /* 'W' */ ".--",     /* 'X' */ "-..-",    /* 'Y' */ "-.--",
-    /* 'Z' */ "--.."
-};
 
 EmetteurMorse::EmetteurMorse(int pttPin, int txLedPin, int wpm) 
-  : _pttPin(pttPin), _txLedPin(txLedPin) {
+  : _pttPin(pttPin), _txLedPin(txLedPin), _wpm(wpm),
+    _etape(0), _enCours(false), _debutMicros(0), _unites(0), _manipulateur(nullptr),
+    _departEnAttente(false), _actionDepart(nullptr) {
   // On prépare les broches à fonctionner en sortie.
   pinMode(_pttPin, OUTPUT);
   pinMode(_txLedPin, OUTPUT);
   // On s'assure que l'émission est coupée au départ.
   pttOff();
-  // On calcule la durée d'un "point" en millisecondes. C'est la base de tout le rythme Morse.
-  // La formule standard est 1200 divisé par la vitesse en mots par minute.
-  _dot_len_ms = 1200 / wpm;
 }
 
 // Active l'émission.
@@ -47,50 +23,116 @@ void EmetteurMorse::pttOff() {
   digitalWrite(_txLedPin, LOW);
 }
 
-// Envoie un "point".
-void EmetteurMorse::dot() {
-  pttOn();
-  delay(_dot_len_ms); // Le "point" dure 1 unité de temps.
-  pttOff();
-  delay(_dot_len_ms); // L'espace entre deux sons dans une même lettre dure 1 unité de temps.
+bool EmetteurMorse::utiliserTimer(ManipulateurTimer& manipulateur) {
+  if (!manipulateur.begin(_pttPin, _txLedPin, _wpm)) return false;
+  _manipulateur = &manipulateur;
+  return true;
 }
 
-// Envoie un "trait".
-void EmetteurMorse::dash() {
-  pttOn();
-  delay(_dot_len_ms * 3); // Le "trait" dure 3 unités de temps.
-  pttOff();
-  delay(_dot_len_ms); // L'espace entre deux sons dure toujours 1 unité de temps.
+unsigned long EmetteurMorse::unitesEnMicros(unsigned long unites) const {
+  // Un "point" dure 1200 / wpm millisecondes, soit 1 200 000 / wpm microsecondes.
+  // On découpe le calcul pour rester exact (pas de troncature de 1200 / wpm qui se
+  // cumulerait élément après élément) sans dépasser la capacité d'un unsigned long.
+  return (unites / _wpm) * 1200000UL + ((unites % _wpm) * 1200000UL) / _wpm;
 }
 
 void EmetteurMorse::sendMessage(const char* message) {
-  pttOff();
-  size_t longueurMessage = strlen(message);
-
-  // On parcourt chaque caractère du message, un par un.
-  for (size_t i = 0; i < longueurMessage; i++) {
-    char c = toupper(message[i]); // On met en majuscule pour correspondre à notre dictionnaire.
-
-    if (c == ' ') {
-      // Si c'est un espace, on fait une pause plus longue (un espace entre mots).
-      delay(_dot_len_ms * 4);
-    } else if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z')) {
-      // Si c'est une lettre ou un chiffre, on l'envoie.
-      sendChar(c);
-      // Puis on attend l'équivalent d'un espace entre deux lettres.
-      delay(_dot_len_ms * 2);
-    }
+  start(message);
+  while (poll()) {
+    // On attend simplement la fin du message.
   }
   delay(1000); // Petite pause à la fin de la transmission complète.
 }
 
-void EmetteurMorse::sendChar(char c) {
-  // On va chercher la traduction dans notre dictionnaire.
-  const char* code = MORSE_CODE[(int)c];
-  // On "joue" la séquence de points et de traits trouvée.
-  while (*code) {
-    if (*code == '.') dot();
-    else if (*code == '-') dash();
-    code++;
+bool EmetteurMorse::preparer(const char* message, uint16_t unitesMax) {
+  return _sequence.compiler(message, unitesMax);
+}
+
+const SequenceMorse& EmetteurMorse::getSequence() const { return _sequence; }
+
+void EmetteurMorse::start(const char* message) {
+  preparer(message);
+  start();
+}
+
+void EmetteurMorse::start() {
+  startAt(micros());
+}
+
+void EmetteurMorse::startAt(unsigned long debutMicros, ActionDepart action) {
+  _etape = 0;
+  _unites = 0;
+  _enCours = true;
+  // Toutes les échéances du message seront comptées depuis cet instant.
+  _debutMicros = debutMicros;
+  _actionDepart = action;
+  pttOff();
+
+  if (_manipulateur != nullptr) {
+    // Le timer sert aussi aux émissions à déplacement de fréquence : on lui redonne le
+    // rythme du Morse, puis on remplit la file avant de le lancer.
+    _manipulateur->setDureeUnite(6, 5UL * _wpm);
+    _manipulateur->vider();
+    alimenterTimer();
+    _departEnAttente = true;
+    demarrerTimerSiProche();
+    return;
   }
-}
\ No newline at end of file
+
+  poll();
+}
+
+void EmetteurMorse::demarrerTimerSiProche() {
+  long reste = (long)(_debutMicros - micros());
+  if (reste > (long)ManipulateurTimer::DELAI_MAX_US) return; // Trop tôt : on réessaiera au prochain poll().
+  _manipulateur->demarrer(reste > 0 ? (unsigned long)reste : 0, _actionDepart);
+  _actionDepart = nullptr;
+  _departEnAttente = false;
+}
+
+bool EmetteurMorse::isBusy() const { return _enCours; }
+
+void EmetteurMorse::alimenterTimer() {
+  while (_etape < _sequence.getNombreEtapes() && _manipulateur->ajouterEtape(_sequence.getEtape(_etape))) {
+    _etape++;
+  }
+  if (_etape >= _sequence.getNombreEtapes()) {
+    _manipulateur->terminer();
+  }
+}
+
+bool EmetteurMorse::poll() {
+  if (!_enCours) return false;
+
+  if (_manipulateur != nullptr) {
+    if (_departEnAttente) {
+      demarrerTimerSiProche();
+      if (_departEnAttente) return true;
+    }
+    // C'est le timer qui manipule : on ne fait que compléter sa file.
+    alimenterTimer();
+    _enCours = _manipulateur->estActif();
+    return _enCours;
+  }
+
+  // On traite toutes les échéances atteintes. Si loop() a pris du retard, on rattrape
+  // sans décaler la suite du message, qui reste calée sur l'instant de départ.
+  while ((long)(micros() - (_debutMicros + unitesEnMicros(_unites))) >= 0) {
+    if (_etape >= _sequence.getNombreEtapes()) {
+      pttOff();
+      _enCours = false;
+      return false;
+    }
+    if (_actionDepart != nullptr) {
+      // C'est l'heure du départ : l'action prévue passe juste avant le premier élément.
+      _actionDepart();
+      _actionDepart = nullptr;
+    }
+    // L'étape dit directement s'il faut un son ou un silence, et pendant combien d'unités.
+    uint8_t etape = _sequence.getEtape(_etape++);
+    if (SequenceMorse::estSon(etape)) pttOn();
+    else pttOff();
+    _unites += SequenceMorse::getDuree(etape);
+  }
+  return true;
+}
@@ -2,6 +2,8 @@
 #define EMETTEUR_MORSE_H
 
 #include <Arduino.h>
+#include "SequenceMorse.h"
+#include "ManipulateurTimer.h"
 
 /**
  * @class EmetteurMorse
@@ -9,6 +11,21 @@
  * @details Cette classe sait comment convertir du texte en signaux Morse. Elle connaît
  * l'alphabet, gère le rythme des points et des traits, et commande physiquement
  * l'émetteur (via le PTT) et la LED d'émission.
+ *
+ * Deux façons de travailler sont possibles :
+ * - `sendMessage()` envoie tout le message d'un coup et ne rend la main qu'à la fin ;
+ * - `start()` puis `poll()` : le télégraphiste avance d'un élément à chaque fois qu'on
+ *   le sollicite et que son échéance est atteinte, ce qui laisse `loop()` libre de
+ *   s'occuper du GPS et de l'écran pendant l'émission.
+ *
+ * Chaque échéance est calculée depuis l'instant de début du message (et non depuis
+ * l'élément précédent) : un retard ponctuel de `loop()` ne se cumule donc jamais.
+ *
+ * Le message est d'abord traduit en SequenceMorse par `preparer()`, ce qui donne sa
+ * durée exacte avant d'émettre ; l'émission ne fait ensuite que rejouer cette séquence.
+ *
+ * En option, la manipulation peut être confiée à un ManipulateurTimer : `poll()` se
+ * contente alors d'alimenter sa file, et les fronts ne dépendent plus du tout de `loop()`.
  */
 class EmetteurMorse {
 public:
@@ -20,28 +37,88 @@ public:
    */
   EmetteurMorse(int pttPin, int txLedPin, int wpm);
 
+  /**
+   * @brief Confie la manipulation à un timer matériel plutôt qu'à `loop()`.
+   * @param manipulateur Le manipulateur à utiliser.
+   * @return `false` si le timer n'est pas disponible : la manipulation reste alors dans `poll()`.
+   */
+  bool utiliserTimer(ManipulateurTimer& manipulateur);
+
   /**
    * @brief Prend un message et le transmet en Morse du début à la fin.
+   * @details Fonction bloquante : elle ne rend la main qu'une fois le message terminé.
    * @param message Le texte à envoyer.
    */
   void sendMessage(const char* message);
 
+  /**
+   * @brief Traduit un message en séquence Morse, sans encore l'émettre.
+   * @details Permet de connaître la durée exacte de l'émission (voir `getSequence()`)
+   * avant de la lancer avec `start()`.
+   * @param message Le texte à envoyer.
+   * @param unitesMax La durée d'antenne à ne pas dépasser, en unités Morse. Au-delà,
+   * le message est tronqué au dernier caractère complet.
+   * @return `true` si le message tient en entier, `false` s'il a été tronqué.
+   */
+  bool preparer(const char* message, uint16_t unitesMax = 0xFFFF);
+
+  /**
+   * @brief Donne accès à la séquence préparée (durée, troncature...).
+   */
+  const SequenceMorse& getSequence() const;
+
+  /**
+   * @brief Commence l'émission de la séquence préparée sans bloquer le programme.
+   * @details Il faut ensuite appeler `poll()` le plus souvent possible jusqu'à la fin.
+   */
+  void start();
+
+  /**
+   * @brief Programme l'émission de la séquence préparée pour un instant précis.
+   * @details Le PTT reste relâché jusqu'à l'instant demandé, qui peut être dans le
+   * futur (par exemple le début de la minute suivante). Il faut appeler `poll()` le
+   * plus souvent possible dès maintenant : avec le timer, le départ est ensuite confié
+   * au matériel et tombe à quelques microsecondes près.
+   * @param debutMicros L'instant (au sens de `micros()`) du premier élément.
+   * @param action Une action à faire à cet instant précis, juste avant le premier
+   * élément (par exemple valider la fréquence préchargée dans le DDS), ou `nullptr`.
+   */
+  void startAt(unsigned long debutMicros, ActionDepart action = nullptr);
+
+  /**
+   * @brief Prépare puis commence l'émission d'un message sans bloquer le programme.
+   * @details Le message est traduit immédiatement : l'appelant n'a pas besoin de le conserver.
+   * @param message Le texte à envoyer.
+   */
+  void start(const char* message);
+
+  /**
+   * @brief Fait avancer l'émission en cours si l'échéance du prochain élément est atteinte.
+   * @return `true` tant que le message n'est pas terminé, `false` ensuite.
+   */
+  bool poll();
+
+  /**
+   * @brief Permet de savoir si un message est en cours d'émission.
+   */
+  bool isBusy() const;
+
 private:
   /**
-   * @brief Interne : traduit et envoie un seul caractère.
-   * @param c La lettre ou le chiffre à envoyer.
+   * @brief Interne : convertit un nombre d'unités Morse en microsecondes, sans arrondi cumulé.
+   * @param unites Le nombre d'unités (durées de "point") écoulées depuis le début du message.
    */
-  void sendChar(char c);
+  unsigned long unitesEnMicros(unsigned long unites) const;
 
   /**
-   * @brief Génère le son court ("point") du Morse.
+   * @brief Interne : ajoute à la file du manipulateur toutes les étapes qui y tiennent.
    */
-  void dot();
+  void alimenterTimer();
 
   /**
-   * @brief Génère le son long ("trait") du Morse.
+   * @brief Interne : lance le timer si l'instant de départ est assez proche pour qu'il puisse l'attendre lui-même.
    */
-  void dash();
+  void demarrerTimerSiProche();
 
   /**
    * @brief Appuie sur le bouton du PTT et allume la LED d'émission.
@@ -52,10 +129,19 @@ private:
    * @brief Relâche le bouton du PTT et éteint la LED d'émission.
    */
   void pttOff();
-  
+
   int _pttPin;        ///< Mémorise la broche du PTT.
   int _txLedPin;      ///< Mémorise la broche de la LED d'émission.
-  int _dot_len_ms;    ///< Calcule et mémorise la durée d'un "point" en millisecondes, qui définit tout le rythme.
+  int _wpm;           ///< Le rythme en mots par minute, qui définit la durée d'un "point" (1200 / wpm ms).
+
+  SequenceMorse _sequence;     ///< Le message traduit, prêt à être rejoué.
+  uint16_t _etape;             ///< Prochaine étape de la séquence à jouer.
+  bool _enCours;               ///< `true` tant qu'un message est en cours d'émission.
+  unsigned long _debutMicros;  ///< Instant (micros()) du début du message, origine de toutes les échéances.
+  unsigned long _unites;       ///< Nombre d'unités écoulées à la fin de l'élément en cours.
+  ManipulateurTimer* _manipulateur; ///< Le timer qui manipule à notre place, ou `nullptr`.
+  bool _departEnAttente;       ///< `true` tant que le timer n'a pas encore été lancé.
+  ActionDepart _actionDepart;  ///< L'action à faire juste avant le premier élément, ou `nullptr`.
 };
 
 #endif
\ No newline at end of file
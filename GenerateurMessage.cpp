@@ -0,0 +1,78 @@
+/**
+ * @file GenerateurMessage.cpp
+ * @brief Implémentation de la classe GenerateurMessage.
+ * @details Contient le remplacement des jetons d'un modèle de message, écrit
+ * directement dans le tableau de l'appelant.
+ */
+#include "GenerateurMessage.h"
+#include <string.h>
+
+/// Tous les jetons font la même longueur : "#" + 4 caractères + "#".
+static const uint8_t LONGUEUR_JETON = 6;
+/// Place suffisante pour la plus longue valeur d'un jeton (locator étendu ou numéro), zéro final compris.
+static const uint8_t TAILLE_VALEUR_MAX = 9;
+
+GenerateurMessage::GenerateurMessage()
+  : _locator(""), _locatorEtendu(""), _heure(0), _minute(0), _numeroSequence(0) {}
+
+void GenerateurMessage::setLocator(const char* locator) { _locator = locator; }
+void GenerateurMessage::setLocatorEtendu(const char* locator) { _locatorEtendu = locator; }
+void GenerateurMessage::setNumeroSequence(uint16_t numero) { _numeroSequence = numero; }
+
+void GenerateurMessage::setHeure(uint8_t heure, uint8_t minute) {
+  _heure = heure;
+  _minute = minute;
+}
+
+StatutMessage GenerateurMessage::generer(const char* modele, char* sortie, size_t taille) const {
+  if (taille == 0) return MESSAGE_DEBORDEMENT;
+  size_t longueur = 0;
+  char valeur[TAILLE_VALEUR_MAX];
+
+  while (*modele) {
+    const char* morceau = modele;
+    size_t longueurMorceau = 1;
+    uint8_t longueurJeton = (*modele == '#') ? remplacerJeton(modele, valeur) : 0;
+    if (longueurJeton > 0) {
+      morceau = valeur;
+      longueurMorceau = strlen(valeur);
+      modele += longueurJeton;
+    } else {
+      modele++;
+    }
+
+    // On garde toujours une case pour le zéro final.
+    if (longueur + longueurMorceau >= taille) {
+      sortie[0] = '\0';
+      return MESSAGE_DEBORDEMENT;
+    }
+    memcpy(sortie + longueur, morceau, longueurMorceau);
+    longueur += longueurMorceau;
+  }
+
+  sortie[longueur] = '\0';
+  return MESSAGE_OK;
+}
+
+uint8_t GenerateurMessage::remplacerJeton(const char* texte, char* valeur) const {
+  // strncmp s'arrête au zéro final : un modèle qui se termine au milieu d'un jeton ne pose pas de problème.
+  if (strncmp(texte, "#LOCA#", LONGUEUR_JETON) == 0) {
+    strncpy(valeur, _locator, TAILLE_VALEUR_MAX - 1);
+  } else if (strncmp(texte, "#LOC8#", LONGUEUR_JETON) == 0) {
+    strncpy(valeur, _locatorEtendu, TAILLE_VALEUR_MAX - 1);
+  } else if (strncmp(texte, "#HHMM#", LONGUEUR_JETON) == 0) {
+    valeur[0] = '0' + _heure / 10;
+    valeur[1] = '0' + _heure % 10;
+    valeur[2] = '0' + _minute / 10;
+    valeur[3] = '0' + _minute % 10;
+    valeur[4] = '\0';
+    return LONGUEUR_JETON;
+  } else if (strncmp(texte, "#NSEQ#", LONGUEUR_JETON) == 0) {
+    utoa(_numeroSequence, valeur, 10);
+    return LONGUEUR_JETON;
+  } else {
+    return 0;
+  }
+  valeur[TAILLE_VALEUR_MAX - 1] = '\0';
+  return LONGUEUR_JETON;
+}
@@ -0,0 +1,152 @@
+#ifndef GENERATEUR_MESSAGE_H
+#define GENERATEUR_MESSAGE_H
+
+#include <Arduino.h>
+#include "SequenceMorse.h"
+
+/**
+ * @enum StatutMessage
+ * @brief Le résultat de la fabrication d'un message.
+ */
+enum StatutMessage {
+  MESSAGE_OK,          ///< Le message complet a été écrit.
+  MESSAGE_DEBORDEMENT, ///< Le message ne tenait pas dans la place prévue : rien n'a été écrit.
+};
+
+/**
+ * @class GenerateurMessage
+ * @brief Le "secrétaire" qui remplit les trous du message de chaque balise.
+ * @details Les messages des balises sont des modèles dans lesquels certains mots,
+ * appelés jetons, sont remplacés au moment d'émettre :
+ * - `#LOCA#` : le locator sur 6 caractères (ex: "JN18NT") ;
+ * - `#LOC8#` : le locator étendu sur 8 caractères (ex: "JN18NT47") ;
+ * - `#HHMM#` : l'heure UTC sur 4 chiffres (ex: "1437") ;
+ * - `#NSEQ#` : le numéro de l'émission, qui augmente à chaque message.
+ *
+ * Le message est écrit directement dans un tableau fourni par l'appelant : aucune
+ * mémoire n'est réservée sur le tas, ce qui évite de morceler la petite SRAM de
+ * l'Arduino au fil des jours de fonctionnement. Si le résultat ne tient pas dans le
+ * tableau, on n'écrit rien plutôt qu'un message coupé n'importe où.
+ *
+ * Un `#` qui ne commence pas un jeton connu est recopié tel quel.
+ *
+ * Le compilateur sait aussi mesurer un modèle dans le pire des cas, chaque jeton
+ * remplacé par sa valeur la plus longue (`longueurMax()`, `unitesMorseMax()`...) :
+ * un message qui ne tient pas dans son créneau est ainsi refusé dès la compilation.
+ */
+class GenerateurMessage {
+public:
+  GenerateurMessage();
+
+  /**
+   * @brief Donne le locator à utiliser pour `#LOCA#`.
+   * @param locator Le texte du locator ; il doit rester valide jusqu'à `generer()`.
+   */
+  void setLocator(const char* locator);
+
+  /**
+   * @brief Donne le locator étendu à utiliser pour `#LOC8#`.
+   * @param locator Le texte du locator ; il doit rester valide jusqu'à `generer()`.
+   */
+  void setLocatorEtendu(const char* locator);
+
+  /**
+   * @brief Donne l'heure UTC à utiliser pour `#HHMM#`.
+   * @param heure L'heure (0-23).
+   * @param minute Les minutes (0-59).
+   */
+  void setHeure(uint8_t heure, uint8_t minute);
+
+  /**
+   * @brief Donne le numéro d'émission à utiliser pour `#NSEQ#`.
+   */
+  void setNumeroSequence(uint16_t numero);
+
+  /**
+   * @brief Fabrique le message final à partir d'un modèle.
+   * @param modele Le message de la balise, avec ses jetons.
+   * @param sortie Le tableau où écrire le message final.
+   * @param taille La taille du tableau, zéro final compris.
+   * @return `MESSAGE_OK`, ou `MESSAGE_DEBORDEMENT` si le message ne tient pas : `sortie`
+   * contient alors une chaîne vide.
+   */
+  StatutMessage generer(const char* modele, char* sortie, size_t taille) const;
+
+  /**
+   * @brief Donne la plus grande longueur du message final, zéro final non compris.
+   */
+  static constexpr uint16_t longueurMax(const char* modele) { return mesurer(modele, MESURE_CARACTERES); }
+
+  /**
+   * @brief Donne le plus long temps d'antenne du message final, en unités Morse.
+   * @details Un majorant : chaque lettre d'un signe de procédure ("<SK>") est comptée
+   * avec l'espace d'une lettre ordinaire.
+   */
+  static constexpr uint16_t unitesMorseMax(const char* modele) {
+    // Le silence qui suit la dernière lettre ne fait pas partie de l'émission.
+    return plusGrand(mesurer(modele, MESURE_UNITES_MORSE), 3) - 3;
+  }
+
+  /**
+   * @brief Donne le plus grand nombre de points et de traits du message final.
+   */
+  static constexpr uint16_t elementsMorseMax(const char* modele) { return mesurer(modele, MESURE_ELEMENTS_MORSE); }
+
+private:
+  /// Ce que compte `mesurer()`.
+  enum Mesure { MESURE_CARACTERES, MESURE_UNITES_MORSE, MESURE_ELEMENTS_MORSE };
+
+  /// Interne : la mesure d'un caractère.
+  static constexpr uint16_t mesurerCaractere(char c, Mesure mesure) {
+    return mesure == MESURE_CARACTERES ? 1
+         : mesure == MESURE_UNITES_MORSE ? SequenceMorse::unitesCaractere(c)
+         : SequenceMorse::elementsCaractere(c);
+  }
+
+  /// Interne : le plus grand de deux entiers.
+  static constexpr uint16_t plusGrand(uint16_t a, uint16_t b) { return a > b ? a : b; }
+
+  /// Interne : la plus grande mesure d'un caractère compris entre `premier` et `dernier`.
+  static constexpr uint16_t mesurerPlage(char premier, char dernier, Mesure mesure) {
+    return premier >= dernier ? mesurerCaractere(premier, mesure)
+         : plusGrand(mesurerCaractere(premier, mesure), mesurerPlage(premier + 1, dernier, mesure));
+  }
+
+  /// Interne : la plus grande mesure des caractères `rang` et suivants d'un locator de `longueur` caractères.
+  static constexpr uint16_t mesurerLocator(uint8_t rang, uint8_t longueur, Mesure mesure) {
+    // Deux lettres de A à R, deux chiffres, deux lettres de A à X, deux chiffres.
+    return rang >= longueur ? 0
+         : mesurerPlage(rang == 2 || rang == 3 || rang >= 6 ? '0' : 'A', rang < 2 ? 'R' : rang >= 4 && rang < 6 ? 'X' : '9', mesure) +
+           mesurerLocator(rang + 1, longueur, mesure);
+  }
+
+  /// Interne : `true` si `texte` commence par `jeton`.
+  static constexpr bool commencePar(const char* texte, const char* jeton) {
+    return *jeton == '\0' || (*texte == *jeton && commencePar(texte + 1, jeton + 1));
+  }
+
+  /// Interne : la mesure d'un modèle, chaque jeton remplacé par sa plus longue valeur.
+  static constexpr uint16_t mesurer(const char* modele, Mesure mesure) {
+    return *modele == '\0' ? 0
+         : commencePar(modele, "#LOCA#") ? mesurerLocator(0, 6, mesure) + mesurer(modele + 6, mesure)
+         : commencePar(modele, "#LOC8#") ? mesurerLocator(0, 8, mesure) + mesurer(modele + 6, mesure)
+         : commencePar(modele, "#HHMM#") ? mesurerPlage('0', '2', mesure) + mesurerPlage('0', '9', mesure) +
+                                           mesurerPlage('0', '5', mesure) + mesurerPlage('0', '9', mesure) + mesurer(modele + 6, mesure)
+         : commencePar(modele, "#NSEQ#") ? 5 * mesurerPlage('0', '9', mesure) + mesurer(modele + 6, mesure)
+         : mesurerCaractere(*modele, mesure) + mesurer(modele + 1, mesure);
+  }
+
+  /**
+   * @brief Interne : écrit dans `valeur` le texte qui remplace le jeton en début de `texte`.
+   * @return La longueur du jeton reconnu, ou 0 si `texte` ne commence pas par un jeton.
+   */
+  uint8_t remplacerJeton(const char* texte, char* valeur) const;
+
+  const char* _locator;        ///< Le locator sur 6 caractères.
+  const char* _locatorEtendu;  ///< Le locator sur 8 caractères.
+  uint8_t _heure;              ///< L'heure UTC.
+  uint8_t _minute;             ///< Les minutes UTC.
+  uint16_t _numeroSequence;    ///< Le numéro de l'émission.
+};
+
+#endif
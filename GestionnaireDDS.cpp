@@ -1,9 +1,17 @@
 #include "GestionnaireDDS.h"
+#include <SPI.h>
+#include <util/atomic.h>
 
-GestionnaireDDS::GestionnaireDDS(int w_clk, int fq_ud, int data, int reset) :
-  _pin_w_clk(w_clk), _pin_fq_ud(fq_ud), _pin_data(data), _pin_reset(reset) {}
+/// Réglages du SPI pour l'AD9850 : bits de poids faible en premier, donnée lue sur le front montant de W_CLK.
+static const SPISettings REGLAGES_SPI_DDS(8000000, LSBFIRST, SPI_MODE0);
 
-void GestionnaireDDS::begin() {
+GestionnaireDDS::GestionnaireDDS(int w_clk, int fq_ud, int data, int reset, PuceDDS puce, uint32_t referenceHz) :
+  _pin_w_clk(w_clk), _pin_fq_ud(fq_ud), _pin_data(data), _pin_reset(reset),
+  _puce(puce), _horlogeNominale(horlogeNominale(puce, referenceHz)), _dds_clock(_horlogeNominale), _correction_ppb(0), _nombreChargements(0),
+  _transport(TRANSPORT_DIGITALWRITE), _port_w_clk(nullptr), _port_fq_ud(nullptr), _port_data(nullptr),
+  _masque_w_clk(0), _masque_fq_ud(0), _masque_data(0) {}
+
+void GestionnaireDDS::begin(TransportDDS transport) {
   pinMode(_pin_w_clk, OUTPUT);
   pinMode(_pin_fq_ud, OUTPUT);
   pinMode(_pin_data, OUTPUT);
@@ -12,23 +20,177 @@ void GestionnaireDDS::begin() {
   digitalWrite(_pin_fq_ud, LOW);
   digitalWrite(_pin_reset, HIGH);
   digitalWrite(_pin_reset, LOW);
+
+  // On retrouve une fois pour toutes le registre et le bit de chaque broche : plus
+  // besoin ensuite de consulter les tables de correspondance à chaque écriture.
+  _port_w_clk = portOutputRegister(digitalPinToPort(_pin_w_clk));
+  _port_fq_ud = portOutputRegister(digitalPinToPort(_pin_fq_ud));
+  _port_data = portOutputRegister(digitalPinToPort(_pin_data));
+  _masque_w_clk = digitalPinToBitMask(_pin_w_clk);
+  _masque_fq_ud = digitalPinToBitMask(_pin_fq_ud);
+  _masque_data = digitalPinToBitMask(_pin_data);
+
+  setTransport(transport);
 }
 
+bool GestionnaireDDS::spiPossible() const {
+  return _pin_data == MOSI && _pin_w_clk == SCK;
+}
+
+bool GestionnaireDDS::setTransport(TransportDDS transport) {
+  bool obtenu = true;
+  if (transport == TRANSPORT_SPI && !spiPossible()) {
+    transport = TRANSPORT_PORTS;
+    obtenu = false;
+  }
+  // On rend ou on prend la main sur les broches du SPI matériel selon le besoin.
+  if (_transport == TRANSPORT_SPI && transport != TRANSPORT_SPI) {
+    SPI.end();
+    pinMode(_pin_w_clk, OUTPUT);
+    pinMode(_pin_data, OUTPUT);
+    digitalWrite(_pin_w_clk, LOW);
+  } else if (_transport != TRANSPORT_SPI && transport == TRANSPORT_SPI) {
+    SPI.begin();
+  }
+  _transport = transport;
+  return obtenu;
+}
+
+TransportDDS GestionnaireDDS::getTransport() const { return _transport; }
+
 void GestionnaireDDS::setFrequency(unsigned long frequency) {
-  uint32_t freq_word = (uint32_t)((double)frequency * (double)(1ULL << 32) / _dds_clock);
-  sendCommand((uint64_t)freq_word);
+  chargerMotAccord(calculerMotAccord(frequency));
+}
+
+uint32_t GestionnaireDDS::calculerMotAccord(unsigned long frequency) const {
+  return calculerMotAccord(frequency, _dds_clock);
+}
+
+uint32_t GestionnaireDDS::calculerMotAccordPrecis(uint64_t frequence256) const {
+  return calculerMotAccordPrecis(frequence256, _dds_clock);
+}
+
+uint32_t GestionnaireDDS::calculerMotAccordPrecis(uint64_t frequence256, uint32_t horlogeHz) {
+  // mot = (f / 256) × 2^32 / horloge = f × 2^24 / horloge. Avec f < 2^40 (moins de la
+  // moitié de l'horloge, en 1/256 de hertz), le numérateur tient encore sur 64 bits.
+  return (uint32_t)(((frequence256 << 24) + horlogeHz / 2) / horlogeHz);
+}
+
+void GestionnaireDDS::chargerMotAccord(uint32_t mot) {
+  prechargerMotAccord(mot);
+  validerFrequence();
+}
+
+void GestionnaireDDS::prechargerMotAccord(uint32_t mot) {
+  sendCommand(ordre(mot, _puce));
+}
+
+void GestionnaireDDS::validerFrequence() {
   pulseFqUd();
 }
 
+bool GestionnaireDDS::setCorrectionPpb(long ppb) {
+  if (!correctionValide(ppb)) return false;
+  _correction_ppb = ppb;
+  _dds_clock = horlogeCorrigee(_horlogeNominale, ppb);
+  return true;
+}
+
+uint32_t GestionnaireDDS::horlogeCorrigee(uint32_t horlogeNominale, long ppb) {
+  // Horloge × ppb / 10^9 (ppb / 8 à 125 MHz) : on arrondit au hertz le plus proche.
+  // La PLL de l'AD9851 multiplie l'écart de la référence avec elle.
+  int64_t ecart = ((int64_t)horlogeNominale * ppb + (ppb >= 0 ? 500000000LL : -500000000LL)) / 1000000000LL;
+  return (uint32_t)((int64_t)horlogeNominale + ecart);
+}
+
+PuceDDS GestionnaireDDS::getPuce() const { return _puce; }
+long GestionnaireDDS::getCorrectionPpb() const { return _correction_ppb; }
+uint32_t GestionnaireDDS::getHorlogeHz() const { return _dds_clock; }
+unsigned long GestionnaireDDS::getNombreChargements() const { return _nombreChargements; }
+
 void GestionnaireDDS::pulseFqUd() {
-  digitalWrite(_pin_fq_ud, HIGH);
-  digitalWrite(_pin_fq_ud, LOW);
+  if (_transport == TRANSPORT_DIGITALWRITE) {
+    digitalWrite(_pin_fq_ud, HIGH);
+    digitalWrite(_pin_fq_ud, LOW);
+    return;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *_port_fq_ud |= _masque_fq_ud;
+    *_port_fq_ud &= ~_masque_fq_ud;
+  }
 }
 
 void GestionnaireDDS::sendCommand(uint64_t w) {
-  for (int i = 0; i < 40; i++, w >>= 1) {
-    digitalWrite(_pin_data, w & 1);
-    digitalWrite(_pin_w_clk, HIGH);
-    digitalWrite(_pin_w_clk, LOW);
+  _nombreChargements++;
+  switch (_transport) {
+    case TRANSPORT_DIGITALWRITE:
+      for (int i = 0; i < 40; i++, w >>= 1) {
+        digitalWrite(_pin_data, w & 1);
+        digitalWrite(_pin_w_clk, HIGH);
+        digitalWrite(_pin_w_clk, LOW);
+      }
+      break;
+
+    case TRANSPORT_PORTS:
+      for (int i = 0; i < 40; i++, w >>= 1) {
+        // Le port peut être partagé avec des broches commandées sous interruption
+        // (PTT, LED...) : chaque lecture-modification-écriture est protégée, mais
+        // brièvement, pour ne pas retarder ces interruptions.
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+          if (w & 1) *_port_data |= _masque_data;
+          else *_port_data &= ~_masque_data;
+          *_port_w_clk |= _masque_w_clk;
+          *_port_w_clk &= ~_masque_w_clk;
+        }
+      }
+      break;
+
+    case TRANSPORT_SPI:
+      // 5 octets, le poids faible en premier : le même ordre que bit à bit.
+      SPI.beginTransaction(REGLAGES_SPI_DDS);
+      for (int i = 0; i < 5; i++, w >>= 8) {
+        SPI.transfer((uint8_t)(w & 0xFF));
+      }
+      SPI.endTransaction();
+      break;
+  }
+}
+
+void GestionnaireDDS::mesurerTransports(Print& sortie, LiaisonDDS* pilote) {
+  static const uint8_t REPETITIONS = 50;
+  static const char* const NOMS[] = { "digitalWrite", "ports", "SPI" };
+  TransportDDS transportInitial = _transport;
+  unsigned long chargementsInitiaux = _nombreChargements; // Les essais ne sont pas des émissions.
+  const uint64_t ordre10MHz = ordre(calculerMotAccord(10000000UL), _puce); // Sans importance ici.
+
+  for (uint8_t t = TRANSPORT_DIGITALWRITE; t <= TRANSPORT_SPI; t++) {
+    if (!setTransport((TransportDDS)t)) continue; // SPI impossible avec ce câblage.
+    unsigned long debut = micros();
+    for (uint8_t i = 0; i < REPETITIONS; i++) {
+      sendCommand(ordre10MHz);
+      pulseFqUd();
+    }
+    afficherMesure(sortie, NOMS[t], micros() - debut, REPETITIONS);
   }
-}
\ No newline at end of file
+  setTransport(transportInitial);
+  _nombreChargements = chargementsInitiaux;
+
+  // Le même mot, par l'autre pilote : ses broches sont les nôtres, et son octet de contrôle le même.
+  if (pilote != nullptr) {
+    unsigned long debut = micros();
+    for (uint8_t i = 0; i < REPETITIONS; i++) pilote->chargerMotAccord((uint32_t)ordre10MHz);
+    afficherMesure(sortie, "pilote", micros() - debut, REPETITIONS);
+  }
+}
+
+void GestionnaireDDS::afficherMesure(Print& sortie, const char* nom, unsigned long dureeUs, uint8_t repetitions) {
+  // Durée moyenne d'un chargement, en dixièmes de microseconde.
+  unsigned long dixiemes = (dureeUs * 10UL) / repetitions;
+  sortie.print(F("DDS, chargement par "));
+  sortie.print(nom);
+  sortie.print(F(" : "));
+  sortie.print(dixiemes / 10);
+  sortie.print('.');
+  sortie.print(dixiemes % 10);
+  sortie.println(F(" us"));
+}
@@ -2,39 +2,249 @@
 #define GESTIONNAIRE_DDS_H
 
 #include <Arduino.h>
+#include "LiaisonDDS.h"
+
+/**
+ * @enum TransportDDS
+ * @brief Les différentes façons d'envoyer les 40 bits d'un ordre au DDS.
+ */
+enum TransportDDS {
+  TRANSPORT_DIGITALWRITE, ///< Avec `digitalWrite()` : simple mais lent (environ 3 appels par bit).
+  TRANSPORT_PORTS,        ///< En écrivant directement dans les registres des ports : quelques cycles par bit.
+  TRANSPORT_SPI,          ///< Avec le SPI matériel : possible si DATA est sur MOSI et W_CLK sur SCK.
+};
+
+/**
+ * @enum PuceDDS
+ * @brief Les modèles de DDS que le pilote sait commander.
+ */
+enum PuceDDS {
+  PUCE_AD9850, ///< L'horloge de référence est utilisée telle quelle (125 MHz au plus).
+  PUCE_AD9851, ///< L'horloge de référence est multipliée par 6 par la PLL interne (30 MHz × 6 = 180 MHz).
+};
 
 /**
  * @class GestionnaireDDS
- * @brief Le pilote du composant qui génère le signal radio (DDS AD9850).
- * @details Cette classe est une "télécommande" pour le module AD9850. Elle simplifie
+ * @brief Le pilote du composant qui génère le signal radio (DDS AD9850 ou AD9851).
+ * @details Cette classe est une "télécommande" pour le module DDS. Elle simplifie
  * son utilisation en cachant les détails techniques complexes. On peut simplement
  * lui demander de générer une fréquence, et elle se charge d'envoyer les bons
  * ordres au composant.
+ *
+ * Les broches, la puce et son horloge sont donnés à la construction : c'est la version
+ * souple, pour un câblage choisi pendant le fonctionnement, qui sait aussi changer de
+ * transport (voir `setTransport()`). Le programme de la balise, dont le câblage est
+ * connu à la compilation, utilise PiloteDDS (voir PiloteDDS.h) : les calculs d'horloge
+ * et de mots d'accord sont ceux d'ici, fournis par les fonctions statiques, et les deux
+ * pilotes se remplacent l'un l'autre derrière LiaisonDDS.
  */
-class GestionnaireDDS {
+class GestionnaireDDS : public LiaisonDDS {
 public:
+  static const uint32_t HORLOGE_NOMINALE_HZ = 125000000UL; ///< La vitesse nominale de l'horloge d'un module AD9850, la plus courante.
+  static const long CORRECTION_MAX_PPB = 1000000L; ///< La plus forte correction d'horloge acceptée (1000 ppm), dans un sens ou dans l'autre.
+
   /**
    * @brief Construit la "télécommande" pour le DDS.
    * @param w_clk Broche pour l'horloge de chargement des mots.
    * @param fq_ud Broche pour la mise à jour de la fréquence.
    * @param data Broche pour l'envoi des données.
    * @param reset Broche pour réinitialiser le composant.
+   * @param puce Le modèle de DDS.
+   * @param referenceHz La fréquence nominale de l'oscillateur de référence du module.
+   */
+  GestionnaireDDS(int w_clk, int fq_ud, int data, int reset, PuceDDS puce = PUCE_AD9850, uint32_t referenceHz = HORLOGE_NOMINALE_HZ);
+
+  /**
+   * @brief Donne le coefficient de la PLL interne d'une puce : 6 pour l'AD9851, 1 pour l'AD9850.
+   */
+  static constexpr uint8_t multiplicateur(PuceDDS puce) { return puce == PUCE_AD9851 ? 6 : 1; }
+
+  /**
+   * @brief Donne la vitesse nominale de l'horloge de travail d'une puce, PLL comprise.
+   * @param puce Le modèle de DDS.
+   * @param referenceHz La fréquence de l'oscillateur de référence.
+   */
+  static constexpr uint32_t horlogeNominale(PuceDDS puce, uint32_t referenceHz) { return referenceHz * multiplicateur(puce); }
+
+  /**
+   * @brief Donne l'octet de contrôle d'une puce : les bits 32 à 39 de chaque ordre.
+   * @details Phase nulle et pas de mise en veille. Sur l'AD9851, le premier bit (W32)
+   * met en service la PLL ×6 ; sur l'AD9850, les deux premiers sont réservés aux essais
+   * du fabricant et doivent rester à 0.
+   */
+  static constexpr uint8_t octetControle(PuceDDS puce) { return puce == PUCE_AD9851 ? 0x01 : 0x00; }
+
+  /**
+   * @brief Donne l'ordre de 40 bits qui porte un mot d'accord : le mot, puis l'octet de contrôle.
    */
-  GestionnaireDDS(int w_clk, int fq_ud, int data, int reset);
+  static constexpr uint64_t ordre(uint32_t mot, PuceDDS puce) { return ((uint64_t)octetControle(puce) << 32) | mot; }
 
   /**
    * @brief Allume et prépare le module DDS.
    * @details Doit être appelée une fois au démarrage pour s'assurer que le DDS
-   * est prêt à recevoir des ordres.
+   * est prêt à recevoir des ordres. C'est aussi là que les registres et les bits de
+   * chaque broche sont retrouvés, une fois pour toutes.
+   * @param transport La façon d'envoyer les ordres (voir `setTransport()`).
+   */
+  void begin(TransportDDS transport = TRANSPORT_PORTS);
+
+  /**
+   * @brief Choisit la façon d'envoyer les ordres au DDS.
+   * @details Si le SPI matériel est demandé alors que les broches ne le permettent
+   * pas, on se rabat sur l'écriture directe dans les ports.
+   * @param transport Le transport souhaité.
+   * @return `true` si le transport demandé est bien celui utilisé.
+   */
+  bool setTransport(TransportDDS transport);
+
+  /**
+   * @brief Donne le transport actuellement utilisé.
+   */
+  TransportDDS getTransport() const;
+
+  /**
+   * @brief Permet de savoir si le SPI matériel est utilisable avec ce câblage.
    */
-  void begin();
+  bool spiPossible() const;
 
   /**
    * @brief Donne l'ordre au DDS de produire une fréquence précise.
+   * @details Équivaut à `chargerMotAccord(calculerMotAccord(frequency))`. Quand la
+   * fréquence est connue d'avance, mieux vaut garder son mot d'accord et ne faire
+   * que le charger.
    * @param frequency La fréquence à générer, en Hertz (ex: 14095600).
    */
   void setFrequency(unsigned long frequency);
 
+  /**
+   * @brief Calcule le "mot d'accord" du DDS pour une fréquence, sans rien lui envoyer.
+   * @details Le DDS produit `mot × horloge / 2^32` Hz. Le calcul se fait entièrement
+   * en entiers de 64 bits, arrondi au plus proche : aucune perte de précision,
+   * contrairement à un calcul en `double` (qui n'a que 24 bits de mantisse sur AVR).
+   * Il tient compte de la correction d'horloge en cours.
+   * @param frequency La fréquence souhaitée, en Hertz.
+   * @return Le mot d'accord sur 32 bits.
+   */
+  uint32_t calculerMotAccord(unsigned long frequency) const;
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence pour une horloge donnée.
+   * @details Le même calcul, mais utilisable par le compilateur : le plan de bandes
+   * connaît ainsi le mot de chaque balise (à l'horloge nominale) avant même le
+   * démarrage. Un mot de 2^31 ou plus désigne une fréquence que le DDS ne sait pas
+   * produire (plus de la moitié de son horloge).
+   * @param frequency La fréquence souhaitée, en Hertz.
+   * @param horlogeHz La fréquence de l'horloge du DDS, en Hertz.
+   */
+  static constexpr uint32_t calculerMotAccord(unsigned long frequency, uint32_t horlogeHz) {
+    // mot = f × 2^32 / horloge, arrondi au plus proche. Avec f < 2^32, le numérateur
+    // tient sans problème sur 64 bits.
+    return (uint32_t)((((uint64_t)frequency << 32) + horlogeHz / 2) / horlogeHz);
+  }
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence au 1/256 de hertz près, pour une horloge donnée.
+   * @details Le calcul de `calculerMotAccordPrecis()`, partagé avec PiloteDDS.
+   * @param frequence256 La fréquence souhaitée, en 1/256 de hertz.
+   * @param horlogeHz La fréquence de l'horloge du DDS, en Hertz.
+   */
+  static uint32_t calculerMotAccordPrecis(uint64_t frequence256, uint32_t horlogeHz);
+
+  /**
+   * @brief Permet de savoir si une correction d'horloge est acceptable.
+   * @details Au-delà de `CORRECTION_MAX_PPB`, l'horloge corrigée pourrait s'annuler ou
+   * déborder : les mots d'accord n'auraient plus de sens. Partagée avec PiloteDDS.
+   * @param ppb L'écart de l'horloge, en milliardièmes.
+   */
+  static constexpr bool correctionValide(long ppb) { return ppb >= -CORRECTION_MAX_PPB && ppb <= CORRECTION_MAX_PPB; }
+
+  /**
+   * @brief Applique une correction à la vitesse nominale d'une horloge.
+   * @details Le calcul de `setCorrectionPpb()`, partagé avec PiloteDDS. La correction
+   * doit être acceptable (voir `correctionValide()`).
+   * @param horlogeNominale La vitesse nominale de l'horloge de travail, en Hertz.
+   * @param ppb L'écart de l'horloge, en milliardièmes.
+   * @return La vitesse corrigée, arrondie au hertz le plus proche.
+   */
+  static uint32_t horlogeCorrigee(uint32_t horlogeNominale, long ppb);
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence donnée au 1/256 de hertz près.
+   * @details Pour les modes à déplacement de fréquence (WSPR, QRSS), dont les tons sont
+   * espacés de fractions de hertz : l'écart de 12000 / 8192 Hz des tons WSPR vaut
+   * exactement 375 / 256 Hz. Même calcul entier que `calculerMotAccord()`.
+   * @param frequence256 La fréquence souhaitée, en 1/256 de hertz.
+   * @return Le mot d'accord sur 32 bits.
+   */
+  uint32_t calculerMotAccordPrecis(uint64_t frequence256) const;
+
+  /**
+   * @brief Envoie un mot d'accord déjà calculé au DDS et le valide.
+   * @details Équivaut à `prechargerMotAccord(mot)` suivi de `validerFrequence()`.
+   * @param mot Le mot d'accord (voir `calculerMotAccord()`).
+   */
+  void chargerMotAccord(uint32_t mot);
+
+  /**
+   * @brief Envoie un mot d'accord au DDS sans le valider.
+   * @details L'AD9850 garde le mot dans un registre d'attente et continue à produire
+   * l'ancienne fréquence jusqu'à `validerFrequence()`. On peut ainsi faire le transfert,
+   * relativement long, bien à l'avance, et ne changer de fréquence qu'au bon moment.
+   * @param mot Le mot d'accord (voir `calculerMotAccord()`).
+   */
+  void prechargerMotAccord(uint32_t mot) override;
+
+  /**
+   * @brief Fait passer le DDS sur le mot préchargé.
+   * @details Une simple impulsion sur FQ_UD : quelques cycles avec les ports ou le SPI,
+   * ce qui permet de l'appeler depuis une interruption.
+   */
+  void validerFrequence() override;
+
+  /**
+   * @brief Donne le modèle de DDS commandé.
+   */
+  PuceDDS getPuce() const;
+
+  /**
+   * @brief Corrige l'écart de l'horloge de référence du DDS par rapport à sa valeur nominale.
+   * @details Le quartz de 125 MHz n'est jamais tout à fait à 125 MHz. Si la balise
+   * émet un peu trop haut, son horloge est trop rapide : il faut une correction
+   * positive. L'écart se mesure une fois par carte, par exemple en écoutant la
+   * balise sur un récepteur calé sur un signal de référence.
+   * Les mots d'accord déjà calculés doivent ensuite être recalculés.
+   * @param ppb L'écart de l'horloge, en milliardièmes (1000 ppb = 1 ppm).
+   * @return `false` si l'écart n'est pas acceptable (voir `correctionValide()`) : la correction en cours est alors gardée.
+   */
+  bool setCorrectionPpb(long ppb);
+
+  /**
+   * @brief Donne la correction d'horloge en cours, en milliardièmes.
+   */
+  long getCorrectionPpb() const;
+
+  /**
+   * @brief Donne la fréquence d'horloge du DDS utilisée pour les calculs, correction comprise.
+   */
+  uint32_t getHorlogeHz() const;
+
+  /**
+   * @brief Donne le nombre de mots envoyés au DDS depuis le démarrage (télémétrie).
+   */
+  unsigned long getNombreChargements() const;
+
+  /**
+   * @brief Mesure la durée d'un chargement de fréquence pour chaque transport disponible.
+   * @details Petit banc d'essai à lancer au démarrage, avant toute émission : il
+   * charge plusieurs fois un même mot et affiche la durée moyenne par chargement.
+   * Le transport choisi est rétabli à la fin, et ces chargements d'essai ne sont pas
+   * comptés dans `getNombreChargements()`.
+   * @param sortie Où afficher les résultats (par exemple `Serial`).
+   * @param pilote Un autre pilote branché sur les mêmes broches (PiloteDDS...), mesuré
+   * à la suite, ou `nullptr`.
+   */
+  void mesurerTransports(Print& sortie, LiaisonDDS* pilote = nullptr);
+
 private:
   /**
    * @brief Envoie un "mot de code" de 40 bits au DDS.
@@ -51,8 +261,25 @@ private:
    */
   void pulseFqUd();
 
+  /**
+   * @brief Interne : affiche la durée moyenne d'un chargement, mesurée par `mesurerTransports()`.
+   */
+  static void afficherMesure(Print& sortie, const char* nom, unsigned long dureeUs, uint8_t repetitions);
+
   int _pin_w_clk, _pin_fq_ud, _pin_data, _pin_reset; ///< Mémorise les broches de connexion.
-  const double _dds_clock = 125000000.0; ///< La vitesse de l'horloge interne du module DDS, nécessaire pour les calculs.
+  PuceDDS _puce;                  ///< Le modèle de DDS.
+  uint32_t _horlogeNominale;      ///< La vitesse nominale de l'horloge de travail (référence × PLL).
+  uint32_t _dds_clock;            ///< La vitesse de l'horloge du module DDS, corrigée, nécessaire pour les calculs.
+  long _correction_ppb;           ///< L'écart de l'horloge par rapport à sa valeur nominale, en milliardièmes.
+  unsigned long _nombreChargements; ///< Nombre de mots envoyés au DDS.
+
+  TransportDDS _transport;        ///< Le transport utilisé pour envoyer les ordres.
+  volatile uint8_t* _port_w_clk;  ///< Registre de sortie de la broche W_CLK.
+  volatile uint8_t* _port_fq_ud;  ///< Registre de sortie de la broche FQ_UD.
+  volatile uint8_t* _port_data;   ///< Registre de sortie de la broche DATA.
+  uint8_t _masque_w_clk;          ///< Bit de la broche W_CLK dans son registre.
+  uint8_t _masque_fq_ud;          ///< Bit de la broche FQ_UD dans son registre.
+  uint8_t _masque_data;           ///< Bit de la broche DATA dans son registre.
 };
 
 #endif
\ No newline at end of file
@@ -5,26 +5,56 @@
  * Il gère la logique concrète de lecture des données GPS et de conversion des coordonnées.
  */
 #include "GestionnaireGPS.h"
-#include <math.h>
+
+/// Nombre de plus petites cases du locator (10 caractères) par degré de longitude : 12 × 10 × 24.
+static const unsigned long CASES_PAR_DEGRE_LONGITUDE = 2880UL;
+/// Nombre de plus petites cases du locator par degré de latitude : 24 × 10 × 24.
+static const unsigned long CASES_PAR_DEGRE_LATITUDE = 5760UL;
+
+/// Une seconde, en microsecondes.
+static const unsigned long SECONDE_US = 1000000UL;
+/// Nombre de secondes dans une journée.
+static const unsigned long SECONDES_PAR_JOUR = 86400UL;
+/// Au-delà de ce temps sans nouvelle du GPS, l'horloge n'est plus considérée comme fiable.
+static const unsigned long AGE_MAX_REFERENCE_US = 10UL * SECONDE_US;
+
+/// Le gestionnaire que la routine d'interruption du PPS doit servir.
+static GestionnaireGPS* gpsActif = nullptr;
+
+/**
+ * @brief Routine d'interruption appelée à chaque front montant du PPS.
+ */
+static void interruptionPPS() {
+  gpsActif->frontPPS();
+}
 
 /**
  * @brief Construit l'objet et initialise la communication série avec le module GPS.
  */
-GestionnaireGPS::GestionnaireGPS(HardwareSerial& serialPort) : _gpsSerial(serialPort) {
+GestionnaireGPS::GestionnaireGPS(HardwareSerial& serialPort)
+  : _gpsSerial(serialPort), _caseLongitude(-1), _caseLatitude(-1), _attenteMax(0), _instantPPS(0), _nombrePPS(0),
+    _referenceValide(false), _secondeReference(0), _debutReference(0) {
   _gpsSerial.begin(9600);
   strcpy(_locator, "......"); // On met une valeur par défaut en attendant les vraies données.
+  strcpy(_locatorEtendu, "........");
+  strcpy(_locatorPrecis, "..........");
 }
 
 /**
  * @brief Boucle de lecture des données NMEA envoyées par le GPS.
  */
-void GestionnaireGPS::update() {
-  // Tant qu'il y a des données à lire...
-  while (_gpsSerial.available() > 0) {
-    // On les envoie à la bibliothèque TinyGPS++ qui les déchiffre.
-    if (_gps.encode(_gpsSerial.read())) {
+void GestionnaireGPS::update(uint16_t budgetOctets) {
+  // On note au passage le remplissage du tampon de réception (télémétrie).
+  int attente = _gpsSerial.available();
+  if (attente > _attenteMax) _attenteMax = attente > 255 ? 255 : attente;
+  // Tant qu'il y a des données à lire, et dans la limite du budget...
+  while (budgetOctets > 0 && _gpsSerial.available() > 0) {
+    budgetOctets--;
+    // On les envoie à notre lecteur de phrases NMEA qui les déchiffre.
+    if (_gps.encoder(_gpsSerial.read())) {
+      recalerHorloge(micros());
       // Si une nouvelle position a été reçue et qu'elle est valide...
-      if (_gps.location.isUpdated() && hasValidLocation()) {
+      if (_gps.positionMiseAJour() && hasValidLocation()) {
         // ... on recalcule le locator.
         calculateLocator();
       }
@@ -32,31 +62,157 @@ void GestionnaireGPS::update() {
   }
 }
 
+bool GestionnaireGPS::activerPPS(int brochePPS) {
+  int interruption = digitalPinToInterrupt(brochePPS);
+  if (interruption == NOT_AN_INTERRUPT) return false;
+  gpsActif = this;
+  pinMode(brochePPS, INPUT);
+  attachInterrupt(interruption, interruptionPPS, RISING);
+  return true;
+}
+
+void GestionnaireGPS::frontPPS() {
+  _instantPPS = micros();
+  _nombrePPS++;
+}
+
+bool GestionnaireGPS::ppsActif() const {
+  noInterrupts();
+  unsigned long instantPPS = _instantPPS;
+  uint16_t nombrePPS = _nombrePPS;
+  interrupts();
+  // Une impulsion par seconde : on tolère une demi-seconde de retard avant de la croire perdue.
+  return nombrePPS > 0 && micros() - instantPPS < SECONDE_US + SECONDE_US / 2;
+}
+
+void GestionnaireGPS::recalerHorloge(unsigned long instantArrivee) {
+  if (!_gps.heureValide()) return;
+  unsigned long seconde = _gps.getHeure() * 3600UL + _gps.getMinute() * 60UL + _gps.getSeconde();
+  // RMC et GGA annoncent la même seconde : seule la première compte.
+  if (_referenceValide && seconde == _secondeReference) return;
+
+  _secondeReference = seconde;
+  _debutReference = instantArrivee;
+  if (ppsActif()) {
+    // La phrase décrit la seconde ouverte par la dernière impulsion PPS.
+    noInterrupts();
+    unsigned long instantPPS = _instantPPS;
+    interrupts();
+    if (instantArrivee - instantPPS < SECONDE_US) _debutReference = instantPPS;
+  }
+  _referenceValide = true;
+}
+
+bool GestionnaireGPS::getHorloge(unsigned long& secondesDuJour, unsigned long& debutSecondeMicros) const {
+  if (!_referenceValide) return false;
+  unsigned long seconde = _secondeReference;
+  unsigned long debut = _debutReference;
+
+  if (ppsActif()) {
+    // Une impulsion plus récente que la référence donne un début de seconde plus frais :
+    // on n'attend pas la phrase NMEA qui la suivra.
+    noInterrupts();
+    unsigned long instantPPS = _instantPPS;
+    interrupts();
+    if ((long)(instantPPS - debut) > 0) {
+      seconde += (instantPPS - debut + SECONDE_US / 2) / SECONDE_US;
+      debut = instantPPS;
+    }
+  }
+
+  unsigned long ecoule = micros() - debut;
+  if (ecoule > AGE_MAX_REFERENCE_US) return false;
+  secondesDuJour = (seconde + ecoule / SECONDE_US) % SECONDES_PAR_JOUR;
+  debutSecondeMicros = debut + (ecoule / SECONDE_US) * SECONDE_US;
+  return true;
+}
+
 // Implémentation des différentes fonctions "getter".
-// Elles se contentent de retourner la valeur correspondante, lue par la bibliothèque TinyGPS++.
-bool GestionnaireGPS::hasValidTime() const { return _gps.time.isValid(); }
-bool GestionnaireGPS::hasValidLocation() const { return _gps.location.isValid() && _gps.location.age() < 2000; }
-uint8_t GestionnaireGPS::getHeure() const { return _gps.time.hour(); }
-uint8_t GestionnaireGPS::getMinute() const { return _gps.time.minute(); }
-uint8_t GestionnaireGPS::getSeconde() const { return _gps.time.second(); }
-uint8_t GestionnaireGPS::getJour() const { return _gps.date.day(); }
-uint8_t GestionnaireGPS::getMois() const { return _gps.date.month(); }
-uint16_t GestionnaireGPS::getAnnee() const { return _gps.date.year(); }
-double GestionnaireGPS::getLatitude() const { return _gps.location.lat(); }
-double GestionnaireGPS::getLongitude() const { return _gps.location.lng(); }
+// Elles se contentent de retourner la valeur correspondante, lue par l'analyseur NMEA.
+bool GestionnaireGPS::hasValidTime() const { return _gps.heureValide(); }
+bool GestionnaireGPS::hasValidLocation() const { return _gps.positionValide() && _gps.getAgePositionMs() < 2000; }
+uint8_t GestionnaireGPS::getHeure() const { return _gps.getHeure(); }
+uint8_t GestionnaireGPS::getMinute() const { return _gps.getMinute(); }
+uint8_t GestionnaireGPS::getSeconde() const { return _gps.getSeconde(); }
+uint8_t GestionnaireGPS::getJour() const { return _gps.getJour(); }
+uint8_t GestionnaireGPS::getMois() const { return _gps.getMois(); }
+uint16_t GestionnaireGPS::getAnnee() const { return _gps.getAnnee(); }
+double GestionnaireGPS::getLatitude() const { return _gps.getLatitudeMicro() / 1000000.0; }
+double GestionnaireGPS::getLongitude() const { return _gps.getLongitudeMicro() / 1000000.0; }
+uint8_t GestionnaireGPS::getSatellites() const { return _gps.getSatellites(); }
+const AnalyseurNMEA& GestionnaireGPS::getAnalyseur() const { return _gps; }
+void GestionnaireGPS::setLocatorParDefaut(const char* locator) {
+  // Une position calculée est toujours préférée au locator donné par défaut.
+  if (locatorCalcule()) return;
+  strncpy(_locatorPrecis, locator, 10);
+  _locatorPrecis[10] = '\0';
+  strncpy(_locator, _locatorPrecis, 6);
+  _locator[6] = '\0';
+  strncpy(_locatorEtendu, _locatorPrecis, 8);
+  _locatorEtendu[8] = '\0';
+}
+
+bool GestionnaireGPS::hasLocator() const { return _locator[0] != '\0' && _locator[0] != '.'; }
+bool GestionnaireGPS::locatorCalcule() const { return _caseLongitude >= 0; }
 const char* GestionnaireGPS::getLocator() const { return _locator; }
+uint8_t GestionnaireGPS::getAttenteMax() const { return _attenteMax; }
+void GestionnaireGPS::effacerAttenteMax() { _attenteMax = 0; }
+const char* GestionnaireGPS::getLocatorEtendu() const { return _locatorEtendu; }
+const char* GestionnaireGPS::getLocatorPrecis() const { return _locatorPrecis; }
 
 /**
- * @brief Fonction interne qui applique la formule de conversion en Maidenhead locator.
+ * @brief Donne le numéro de la plus petite case du locator qui contient une coordonnée.
+ * @param microDegres La coordonnée en millionièmes de degré, déjà ramenée à partir de 0.
+ * @param casesParDegre Le nombre de cases par degré.
+ * @param nombreDegres L'étendue de la coordonnée (360 en longitude, 180 en latitude).
+ */
+static long numeroCase(long microDegres, unsigned long casesParDegre, unsigned long nombreDegres) {
+  if (microDegres < 0) return 0;
+  unsigned long degres = (unsigned long)microDegres / 1000000UL;
+  unsigned long reste = (unsigned long)microDegres % 1000000UL;
+  // Au pôle ou sur l'antiméridien, on reste dans la dernière case.
+  if (degres >= nombreDegres) return (long)(nombreDegres * casesParDegre - 1);
+  // On sépare degrés et fraction pour rester dans les 32 bits : reste × cases / 10^6,
+  // simplifié par 10 des deux côtés, ne dépasse jamais 6 × 10^8.
+  return (long)(degres * casesParDegre + (reste * (casesParDegre / 10)) / 100000UL);
+}
+
+void GestionnaireGPS::calculerLocator(long latitudeMicro, long longitudeMicro, char* sortie, uint8_t longueur) {
+  unsigned long lon = numeroCase(longitudeMicro + 180000000L, CASES_PAR_DEGRE_LONGITUDE, 360);
+  unsigned long lat = numeroCase(latitudeMicro + 90000000L, CASES_PAR_DEGRE_LATITUDE, 180);
+
+  // On découpe le numéro de la plus petite case en partant de la fin du locator :
+  // 24 lettres, puis 10 chiffres, puis 24 lettres, puis 10 chiffres, puis 18 lettres.
+  static const uint8_t DIVISIONS[5] = { 18, 10, 24, 10, 24 };
+  static const char ORIGINES[5] = { 'A', '0', 'a', '0', 'a' };
+  char paires[10];
+  for (int8_t i = 4; i >= 0; i--) {
+    uint8_t division = DIVISIONS[i];
+    paires[2 * i] = ORIGINES[i] + (char)(lon % division);
+    paires[2 * i + 1] = ORIGINES[i] + (char)(lat % division);
+    lon /= division;
+    lat /= division;
+  }
+  if (longueur > 10) longueur = 10;
+  memcpy(sortie, paires, longueur);
+  sortie[longueur] = '\0';
+}
+
+/**
+ * @brief Fonction interne qui met à jour les locators, seulement si la position a changé de case.
  */
 void GestionnaireGPS::calculateLocator() {
-  double lat = getLatitude(), lon = getLongitude();
-  lon += 180; lat += 90;
-  _locator[0] = (char)('A' + floor(lon / 20));
-  _locator[1] = (char)('A' + floor(lat / 10));
-  _locator[2] = (char)('0' + floor(fmod(lon, 20) / 2));
-  _locator[3] = (char)('0' + floor(fmod(lat, 10)));
-  _locator[4] = (char)('a' + floor(fmod(lon / 2, 1) * 24));
-  _locator[5] = (char)('a' + floor(fmod(lat, 1) * 24));
+  long latitude = _gps.getLatitudeMicro(), longitude = _gps.getLongitudeMicro();
+  long caseLongitude = numeroCase(longitude + 180000000L, CASES_PAR_DEGRE_LONGITUDE, 360);
+  long caseLatitude = numeroCase(latitude + 90000000L, CASES_PAR_DEGRE_LATITUDE, 180);
+  // La balise ne bouge pas : la plupart du temps, il n'y a rien à refaire.
+  if (caseLongitude == _caseLongitude && caseLatitude == _caseLatitude) return;
+  _caseLongitude = caseLongitude;
+  _caseLatitude = caseLatitude;
+
+  calculerLocator(latitude, longitude, _locatorPrecis, 10);
+  memcpy(_locator, _locatorPrecis, 6);
   _locator[6] = '\0';
+  memcpy(_locatorEtendu, _locatorPrecis, 8);
+  _locatorEtendu[8] = '\0';
 }
\ No newline at end of file
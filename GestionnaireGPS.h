@@ -2,7 +2,7 @@
 #define GESTIONNAIRE_GPS_H
 
 #include <Arduino.h>
-#include <TinyGPS++.h>
+#include "AnalyseurNMEA.h"
 
 /**
  * @class GestionnaireGPS
@@ -10,6 +10,14 @@
  * @details Cette classe est un "traducteur". Elle reçoit les phrases complexes
  * (trames NMEA) envoyées par le module GPS et les déchiffre pour en extraire
  * des informations simples et utilisables : l'heure, la date, la position, etc.
+ *
+ * Les phrases sont lues par un AnalyseurNMEA intégré, qui ne s'intéresse qu'aux
+ * phrases RMC et GGA.
+ *
+ * Une phrase NMEA arrive plusieurs centaines de millisecondes après la seconde
+ * qu'elle annonce. Pour savoir exactement quand commence chaque seconde, on peut
+ * brancher la sortie PPS du module GPS (une impulsion au début de chaque seconde) sur
+ * une broche d'interruption : voir `activerPPS()` et `getHorloge()`.
  */
 class GestionnaireGPS {
 public:
@@ -25,8 +33,40 @@ public:
    * @details C'est la tâche principale de cet objet. Appelée en boucle, elle lit les
    * données qui arrivent sur le port série et met à jour les informations internes
    * (heure, position...).
+   *
+   * Le nombre d'octets lus à chaque appel est limité : même si beaucoup de données
+   * attendent, `loop()` n'est jamais retenue longtemps. Le reste sera lu au passage
+   * suivant (à 9600 bauds, il arrive environ un octet par milliseconde).
+   * @param budgetOctets Le nombre maximal d'octets à lire pendant cet appel.
    */
-  void update();
+  void update(uint16_t budgetOctets = 64);
+
+  /**
+   * @brief Utilise l'impulsion PPS du GPS pour connaître le début exact de chaque seconde.
+   * @details L'instant de chaque front montant est relevé (avec `micros()`) sous interruption.
+   * @param brochePPS La broche reliée à la sortie PPS. Elle doit accepter une
+   * interruption (sur la Mega : 2, 3, 18, 19, 20 ou 21).
+   * @return `false` si la broche ne peut pas déclencher d'interruption.
+   */
+  bool activerPPS(int brochePPS);
+
+  /**
+   * @brief Permet de savoir si des impulsions PPS arrivent en ce moment.
+   */
+  bool ppsActif() const;
+
+  /**
+   * @brief Donne l'heure UTC avec la précision de la microseconde.
+   * @details La seconde en cours est comptée depuis minuit, et son début est donné
+   * au sens de `micros()` : on en déduit l'heure exacte à tout instant. Avec le PPS,
+   * le début de seconde est celui de la dernière impulsion ; sans PPS, c'est
+   * l'arrivée de la première phrase de la seconde, forcément un peu en retard.
+   * Entre deux mises à jour, les secondes sont comptées avec l'horloge de l'Arduino.
+   * @param secondesDuJour Reçoit le numéro de la seconde en cours (0 à 86399).
+   * @param debutSecondeMicros Reçoit l'instant du début de cette seconde.
+   * @return `false` si l'heure n'est pas (ou plus) connue.
+   */
+  bool getHorloge(unsigned long& secondesDuJour, unsigned long& debutSecondeMicros) const;
 
   /**
    * @brief Permet de savoir si l'heure donnée par le GPS est fiable.
@@ -95,11 +135,101 @@ public:
    */
   const char* getLocator() const;
 
+  /**
+   * @brief Donne la position au format Maidenhead étendu, plus précis.
+   * @details Deux chiffres de plus découpent chaque sous-carré en 10 × 10 : on
+   * situe ainsi la balise à quelques centaines de mètres près.
+   * @return Un code de 8 caractères (ex: "JN18NT47").
+   */
+  const char* getLocatorEtendu() const;
+
+  /**
+   * @brief Donne la position au format Maidenhead étendu sur 10 caractères.
+   * @details Deux lettres de plus découpent encore chaque case du locator étendu en
+   * 24 × 24 : on situe ainsi la balise à une quinzaine de mètres près.
+   * @return Un code de 10 caractères (ex: "JN18NT47XK").
+   */
+  const char* getLocatorPrecis() const;
+
+  /**
+   * @brief Donne un locator à utiliser tant que le GPS n'a pas calculé de position.
+   * @details Par exemple celui de la station, connu d'avance : la balise peut alors
+   * émettre dès que l'heure est connue, sans attendre la position. Il est remplacé par
+   * le locator calculé dès la première position valide.
+   * @param locator Le locator (6, 8 ou 10 caractères), ou "" pour n'en donner aucun.
+   */
+  void setLocatorParDefaut(const char* locator);
+
+  /**
+   * @brief Permet de savoir si un locator est disponible, calculé ou donné par défaut.
+   */
+  bool hasLocator() const;
+
+  /**
+   * @brief Permet de savoir si le locator a été calculé à partir d'une position du GPS.
+   */
+  bool locatorCalcule() const;
+
+  /**
+   * @brief Convertit une position en locator Maidenhead, uniquement avec des entiers.
+   * @details Les pôles et l'antiméridien (180°) sont ramenés dans la dernière case.
+   * @param latitudeMicro La latitude en millionièmes de degré (positive au Nord).
+   * @param longitudeMicro La longitude en millionièmes de degré (positive à l'Est).
+   * @param sortie Où écrire le locator, zéro final compris.
+   * @param longueur Le nombre de caractères voulus : 2, 4, 6, 8 ou 10.
+   */
+  static void calculerLocator(long latitudeMicro, long longitudeMicro, char* sortie, uint8_t longueur);
+
+  /**
+   * @brief Donne le nombre de satellites utilisés pour calculer la position.
+   */
+  uint8_t getSatellites() const;
+
+  /**
+   * @brief Donne le plus grand nombre d'octets trouvés en attente dans le port série du GPS.
+   * @details Proche de 64, le tampon de réception a probablement débordé entre deux lectures.
+   */
+  uint8_t getAttenteMax() const;
+
+  /**
+   * @brief Remet à zéro le plus grand nombre d'octets en attente.
+   */
+  void effacerAttenteMax();
+
+  /**
+   * @brief Donne accès au lecteur de phrases NMEA, et à ses compteurs.
+   */
+  const AnalyseurNMEA& getAnalyseur() const;
+
+  /**
+   * @brief Travail fait à chaque impulsion PPS.
+   * @details Appelée uniquement par la routine d'interruption.
+   */
+  void frontPPS();
+
 private:
   void calculateLocator();
+
+  /**
+   * @brief Interne : met à jour la référence de l'horloge quand une phrase annonce une nouvelle seconde.
+   * @param instantArrivee L'instant (micros()) où la phrase a été reçue.
+   */
+  void recalerHorloge(unsigned long instantArrivee);
+
   HardwareSerial& _gpsSerial;
-  TinyGPSPlus _gps;
+  AnalyseurNMEA _gps;
   char _locator[7];
+  char _locatorEtendu[9];
+  char _locatorPrecis[11];
+  long _caseLongitude;   ///< Numéro de la plus petite case du locator (10 caractères) en longitude, -1 si aucune.
+  long _caseLatitude;    ///< Numéro de la plus petite case du locator en latitude, -1 si aucune.
+  uint8_t _attenteMax;   ///< Le plus grand nombre d'octets trouvés en attente au début de `update()`.
+
+  volatile unsigned long _instantPPS;  ///< Instant (micros()) de la dernière impulsion PPS.
+  volatile uint16_t _nombrePPS;        ///< Nombre d'impulsions PPS reçues.
+  bool _referenceValide;               ///< `true` dès que l'heure d'une seconde a été reçue.
+  unsigned long _secondeReference;     ///< La seconde du jour qui sert de référence.
+  unsigned long _debutReference;       ///< L'instant (micros()) du début de cette seconde.
 };
 
 #endif
\ No newline at end of file
@@ -1,99 +1,120 @@
 /**
  * @file GestionnaireLCD.cpp
  * @brief Implémentation de la classe GestionnaireLCD.
- * @details Contient le code qui formate les chaînes de caractères et les envoie
- * à la bibliothèque LiquidCrystal_I2C pour affichage.
+ * @details Contient le code qui formate les chaînes de caractères dans l'image de
+ * l'écran, et celui qui envoie les différences à la bibliothèque LiquidCrystal_I2C.
  */
 #include "GestionnaireLCD.h"
 
 GestionnaireLCD::GestionnaireLCD(uint8_t address, uint8_t cols, uint8_t rows)
-  : _lcd(address, cols, rows), _cols(cols) {}
+  : _lcd(address, cols, rows),
+    _cols(cols > COLONNES_MAX ? COLONNES_MAX : cols), _rows(rows > LIGNES_MAX ? LIGNES_MAX : rows),
+    _prochaineCase(0), _curseurLigne(0xFF), _curseurColonne(0xFF), _aEnvoyer(true),
+    _octetsEnvoyes(0), _octetsFenetre(0), _octetsParSeconde(0), _debutFenetre(0) {
+  memset(_image, ' ', sizeof(_image));
+  memset(_ecran, 0, sizeof(_ecran));
+}
 
 void GestionnaireLCD::begin() {
   _lcd.init();
   _lcd.backlight();
-  _lcd.setCursor(0, 0);
-  this.mettreAJourStatus(StatutBalise.STATUT_INITIAILISATION);
+  _lcd.clear();
+  // Après l'effacement, l'écran ne montre que des espaces, et le curseur est en haut à gauche.
+  memset(_ecran, ' ', sizeof(_ecran));
+  _curseurLigne = 0;
+  _curseurColonne = 0;
+  _debutFenetre = millis();
+  mettreAJourStatus(STATUT_INITIAILISATION);
+}
+
+void GestionnaireLCD::ecrire(uint8_t ligne, uint8_t colonne, const char* texte) {
+  if (ligne >= _rows) return;
+  _aEnvoyer = true;
+  for (; colonne < _cols && *texte; colonne++, texte++) {
+    _image[ligne][colonne] = *texte;
+  }
+}
+
+void GestionnaireLCD::ecrireLigne(uint8_t ligne, const char* texte) {
+  if (ligne >= _rows) return;
+  _aEnvoyer = true;
+  uint8_t colonne = 0;
+  for (; colonne < _cols && *texte; colonne++, texte++) {
+    _image[ligne][colonne] = *texte;
+  }
+  // On efface le reste de la ligne au cas où le texte précédent était plus long.
+  for (; colonne < _cols; colonne++) {
+    _image[ligne][colonne] = ' ';
+  }
 }
 
 /**
- * @brief Formate et affiche la date et l'heure complètes sur la ligne 1.
- * @details Utilise la fonction `sprintf` pour créer une chaîne de caractères
- * formatée "JJ/MM/AAAA HH:MM:SS" avant de l'afficher.
+ * @brief Formate la date et l'heure complètes sur la ligne 1.
+ * @details Utilise la fonction `snprintf` pour créer une chaîne de caractères
+ * formatée "JJ/MM/AAAA HH:MM:SS". D'une seconde à l'autre, seuls un ou deux
+ * chiffres changent vraiment à l'écran. Chaque nombre est ramené à sa largeur : une
+ * valeur fausse ne peut ni décaler ni couper le reste de la ligne.
  */
 void GestionnaireLCD::afficherDateHeure(uint8_t jour, uint8_t mois, uint16_t annee, uint8_t h, uint8_t m, uint8_t s) {
-  char lineBuffer[21];
-  sprintf(lineBuffer, "%02d/%02d/%04d %02d:%02d:%02d", jour, mois, annee, h, m, s);
-  _lcd.setCursor(0, 0);
-  _lcd.print(lineBuffer);
+  char lineBuffer[COLONNES_MAX + 1];
+  snprintf(lineBuffer, sizeof(lineBuffer), "%02u/%02u/%04u %02u:%02u:%02u", jour % 100u, mois % 100u,
+           annee % 10000u, h % 100u, m % 100u, s % 100u);
+  ecrire(0, 0, lineBuffer);
 }
 
-// ... Les autres fonctions de la classe restent inchangées et commentées ...
-void GestionnaireLCD::mettreAJourPositionEtLocator(double lat, double lon, const char* locator) { /* ... */ }
-void GestionnaireLCD::mettreAJourStatus(double lat, double lon, const char* locator) {
-  char posBuffer[21]; // Buffer assez grand pour la ligne (20 caractères + le nul)
+/**
+ * @brief Formate la position et le locator sur la ligne 2.
+ */
+void GestionnaireLCD::mettreAJourPositionEtLocator(double lat, double lon, const char* locator) {
+  char posBuffer[COLONNES_MAX + 1];
   // On utilise dtostrf pour convertir les double (lat/lon) en chaîne
   char latStr[8], lonStr[9];
   dtostrf(lat, 6, 3, latStr); // 6 caractères au total, 3 après la virgule
   dtostrf(lon, 7, 3, lonStr);
-  
-  // On combine toutes les infos dans un seul buffer
-  sprintf(posBuffer, "%s,%s %s", latStr, lonStr, locator);
 
-  _lcd.setCursor(0, 1); // Ligne 2
-  _lcd.print(posBuffer);
-  // On efface le reste de la ligne au cas où le texte précédent était plus long
-  for (int i = strlen(posBuffer); i < _cols; i++) {
-    _lcd.print(" ");
-  }
+  // On combine toutes les infos dans un seul buffer
+  snprintf(posBuffer, sizeof(posBuffer), "%s,%s %s", latStr, lonStr, locator);
+  ecrireLigne(1, posBuffer);
 }
 
 /**
  * @brief Met à jour le message de statut sur la troisième ligne.
  * @param status L'état actuel de la balise, choisi depuis l'énumération StatutBalise.
  */
-void GestionnaireLCD::updateStatus(StatutBalise status) {
-  _lcd.setCursor(0, 2); // Ligne 3
-  String statusMsg;
+void GestionnaireLCD::mettreAJourStatus(StatutBalise status) {
+  const char* statusMsg = "";
   switch (status) {
-
     case STATUT_INITIAILISATION:
-        statusMsg = "Initialisation ...";
-        break;
+      statusMsg = "Initialisation ...";
+      break;
     case STATUT_ERREUR:
-        statusMsg = "Erreur !"
-        break;
+      statusMsg = "Erreur !";
+      break;
     case STATUT_ATTENTE_GPS:
-        statusMsg = "Attente Syncronisation GPS...";
-        break;
+      statusMsg = "Attente synchro GPS";
+      break;
     case STATUT_PRET:
-        statusMsg = "Pret. En attente...";
-        break;
+      statusMsg = "Pret. En attente...";
+      break;
     case STATUT_EMISSION:
-        statusMsg = "En emission";
-        break;
-  }
-  _lcd.print(statusMsg);
-  // On efface le reste de la ligne
-  for (int i = statusMsg.length(); i < _cols; i++) {
-    _lcd.print(" ");
+      statusMsg = "En emission";
+      break;
   }
+  ecrireLigne(2, statusMsg);
 }
 
 /**
  * @brief Affiche les informations de la balise en émission sur la quatrième ligne.
- * @param callsign L'indicatif de la balise (ex: "F6KJU").
- * @param frequencyMhz La fréquence d'émission en MHz.
+ * @details La fréquence est écrite en MHz avec 5 décimales, uniquement avec des entiers.
+ * Elle tient en 14 caractères avec ": " devant (le DDS ne dépasse pas 999 MHz) :
+ * l'indicatif est coupé à ce qui reste, 6 caractères, la longueur d'un indicatif standard.
  */
-void GestionnaireLCD::displayBeaconInfo(const char* callsign, double frequencyMhz) {
-  char infoBuffer[21];
-  char freqStr[10];
-  dtostrf(frequencyMhz, 7, 4, freqStr); // 7 caractères, 4 après la virgule
-
-  sprintf(infoBuffer, "%s: %sMHz", callsign, freqStr);
-  
-  _lcd.setCursor(0, 3); // Ligne 4
-  _lcd.print(infoBuffer);
+void GestionnaireLCD::displayBeaconInfo(const char* callsign, unsigned long frequencyHz) {
+  static const int LARGEUR_INDICATIF = COLONNES_MAX - 14;
+  char infoBuffer[COLONNES_MAX + 1];
+  snprintf(infoBuffer, sizeof(infoBuffer), "%.*s: %lu.%05luMHz", LARGEUR_INDICATIF, callsign,
+           frequencyHz / 1000000UL % 1000UL, (frequencyHz % 1000000UL) / 10);
+  ecrireLigne(3, infoBuffer);
 }
 
 /**
@@ -101,9 +122,108 @@ void GestionnaireLCD::displayBeaconInfo(const char* callsign, double frequencyMh
  * @details Utile après la fin d'une émission pour nettoyer l'écran.
  */
 void GestionnaireLCD::clearBeaconInfo() {
-  _lcd.setCursor(0, 3); // Ligne 4
-  // On efface toute la ligne en imprimant des espaces
-  for (int i = 0; i < _cols; i++) {
-    _lcd.print(" ");
+  ecrireLigne(3, "");
+}
+
+/**
+ * @brief Affiche l'avancement de l'attente du GPS sur la quatrième ligne.
+ * @details Appelée chaque seconde pendant le démarrage : seuls les chiffres qui
+ * changent partent vers l'écran. La ligne fait juste 20 colonnes : au-delà de 99
+ * satellites ou de 9999 secondes (2 h 46), l'affichage reste bloqué à ces valeurs.
+ */
+void GestionnaireLCD::afficherAttenteGPS(uint8_t satellites, unsigned long secondes) {
+  char attenteBuffer[COLONNES_MAX + 1];
+  snprintf(attenteBuffer, sizeof(attenteBuffer), "Sat:%2u  Depuis %4lus", satellites > 99 ? 99u : satellites,
+           secondes > 9999UL ? 9999UL : secondes);
+  ecrireLigne(3, attenteBuffer);
+}
+
+uint16_t GestionnaireLCD::flush(uint16_t budgetOctets) {
+  uint8_t nombreCases = _rows * _cols;
+  uint16_t envoyes = 0;
+  if (!_aEnvoyer) {
+    // Rien n'a changé depuis le dernier tour complet : inutile de comparer toutes les cases.
+    compterOctets(0);
+    return 0;
+  }
+
+  uint8_t n = 0;
+  for (; n < nombreCases && envoyes < budgetOctets; n++) {
+    uint8_t ligne = _prochaineCase / _cols;
+    uint8_t colonne = _prochaineCase % _cols;
+    char c = _image[ligne][colonne];
+    if (c != _ecran[ligne][colonne]) {
+      // Après un caractère, l'écran avance tout seul son curseur : on ne le
+      // déplace que si la case à écrire n'est pas juste après la précédente.
+      if (ligne != _curseurLigne || colonne != _curseurColonne) {
+        if (envoyes + 2 > budgetOctets) break; // Pas la place pour le déplacement et le caractère.
+        _lcd.setCursor(colonne, ligne);
+        envoyes++;
+      }
+      _lcd.write((uint8_t)c);
+      envoyes++;
+      _ecran[ligne][colonne] = c;
+      _curseurLigne = ligne;
+      _curseurColonne = colonne + 1;
+    }
+    _prochaineCase = (_prochaineCase + 1) % nombreCases;
+  }
+  // Un tour complet sans manquer de budget : l'écran montre toute l'image.
+  if (n == nombreCases) _aEnvoyer = false;
+
+  compterOctets(envoyes);
+  return envoyes;
+}
+
+bool GestionnaireLCD::estAJour() const {
+  return memcmp(_image, _ecran, sizeof(_image)) == 0;
+}
+
+void GestionnaireLCD::invaliderEcran() {
+  memset(_ecran, 0, sizeof(_ecran));
+  _curseurLigne = 0xFF;
+  _curseurColonne = 0xFF;
+  _prochaineCase = 0;
+  _aEnvoyer = true;
+}
+
+void GestionnaireLCD::compterOctets(uint16_t octets) {
+  _octetsEnvoyes += octets;
+  _octetsFenetre += octets;
+  unsigned long ecoule = millis() - _debutFenetre;
+  if (ecoule >= 1000) {
+    _octetsParSeconde = (uint16_t)(((unsigned long)_octetsFenetre * 1000UL) / ecoule);
+    _octetsFenetre = 0;
+    _debutFenetre = millis();
   }
-}
\ No newline at end of file
+}
+
+uint16_t GestionnaireLCD::getOctetsParSeconde() const { return _octetsParSeconde; }
+unsigned long GestionnaireLCD::getOctetsEnvoyes() const { return _octetsEnvoyes; }
+
+void GestionnaireLCD::mesurerRafraichissement(Print& sortie) {
+  // 1) Tout l'écran, comme le faisait l'ancienne version chaque seconde.
+  flush();
+  invaliderEcran();
+  unsigned long debut = micros();
+  uint16_t octets = flush();
+  unsigned long duree = micros() - debut;
+  sortie.print(F("LCD, ecran complet : "));
+  sortie.print(duree);
+  sortie.print(F(" us / "));
+  sortie.print(octets);
+  sortie.println(F(" octets"));
+
+  // 2) Une seconde qui passe : seul le dernier chiffre de l'heure change ("JJ/MM/AAAA HH:MM:SS").
+  char& chiffre = _image[0][_cols > 18 ? 18 : _cols - 1];
+  chiffre = (chiffre >= '0' && chiffre < '9') ? chiffre + 1 : '0';
+  _aEnvoyer = true;
+  debut = micros();
+  octets = flush();
+  duree = micros() - debut;
+  sortie.print(F("LCD, une seconde : "));
+  sortie.print(duree);
+  sortie.print(F(" us / "));
+  sortie.print(octets);
+  sortie.println(F(" octets"));
+}
@@ -22,9 +22,18 @@ enum StatutBalise {
  * @details Cette classe est une interface complète pour l'écran. Elle formate et
  * affiche toutes les données pertinentes sur les 4 lignes de l'afficheur,
  * en s'assurant que l'écran est toujours à jour et lisible.
+ *
+ * Chaque caractère envoyé à l'écran coûte plusieurs échanges sur le bus I2C. Les
+ * fonctions d'affichage n'écrivent donc que dans une "image" de l'écran gardée en
+ * mémoire. C'est `flush()` qui envoie ensuite à l'écran les seules cases qui ont
+ * changé, en évitant les déplacements de curseur inutiles, et éventuellement en
+ * plusieurs fois pour ne jamais retenir `loop()` longtemps.
  */
 class GestionnaireLCD {
 public:
+  static const uint8_t COLONNES_MAX = 20; ///< Le plus grand nombre de colonnes géré.
+  static const uint8_t LIGNES_MAX = 4;    ///< Le plus grand nombre de lignes géré.
+
   GestionnaireLCD(uint8_t address, uint8_t cols, uint8_t rows);
   void begin();
 
@@ -38,14 +47,113 @@ public:
    * @param s Les secondes actuelles (0-59).
    */
   void afficherDateHeure(uint8_t jour, uint8_t mois, uint16_t annee, uint8_t h, uint8_t m, uint8_t s);
+
+  /**
+   * @brief Met à jour la position et le locator sur la deuxième ligne.
+   * @param lat La latitude en degrés.
+   * @param lon La longitude en degrés.
+   * @param locator Le locator Maidenhead.
+   */
   void mettreAJourPositionEtLocator(double lat, double lon, const char* locator);
+
+  /**
+   * @brief Met à jour le message de statut sur la troisième ligne.
+   * @param status L'état actuel de la balise.
+   */
   void mettreAJourStatus(StatutBalise status);
-  void displayBeaconInfo(const char* callsign, double frequencyMhz);
+
+  /**
+   * @brief Affiche les informations de la balise en émission sur la quatrième ligne.
+   * @param callsign L'indicatif de la balise (ex: "F6KJU").
+   * @param frequencyHz La fréquence d'émission en Hertz.
+   */
+  void displayBeaconInfo(const char* callsign, unsigned long frequencyHz);
+
+  /**
+   * @brief Efface les informations de la balise sur la quatrième ligne.
+   */
   void clearBeaconInfo();
 
+  /**
+   * @brief Affiche l'avancement de l'attente du GPS sur la quatrième ligne.
+   * @param satellites Le nombre de satellites utilisés par le GPS.
+   * @param secondes Le temps écoulé depuis le démarrage, en secondes.
+   */
+  void afficherAttenteGPS(uint8_t satellites, unsigned long secondes);
+
+  /**
+   * @brief Écrit un texte dans l'image de l'écran, et complète la ligne avec des espaces.
+   * @param ligne La ligne (0 pour la première).
+   * @param texte Le texte à afficher, coupé s'il dépasse la largeur de l'écran.
+   */
+  void ecrireLigne(uint8_t ligne, const char* texte);
+
+  /**
+   * @brief Envoie à l'écran les cases de l'image qui ont changé.
+   * @details Les cases sont parcourues dans l'ordre de lecture, en reprenant là où
+   * l'appel précédent s'était arrêté. Le curseur n'est déplacé que lorsque la case
+   * suivante à écrire n'est pas juste après la précédente.
+   * @param budgetOctets Le nombre maximal d'octets (caractères et déplacements de
+   * curseur) à envoyer pendant cet appel.
+   * @return Le nombre d'octets envoyés.
+   */
+  uint16_t flush(uint16_t budgetOctets = 0xFFFF);
+
+  /**
+   * @brief Permet de savoir si toute l'image a été envoyée à l'écran.
+   */
+  bool estAJour() const;
+
+  /**
+   * @brief Donne le nombre d'octets envoyés à l'écran pendant la dernière seconde complète.
+   */
+  uint16_t getOctetsParSeconde() const;
+
+  /**
+   * @brief Donne le nombre total d'octets envoyés à l'écran depuis le démarrage.
+   */
+  unsigned long getOctetsEnvoyes() const;
+
+  /**
+   * @brief Compare la durée d'un rafraîchissement complet et d'un rafraîchissement des seules différences.
+   * @details Petit banc d'essai à lancer au démarrage : il redessine tout l'écran
+   * comme le faisait l'ancienne version, puis ne fait changer qu'une seconde de
+   * l'heure, et affiche pour chacun la durée et le nombre d'octets envoyés.
+   * @param sortie Où afficher les résultats (par exemple `Serial`).
+   */
+  void mesurerRafraichissement(Print& sortie);
+
 private:
+  /**
+   * @brief Interne : écrit un texte dans l'image à partir d'une case, sans dépasser la ligne.
+   */
+  void ecrire(uint8_t ligne, uint8_t colonne, const char* texte);
+
+  /**
+   * @brief Interne : oublie ce qui est affiché, pour que `flush()` renvoie tout.
+   */
+  void invaliderEcran();
+
+  /**
+   * @brief Interne : ajoute des octets envoyés aux compteurs.
+   */
+  void compterOctets(uint16_t octets);
+
   LiquidCrystal_I2C _lcd;
   uint8_t _cols;
+  uint8_t _rows;
+
+  char _image[LIGNES_MAX][COLONNES_MAX];  ///< Ce que l'on veut voir à l'écran.
+  char _ecran[LIGNES_MAX][COLONNES_MAX];  ///< Ce qui est réellement affiché (0 : case inconnue).
+  uint8_t _prochaineCase;                 ///< Case où reprendra le prochain `flush()`.
+  uint8_t _curseurLigne;                  ///< Position du curseur de l'écran (0xFF : inconnue).
+  uint8_t _curseurColonne;
+  bool _aEnvoyer;                         ///< L'image a peut-être changé depuis le dernier tour complet de `flush()`.
+
+  unsigned long _octetsEnvoyes;           ///< Total des octets envoyés.
+  uint16_t _octetsFenetre;                ///< Octets envoyés depuis le début de la seconde en cours.
+  uint16_t _octetsParSeconde;             ///< Octets envoyés pendant la dernière seconde complète.
+  unsigned long _debutFenetre;            ///< Début (millis()) de la seconde en cours.
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file GestionnaireVeille.cpp
+ * @brief Implémentation de la classe GestionnaireVeille.
+ * @details Contient la mise en sommeil sans réveil manqué et la mesure du temps passé à dormir.
+ */
+#include "GestionnaireVeille.h"
+#include <avr/sleep.h>
+
+GestionnaireVeille::GestionnaireVeille()
+  : _condition(nullptr), _active(false), _debutFenetre(0), _sommeilUs(0), _sommes(0),
+    _dureeMinuteUs(0), _sommeilMinuteUs(0), _sommesMinute(0) {}
+
+void GestionnaireVeille::begin(ConditionVeille condition, bool active) {
+  _condition = condition;
+  _active = active;
+  // IDLE : seul le cœur s'arrête. Les modes plus profonds arrêtent le Timer0, et avec lui
+  // millis() et micros() : la balise perdrait l'heure.
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  _debutFenetre = micros();
+}
+
+void GestionnaireVeille::setActive(bool active) { _active = active; }
+bool GestionnaireVeille::isActive() const { return _active; }
+
+void GestionnaireVeille::somnoler() {
+  unsigned long avant = micros();
+  fermerFenetre(avant);
+  if (!_active || _condition == nullptr) return;
+
+  // La condition est vérifiée interruptions coupées : un octet reçu juste après ne
+  // pourrait plus réveiller la boucle, puisque sa routine serait déjà passée.
+  cli();
+  if (!_condition()) {
+    sei();
+    return;
+  }
+  sleep_enable();
+  // L'instruction qui suit sei() est toujours exécutée avant la moindre interruption :
+  // celle qui attend déjà réveillera donc le cœur dès qu'il s'endort.
+  sei();
+  sleep_cpu();
+  sleep_disable();
+
+  _sommeilUs += micros() - avant;
+  _sommes++;
+}
+
+void GestionnaireVeille::fermerFenetre(unsigned long maintenant) {
+  unsigned long duree = maintenant - _debutFenetre;
+  if (duree < FENETRE_US) return;
+  _dureeMinuteUs = duree;
+  _sommeilMinuteUs = _sommeilUs;
+  _sommesMinute = _sommes;
+  _debutFenetre = maintenant;
+  _sommeilUs = 0;
+  _sommes = 0;
+}
+
+unsigned long GestionnaireVeille::getSommeilMs() const { return _sommeilMinuteUs / 1000; }
+unsigned long GestionnaireVeille::getEveilMs() const { return (_dureeMinuteUs - _sommeilMinuteUs) / 1000; }
+unsigned long GestionnaireVeille::getSommes() const { return _sommesMinute; }
+
+uint16_t GestionnaireVeille::getSommeilPourMille() const {
+  if (_dureeMinuteUs == 0) return 0;
+  // Le temps de sommeil est exprimé en ms pour que le produit tienne sur 32 bits.
+  return (uint16_t)(_sommeilMinuteUs / 1000 * 1000UL / (_dureeMinuteUs / 1000));
+}
+
+void GestionnaireVeille::afficherRapport(Print& sortie) const {
+  sortie.print(F("Veille "));
+  sortie.print(_active ? F("ON") : F("OFF"));
+  if (_dureeMinuteUs == 0) {
+    sortie.println(F(", pas encore de minute complete"));
+    return;
+  }
+  sortie.print(F(", derniere minute : eveil "));
+  sortie.print(getEveilMs());
+  sortie.print(F(" ms, sommeil "));
+  sortie.print(getSommeilMs());
+  sortie.print(F(" ms ("));
+  sortie.print(getSommeilPourMille() / 10);
+  sortie.print('.');
+  sortie.print(getSommeilPourMille() % 10);
+  sortie.print(F(" %), "));
+  sortie.print(_sommesMinute);
+  sortie.println(F(" sommes"));
+}
@@ -0,0 +1,106 @@
+#ifndef GESTIONNAIRE_VEILLE_H
+#define GESTIONNAIRE_VEILLE_H
+
+#include <Arduino.h>
+
+/// La condition du sommeil : `true` si rien ne presse d'ici la prochaine interruption.
+typedef bool (*ConditionVeille)();
+
+/**
+ * @class GestionnaireVeille
+ * @brief Le "veilleur de nuit" qui laisse le microcontrôleur somnoler entre deux émissions.
+ * @details Hors émission, la boucle principale tourne à vide la plupart du temps : elle
+ * ne fait que regarder si un octet du GPS est arrivé ou si une échéance est passée. Sur
+ * un site alimenté par panneau solaire ou batterie, ce tour à vide coûte cher.
+ *
+ * Après chaque passage, `somnoler()` met donc le cœur en sommeil léger (mode IDLE) : les
+ * périphériques continuent de tourner, et la moindre interruption le réveille en quelques
+ * cycles, avant même d'être servie. Aucune mesure de temps n'est perdue :
+ * - le Timer0 de `millis()` et `micros()` continue de compter, et réveille la boucle au
+ *   plus tard toutes les 1024 µs : les tâches périodiques gardent leur rythme ;
+ * - un octet reçu du GPS ou de la console réveille la boucle aussitôt ;
+ * - le PPS et le Timer3 du manipulateur réveillent la boucle après leur routine, qui a
+ *   déjà noté l'instant exact.
+ *
+ * La condition du sommeil est vérifiée interruptions coupées, juste avant de s'endormir :
+ * un octet arrivé pendant la vérification ne peut pas attendre le réveil suivant.
+ *
+ * Le veilleur mesure aussi le temps passé à dormir, par fenêtres d'une minute, pour
+ * chiffrer l'économie (commande "VEILLE" de la console).
+ */
+class GestionnaireVeille {
+public:
+  /// Durée d'une fenêtre de mesure, en microsecondes (une minute).
+  static const unsigned long FENETRE_US = 60000000UL;
+
+  GestionnaireVeille();
+
+  /**
+   * @brief Prépare le veilleur.
+   * @param condition La condition du sommeil, appelée interruptions coupées : elle doit
+   * être très courte, et ne pas les rétablir.
+   * @param active `false` pour ne jamais dormir (la boucle tourne alors à vide, comme avant).
+   */
+  void begin(ConditionVeille condition, bool active = true);
+
+  /**
+   * @brief Autorise ou interdit le sommeil.
+   */
+  void setActive(bool active);
+
+  /**
+   * @brief Permet de savoir si le sommeil est autorisé.
+   */
+  bool isActive() const;
+
+  /**
+   * @brief Endort le cœur jusqu'à la prochaine interruption, si la condition le permet.
+   * @details À appeler à la fin de chaque passage dans `loop()`.
+   */
+  void somnoler();
+
+  /**
+   * @brief Donne le temps passé à dormir pendant la dernière minute complète, en millisecondes.
+   */
+  unsigned long getSommeilMs() const;
+
+  /**
+   * @brief Donne le temps passé éveillé pendant la dernière minute complète, en millisecondes.
+   */
+  unsigned long getEveilMs() const;
+
+  /**
+   * @brief Donne la part de la dernière minute complète passée à dormir, en pour mille.
+   */
+  uint16_t getSommeilPourMille() const;
+
+  /**
+   * @brief Donne le nombre de sommes de la dernière minute complète.
+   */
+  unsigned long getSommes() const;
+
+  /**
+   * @brief Affiche les mesures de la dernière minute complète.
+   * @param sortie Où les afficher (par exemple le Journal).
+   */
+  void afficherRapport(Print& sortie) const;
+
+private:
+  /**
+   * @brief Interne : clôt la fenêtre de mesure en cours si la minute est écoulée.
+   */
+  void fermerFenetre(unsigned long maintenant);
+
+  ConditionVeille _condition;      ///< La condition du sommeil.
+  bool _active;                    ///< `true` si le sommeil est autorisé.
+
+  unsigned long _debutFenetre;     ///< Début (micros()) de la fenêtre en cours.
+  unsigned long _sommeilUs;        ///< Temps passé à dormir dans la fenêtre en cours.
+  unsigned long _sommes;           ///< Nombre de sommes dans la fenêtre en cours.
+
+  unsigned long _dureeMinuteUs;    ///< Durée exacte de la dernière fenêtre complète (0 : pas encore).
+  unsigned long _sommeilMinuteUs;  ///< Temps passé à dormir pendant cette fenêtre.
+  unsigned long _sommesMinute;     ///< Nombre de sommes pendant cette fenêtre.
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file Journal.cpp
+ * @brief Implémentation de la classe Journal.
+ * @details Contient le tampon circulaire, le formatage compact des événements et
+ * la vidange sans attente vers le port série.
+ */
+#include "Journal.h"
+
+/// La lettre qui précède le code d'un événement, pour chaque niveau.
+static const char LETTRES_NIVEAU[] = { 'E', 'A', 'I', 'D' };
+
+Journal::Journal(HardwareSerial& sortie)
+  : _sortie(sortie), _niveau(NIVEAU_INFO), _tete(0), _queue(0), _remplissageMax(0),
+    _octetsPerdus(0), _pertesSignalees(0) {}
+
+void Journal::setNiveau(NiveauJournal niveau) { _niveau = niveau; }
+NiveauJournal Journal::getNiveau() const { return _niveau; }
+
+Print& Journal::message(NiveauJournal niveau) {
+  if (niveau > _niveau) return _muette;
+  return *this;
+}
+
+uint16_t Journal::placeLibre() const {
+  // Une case reste toujours vide, pour distinguer un tampon plein d'un tampon vide.
+  return TAILLE - 1 - getEnAttente();
+}
+
+uint16_t Journal::getEnAttente() const {
+  return (_tete - _queue) & (TAILLE - 1);
+}
+
+size_t Journal::write(uint8_t octet) {
+  if (placeLibre() == 0) {
+    _octetsPerdus++;
+    return 0;
+  }
+  _tampon[_tete] = octet;
+  _tete = (_tete + 1) & (TAILLE - 1);
+  uint16_t enAttente = getEnAttente();
+  if (enAttente > _remplissageMax) _remplissageMax = enAttente;
+  return 1;
+}
+
+bool Journal::ecrireEnEntier(const uint8_t* octets, uint16_t longueur) {
+  if (placeLibre() < longueur) {
+    _octetsPerdus += longueur;
+    return false;
+  }
+  for (uint16_t i = 0; i < longueur; i++) write(octets[i]);
+  return true;
+}
+
+void Journal::evenement(NiveauJournal niveau, CodeEvenement code, long valeur) {
+  if (niveau > _niveau) return;
+  // "I04 3\n" : la lettre du niveau, le code sur deux chiffres, la valeur.
+  char ligne[16];
+  ligne[0] = LETTRES_NIVEAU[niveau];
+  ligne[1] = '0' + (code / 10) % 10;
+  ligne[2] = '0' + code % 10;
+  ligne[3] = ' ';
+  ltoa(valeur, ligne + 4, 10);
+  uint8_t longueur = strlen(ligne);
+  ligne[longueur++] = '\n';
+  // Tout ou rien : un événement à moitié écrit serait illisible.
+  ecrireEnEntier((const uint8_t*)ligne, longueur);
+}
+
+void Journal::vider() {
+  // Seulement ce qui tient dans le tampon du port série : write() n'attendra jamais.
+  int place = _sortie.availableForWrite();
+  while (place > 0 && _queue != _tete) {
+    _sortie.write((uint8_t)_tampon[_queue]);
+    _queue = (_queue + 1) & (TAILLE - 1);
+    place--;
+  }
+  // Des octets ont été perdus : on le signale dès qu'il y a de nouveau de la place.
+  if (_octetsPerdus != _pertesSignalees && placeLibre() >= TAILLE / 2) {
+    _pertesSignalees = _octetsPerdus;
+    evenement(NIVEAU_ALERTE, EVT_JOURNAL_PERTES, (long)_octetsPerdus);
+  }
+}
+
+uint16_t Journal::getRemplissageMax() const { return _remplissageMax; }
+unsigned long Journal::getOctetsPerdus() const { return _octetsPerdus; }
@@ -0,0 +1,145 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <Arduino.h>
+
+/**
+ * @enum NiveauJournal
+ * @brief L'importance d'un message du journal : seuls ceux au moins aussi importants que le niveau choisi sont gardés.
+ */
+enum NiveauJournal {
+  NIVEAU_ERREUR, ///< Quelque chose n'a pas pu se faire (émission annulée...).
+  NIVEAU_ALERTE, ///< Quelque chose d'anormal, sans conséquence immédiate.
+  NIVEAU_INFO,   ///< La vie normale de la balise (émissions, démarrage...).
+  NIVEAU_DETAIL, ///< Les mesures détaillées (statistiques après chaque émission...).
+};
+
+/**
+ * @enum CodeEvenement
+ * @brief Les événements que le journal sait noter en quelques octets.
+ * @details Un événement s'écrit sous la forme "<niveau><code> <valeur>", par exemple
+ * "I04 3" pour le début d'une émission de la balise n° 3. Les numéros ne doivent
+ * jamais changer : on ajoute les nouveaux à la fin.
+ */
+enum CodeEvenement {
+  EVT_HEURE_VALIDE = 1,      ///< L'heure du GPS est valide. Valeur : ms depuis la mise sous tension.
+  EVT_POSITION_VALIDE = 2,   ///< La position du GPS est valide. Valeur : ms depuis la mise sous tension.
+  EVT_PREMIERE_EMISSION = 3, ///< La première émission est programmée. Valeur : ms depuis la mise sous tension de son début.
+  EVT_EMISSION = 4,          ///< Une émission est programmée. Valeur : numéro de la balise (à partir de 1).
+  EVT_DUREE_PREVUE = 5,      ///< Durée prévue de l'émission. Valeur : ms.
+  EVT_FIN_EMISSION = 6,      ///< Fin de l'émission. Valeur : numéro de l'émission (jeton #NSEQ#).
+  EVT_FAMINES = 7,           ///< Famines du manipulateur depuis le démarrage.
+  EVT_GIGUE_US = 8,          ///< Gigue maximale du manipulateur, en µs.
+  EVT_NMEA_PHRASES = 9,      ///< Phrases NMEA valides depuis le démarrage.
+  EVT_NMEA_ERREURS = 10,     ///< Phrases NMEA rejetées pour leur somme de contrôle.
+  EVT_NMEA_PERDUS = 11,      ///< Octets du GPS perdus (phrase trop longue).
+  EVT_LCD_OCTETS = 12,       ///< Octets envoyés à l'écran par seconde.
+  EVT_MESSAGE_TROP_LONG = 13,///< Message trop long une fois les jetons remplacés : pas d'émission. Valeur : numéro de la balise.
+  EVT_MESSAGE_TRONQUE = 14,  ///< Message trop long pour la minute. Valeur : numéro de la balise.
+  EVT_FILTRE_PAS_PRET = 15,  ///< Le relais du filtre n'avait pas fini de commuter. Valeur : numéro de la balise.
+  EVT_JOURNAL_PERTES = 16,   ///< Le journal était plein. Valeur : octets perdus depuis le démarrage.
+  EVT_SYMBOLES_EN_RETARD = 17, ///< Symboles WSPR ou QRSS dont le ton n'était pas préchargé à temps. Valeur : nombre de symboles.
+  EVT_MODE_IMPOSSIBLE = 18,  ///< Le message ne peut pas être émis dans le mode de la balise (indicatif WSPR non standard, pas de timer...). Valeur : numéro de la balise.
+};
+
+/**
+ * @class Journal
+ * @brief Le "secrétaire de séance" qui note tout sans jamais faire attendre la balise.
+ * @details À 9600 bauds, le port série n'envoie qu'un octet par milliseconde environ,
+ * et son tampon de 64 octets est vite plein : un `Serial.print()` un peu long bloque
+ * alors la boucle pendant des dizaines de millisecondes, parfois juste avant une émission.
+ *
+ * Le journal s'utilise comme `Serial` (c'est un `Print`), mais il ne fait que ranger les
+ * octets dans un grand tampon circulaire. C'est `vider()`, appelée quand la boucle n'a
+ * rien de plus urgent à faire, qui les passe au port série, seulement à hauteur de la
+ * place libre dans son tampon : elle ne bloque jamais non plus.
+ *
+ * Si le tampon du journal est plein, les octets sont comptés comme perdus au lieu de
+ * faire attendre la balise, et un événement `EVT_JOURNAL_PERTES` le signale dès que la
+ * place revient. Les événements (`evenement()`) sont écrits en entier ou pas du tout.
+ */
+class Journal : public Print {
+public:
+  /// Taille du tampon circulaire (puissance de 2, pour un calcul de position rapide).
+  static const uint16_t TAILLE = 1024;
+
+  /**
+   * @brief Construit le journal.
+   * @param sortie Le port série où le journal est vidé.
+   */
+  Journal(HardwareSerial& sortie);
+
+  /**
+   * @brief Choisit le niveau de détail : les messages moins importants sont ignorés.
+   */
+  void setNiveau(NiveauJournal niveau);
+
+  /**
+   * @brief Donne le niveau de détail en cours.
+   */
+  NiveauJournal getNiveau() const;
+
+  /**
+   * @brief Donne où écrire un message d'un niveau donné.
+   * @details Renvoie le journal lui-même si ce niveau est gardé, sinon une sortie qui
+   * ignore tout. Par exemple : `journal.message(NIVEAU_DETAIL).println(valeur);`.
+   */
+  Print& message(NiveauJournal niveau);
+
+  /**
+   * @brief Note un événement sous sa forme compacte ("<niveau><code> <valeur>").
+   * @param niveau L'importance de l'événement.
+   * @param code Le code de l'événement.
+   * @param valeur La valeur qui l'accompagne.
+   */
+  void evenement(NiveauJournal niveau, CodeEvenement code, long valeur = 0);
+
+  /**
+   * @brief Range un octet dans le tampon (ou le compte comme perdu si le tampon est plein).
+   */
+  virtual size_t write(uint8_t octet);
+  using Print::write;
+
+  /**
+   * @brief Range des octets seulement s'ils tiennent tous dans le tampon.
+   * @details Pour les trames binaires (voir Telemetrie) : une trame coupée serait inutilisable.
+   * @return `false` si la place manque (rien n'est alors rangé, les octets sont comptés comme perdus).
+   */
+  bool ecrireEnEntier(const uint8_t* octets, uint16_t longueur);
+
+  /**
+   * @brief Passe au port série tout ce qui tient dans son tampon, sans attendre.
+   * @details À appeler quand la boucle n'a rien de plus urgent à faire.
+   */
+  void vider();
+
+  uint16_t getEnAttente() const;       ///< Le nombre d'octets en attente d'envoi.
+  uint16_t getRemplissageMax() const;  ///< Le plus grand nombre d'octets en attente observé.
+  unsigned long getOctetsPerdus() const; ///< Le nombre d'octets perdus faute de place.
+
+private:
+  /**
+   * @brief Une sortie qui ignore tout ce qu'on lui écrit, pour les messages filtrés.
+   */
+  class SortieMuette : public Print {
+  public:
+    virtual size_t write(uint8_t) { return 1; }
+  };
+
+  /**
+   * @brief Interne : la place libre dans le tampon.
+   */
+  uint16_t placeLibre() const;
+
+  HardwareSerial& _sortie;       ///< Le port série où le journal est vidé.
+  SortieMuette _muette;          ///< La sortie des messages filtrés.
+  NiveauJournal _niveau;         ///< Le niveau de détail en cours.
+  char _tampon[TAILLE];          ///< Le tampon circulaire.
+  uint16_t _tete;                ///< Prochaine case libre.
+  uint16_t _queue;               ///< Prochain octet à envoyer.
+  uint16_t _remplissageMax;      ///< Le plus grand nombre d'octets en attente observé.
+  unsigned long _octetsPerdus;   ///< Octets perdus faute de place.
+  unsigned long _pertesSignalees;///< Octets perdus déjà signalés par un événement.
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef LIAISON_DDS_H
+#define LIAISON_DDS_H
+
+#include <Arduino.h>
+
+/**
+ * @class LiaisonDDS
+ * @brief Le "fil" qui mène au DDS : tout ce qu'il faut pour lui faire changer de fréquence.
+ * @details Les mots d'accord sont calculés d'avance ; pour émettre, il ne reste qu'à les
+ * envoyer au DDS, puis à les valider au bon moment. C'est tout ce que demandent les
+ * classes qui émettent (EmetteurFSK...), qui peuvent ainsi servir avec GestionnaireDDS
+ * comme avec PiloteDDS.
+ *
+ * Un appel par cette interface coûte un saut de plus. Pour la validation, donnée sous
+ * interruption, le programme appelle directement son pilote (voir `validerFrequenceDDS()`).
+ */
+class LiaisonDDS {
+public:
+  /**
+   * @brief Envoie un mot d'accord au DDS sans le valider (voir `GestionnaireDDS::prechargerMotAccord()`).
+   */
+  virtual void prechargerMotAccord(uint32_t mot) = 0;
+
+  /**
+   * @brief Fait passer le DDS sur le mot préchargé.
+   */
+  virtual void validerFrequence() = 0;
+
+  /**
+   * @brief Envoie un mot d'accord et le valide.
+   */
+  void chargerMotAccord(uint32_t mot) {
+    prechargerMotAccord(mot);
+    validerFrequence();
+  }
+
+protected:
+  /// Une liaison n'est jamais détruite à travers cette interface : pas besoin d'un destructeur virtuel.
+  ~LiaisonDDS() = default;
+};
+
+#endif
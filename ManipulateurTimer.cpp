@@ -0,0 +1,231 @@
+/**
+ * @file ManipulateurTimer.cpp
+ * @brief Implémentation de la classe ManipulateurTimer.
+ * @details Contient la configuration du Timer3 et la routine d'interruption qui
+ * rejoue les étapes de la file sur les broches du PTT et de la LED d'émission.
+ */
+#include "ManipulateurTimer.h"
+#include "SequenceMorse.h"
+
+// Le Timer3 n'existe que sur les "gros" microcontrôleurs AVR (ATmega1280/2560...).
+#if defined(TIMER3_COMPA_vect)
+#define TIMER3_DISPONIBLE 1
+#else
+#define TIMER3_DISPONIBLE 0
+#endif
+
+/// Fréquence des ticks du timer : l'horloge divisée par 64 (4 µs par tick à 16 MHz).
+static const unsigned long TICKS_PAR_SECONDE = F_CPU / 64;
+
+/// Le manipulateur que la routine d'interruption doit servir.
+static ManipulateurTimer* manipulateurActif = nullptr;
+
+#if TIMER3_DISPONIBLE
+/**
+ * @brief Routine d'interruption du Timer3, appelée une fois par unité Morse.
+ */
+ISR(TIMER3_COMPA_vect) {
+  manipulateurActif->interruption();
+}
+#endif
+
+ManipulateurTimer::ManipulateurTimer()
+  : _portPTT(nullptr), _portLed(nullptr), _masquePTT(0), _masqueLed(0),
+    _ticksParUnite(0), _resteParUnite(0), _diviseur(1), _cumulReste(0),
+    _tete(0), _queue(0), _termine(false), _actif(false), _departDiffere(false), _actionDepart(nullptr),
+    _actionAChaqueEtape(false), _etapesCommencees(0), _unitesRestantes(0),
+    _famines(0), _gigueMaxTicks(0) {}
+
+bool ManipulateurTimer::begin(int pttPin, int txLedPin, int wpm) {
+#if TIMER3_DISPONIBLE
+  // Une unité Morse dure 1,2 s / wpm, soit 6 / (5 × wpm) s.
+  if (wpm <= 0 || !setDureeUnite(6, 5UL * wpm)) return false;
+
+  // On retrouve une fois pour toutes le registre et le bit de chaque broche, pour
+  // pouvoir les commuter en quelques cycles depuis l'interruption.
+  pinMode(pttPin, OUTPUT);
+  pinMode(txLedPin, OUTPUT);
+  _portPTT = portOutputRegister(digitalPinToPort(pttPin));
+  _masquePTT = digitalPinToBitMask(pttPin);
+  _portLed = portOutputRegister(digitalPinToPort(txLedPin));
+  _masqueLed = digitalPinToBitMask(txLedPin);
+
+  manipulateurActif = this;
+  return true;
+#else
+  (void)pttPin;
+  (void)txLedPin;
+  (void)wpm;
+  return false;
+#endif
+}
+
+bool ManipulateurTimer::setDureeUnite(unsigned long numerateur, unsigned long denominateur) {
+#if TIMER3_DISPONIBLE
+  // On garde le reste de la division pour le répartir d'une unité à l'autre : la durée
+  // moyenne est ainsi exacte.
+  if (denominateur == 0 || denominateur > 65535UL || numerateur > 0xFFFFFFFFUL / TICKS_PAR_SECONDE) return false;
+  unsigned long ticksParUnite = (TICKS_PAR_SECONDE * numerateur) / denominateur;
+  if (ticksParUnite < 2 || ticksParUnite > 65535UL) return false;
+  _ticksParUnite = ticksParUnite;
+  _resteParUnite = (TICKS_PAR_SECONDE * numerateur) % denominateur;
+  _diviseur = denominateur;
+  return true;
+#else
+  (void)numerateur;
+  (void)denominateur;
+  return false;
+#endif
+}
+
+void ManipulateurTimer::vider() {
+  _tete = 0;
+  _queue = 0;
+  _termine = false;
+}
+
+bool ManipulateurTimer::ajouterEtape(uint8_t etape) {
+  uint8_t suivante = (_tete + 1) & (TAILLE_FILE - 1);
+  if (suivante == _queue) return false; // File pleine.
+  _file[_tete] = etape;
+  // La case est remplie avant d'avancer la tête : l'interruption ne lit jamais une case à moitié écrite.
+  _tete = suivante;
+  return true;
+}
+
+void ManipulateurTimer::terminer() { _termine = true; }
+
+void ManipulateurTimer::demarrer(unsigned long delaiMicros, ActionDepart action, bool actionAChaqueEtape) {
+#if TIMER3_DISPONIBLE
+  if (delaiMicros > DELAI_MAX_US) delaiMicros = DELAI_MAX_US;
+  unsigned long ticksDelai = (delaiMicros * (TICKS_PAR_SECONDE / 1000)) / 1000;
+
+  noInterrupts();
+  // Mode CTC : le compteur repart de zéro à chaque fois qu'il atteint OCR3A.
+  TCCR3A = 0;
+  TCCR3B = 0;
+  TCNT3 = 0;
+  _cumulReste = 0;
+  _actif = true;
+  _etapesCommencees = 0;
+  // L'action passe juste avant la première étape (voir etapeSuivante()).
+  _actionDepart = action;
+  _actionAChaqueEtape = actionAChaqueEtape;
+  if (ticksDelai < 2) {
+    // La première étape est jouée tout de suite, les suivantes au fil des interruptions.
+    _departDiffere = false;
+    OCR3A = _ticksParUnite - 1;
+    etapeSuivante();
+  } else {
+    // La première interruption tombera à l'heure du départ et jouera la première étape.
+    _departDiffere = true;
+    OCR3A = ticksDelai - 1;
+  }
+  TIFR3 = (1 << OCF3A);
+  TIMSK3 |= (1 << OCIE3A);
+  TCCR3B = (1 << WGM32) | (1 << CS31) | (1 << CS30); // Diviseur par 64.
+  interrupts();
+#else
+  (void)delaiMicros;
+  (void)action;
+  (void)actionAChaqueEtape;
+#endif
+}
+
+bool ManipulateurTimer::estActif() const { return _actif; }
+
+uint16_t ManipulateurTimer::getEtapesCommencees() const {
+  noInterrupts();
+  uint16_t etapes = _etapesCommencees;
+  interrupts();
+  return etapes;
+}
+
+uint16_t ManipulateurTimer::getFamines() const {
+  noInterrupts();
+  uint16_t famines = _famines;
+  interrupts();
+  return famines;
+}
+
+uint16_t ManipulateurTimer::getGigueMaxUs() const {
+  noInterrupts();
+  uint16_t ticks = _gigueMaxTicks;
+  interrupts();
+  return (uint16_t)((ticks * 1000000UL) / TICKS_PAR_SECONDE);
+}
+
+void ManipulateurTimer::reinitialiserStatistiques() {
+  noInterrupts();
+  _famines = 0;
+  _gigueMaxTicks = 0;
+  interrupts();
+}
+
+void ManipulateurTimer::interruption() {
+#if TIMER3_DISPONIBLE
+  // Le compteur est reparti de zéro à la comparaison : sa valeur est le retard avec
+  // lequel on entre ici (autre interruption en cours, section protégée...).
+  uint16_t retard = TCNT3;
+  if (retard > _gigueMaxTicks) _gigueMaxTicks = retard;
+
+  if (_departDiffere) {
+    // C'est l'heure du départ : première étape, puis on passe au rythme des unités.
+    _departDiffere = false;
+    etapeSuivante();
+    OCR3A = _ticksParUnite - 1;
+    return;
+  }
+
+  if (--_unitesRestantes == 0) {
+    etapeSuivante();
+  }
+
+  // Durée de la prochaine unité : un tick de plus de temps en temps pour rattraper le reste.
+  _cumulReste += _resteParUnite;
+  if (_cumulReste >= _diviseur) {
+    _cumulReste -= _diviseur;
+    OCR3A = _ticksParUnite;
+  } else {
+    OCR3A = _ticksParUnite - 1;
+  }
+#endif
+}
+
+void ManipulateurTimer::etapeSuivante() {
+  if (_queue == _tete) {
+    // Plus rien dans la file : on relâche le PTT.
+    *_portPTT &= ~_masquePTT;
+    *_portLed &= ~_masqueLed;
+    if (_termine) {
+      // Fin normale du message : on arrête le timer.
+#if TIMER3_DISPONIBLE
+      TIMSK3 &= ~(1 << OCIE3A);
+      TCCR3B = 0;
+#endif
+      _actif = false;
+    } else {
+      // loop() n'a pas suivi : on compte une famine et on réessaie à l'unité suivante.
+      _famines++;
+      _unitesRestantes = 1;
+    }
+    return;
+  }
+
+  uint8_t etape = _file[_queue];
+  _queue = (_queue + 1) & (TAILLE_FILE - 1);
+  if (_actionDepart != nullptr) {
+    // Juste avant que l'étape ne commence (valider la fréquence préchargée, par exemple).
+    _actionDepart();
+    if (!_actionAChaqueEtape) _actionDepart = nullptr;
+  }
+  _etapesCommencees++;
+  if (SequenceMorse::estSon(etape)) {
+    *_portPTT |= _masquePTT;
+    *_portLed |= _masqueLed;
+  } else {
+    *_portPTT &= ~_masquePTT;
+    *_portLed &= ~_masqueLed;
+  }
+  _unitesRestantes = SequenceMorse::getDuree(etape);
+}
@@ -0,0 +1,157 @@
+#ifndef MANIPULATEUR_TIMER_H
+#define MANIPULATEUR_TIMER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Une action à faire à l'instant exact du départ d'un message (par exemple valider la fréquence du DDS).
+ * @details Elle peut être appelée depuis l'interruption du timer : elle doit donc être très brève.
+ */
+typedef void (*ActionDepart)();
+
+/**
+ * @class ManipulateurTimer
+ * @brief Le "métronome" matériel qui manipule le PTT sous interruption.
+ * @details Même sans `delay()`, les fronts produits depuis `loop()` tremblent de la
+ * durée du reste de la boucle (écran, GPS, port série...). Ce manipulateur confie la
+ * manipulation au Timer3 de l'ATmega2560 : une interruption tombe à chaque unité Morse
+ * et commute le PTT et la LED d'émission au bon moment, quoi que fasse `loop()`.
+ *
+ * Les étapes (au format de SequenceMorse) lui sont transmises par une petite file
+ * circulaire à un seul producteur (`loop()`) et un seul consommateur (l'interruption),
+ * qui n'a besoin d'aucun verrou. Deux statistiques permettent de vérifier le bon
+ * fonctionnement sur le terrain :
+ * - le nombre de "famines" : la file était vide alors que le message n'était pas fini ;
+ * - la gigue maximale : le plus grand retard observé à l'entrée de l'interruption.
+ *
+ * Sur une carte sans Timer3, `begin()` renvoie `false` et l'EmetteurMorse continue à
+ * manipuler lui-même depuis `loop()`.
+ *
+ * La durée de l'unité n'est pas forcément celle du Morse : `setDureeUnite()` la règle à
+ * n'importe quelle fraction de seconde (un quart de symbole WSPR, par exemple). En mode
+ * "action à chaque étape", l'action de départ est rejouée au début de chaque étape :
+ * c'est ainsi que les émissions à déplacement de fréquence (voir EmetteurFSK) valident
+ * le ton suivant, préchargé dans le DDS, à l'instant exact où le symbole commence.
+ */
+class ManipulateurTimer {
+public:
+  /// Taille de la file d'étapes (puissance de 2, pour un calcul de position rapide).
+  static const uint8_t TAILLE_FILE = 32;
+  /// Plus long départ différé possible (le compteur 16 bits du timer déborde vers 262 ms).
+  static const unsigned long DELAI_MAX_US = 250000UL;
+
+  ManipulateurTimer();
+
+  /**
+   * @brief Prépare le timer et les broches à commander.
+   * @param pttPin La broche du PTT.
+   * @param txLedPin La broche de la LED d'émission.
+   * @param wpm Le rythme de manipulation, en mots par minute (5 au minimum).
+   * @return `false` si la carte n'a pas de Timer3 ou si le rythme est hors limites.
+   */
+  bool begin(int pttPin, int txLedPin, int wpm);
+
+  /**
+   * @brief Règle la durée d'une unité, en fraction de seconde : `numerateur / denominateur` s.
+   * @details Le reste de la division en ticks est réparti d'une unité à l'autre : la durée
+   * moyenne est exacte. Exemples : 6 / (5 × wpm) pour le Morse, 128 / 750 pour un quart
+   * de symbole WSPR (8192 / 12000 s). Le timer doit être à l'arrêt.
+   * @return `false` si l'unité est trop courte, trop longue (plus de 262 ms) ou si le dénominateur dépasse 65535.
+   */
+  bool setDureeUnite(unsigned long numerateur, unsigned long denominateur);
+
+  /**
+   * @brief Vide la file avant un nouveau message. Le timer doit être à l'arrêt.
+   */
+  void vider();
+
+  /**
+   * @brief Ajoute une étape en fin de file (côté `loop()`).
+   * @param etape Une étape au format de SequenceMorse.
+   * @return `false` si la file est pleine : il faudra réessayer plus tard.
+   */
+  bool ajouterEtape(uint8_t etape);
+
+  /**
+   * @brief Signale que toutes les étapes du message ont été ajoutées.
+   * @details Une file vide ne sera alors plus comptée comme une famine, mais comme
+   * la fin normale du message.
+   */
+  void terminer();
+
+  /**
+   * @brief Lance la manipulation.
+   * @details Sans délai, la première étape est jouée immédiatement. Avec un délai, c'est
+   * le timer lui-même qui attend avant de la jouer : le départ est alors précis à
+   * quelques microsecondes près, quoi que fasse `loop()` entre-temps.
+   * @param delaiMicros L'attente avant la première étape, au plus `DELAI_MAX_US`.
+   * @param action Une action à faire juste avant la première étape, ou `nullptr`.
+   * @param actionAChaqueEtape `true` pour refaire l'action juste avant chacune des étapes.
+   */
+  void demarrer(unsigned long delaiMicros = 0, ActionDepart action = nullptr, bool actionAChaqueEtape = false);
+
+  /**
+   * @brief Permet de savoir si le timer est encore en train de manipuler.
+   */
+  bool estActif() const;
+
+  /**
+   * @brief Donne le nombre d'étapes commencées depuis `demarrer()`.
+   * @details Permet à `loop()` de savoir quand l'étape suivante a commencé, pour préparer
+   * celle d'après.
+   */
+  uint16_t getEtapesCommencees() const;
+
+  /**
+   * @brief Donne le nombre de fois où la file s'est trouvée vide en plein message.
+   */
+  uint16_t getFamines() const;
+
+  /**
+   * @brief Donne le plus grand retard observé à l'entrée de l'interruption, en microsecondes.
+   */
+  uint16_t getGigueMaxUs() const;
+
+  /**
+   * @brief Remet les deux statistiques à zéro.
+   */
+  void reinitialiserStatistiques();
+
+  /**
+   * @brief Travail fait à chaque interruption du timer (une fois par unité Morse).
+   * @details Appelée uniquement par la routine d'interruption.
+   */
+  void interruption();
+
+private:
+  /**
+   * @brief Interne : retire l'étape suivante de la file et l'applique aux broches.
+   */
+  void etapeSuivante();
+
+  volatile uint8_t* _portPTT;    ///< Registre de sortie de la broche du PTT.
+  volatile uint8_t* _portLed;    ///< Registre de sortie de la broche de la LED d'émission.
+  uint8_t _masquePTT;            ///< Bit de la broche du PTT dans son registre.
+  uint8_t _masqueLed;            ///< Bit de la broche de la LED dans son registre.
+
+  uint16_t _ticksParUnite;       ///< Partie entière de la durée d'une unité, en ticks de 4 µs.
+  uint16_t _resteParUnite;       ///< Reste de la division, réparti d'une unité à l'autre.
+  uint16_t _diviseur;            ///< Le dénominateur de la durée de l'unité (celui du reste).
+  uint16_t _cumulReste;          ///< Accumulateur du reste (méthode de Bresenham).
+
+  volatile uint8_t _file[TAILLE_FILE]; ///< Les étapes en attente.
+  volatile uint8_t _tete;        ///< Prochaine case libre (écrite par `loop()`).
+  volatile uint8_t _queue;       ///< Prochaine étape à jouer (lue par l'interruption).
+  volatile bool _termine;        ///< `true` quand le message complet est dans la file.
+  volatile bool _actif;          ///< `true` tant que le timer manipule.
+  volatile bool _departDiffere;  ///< `true` tant que la première étape attend son heure.
+  ActionDepart _actionDepart;    ///< L'action à faire juste avant la première étape, ou `nullptr`.
+  bool _actionAChaqueEtape;      ///< `true` si l'action est à refaire avant chaque étape.
+  volatile uint16_t _etapesCommencees; ///< Nombre d'étapes commencées depuis le départ.
+  volatile uint8_t _unitesRestantes; ///< Unités restantes pour l'étape en cours.
+
+  volatile uint16_t _famines;    ///< Nombre de files vides en plein message.
+  volatile uint16_t _gigueMaxTicks; ///< Plus grand retard d'entrée en interruption, en ticks.
+};
+
+#endif
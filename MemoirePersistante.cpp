@@ -0,0 +1,226 @@
+/**
+ * @file MemoirePersistante.cpp
+ * @brief Implémentation de la classe MemoirePersistante.
+ * @details Contient la recherche du carnet le plus récent dans l'EEPROM, les
+ * modifications qui ne marquent le carnet comme changé que si une valeur change
+ * vraiment, et l'écriture octet par octet à tour de rôle dans les emplacements.
+ */
+#include "MemoirePersistante.h"
+#include <util/crc16.h>
+
+/// "BA" suivi de la version du format : à changer si `EnregistrementMemoire` change.
+static const uint16_t SIGNATURE = 0xBA03;
+
+/// Taille d'un enregistrement, somme de contrôle comprise.
+static const uint16_t TAILLE_ENREGISTREMENT = sizeof(EnregistrementMemoire);
+/// Nombre d'octets couverts par la somme de contrôle.
+static const uint16_t TAILLE_CONTROLEE = offsetof(EnregistrementMemoire, crc);
+
+MemoirePersistante::MemoirePersistante()
+  : _emplacement(NOMBRE_EMPLACEMENTS - 1), _modifie(false), _ecriture(false), _position(0) {
+  memset(&_enregistrement, 0, sizeof(_enregistrement));
+  memset(&_copie, 0, sizeof(_copie));
+  _enregistrement.signature = SIGNATURE;
+  _enregistrement.dureeCreneau = 1;
+}
+
+uint8_t* MemoirePersistante::adresse(uint8_t emplacement) {
+  return (uint8_t*)(uintptr_t)((uint16_t)emplacement * TAILLE_ENREGISTREMENT);
+}
+
+uint16_t MemoirePersistante::crcEmplacement(uint8_t emplacement) {
+  const uint8_t* source = adresse(emplacement);
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < TAILLE_CONTROLEE; i++) {
+    crc = _crc_ccitt_update(crc, eeprom_read_byte(source + i));
+  }
+  return crc;
+}
+
+uint16_t MemoirePersistante::crcEnregistrement() const {
+  const uint8_t* source = (const uint8_t*)&_enregistrement;
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < TAILLE_CONTROLEE; i++) {
+    crc = _crc_ccitt_update(crc, source[i]);
+  }
+  return crc;
+}
+
+bool MemoirePersistante::charger() {
+  // On lit d'abord la signature et le numéro d'écriture de chaque emplacement : quelques
+  // octets seulement. La somme de contrôle n'est vérifiée que pour le candidat le plus récent.
+  bool dejaEssaye[NOMBRE_EMPLACEMENTS];
+  memset(dejaEssaye, 0, sizeof(dejaEssaye));
+  for (uint8_t essai = 0; essai < NOMBRE_EMPLACEMENTS; essai++) {
+    int8_t meilleur = -1;
+    uint16_t meilleureGeneration = 0;
+    for (uint8_t e = 0; e < NOMBRE_EMPLACEMENTS; e++) {
+      if (dejaEssaye[e]) continue;
+      uint16_t entete[2];
+      eeprom_read_block(entete, adresse(e), sizeof(entete));
+      if (entete[0] != SIGNATURE) continue;
+      // Comparaison "circulaire" : le numéro d'écriture peut repasser par zéro.
+      if (meilleur < 0 || (int16_t)(entete[1] - meilleureGeneration) > 0) {
+        meilleur = e;
+        meilleureGeneration = entete[1];
+      }
+    }
+    if (meilleur < 0) return false; // Plus aucun candidat.
+    dejaEssaye[meilleur] = true;
+
+    uint16_t crc;
+    eeprom_read_block(&crc, adresse(meilleur) + TAILLE_CONTROLEE, sizeof(crc));
+    if (crc != crcEmplacement(meilleur)) continue; // Écriture interrompue : on essaie le précédent.
+
+    eeprom_read_block(&_enregistrement, adresse(meilleur), TAILLE_ENREGISTREMENT);
+    _enregistrement.locator[sizeof(_enregistrement.locator) - 1] = '\0';
+    for (uint8_t i = 0; i < EnregistrementMemoire::NOMBRE_MAX_BALISES; i++) {
+      _enregistrement.balises[i].message[ConfigurationBalise::TAILLE_MESSAGE] = '\0';
+    }
+    _emplacement = meilleur;
+    _modifie = false;
+    return true;
+  }
+  return false;
+}
+
+void MemoirePersistante::importerBalises(const Balise* balisesEnFlash, uint8_t nombre) {
+  if (nombre > EnregistrementMemoire::NOMBRE_MAX_BALISES) nombre = EnregistrementMemoire::NOMBRE_MAX_BALISES;
+  _enregistrement.nombreBalises = nombre;
+  for (uint8_t i = 0; i < nombre; i++) {
+    // La fiche est d'abord recopiée de la flash en RAM ; son message, lui, reste en flash.
+    Balise balise;
+    memcpy_P(&balise, &balisesEnFlash[i], sizeof(Balise));
+    ConfigurationBalise& config = _enregistrement.balises[i];
+    strncpy_P(config.message, balise.getMessage(), ConfigurationBalise::TAILLE_MESSAGE);
+    config.message[ConfigurationBalise::TAILLE_MESSAGE] = '\0';
+    config.frequenceHz = balise.getFrequency();
+    config.brocheFiltre = balise.getFilterPin();
+    config.active = balise.isActive() ? 1 : 0;
+    config.mode = balise.getMode();
+  }
+  _modifie = true;
+}
+
+bool MemoirePersistante::appliquerBalises(Balise* balises, uint8_t nombre) const {
+  if (nombre != _enregistrement.nombreBalises) return false;
+  for (uint8_t i = 0; i < nombre; i++) {
+    const ConfigurationBalise& config = _enregistrement.balises[i];
+    balises[i].setMessage(config.message);
+    balises[i].setFrequency(config.frequenceHz);
+    balises[i].setFilterPin(config.brocheFiltre);
+    balises[i].setActive(config.active != 0);
+    balises[i].setMode(config.mode <= MODE_QRSS ? (ModeBalise)config.mode : MODE_CW);
+  }
+  return true;
+}
+
+bool MemoirePersistante::setMessage(uint8_t balise, const char* message) {
+  if (balise >= _enregistrement.nombreBalises || strlen(message) > ConfigurationBalise::TAILLE_MESSAGE) return false;
+  char* actuel = _enregistrement.balises[balise].message;
+  if (strcmp(actuel, message) != 0) {
+    strcpy(actuel, message);
+    _modifie = true;
+  }
+  return true;
+}
+
+bool MemoirePersistante::setFrequence(uint8_t balise, uint32_t frequenceHz) {
+  if (balise >= _enregistrement.nombreBalises) return false;
+  if (_enregistrement.balises[balise].frequenceHz != frequenceHz) {
+    _enregistrement.balises[balise].frequenceHz = frequenceHz;
+    _modifie = true;
+  }
+  return true;
+}
+
+bool MemoirePersistante::setBrocheFiltre(uint8_t balise, uint8_t broche) {
+  if (balise >= _enregistrement.nombreBalises) return false;
+  if (_enregistrement.balises[balise].brocheFiltre != broche) {
+    _enregistrement.balises[balise].brocheFiltre = broche;
+    _modifie = true;
+  }
+  return true;
+}
+
+bool MemoirePersistante::setActive(uint8_t balise, bool active) {
+  if (balise >= _enregistrement.nombreBalises) return false;
+  uint8_t valeur = active ? 1 : 0;
+  if (_enregistrement.balises[balise].active != valeur) {
+    _enregistrement.balises[balise].active = valeur;
+    _modifie = true;
+  }
+  return true;
+}
+
+bool MemoirePersistante::setMode(uint8_t balise, ModeBalise mode) {
+  if (balise >= _enregistrement.nombreBalises) return false;
+  if (_enregistrement.balises[balise].mode != mode) {
+    _enregistrement.balises[balise].mode = mode;
+    _modifie = true;
+  }
+  return true;
+}
+
+void MemoirePersistante::setPlanning(uint8_t dureeCreneau, uint8_t decalageSite) {
+  if (_enregistrement.dureeCreneau == dureeCreneau && _enregistrement.decalageSite == decalageSite) return;
+  _enregistrement.dureeCreneau = dureeCreneau;
+  _enregistrement.decalageSite = decalageSite;
+  _modifie = true;
+}
+
+void MemoirePersistante::setCorrectionPpb(int32_t ppb) {
+  if (_enregistrement.correctionPpb == ppb) return;
+  _enregistrement.correctionPpb = ppb;
+  _modifie = true;
+}
+
+void MemoirePersistante::setLocator(const char* locator) {
+  if (strncmp(_enregistrement.locator, locator, sizeof(_enregistrement.locator) - 1) == 0) return;
+  strncpy(_enregistrement.locator, locator, sizeof(_enregistrement.locator) - 1);
+  _enregistrement.locator[sizeof(_enregistrement.locator) - 1] = '\0';
+  _modifie = true;
+}
+
+void MemoirePersistante::setDerniereHeure(uint16_t annee, uint8_t mois, uint8_t jour, unsigned long secondeDuJour) {
+  // On ne demande une écriture que lorsqu'elle passe à l'heure suivante (ou que la date
+  // change), soit au plus 24 fois par jour.
+  bool nouvelleHeure = annee != _enregistrement.annee || mois != _enregistrement.mois || jour != _enregistrement.jour ||
+                       secondeDuJour / 3600 != _enregistrement.secondeDuJour / 3600;
+  _enregistrement.annee = annee;
+  _enregistrement.mois = mois;
+  _enregistrement.jour = jour;
+  _enregistrement.secondeDuJour = secondeDuJour;
+  if (nouvelleHeure) _modifie = true;
+}
+
+const char* MemoirePersistante::getLocator() const { return _enregistrement.locator; }
+uint8_t MemoirePersistante::getDureeCreneau() const { return _enregistrement.dureeCreneau; }
+uint8_t MemoirePersistante::getDecalageSite() const { return _enregistrement.decalageSite; }
+int32_t MemoirePersistante::getCorrectionPpb() const { return _enregistrement.correctionPpb; }
+const EnregistrementMemoire& MemoirePersistante::getEnregistrement() const { return _enregistrement; }
+bool MemoirePersistante::ecritureEnCours() const { return _ecriture || _modifie; }
+
+void MemoirePersistante::mettreAJour() {
+  if (!_ecriture) {
+    if (!_modifie) return;
+    // On fige une copie du carnet et on l'écrit dans l'emplacement suivant : le
+    // précédent reste intact tant que celle-ci n'est pas complète.
+    _modifie = false;
+    _enregistrement.generation++;
+    _enregistrement.crc = crcEnregistrement();
+    _copie = _enregistrement;
+    _emplacement = (_emplacement + 1) % NOMBRE_EMPLACEMENTS;
+    _position = 0;
+    _ecriture = true;
+  }
+
+  // Un octet au plus, et seulement si l'EEPROM a fini le précédent : jamais d'attente.
+  // Les réglages changés pendant l'écriture ne touchent pas à la copie : ils seront
+  // écrits par l'enregistrement suivant.
+  if (!eeprom_is_ready()) return;
+  eeprom_update_byte(adresse(_emplacement) + _position, ((const uint8_t*)&_copie)[_position]);
+  if (++_position >= TAILLE_ENREGISTREMENT) {
+    _ecriture = false;
+  }
+}
@@ -0,0 +1,158 @@
+#ifndef MEMOIRE_PERSISTANTE_H
+#define MEMOIRE_PERSISTANTE_H
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include "Balise.h"
+
+/**
+ * @struct ConfigurationBalise
+ * @brief Les réglages d'une balise tels qu'ils sont rangés en EEPROM.
+ */
+struct ConfigurationBalise {
+  static const uint8_t TAILLE_MESSAGE = 40; ///< Longueur maximale du message (avant remplacement des jetons).
+
+  char message[TAILLE_MESSAGE + 1]; ///< Le message, avec ses jetons.
+  uint32_t frequenceHz;             ///< La fréquence, en Hertz.
+  uint8_t brocheFiltre;             ///< La broche du filtre.
+  uint8_t active;                   ///< 1 si la balise participe au programme des émissions.
+  uint8_t mode;                     ///< La façon d'émettre (voir `ModeBalise`).
+};
+
+/**
+ * @struct EnregistrementMemoire
+ * @brief Tout ce que la balise retient d'une mise sous tension à l'autre.
+ * @details La somme de contrôle (CRC-16 CCITT) couvre tous les champs qui la précèdent.
+ */
+struct EnregistrementMemoire {
+  static const uint8_t NOMBRE_MAX_BALISES = 10; ///< Nombre de balises que l'enregistrement peut décrire.
+
+  uint16_t signature;        ///< Reconnaît un enregistrement de ce programme (et de cette version du format).
+  uint16_t generation;       ///< Numéro d'écriture : le plus récent l'emporte.
+  char locator[11];          ///< Le dernier locator calculé par le GPS ("" s'il n'y en a jamais eu).
+  uint16_t annee;            ///< La dernière date UTC connue (0 si jamais).
+  uint8_t mois;
+  uint8_t jour;
+  uint32_t secondeDuJour;    ///< La dernière heure UTC connue, en secondes depuis minuit.
+  uint8_t dureeCreneau;      ///< La durée des créneaux de l'horaire, en minutes.
+  uint8_t decalageSite;      ///< Le décalage de ce site dans la rotation, en créneaux.
+  int32_t correctionPpb;     ///< La correction de l'horloge du DDS, en milliardièmes (voir `GestionnaireDDS::setCorrectionPpb()`).
+  uint8_t nombreBalises;     ///< Le nombre de cases utiles de `balises`.
+  ConfigurationBalise balises[NOMBRE_MAX_BALISES]; ///< Le plan de bandes.
+  uint16_t crc;              ///< La somme de contrôle des champs précédents.
+};
+
+/**
+ * @class MemoirePersistante
+ * @brief Le "carnet de bord" de la balise, rangé dans l'EEPROM.
+ * @details Le carnet retient le dernier locator, la dernière heure UTC, la correction
+ * d'horloge du DDS et le plan de bandes (messages, fréquences, filtres, bandes actives,
+ * horaire). Au démarrage, la balise reprend donc tout de suite un locator connu, et
+ * l'étalonnage comme le plan de bandes peuvent être changés depuis la console sans
+ * reprogrammer la carte.
+ *
+ * Pour ménager l'EEPROM (environ 100 000 écritures par case) :
+ * - l'EEPROM est découpée en plusieurs emplacements, écrits à tour de rôle ;
+ * - rien n'est écrit tant qu'aucune valeur n'a vraiment changé, et l'heure seule ne
+ *   provoque qu'une écriture par heure ;
+ * - l'écriture se fait octet par octet, un octet chaque fois que l'EEPROM est libre,
+ *   depuis `mettreAJour()` : elle ne bloque jamais la boucle (3,3 ms par octet sinon).
+ *   Elle part d'une copie figée du carnet, que les modifications faites pendant ce
+ *   temps ne touchent pas.
+ *
+ * La somme de contrôle est écrite en dernier : un enregistrement interrompu par une
+ * coupure de courant est simplement ignoré, et le précédent reste valable.
+ */
+class MemoirePersistante {
+public:
+  /// Nombre d'emplacements utilisés à tour de rôle dans l'EEPROM.
+  static const uint8_t NOMBRE_EMPLACEMENTS = (E2END + 1) / sizeof(EnregistrementMemoire);
+
+  MemoirePersistante();
+
+  /**
+   * @brief Relit le carnet le plus récent et valide dans l'EEPROM.
+   * @details Seule la somme de contrôle du plus récent est vérifiée (et des suivants s'il
+   * est abîmé) : la lecture prend environ une milliseconde.
+   * @return `false` si aucun enregistrement valide n'a été trouvé (EEPROM neuve, format changé...).
+   */
+  bool charger();
+
+  /**
+   * @brief Remplit le plan de bandes à partir du plan de bandes du programme.
+   * @details Utilisé au premier démarrage, quand l'EEPROM ne contient encore rien.
+   * @param balisesEnFlash Les balises du programme, rangées en mémoire flash (PROGMEM),
+   * tout comme les textes de leurs messages.
+   * @param nombre Le nombre de balises.
+   */
+  void importerBalises(const Balise* balisesEnFlash, uint8_t nombre);
+
+  /**
+   * @brief Recopie le plan de bandes dans les balises du programme.
+   * @details Les messages des balises pointent alors sur ceux du carnet.
+   * @return `false` si le carnet ne décrit pas le même nombre de balises : elles gardent alors leurs réglages.
+   */
+  bool appliquerBalises(Balise* balises, uint8_t nombre) const;
+
+  bool setMessage(uint8_t balise, const char* message);     ///< Change le message d'une balise (`false` si trop long).
+  bool setFrequence(uint8_t balise, uint32_t frequenceHz);  ///< Change la fréquence d'une balise.
+  bool setBrocheFiltre(uint8_t balise, uint8_t broche);     ///< Change la broche du filtre d'une balise.
+  bool setActive(uint8_t balise, bool active);              ///< Active ou désactive une balise.
+  bool setMode(uint8_t balise, ModeBalise mode);            ///< Change la façon d'émettre d'une balise.
+  void setPlanning(uint8_t dureeCreneau, uint8_t decalageSite); ///< Change l'horaire des émissions.
+  void setCorrectionPpb(int32_t ppb);                       ///< Change la correction d'horloge du DDS.
+
+  /**
+   * @brief Retient le dernier locator calculé par le GPS.
+   */
+  void setLocator(const char* locator);
+
+  /**
+   * @brief Retient la dernière heure UTC connue.
+   * @details Une nouvelle écriture n'est demandée que si l'heure (au sens des 60
+   * minutes) ou la date a changé depuis la dernière fois.
+   */
+  void setDerniereHeure(uint16_t annee, uint8_t mois, uint8_t jour, unsigned long secondeDuJour);
+
+  const char* getLocator() const;          ///< Le dernier locator connu ("" s'il n'y en a pas).
+  uint8_t getDureeCreneau() const;         ///< La durée des créneaux de l'horaire, en minutes.
+  uint8_t getDecalageSite() const;         ///< Le décalage de ce site dans la rotation, en créneaux.
+  int32_t getCorrectionPpb() const;        ///< La correction d'horloge du DDS, en milliardièmes.
+  const EnregistrementMemoire& getEnregistrement() const; ///< Tout le carnet, pour l'afficher.
+
+  /**
+   * @brief Fait avancer l'écriture du carnet s'il a changé. À appeler régulièrement.
+   * @details Écrit au plus un octet par appel, et seulement si l'EEPROM est libre.
+   */
+  void mettreAJour();
+
+  /**
+   * @brief Permet de savoir si une écriture est en cours ou en attente.
+   */
+  bool ecritureEnCours() const;
+
+private:
+  /**
+   * @brief Interne : calcule la somme de contrôle d'un enregistrement rangé dans l'EEPROM.
+   */
+  static uint16_t crcEmplacement(uint8_t emplacement);
+
+  /**
+   * @brief Interne : calcule la somme de contrôle de l'enregistrement en mémoire vive.
+   */
+  uint16_t crcEnregistrement() const;
+
+  /**
+   * @brief Interne : l'adresse d'un emplacement dans l'EEPROM.
+   */
+  static uint8_t* adresse(uint8_t emplacement);
+
+  EnregistrementMemoire _enregistrement; ///< Le carnet en mémoire vive.
+  EnregistrementMemoire _copie;          ///< Le carnet tel qu'il est en train d'être écrit.
+  uint8_t _emplacement;                  ///< L'emplacement du dernier enregistrement valide.
+  bool _modifie;                         ///< `true` si le carnet a changé depuis la dernière écriture.
+  bool _ecriture;                        ///< `true` pendant qu'un enregistrement est en train d'être écrit.
+  uint16_t _position;                    ///< Le prochain octet à écrire.
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file Ordonnanceur.cpp
+ * @brief Implémentation de la classe Ordonnanceur.
+ * @details Contient le passage en revue des tâches prêtes et la mesure de leurs
+ * durées et de leurs retards.
+ */
+#include "Ordonnanceur.h"
+
+Ordonnanceur::Ordonnanceur() : _nombreTaches(0), _passageMaxUs(0), _dernierPassageUs(0) {}
+
+bool Ordonnanceur::ajouterTache(const char* nom, FonctionTache fonction, unsigned long periodeUs,
+                                unsigned long delaiMaxUs, uint8_t priorite) {
+  if (_nombreTaches >= NOMBRE_MAX_TACHES) return false;
+
+  // On insère la tâche à sa place : le tableau reste trié par priorité, et le
+  // passage n'a plus qu'à le parcourir dans l'ordre.
+  uint8_t position = _nombreTaches;
+  while (position > 0 && _taches[position - 1].priorite > priorite) {
+    _taches[position] = _taches[position - 1];
+    position--;
+  }
+
+  Tache& tache = _taches[position];
+  tache.nom = nom;
+  tache.fonction = fonction;
+  tache.periodeUs = periodeUs;
+  tache.delaiMaxUs = delaiMaxUs;
+  tache.priorite = priorite;
+  tache.echeance = micros();
+  effacerStatistiques(tache);
+  _nombreTaches++;
+  return true;
+}
+
+void Ordonnanceur::executer() {
+  unsigned long debutPassage = micros();
+  for (uint8_t i = 0; i < _nombreTaches; i++) {
+    Tache& tache = _taches[i];
+    unsigned long maintenant = micros();
+    if ((long)(maintenant - tache.echeance) >= 0) {
+      lancer(tache, maintenant);
+    }
+  }
+  unsigned long duree = micros() - debutPassage;
+  _dernierPassageUs = duree;
+  if (duree > _passageMaxUs) _passageMaxUs = duree;
+}
+
+void Ordonnanceur::lancer(Tache& tache, unsigned long maintenant) {
+  unsigned long retard = maintenant - tache.echeance;
+  if (retard > tache.retardMaxUs) tache.retardMaxUs = retard;
+  if (retard > tache.delaiMaxUs && tache.echeancesManquees < 0xFFFF) tache.echeancesManquees++;
+
+  tache.fonction();
+
+  unsigned long duree = micros() - maintenant;
+  if (duree > tache.dureeMaxUs) tache.dureeMaxUs = duree;
+  // Avant que la somme ne déborde, on divise somme et nombre par deux : la moyenne ne change pas.
+  if (tache.sommeDureesUs > 0x7FFFFFFFUL) {
+    tache.sommeDureesUs /= 2;
+    tache.executions /= 2;
+  }
+  tache.sommeDureesUs += duree;
+  tache.executions++;
+
+  if (tache.periodeUs == 0) {
+    // Sans période, la tâche est toujours prête : son retard se compte depuis son démarrage précédent.
+    tache.echeance = maintenant;
+  } else {
+    // L'échéance suivante est comptée depuis la précédente, pour ne pas dériver...
+    tache.echeance += tache.periodeUs;
+    // ... sauf si on a pris plus d'une période de retard : on repart alors de maintenant.
+    if ((long)(maintenant - tache.echeance) >= 0) tache.echeance = maintenant + tache.periodeUs;
+  }
+}
+
+void Ordonnanceur::afficherStatistiques(Print& sortie) const {
+  sortie.println(F("Tache       prio  max(us)  moy(us)  retard max(us)  manquees"));
+  for (uint8_t i = 0; i < _nombreTaches; i++) {
+    const Tache& tache = _taches[i];
+    sortie.print(tache.nom);
+    for (uint8_t n = strlen(tache.nom); n < 12; n++) sortie.print(' ');
+    sortie.print(tache.priorite);
+    sortie.print(F("  "));
+    sortie.print(tache.dureeMaxUs);
+    sortie.print(F("  "));
+    sortie.print(tache.executions > 0 ? tache.sommeDureesUs / tache.executions : 0);
+    sortie.print(F("  "));
+    sortie.print(tache.retardMaxUs);
+    sortie.print(F("  "));
+    sortie.println(tache.echeancesManquees);
+  }
+  sortie.print(F("Passage complet max (us) : "));
+  sortie.println(_passageMaxUs);
+}
+
+void Ordonnanceur::reinitialiserStatistiques() {
+  for (uint8_t i = 0; i < _nombreTaches; i++) {
+    effacerStatistiques(_taches[i]);
+  }
+  _passageMaxUs = 0;
+}
+
+void Ordonnanceur::effacerStatistiques(Tache& tache) {
+  tache.dureeMaxUs = 0;
+  tache.sommeDureesUs = 0;
+  tache.executions = 0;
+  tache.retardMaxUs = 0;
+  tache.echeancesManquees = 0;
+}
+
+unsigned long Ordonnanceur::getPassageMaxUs() const { return _passageMaxUs; }
+unsigned long Ordonnanceur::getDernierPassageUs() const { return _dernierPassageUs; }
@@ -0,0 +1,107 @@
+#ifndef ORDONNANCEUR_H
+#define ORDONNANCEUR_H
+
+#include <Arduino.h>
+
+/// Une tâche de l'ordonnanceur : une simple fonction, sans paramètre.
+typedef void (*FonctionTache)();
+
+/**
+ * @class Ordonnanceur
+ * @brief Le "chef d'orchestre" qui donne la parole, tour à tour, à chaque tâche de `loop()`.
+ * @details Chaque travail de la balise (écouter le GPS, manipuler, rafraîchir
+ * l'écran...) est enregistré comme une tâche, avec :
+ * - une période : la tâche est relancée toutes les N microsecondes, ou à chaque
+ *   passage si la période est nulle ;
+ * - un délai maximal : si la tâche démarre plus tard que cela après l'instant où elle
+ *   aurait dû démarrer (ou, pour une tâche sans période, après son démarrage
+ *   précédent), on compte une échéance manquée ;
+ * - une priorité : à chaque passage, les tâches prêtes sont lancées de la plus
+ *   prioritaire (0) à la moins prioritaire.
+ *
+ * Les tâches sont coopératives : chacune doit rendre la main rapidement. Pour le
+ * vérifier, l'ordonnanceur mesure la durée de chaque exécution (maximale et
+ * moyenne) et la durée maximale d'un passage complet, qui borne le temps qu'une
+ * tâche peut attendre son tour. Ces statistiques s'affichent avec `afficherStatistiques()`.
+ */
+class Ordonnanceur {
+public:
+  /// Nombre maximal de tâches (le tableau est réservé une fois pour toutes).
+  static const uint8_t NOMBRE_MAX_TACHES = 12;
+
+  Ordonnanceur();
+
+  /**
+   * @brief Enregistre une nouvelle tâche.
+   * @param nom Un nom court pour les statistiques (le texte doit rester valide).
+   * @param fonction La fonction à appeler.
+   * @param periodeUs La période, en microsecondes (0 : à chaque passage).
+   * @param delaiMaxUs Le retard au-delà duquel on compte une échéance manquée.
+   * @param priorite La priorité, 0 étant la plus forte.
+   * @return `false` si le tableau des tâches est plein.
+   */
+  bool ajouterTache(const char* nom, FonctionTache fonction, unsigned long periodeUs,
+                    unsigned long delaiMaxUs, uint8_t priorite);
+
+  /**
+   * @brief Fait un passage : lance, par ordre de priorité, toutes les tâches prêtes.
+   * @details À appeler depuis `loop()`, et seulement depuis `loop()`.
+   */
+  void executer();
+
+  /**
+   * @brief Affiche, pour chaque tâche, ses durées d'exécution et ses échéances manquées.
+   * @param sortie Où afficher les statistiques (par exemple `Serial`).
+   */
+  void afficherStatistiques(Print& sortie) const;
+
+  /**
+   * @brief Remet toutes les statistiques à zéro.
+   */
+  void reinitialiserStatistiques();
+
+  /**
+   * @brief Donne la durée maximale d'un passage complet, en microsecondes.
+   */
+  unsigned long getPassageMaxUs() const;
+
+  /**
+   * @brief Donne la durée du dernier passage, en microsecondes (pour la télémétrie).
+   */
+  unsigned long getDernierPassageUs() const;
+
+private:
+  /**
+   * @brief Une tâche enregistrée et ses statistiques.
+   */
+  struct Tache {
+    const char* nom;
+    FonctionTache fonction;
+    unsigned long periodeUs;
+    unsigned long delaiMaxUs;
+    uint8_t priorite;
+    unsigned long echeance;        ///< Instant (micros()) où la tâche doit démarrer.
+    unsigned long dureeMaxUs;      ///< Plus longue exécution.
+    unsigned long sommeDureesUs;   ///< Somme des durées, pour la moyenne.
+    unsigned long executions;      ///< Nombre d'exécutions comptées dans la somme.
+    unsigned long retardMaxUs;     ///< Plus grand retard au démarrage.
+    uint16_t echeancesManquees;    ///< Nombre de démarrages plus tardifs que le délai maximal.
+  };
+
+  /**
+   * @brief Interne : lance une tâche et met à jour ses statistiques.
+   */
+  void lancer(Tache& tache, unsigned long maintenant);
+
+  /**
+   * @brief Interne : remet à zéro les statistiques d'une tâche.
+   */
+  static void effacerStatistiques(Tache& tache);
+
+  Tache _taches[NOMBRE_MAX_TACHES]; ///< Les tâches, rangées par priorité.
+  uint8_t _nombreTaches;
+  unsigned long _passageMaxUs;      ///< Plus long passage complet.
+  unsigned long _dernierPassageUs;  ///< Durée du dernier passage.
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef PILOTE_DDS_H
+#define PILOTE_DDS_H
+
+#include <Arduino.h>
+#include "BrocheRapide.h"
+#include "GestionnaireDDS.h"
+#include "LiaisonDDS.h"
+
+/**
+ * @class PiloteDDS
+ * @brief La "télécommande" du DDS, réglée une fois pour toutes par le compilateur.
+ * @details Le pilote du programme de la balise. Le même travail que GestionnaireDDS,
+ * quand la puce, son horloge et son câblage sont connus à la compilation :
+ * - l'horloge nominale, l'octet de contrôle et les mots d'accord des fréquences
+ *   constantes sont calculés par le compilateur (`motAccord()` est `constexpr`) ;
+ * - chaque front de W_CLK, DATA ou FQ_UD est une seule instruction (voir BrocheRapide) ;
+ * - l'octet de contrôle étant constant, ses 8 bits sont envoyés sans calcul, et les
+ *   32 bits du mot sont décalés sur 32 bits plutôt que 64.
+ *
+ * Seule la correction d'horloge, mesurée sur chaque carte, se règle pendant le
+ * fonctionnement : `calculerMotAccord()` et `calculerMotAccordPrecis()` en tiennent
+ * compte, avec les calculs de GestionnaireDDS. Il n'y a pas de choix du transport.
+ *
+ * Exemple, pour un module AD9851 à quartz de 30 MHz :
+ * @code
+ * PiloteDDS<PUCE_AD9851, 30000000UL, 26, 28, 30, 32> dds;
+ * constexpr uint32_t MOT_30M = decltype(dds)::motAccord(10140100UL);
+ * dds.begin();
+ * dds.chargerMotAccord(MOT_30M);
+ * @endcode
+ *
+ * @tparam PUCE Le modèle de DDS.
+ * @tparam REFERENCE_HZ La fréquence nominale de l'oscillateur de référence du module.
+ * @tparam W_CLK, FQ_UD, DATA, RESET Les broches de connexion.
+ */
+template <PuceDDS PUCE, uint32_t REFERENCE_HZ, uint8_t W_CLK, uint8_t FQ_UD, uint8_t DATA, uint8_t RESET>
+class PiloteDDS final : public LiaisonDDS {
+public:
+  /// La vitesse nominale de l'horloge de travail, PLL comprise.
+  static constexpr uint32_t HORLOGE_HZ = GestionnaireDDS::horlogeNominale(PUCE, REFERENCE_HZ);
+  /// L'octet de contrôle, envoyé après chaque mot d'accord.
+  static constexpr uint8_t OCTET_CONTROLE = GestionnaireDDS::octetControle(PUCE);
+
+  static_assert(HORLOGE_HZ / GestionnaireDDS::multiplicateur(PUCE) == REFERENCE_HZ, "Horloge de reference trop rapide");
+  static_assert(HORLOGE_HZ <= (PUCE == PUCE_AD9851 ? 180000000UL : 125000000UL), "Horloge au-dela de ce que la puce accepte");
+
+  PiloteDDS() : _horlogeHz(HORLOGE_HZ), _correction_ppb(0), _nombreChargements(0) {}
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence, à l'horloge nominale.
+   * @details Utilisable par le compilateur (voir `GestionnaireDDS::calculerMotAccord()`) ;
+   * sans correction d'horloge.
+   */
+  static constexpr uint32_t motAccord(unsigned long frequency) { return GestionnaireDDS::calculerMotAccord(frequency, HORLOGE_HZ); }
+
+  /**
+   * @brief Donne l'ordre de 40 bits envoyé pour un mot d'accord.
+   */
+  static constexpr uint64_t ordre(uint32_t mot) { return GestionnaireDDS::ordre(mot, PUCE); }
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence, correction d'horloge comprise.
+   */
+  uint32_t calculerMotAccord(unsigned long frequency) const { return GestionnaireDDS::calculerMotAccord(frequency, _horlogeHz); }
+
+  /**
+   * @brief Calcule le mot d'accord d'une fréquence donnée au 1/256 de hertz près, correction comprise.
+   * @details Voir `GestionnaireDDS::calculerMotAccordPrecis()`.
+   */
+  uint32_t calculerMotAccordPrecis(uint64_t frequence256) const {
+    return GestionnaireDDS::calculerMotAccordPrecis(frequence256, _horlogeHz);
+  }
+
+  /**
+   * @brief Corrige l'écart de l'horloge de référence (voir `GestionnaireDDS::setCorrectionPpb()`).
+   * @return `false` si l'écart n'est pas acceptable (voir `GestionnaireDDS::correctionValide()`) : la correction en cours est alors gardée.
+   */
+  bool setCorrectionPpb(long ppb) {
+    if (!GestionnaireDDS::correctionValide(ppb)) return false;
+    _correction_ppb = ppb;
+    _horlogeHz = GestionnaireDDS::horlogeCorrigee(HORLOGE_HZ, ppb);
+    return true;
+  }
+
+  long getCorrectionPpb() const { return _correction_ppb; }                 ///< La correction d'horloge en cours, en milliardièmes.
+  uint32_t getHorlogeHz() const { return _horlogeHz; }                      ///< L'horloge utilisée pour les calculs, correction comprise.
+  unsigned long getNombreChargements() const { return _nombreChargements; } ///< Le nombre de mots envoyés depuis `begin()`.
+
+  /**
+   * @brief Allume et prépare le module DDS (comme `GestionnaireDDS::begin()`).
+   */
+  void begin() {
+    BrocheRapide<W_CLK>::sortie();
+    BrocheRapide<FQ_UD>::sortie();
+    BrocheRapide<DATA>::sortie();
+    BrocheRapide<RESET>::sortie();
+    BrocheRapide<W_CLK>::bas();
+    BrocheRapide<FQ_UD>::bas();
+    BrocheRapide<RESET>::haut();
+    BrocheRapide<RESET>::bas();
+    _nombreChargements = 0;
+  }
+
+  /**
+   * @brief Envoie un mot d'accord au DDS sans le valider (voir `GestionnaireDDS::prechargerMotAccord()`).
+   */
+  void prechargerMotAccord(uint32_t mot) override {
+    _nombreChargements++;
+    for (uint8_t i = 0; i < 32; i++, mot >>= 1) envoyerBit(mot & 1);
+    // Constants, les 8 bits de contrôle se réduisent à des fronts sans calcul.
+    for (uint8_t i = 0; i < 8; i++) envoyerBit((OCTET_CONTROLE >> i) & 1);
+  }
+
+  /**
+   * @brief Fait passer le DDS sur le mot préchargé : deux instructions, utilisable sous interruption.
+   */
+  void validerFrequence() override {
+    BrocheRapide<FQ_UD>::haut();
+    BrocheRapide<FQ_UD>::bas();
+  }
+
+  /**
+   * @brief Envoie un mot d'accord et le valide.
+   */
+  void chargerMotAccord(uint32_t mot) {
+    prechargerMotAccord(mot);
+    validerFrequence();
+  }
+
+  /**
+   * @brief Produit une fréquence, correction d'horloge comprise.
+   * @details Sans correction, `chargerMotAccord(motAccord(frequence))` laisse le calcul au compilateur.
+   */
+  void setFrequency(unsigned long frequency) { chargerMotAccord(calculerMotAccord(frequency)); }
+
+private:
+  /// Interne : un bit sur DATA, lu par le DDS au front montant de W_CLK.
+  static void envoyerBit(bool bit) {
+    BrocheRapide<DATA>::ecrire(bit);
+    BrocheRapide<W_CLK>::haut();
+    BrocheRapide<W_CLK>::bas();
+  }
+
+  uint32_t _horlogeHz;              ///< La vitesse de l'horloge de travail, corrigée, pour les calculs.
+  long _correction_ppb;             ///< L'écart de l'horloge par rapport à sa valeur nominale, en milliardièmes.
+  unsigned long _nombreChargements; ///< Nombre de mots envoyés au DDS.
+};
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file PlanningBalises.cpp
+ * @brief Implémentation de la classe PlanningBalises.
+ * @details Contient le calcul de l'ordre de passage des balises actives, avec le
+ * calage des balises WSPR sur les minutes paires, et la recherche de la balise d'une
+ * minute donnée.
+ */
+#include "PlanningBalises.h"
+
+PlanningBalises::PlanningBalises(Balise* balises, uint8_t nombreBalises, uint8_t dureeCreneauMinutes, uint8_t decalageSite)
+  : _balises(balises), _nombreBalises(nombreBalises > NOMBRE_MAX_BALISES ? NOMBRE_MAX_BALISES : nombreBalises),
+    _dureeCreneau(dureeCreneauMinutes > 0 ? dureeCreneauMinutes : 1), _decalageSite(decalageSite), _nombreCreneaux(0), _nombreActives(0) {}
+
+void PlanningBalises::calculer() {
+  _nombreCreneaux = 0;
+  _nombreActives = 0;
+  // Avec des créneaux d'une durée paire, tous commencent à une minute paire. Sinon, le
+  // créneau n° c commence à une minute de même parité que c, et la case n° p du tour
+  // sert au créneau c = p - décalage (à un nombre pair de tours près, voir plus bas).
+  bool creneauxImpairs = _dureeCreneau % 2 != 0;
+  bool calageWSPR = false;
+  for (uint8_t i = 0; i < _nombreBalises; i++) {
+    if (!_balises[i].isActive()) continue;
+    _nombreActives++;
+    if (creneauxImpairs && _balises[i].getMode() == MODE_WSPR) {
+      calageWSPR = true;
+      if ((_nombreCreneaux + _decalageSite) % 2 != 0) _ordre[_nombreCreneaux++] = CRENEAU_LIBRE;
+      _ordre[_nombreCreneaux++] = i;
+      if (_dureeCreneau == 1) _ordre[_nombreCreneaux++] = i; // La deuxième minute.
+    } else {
+      _ordre[_nombreCreneaux++] = i;
+    }
+  }
+  // Un tour impair inverserait la parité des minutes à chaque tour.
+  if (calageWSPR && _nombreCreneaux % 2 != 0) _ordre[_nombreCreneaux++] = CRENEAU_LIBRE;
+}
+
+int8_t PlanningBalises::baliseDeLaMinute(uint16_t minuteDuJour) const {
+  if (_nombreCreneaux == 0) return AUCUNE_BALISE;
+  uint16_t creneau = minuteDuJour / _dureeCreneau;
+  uint8_t balise = _ordre[(creneau + _decalageSite) % _nombreCreneaux];
+  return balise == CRENEAU_LIBRE ? AUCUNE_BALISE : (int8_t)balise;
+}
+
+bool PlanningBalises::peutCommencerWSPR(uint16_t minuteDuJour) const {
+  int8_t balise = baliseDeLaMinute(minuteDuJour);
+  return minuteDuJour % 2 == 0 && balise != AUCUNE_BALISE && baliseDeLaMinute((minuteDuJour + 1) % 1440) == balise;
+}
+
+void PlanningBalises::setDureeCreneau(uint8_t minutes) { _dureeCreneau = minutes > 0 ? minutes : 1; }
+void PlanningBalises::setDecalageSite(uint8_t creneaux) { _decalageSite = creneaux; }
+uint8_t PlanningBalises::getDureeCreneau() const { return _dureeCreneau; }
+uint8_t PlanningBalises::getDecalageSite() const { return _decalageSite; }
+uint8_t PlanningBalises::getNombreActives() const { return _nombreActives; }
@@ -0,0 +1,96 @@
+#ifndef PLANNING_BALISES_H
+#define PLANNING_BALISES_H
+
+#include <Arduino.h>
+#include "Balise.h"
+
+/**
+ * @class PlanningBalises
+ * @brief L'"horaire" qui dit quelle balise émet à quelle minute.
+ * @details Plutôt que de passer d'une balise à la suivante à chaque émission (ce qui
+ * décale tout le programme après un redémarrage ou une minute manquée), la balise
+ * à émettre est déduite directement de l'heure UTC, à la manière des balises
+ * NCDXF/IARU :
+ * - la journée est découpée en créneaux de quelques minutes ;
+ * - les balises actives se succèdent, un créneau chacune, dans l'ordre du tableau ;
+ * - un décalage de site (en créneaux) permet à deux stations de se partager les
+ *   mêmes bandes sans émettre en même temps sur la même ;
+ * - une balise WSPR, qui émet près de deux minutes à partir d'une minute paire, reçoit
+ *   deux minutes qui commencent à une minute paire : avec des créneaux d'une minute,
+ *   elle en occupe deux, et si besoin un créneau libre la précède pour la caler. Le
+ *   tour compte alors un nombre pair de créneaux, pour que le calage tienne d'un tour
+ *   à l'autre (deux sites qui se partagent les bandes prennent alors des décalages de
+ *   même parité).
+ *
+ * Deux balises réglées de la même façon émettent donc toujours sur la même bande à
+ * la même minute, et la balise retrouve sa place dans le programme dès que l'heure
+ * est connue. L'ordre des balises actives est calculé une fois pour toutes par
+ * `calculer()` : trouver la balise d'une minute ne coûte ensuite qu'une division et
+ * une lecture de tableau.
+ */
+class PlanningBalises {
+public:
+  /// Nombre maximal de balises dans le programme.
+  static const uint8_t NOMBRE_MAX_BALISES = 16;
+  /// Nombre maximal de créneaux d'un tour : chaque balise WSPR peut en prendre trois.
+  static const uint8_t NOMBRE_MAX_CRENEAUX = 3 * NOMBRE_MAX_BALISES + 1;
+  /// Valeur rendue quand aucune balise n'est active, ou pour un créneau laissé libre.
+  static const int8_t AUCUNE_BALISE = -1;
+
+  /**
+   * @brief Construit l'horaire à partir de la liste des balises.
+   * @param balises Le tableau des balises (il doit rester valide).
+   * @param nombreBalises Le nombre de balises du tableau (au plus `NOMBRE_MAX_BALISES`).
+   * @param dureeCreneauMinutes La durée d'un créneau, en minutes (1 au minimum).
+   * @param decalageSite Le décalage de ce site dans la rotation, en créneaux.
+   */
+  PlanningBalises(Balise* balises, uint8_t nombreBalises, uint8_t dureeCreneauMinutes = 1, uint8_t decalageSite = 0);
+
+  /**
+   * @brief Recalcule l'ordre des balises actives.
+   * @details À appeler au démarrage, puis après chaque changement de réglage
+   * (balise activée ou désactivée, durée de créneau, décalage).
+   */
+  void calculer();
+
+  /**
+   * @brief Donne la balise qui émet pendant une minute donnée.
+   * @param minuteDuJour Le nombre de minutes depuis minuit UTC (0 à 1439).
+   * @return Le numéro de la balise dans le tableau, ou `AUCUNE_BALISE`.
+   */
+  int8_t baliseDeLaMinute(uint16_t minuteDuJour) const;
+
+  /**
+   * @brief Permet de savoir si une émission WSPR peut commencer pendant une minute donnée.
+   * @details Il faut une minute paire, et que la minute suivante revienne à la même balise.
+   * @param minuteDuJour Le nombre de minutes depuis minuit UTC (0 à 1439).
+   */
+  bool peutCommencerWSPR(uint16_t minuteDuJour) const;
+
+  /**
+   * @brief Change la durée des créneaux (pensez ensuite à `calculer()`).
+   */
+  void setDureeCreneau(uint8_t minutes);
+
+  /**
+   * @brief Change le décalage de ce site dans la rotation (pensez ensuite à `calculer()`).
+   */
+  void setDecalageSite(uint8_t creneaux);
+
+  uint8_t getDureeCreneau() const;   ///< La durée d'un créneau, en minutes.
+  uint8_t getDecalageSite() const;   ///< Le décalage de ce site, en créneaux.
+  uint8_t getNombreActives() const;  ///< Le nombre de balises qui participent à la rotation.
+
+private:
+  Balise* _balises;                        ///< Le tableau des balises.
+  uint8_t _nombreBalises;                  ///< Le nombre de balises du tableau.
+  uint8_t _dureeCreneau;                   ///< La durée d'un créneau, en minutes.
+  uint8_t _decalageSite;                   ///< Le décalage de ce site, en créneaux.
+  uint8_t _ordre[NOMBRE_MAX_CRENEAUX];     ///< La balise de chaque créneau du tour (`CRENEAU_LIBRE` : aucune).
+  uint8_t _nombreCreneaux;                 ///< Le nombre de cases utiles de `_ordre`.
+  uint8_t _nombreActives;                  ///< Le nombre de balises actives.
+
+  static const uint8_t CRENEAU_LIBRE = 0xFF; ///< Dans `_ordre` : un créneau où personne n'émet.
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file SequenceMorse.cpp
+ * @brief Implémentation de la classe SequenceMorse.
+ * @details Contient le dictionnaire Morse et la traduction d'un message texte en
+ * suite d'étapes son/silence prête à être rejouée par l'EmetteurMorse.
+ */
+#include "SequenceMorse.h"
+#include <string.h>
+
+/// Le dictionnaire (voir SequenceMorse.h), rangé en mémoire flash : il est lu avec `pgm_read_byte()`.
+constexpr uint8_t SequenceMorse::CODES_MORSE[] PROGMEM;
+
+/// Premier caractère présent dans le dictionnaire (l'espace).
+static const char PREMIER_CARACTERE = ' ';
+/// Dernier caractère présent dans le dictionnaire ('_').
+static const char DERNIER_CARACTERE = '_';
+
+/// Bit de l'étape indiquant un son (PTT appuyé).
+static const uint8_t ETAPE_SON = 0x80;
+/// Durée maximale d'une étape, limitée par les 7 bits disponibles.
+static const uint8_t DUREE_MAX_ETAPE = 0x7F;
+
+SequenceMorse::SequenceMorse() : _nombreEtapes(0), _dureeUnites(0), _tronquee(false) {}
+
+uint8_t SequenceMorse::codeMorse(char c) {
+  c = toupper((unsigned char)c); // On met en majuscule pour correspondre à notre dictionnaire.
+  if (c < PREMIER_CARACTERE || c > DERNIER_CARACTERE) return 0;
+  return pgm_read_byte(&CODES_MORSE[c - PREMIER_CARACTERE]);
+}
+
+bool SequenceMorse::compiler(const char* message, uint16_t unitesMax) {
+  _nombreEtapes = 0;
+  _dureeUnites = 0;
+  _tronquee = false;
+
+  for (; *message; message++) {
+    if (*message == ' ') {
+      // Un espace entre mots dure 7 unités, dont 3 sont déjà comptées après la lettre précédente.
+      if (!ajouterSilence(4)) {
+        _tronquee = true;
+        break;
+      }
+      continue;
+    }
+
+    // On mémorise où on en était pour pouvoir retirer le caractère s'il ne tient pas.
+    uint16_t nombreEtapes = _nombreEtapes;
+    uint16_t dureeUnites = _dureeUnites;
+    bool place = true;
+
+    if (*message == '<') {
+      // Signe de procédure, par exemple "<SK>" : les lettres sont enchaînées sans
+      // espace entre elles, comme un seul caractère.
+      const char* fin = strchr(message, '>');
+      if (fin == nullptr) continue; // Chevron isolé : on l'ignore.
+      for (const char* p = message + 1; p < fin && place; p++) {
+        place = ajouterCode(codeMorse(*p));
+      }
+      message = fin;
+    } else {
+      uint8_t code = codeMorse(*message);
+      if (code == 0) continue; // Caractère inconnu : on l'ignore.
+      place = ajouterCode(code);
+    }
+
+    // L'espace entre deux lettres dure 3 unités au total. Ces 3 unités de silence ne
+    // comptent pas encore dans le temps d'antenne.
+    if (!place || !ajouterSilence(2) || _dureeUnites - 3 > unitesMax) {
+      _nombreEtapes = nombreEtapes;
+      _dureeUnites = dureeUnites;
+      _tronquee = true;
+      break;
+    }
+  }
+
+  // Le silence final ne fait pas partie de l'émission : on le retire.
+  while (_nombreEtapes > 0 && !estSon(_etapes[_nombreEtapes - 1])) {
+    _nombreEtapes--;
+    _dureeUnites -= getDuree(_etapes[_nombreEtapes]);
+  }
+  return !_tronquee;
+}
+
+bool SequenceMorse::ajouterCode(uint8_t code) {
+  // On "joue" les éléments en partant du bit de poids faible, jusqu'à la sentinelle.
+  for (; code > 1; code >>= 1) {
+    // Le "trait" dure 3 unités, le "point" une seule, et chacun est suivi d'une unité de silence.
+    if (!ajouterSon((code & 1) ? 3 : 1) || !ajouterSilence(1)) return false;
+  }
+  return true;
+}
+
+bool SequenceMorse::ajouterSon(uint8_t unites) {
+  if (_nombreEtapes >= TAILLE_MAX) return false;
+  _etapes[_nombreEtapes++] = ETAPE_SON | unites;
+  _dureeUnites += unites;
+  return true;
+}
+
+bool SequenceMorse::ajouterSilence(uint8_t unites) {
+  // Si l'étape précédente est déjà un silence, on l'allonge plutôt que d'en créer une nouvelle.
+  if (_nombreEtapes > 0) {
+    uint8_t& precedente = _etapes[_nombreEtapes - 1];
+    if (!estSon(precedente) && getDuree(precedente) + unites <= DUREE_MAX_ETAPE) {
+      precedente += unites;
+      _dureeUnites += unites;
+      return true;
+    }
+  }
+  if (_nombreEtapes >= TAILLE_MAX) return false;
+  _etapes[_nombreEtapes++] = unites;
+  _dureeUnites += unites;
+  return true;
+}
+
+uint16_t SequenceMorse::getNombreEtapes() const { return _nombreEtapes; }
+uint16_t SequenceMorse::getDureeUnites() const { return _dureeUnites; }
+bool SequenceMorse::estTronquee() const { return _tronquee; }
+
+unsigned long SequenceMorse::getDureeMs(int wpm) const {
+  // Un "point" dure 1200 / wpm millisecondes.
+  return ((unsigned long)_dureeUnites * 1200UL) / wpm;
+}
@@ -0,0 +1,180 @@
+#ifndef SEQUENCE_MORSE_H
+#define SEQUENCE_MORSE_H
+
+#include <Arduino.h>
+
+/**
+ * @class SequenceMorse
+ * @brief La "partition" d'un message Morse, préparée une fois pour toutes avant l'émission.
+ * @details Plutôt que de relire le texte et le dictionnaire Morse à chaque point ou trait,
+ * on traduit tout le message d'avance en une suite d'étapes : "son pendant N unités",
+ * "silence pendant N unités"... Chaque étape tient dans un seul octet :
+ * - le bit de poids fort vaut 1 pour un son (PTT appuyé), 0 pour un silence ;
+ * - les 7 autres bits donnent la durée de l'étape, en unités Morse (durée d'un "point").
+ *
+ * Le texte peut contenir toute la ponctuation UIT, ainsi que des signes de procédure
+ * écrits entre chevrons ("<SK>", "<AR>"...) dont les lettres sont enchaînées.
+ *
+ * Les silences consécutifs sont fusionnés, et le silence final est retiré : la somme
+ * des durées donne donc exactement le temps d'antenne du message, connu avant même
+ * d'appuyer sur le PTT.
+ */
+class SequenceMorse {
+public:
+  /// Nombre maximal d'étapes mémorisées (environ 2 étapes par point ou trait).
+  static const uint16_t TAILLE_MAX = 256;
+
+  SequenceMorse();
+
+  /**
+   * @brief Traduit un message texte en suite d'étapes.
+   * @details Les caractères inconnus sont ignorés, minuscules et majuscules sont
+   * équivalentes. Si le message complet dépasse `unitesMax` (ou la capacité de la
+   * séquence), on s'arrête au dernier caractère qui tient entièrement : le message
+   * est alors tronqué.
+   * @param message Le texte à traduire.
+   * @param unitesMax La durée d'antenne à ne pas dépasser, en unités Morse.
+   * @return `true` si le message a été traduit en entier, `false` s'il a été tronqué.
+   */
+  bool compiler(const char* message, uint16_t unitesMax = 0xFFFF);
+
+  /**
+   * @brief Donne le nombre d'étapes de la séquence.
+   */
+  uint16_t getNombreEtapes() const;
+
+  /**
+   * @brief Lit une étape de la séquence (voir `estSon()` et `getDuree()` pour la décoder).
+   * @param index Le numéro de l'étape (0 pour la première).
+   */
+  uint8_t getEtape(uint16_t index) const { return _etapes[index]; }
+
+  /**
+   * @brief Donne la durée d'antenne totale du message, en unités Morse.
+   */
+  uint16_t getDureeUnites() const;
+
+  /**
+   * @brief Donne la durée d'antenne totale du message, en millisecondes.
+   * @param wpm Le rythme de manipulation, en mots par minute.
+   */
+  unsigned long getDureeMs(int wpm) const;
+
+  /**
+   * @brief Permet de savoir si le dernier message compilé a dû être raccourci.
+   */
+  bool estTronquee() const;
+
+  /**
+   * @brief Convertit une durée en nombre d'unités Morse entières (arrondi par défaut).
+   * @param dureeMs La durée, en millisecondes.
+   * @param wpm Le rythme de manipulation, en mots par minute.
+   */
+  static constexpr uint16_t unitesPourDuree(unsigned long dureeMs, int wpm) {
+    return (dureeMs * wpm) / 1200UL > 0xFFFF ? 0xFFFF : (uint16_t)((dureeMs * wpm) / 1200UL);
+  }
+
+  /**
+   * @brief Cherche le code Morse d'un caractère dans le dictionnaire en mémoire flash.
+   * @details Le code tient sur un octet : les éléments se lisent à partir du bit de poids
+   * faible (1 pour un "trait", 0 pour un "point") jusqu'au dernier bit à 1, qui sert de
+   * sentinelle.
+   * @param c Le caractère (minuscule ou majuscule).
+   * @return Le code, ou 0 si le caractère n'a pas d'équivalent Morse.
+   */
+  static uint8_t codeMorse(char c);
+
+  /**
+   * @brief Le temps d'antenne qu'ajoute un caractère au message, en unités Morse.
+   * @details Pour le compilateur seulement (voir `GenerateurMessage::unitesMorseMax()`) :
+   * il lit le dictionnaire directement, ce que la carte ne sait pas faire en mémoire
+   * flash. Les éléments, leurs silences et l'espace qui suit la lettre sont comptés ;
+   * un espace vaut 4 unités, un caractère sans code n'en vaut aucune.
+   */
+  static constexpr uint16_t unitesCaractere(char c) {
+    return c == ' ' ? 4 : codeDictionnaire(c) == 0 ? 0 : unitesCode(codeDictionnaire(c)) + 2;
+  }
+
+  /**
+   * @brief Le nombre de points et de traits d'un caractère (pour le compilateur seulement).
+   */
+  static constexpr uint8_t elementsCaractere(char c) { return elementsCode(codeDictionnaire(c)); }
+
+  /// `true` si l'étape correspond à un son (PTT appuyé).
+  static bool estSon(uint8_t etape) { return etape & 0x80; }
+
+  /// Durée de l'étape, en unités Morse.
+  static uint8_t getDuree(uint8_t etape) { return etape & 0x7F; }
+
+private:
+  /**
+   * @brief Dictionnaire de traduction vers le Morse, rangé en mémoire flash (PROGMEM).
+   * @details Chaque caractère imprimable de l'ASCII 32 (espace) à 95 ('_') a sa case,
+   * trouvée directement grâce à son code ASCII. Un seul octet suffit par caractère :
+   * - on lit les éléments en partant du bit de poids faible, 1 pour un "trait", 0 pour un "point" ;
+   * - le bit à 1 le plus à gauche est une sentinelle qui marque la fin du code.
+   *
+   * Exemple : 'A' (".-") vaut 0b110 = 0x06. Une case à 0 désigne un caractère sans code.
+   * Jusqu'à 7 éléments tiennent dans un octet, ce qui couvre toute la ponctuation UIT.
+   * Les signes '+' (AR), '=' (BT) et '&' (AS) servent aussi de signes de procédure.
+   */
+  static constexpr uint8_t CODES_MORSE[64] = {
+    /* ' ' */ 0x00, /* '!' */ 0x75, /* '"' */ 0x52, /* '#' */ 0x00,
+    /* '$' */ 0xC8, /* '%' */ 0x00, /* '&' */ 0x22, /* ''' */ 0x5E,
+    /* '(' */ 0x2D, /* ')' */ 0x6D, /* '*' */ 0x00, /* '+' */ 0x2A,
+    /* ',' */ 0x73, /* '-' */ 0x61, /* '.' */ 0x6A, /* '/' */ 0x29,
+    /* '0' */ 0x3F, /* '1' */ 0x3E, /* '2' */ 0x3C, /* '3' */ 0x38,
+    /* '4' */ 0x30, /* '5' */ 0x20, /* '6' */ 0x21, /* '7' */ 0x23,
+    /* '8' */ 0x27, /* '9' */ 0x2F, /* ':' */ 0x47, /* ';' */ 0x55,
+    /* '<' */ 0x00, /* '=' */ 0x31, /* '>' */ 0x00, /* '?' */ 0x4C,
+    /* '@' */ 0x56, /* 'A' */ 0x06, /* 'B' */ 0x11, /* 'C' */ 0x15,
+    /* 'D' */ 0x09, /* 'E' */ 0x02, /* 'F' */ 0x14, /* 'G' */ 0x0B,
+    /* 'H' */ 0x10, /* 'I' */ 0x04, /* 'J' */ 0x1E, /* 'K' */ 0x0D,
+    /* 'L' */ 0x12, /* 'M' */ 0x07, /* 'N' */ 0x05, /* 'O' */ 0x0F,
+    /* 'P' */ 0x16, /* 'Q' */ 0x1B, /* 'R' */ 0x0A, /* 'S' */ 0x08,
+    /* 'T' */ 0x03, /* 'U' */ 0x0C, /* 'V' */ 0x18, /* 'W' */ 0x0E,
+    /* 'X' */ 0x19, /* 'Y' */ 0x1D, /* 'Z' */ 0x13, /* '[' */ 0x00,
+    /* '\' */ 0x00, /* ']' */ 0x00, /* '^' */ 0x00, /* '_' */ 0x6C
+  };
+
+  /// Interne : le code d'un caractère, lu par le compilateur (minuscules comprises).
+  static constexpr uint8_t codeDictionnaire(char c) {
+    return c >= 'a' && c <= 'z' ? CODES_MORSE[c - 'a' + 'A' - ' '] : c >= ' ' && c <= '_' ? CODES_MORSE[c - ' '] : 0;
+  }
+
+  /// Interne : la durée des éléments d'un code, chacun suivi de son unité de silence.
+  static constexpr uint16_t unitesCode(uint8_t code) {
+    return code > 1 ? ((code & 1) ? 4 : 2) + unitesCode(code >> 1) : 0;
+  }
+
+  /// Interne : le nombre d'éléments d'un code.
+  static constexpr uint8_t elementsCode(uint8_t code) { return code > 1 ? 1 + elementsCode(code >> 1) : 0; }
+
+  /**
+   * @brief Interne : ajoute les points et les traits d'un code du dictionnaire.
+   * @details Chaque élément est suivi d'une unité de silence ; l'espace entre lettres
+   * reste à ajouter par l'appelant.
+   * @param code Le code sur un octet (voir `codeMorse()`).
+   * @return `false` si la séquence est pleine.
+   */
+  bool ajouterCode(uint8_t code);
+
+  /**
+   * @brief Interne : ajoute un son de la durée demandée.
+   * @return `false` si la séquence est pleine.
+   */
+  bool ajouterSon(uint8_t unites);
+
+  /**
+   * @brief Interne : ajoute un silence, fusionné avec le silence précédent si possible.
+   * @return `false` si la séquence est pleine.
+   */
+  bool ajouterSilence(uint8_t unites);
+
+  uint8_t _etapes[TAILLE_MAX]; ///< Les étapes, un octet chacune.
+  uint16_t _nombreEtapes;      ///< Nombre d'étapes utilisées.
+  uint16_t _dureeUnites;       ///< Somme des durées de toutes les étapes.
+  bool _tronquee;              ///< `true` si le dernier message n'a pas pu être compilé en entier.
+};
+
+#endif
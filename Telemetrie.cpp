@@ -0,0 +1,122 @@
+/**
+ * @file Telemetrie.cpp
+ * @brief Implémentation de la classe Telemetrie.
+ * @details Contient les mesures et la construction de la trame binaire.
+ *
+ * Les données de la trame (version 1), toutes en petit-boutiste :
+ * | Octets | Contenu |
+ * | :----- | :------ |
+ * | 1      | version (1) |
+ * | 4      | instant de l'envoi, en ms depuis la mise sous tension |
+ * | 4      | nombre de passages de la boucle depuis la trame précédente |
+ * | 2 × 16 | histogramme des durées de passage |
+ * | 2      | plus long passage, en µs |
+ * | 2      | plus petite mémoire libre, en octets |
+ * | 1      | plus grand nombre d'octets en attente dans le port du GPS |
+ * | 4      | phrases NMEA valides |
+ * | 4      | phrases NMEA rejetées pour leur somme de contrôle |
+ * | 2      | famines du manipulateur |
+ * | 2      | gigue maximale du manipulateur, en µs |
+ * | 4      | mots envoyés au DDS |
+ * | 4      | octets envoyés à l'écran |
+ * | 4      | octets perdus par le journal |
+ */
+#include "Telemetrie.h"
+#include <util/crc16.h>
+
+#if defined(__AVR__)
+// Fournis par l'éditeur de liens et par malloc() : le début du tas, et son sommet actuel.
+extern char __heap_start;
+extern char* __brkval;
+#endif
+
+static const uint8_t SYNCHRO_1 = 0xA5;
+static const uint8_t SYNCHRO_2 = 0x5A;
+static const uint8_t TYPE_TELEMETRIE = 'T';
+static const uint8_t VERSION = 1;
+/// Taille des données de la trame (voir le tableau ci-dessus).
+static const uint8_t TAILLE_DONNEES = 1 + 4 + 4 + 2 * Telemetrie::NOMBRE_CASES + 2 + 2 + 1 + 4 + 4 + 2 + 2 + 4 + 4 + 4;
+
+/**
+ * @brief Petit assistant qui écrit des entiers petit-boutistes dans un tableau.
+ */
+class Ecrivain {
+public:
+  explicit Ecrivain(uint8_t* destination) : _position(destination) {}
+  void octet(uint8_t valeur) { *_position++ = valeur; }
+  void mot(uint16_t valeur) { octet(valeur & 0xFF); octet(valeur >> 8); }
+  void long32(uint32_t valeur) { mot(valeur & 0xFFFF); mot(valeur >> 16); }
+private:
+  uint8_t* _position;
+};
+
+Telemetrie::Telemetrie() : _passages(0), _memoireLibreMin(0xFFFF) {
+  memset(_histogramme, 0, sizeof(_histogramme));
+}
+
+void Telemetrie::noterPassage(unsigned long dureeUs) {
+  // La case est le nombre de bits de la durée : au plus 16 décalages d'un mot de 16 bits.
+  uint16_t reste = dureeUs > 0xFFFFUL ? 0xFFFF : (uint16_t)dureeUs;
+  uint8_t caseDuree = 0;
+  while (reste != 0) {
+    reste >>= 1;
+    caseDuree++;
+  }
+  if (caseDuree >= NOMBRE_CASES) caseDuree = NOMBRE_CASES - 1;
+  if (_histogramme[caseDuree] != 0xFFFF) _histogramme[caseDuree]++;
+  _passages++;
+  noterMemoire();
+}
+
+uint16_t Telemetrie::memoireLibre() {
+#if defined(__AVR__)
+  // La pile descend vers le tas : l'adresse d'une variable locale est le bas de la pile.
+  char basDePile;
+  char* hautDuTas = __brkval != 0 ? __brkval : &__heap_start;
+  return (uint16_t)(&basDePile - hautDuTas);
+#else
+  return 0;
+#endif
+}
+
+void Telemetrie::noterMemoire() {
+  uint16_t libre = memoireLibre();
+  if (libre < _memoireLibreMin) _memoireLibreMin = libre;
+}
+
+bool Telemetrie::envoyer(const ReleveTelemetrie& releve, Journal& journal) {
+  uint8_t trame[4 + TAILLE_DONNEES + 2];
+  Ecrivain ecrivain(trame);
+  ecrivain.octet(SYNCHRO_1);
+  ecrivain.octet(SYNCHRO_2);
+  ecrivain.octet(TYPE_TELEMETRIE);
+  ecrivain.octet(TAILLE_DONNEES);
+
+  ecrivain.octet(VERSION);
+  ecrivain.long32(millis());
+  ecrivain.long32(_passages);
+  for (uint8_t i = 0; i < NOMBRE_CASES; i++) ecrivain.mot(_histogramme[i]);
+  ecrivain.mot(releve.passageMaxUs);
+  ecrivain.mot(_memoireLibreMin);
+  ecrivain.octet(releve.attenteMaxGPS);
+  ecrivain.long32(releve.phrasesNMEA);
+  ecrivain.long32(releve.erreursNMEA);
+  ecrivain.mot(releve.famines);
+  ecrivain.mot(releve.gigueMaxUs);
+  ecrivain.long32(releve.chargementsDDS);
+  ecrivain.long32(releve.octetsLCD);
+  ecrivain.long32(releve.octetsPerdusJournal);
+
+  // La somme de contrôle couvre le type, la longueur et les données.
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 2; i < 4 + TAILLE_DONNEES; i++) crc = _crc_ccitt_update(crc, trame[i]);
+  ecrivain.mot(crc);
+
+  if (!journal.ecrireEnEntier(trame, sizeof(trame))) return false;
+
+  // Nouvelle période de mesure.
+  memset(_histogramme, 0, sizeof(_histogramme));
+  _passages = 0;
+  _memoireLibreMin = 0xFFFF;
+  return true;
+}
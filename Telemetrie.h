@@ -0,0 +1,80 @@
+#ifndef TELEMETRIE_H
+#define TELEMETRIE_H
+
+#include <Arduino.h>
+#include "Journal.h"
+
+/**
+ * @struct ReleveTelemetrie
+ * @brief Les compteurs tenus par les autres classes, recopiés juste avant l'envoi d'une trame.
+ */
+struct ReleveTelemetrie {
+  uint16_t passageMaxUs;         ///< Le plus long passage de l'ordonnanceur (depuis le démarrage ou "TACHES RAZ").
+  uint8_t attenteMaxGPS;         ///< Le plus grand nombre d'octets trouvés en attente dans le port du GPS.
+  unsigned long phrasesNMEA;     ///< Phrases NMEA valides depuis le démarrage.
+  unsigned long erreursNMEA;     ///< Phrases NMEA rejetées pour leur somme de contrôle.
+  uint16_t famines;              ///< Famines du manipulateur depuis le démarrage.
+  uint16_t gigueMaxUs;           ///< Gigue maximale du manipulateur, en µs.
+  unsigned long chargementsDDS;  ///< Mots envoyés au DDS depuis le démarrage.
+  unsigned long octetsLCD;       ///< Octets envoyés à l'écran depuis le démarrage.
+  unsigned long octetsPerdusJournal; ///< Octets perdus par le journal depuis le démarrage.
+};
+
+/**
+ * @class Telemetrie
+ * @brief Le "carnet de santé" de la balise, envoyé en trames binaires compactes.
+ * @details Pour surveiller une balise sans personne à côté, la télémétrie tient :
+ * - un histogramme des durées de passage de la boucle principale, par puissances de 2
+ *   (la case n compte les passages de 2^(n-1) à 2^n - 1 µs, la dernière tous les plus longs) ;
+ * - la plus petite mémoire libre observée entre la pile et le tas ;
+ * - et, au moment de l'envoi, les compteurs des autres classes (voir ReleveTelemetrie).
+ *
+ * Chaque mesure ne coûte que quelques instructions : la télémétrie peut rester active en
+ * service. La trame est rangée d'un bloc dans le Journal, et se présente ainsi (petit-boutiste) :
+ *
+ *     A5 5A | type 'T' | longueur | données (version 1) | CRC-16 CCITT (type, longueur, données)
+ *
+ * Les données sont décrites dans Telemetrie.cpp, et décodées par `outils/decoder_telemetrie.py`.
+ * Après chaque envoi, l'histogramme et les maximums repartent de zéro ; les compteurs
+ * depuis le démarrage, eux, ne font que croître.
+ */
+class Telemetrie {
+public:
+  /// Nombre de cases de l'histogramme des durées de passage.
+  static const uint8_t NOMBRE_CASES = 16;
+
+  Telemetrie();
+
+  /**
+   * @brief Compte un passage de la boucle principale, et mesure la mémoire libre.
+   * @param dureeUs La durée du passage, en microsecondes.
+   */
+  void noterPassage(unsigned long dureeUs);
+
+  /**
+   * @brief Mesure la mémoire libre entre la pile et le tas, et retient la plus petite.
+   * @details À appeler aussi depuis les fonctions les plus gourmandes en pile.
+   */
+  void noterMemoire();
+
+  /**
+   * @brief Donne la mémoire libre en ce moment, entre le haut du tas et le bas de la pile.
+   */
+  static uint16_t memoireLibre();
+
+  /**
+   * @brief Construit la trame et la range d'un bloc dans le journal.
+   * @param releve Les compteurs des autres classes.
+   * @param journal Le journal où ranger la trame.
+   * @return `false` si le journal n'avait pas la place (la trame est perdue, mais les
+   * mesures ne sont pas effacées).
+   */
+  bool envoyer(const ReleveTelemetrie& releve, Journal& journal);
+
+private:
+  uint16_t _histogramme[NOMBRE_CASES]; ///< Nombre de passages par case de durée.
+  unsigned long _passages;             ///< Nombre de passages depuis la trame précédente.
+  uint16_t _memoireLibreMin;           ///< La plus petite mémoire libre observée.
+};
+
+#endif
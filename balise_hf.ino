@@ -5,164 +5,918 @@
  * au démarrage, puis entre dans une boucle infinie où il attend le bon moment
  * (le début de chaque minute) pour déclencher une émission Morse sur une
  * bande radio-amateur.
+ *
+ * Chaque émission est préparée pendant la dernière seconde de la minute, puis
+ * programmée pour l'instant exact où la minute suivante commence (à la
+ * milliseconde près, et mieux encore avec le PPS du GPS et le timer de manipulation).
+ *
+ * Une balise peut aussi émettre en WSPR ou en QRSS (voir EmetteurFSK) : la porteuse
+ * reste alors en place et c'est sa fréquence qui change, symbole après symbole.
  */
 
 // On inclut les "plans de construction" de nos objets personnalisés.
 // Chaque fichier .h est comme une notice de montage pour un composant logiciel.
 #include "GestionnaireGPS.h"
 #include "GestionnaireDDS.h"
+#include "PiloteDDS.h"
 #include "EmetteurMorse.h"
+#include "EmetteurFSK.h"
 #include "Balise.h"
+#include "GenerateurMessage.h"
+#include "GestionnaireLCD.h"
+#include "Ordonnanceur.h"
+#include "PlanningBalises.h"
+#include "CommutateurFiltres.h"
+#include "MemoirePersistante.h"
+#include "Journal.h"
+#include "Telemetrie.h"
+#include "GestionnaireVeille.h"
 
 // --- CONFIGURATION MATERIELLE : C'est ici qu'on dit au programme où sont branchés les composants ---
 
 // -- Broches pour les indicateurs visuels et la commande d'émission --
+const int BROCHE_LED_EMISSION = 23; ///< La LED rouge qui s'allume pendant l'émission.
 const int BROCHE_PTT = 24;          ///< La broche qui commande l'ampli pour passer en émission (Push-To-Talk).
 
+// -- Broche de l'impulsion PPS du GPS (facultative) --
+const int BROCHE_PPS = 2;           ///< La sortie PPS du GPS, sur une broche d'interruption.
+const bool UTILISER_PPS = true;     ///< `true` : le début de chaque seconde est donné par le PPS ; sinon par l'arrivée des phrases NMEA.
+
+// -- Écran LCD I2C (branché sur SDA/SCL) --
+const uint8_t ADRESSE_LCD = 0x27;   ///< L'adresse I2C de l'adaptateur PCF8574 de l'écran.
+const uint8_t LCD_COLONNES = 20;
+const uint8_t LCD_LIGNES = 4;
+const uint16_t BUDGET_OCTETS_LCD = 4;          ///< Nombre maximal d'octets envoyés à l'écran à chaque passage dans loop().
+const bool MESURER_LCD_AU_DEMARRAGE = false;   ///< `true` : affiche au démarrage la durée d'un rafraîchissement complet et d'un rafraîchissement partiel.
+
 // -- Broches pour le composant qui génère la fréquence radio (DDS) --
-const int BROCHE_DDS_W_CLK = 26;
-const int BROCHE_DDS_FQ_UD = 28;
-const int BROCHE_DDS_DATA = 30;
-const int BROCHE_DDS_RESET = 32;
+const uint8_t BROCHE_DDS_W_CLK = 26;
+const uint8_t BROCHE_DDS_FQ_UD = 28;
+const uint8_t BROCHE_DDS_DATA = 30;
+const uint8_t BROCHE_DDS_RESET = 32;
+const PuceDDS PUCE_DDS = PUCE_AD9850;                   ///< Le modèle de DDS : PUCE_AD9850, ou PUCE_AD9851 (référence multipliée par 6).
+const uint32_t HORLOGE_REFERENCE_DDS_HZ = 125000000UL;  ///< L'oscillateur du module : 125 MHz pour un AD9850, 30 MHz pour un AD9851.
+const bool MESURER_DDS_AU_DEMARRAGE = false; ///< `true` : affiche au démarrage la durée d'un chargement de fréquence pour chaque transport de GestionnaireDDS et pour PiloteDDS.
+const long CORRECTION_HORLOGE_DDS_PPB = 0;    ///< Écart mesuré de l'horloge du DDS, en milliardièmes, pris au premier démarrage (ensuite : "PPB <valeur>", gardé en EEPROM).
 
 // -- Broches pour les filtres et les LEDs de chaque bande --
 // Pour chaque bande, on a une broche pour activer le bon filtre et une autre pour allumer une LED.
-const int BROCHE_FILTRE_80M = 34
-const int BROCHE_FILTRE_40M = 35
-const int BROCHE_FILTRE_30M = 36
-const int BROCHE_FILTRE_20M = 37
-const int BROCHE_FILTRE_17M = 38
-const int BROCHE_FILTRE_15M = 39
-const int BROCHE_FILTRE_12M = 40
-const int BROCHE_FILTRE_10M = 41
-const int BROCHE_FILTRE_6M  = 42
+const int BROCHE_FILTRE_80M = 34;
+const int BROCHE_FILTRE_40M = 35;
+const int BROCHE_FILTRE_30M = 36;
+const int BROCHE_FILTRE_20M = 37;
+const int BROCHE_FILTRE_17M = 38;
+const int BROCHE_FILTRE_15M = 39;
+const int BROCHE_FILTRE_12M = 40;
+const int BROCHE_FILTRE_10M = 41;
+const int BROCHE_FILTRE_6M  = 42;
+const uint16_t STABILISATION_RELAIS_MS = 10; ///< Temps d'ouverture ou de fermeture d'un relais de filtre (à ajuster filtre par filtre dans setup()).
 
 // --- CONFIGURATION DU RYTHME DU MORSE ---
 const int MORSE_MOT_PAR_MINUTE = 15; ///< Vitesse de la transmission Morse.
+const unsigned long DUREE_MAX_EMISSION_MS = 58500; ///< Durée d'antenne maximale d'un message : il doit finir avant la dernière seconde, où se prépare le suivant.
+const bool TRONQUER_MESSAGES_TROP_LONGS = true;     ///< `true` : un message trop long est raccourci ; `false` : il n'est pas émis.
+const uint16_t BUDGET_OCTETS_GPS = 32;              ///< Nombre maximal d'octets du GPS lus à chaque passage dans loop().
+const size_t TAILLE_MESSAGE_MAX = 64;               ///< Place réservée au message final, une fois les jetons remplacés.
+const bool MANIPULATION_PAR_TIMER = true;           ///< `true` : les fronts du PTT sont produits sous interruption (Timer3), indépendamment de loop().
+
+// --- CONFIGURATION DES MODES WSPR ET QRSS (voir "BANDE <n> MODE ...") ---
+const int8_t PUISSANCE_WSPR_DBM = 30;               ///< Puissance annoncée dans les messages WSPR, en dBm (0, 3, 7, 10, 13... 60).
+const unsigned long QRSS_DUREE_POINT_MS = 3000;     ///< Durée d'un point en QRSS, en millisecondes (3000 : QRSS3).
+const uint16_t QRSS_ECART_TONS_256E_HZ = 5 * 256;   ///< Écart entre le ton des silences et celui des points et traits en QRSS, en 1/256 de hertz.
+
+// --- CONFIGURATION DU PORT SÉRIE ---
+const unsigned long VITESSE_CONSOLE = 115200;       ///< Vitesse du moniteur série, en bauds (à régler pareil dans l'IDE).
+const NiveauJournal NIVEAU_JOURNAL = NIVEAU_INFO;   ///< Niveau de détail du journal au démarrage (modifiable par la console : "JOURNAL <0-3>").
+const unsigned long PERIODE_TELEMETRIE_S = 300;     ///< Intervalle entre deux trames de télémétrie, en secondes (0 : seulement sur demande, "TELEMETRIE").
+
+// --- CONFIGURATION DE LA CONSOMMATION ---
+const bool VEILLE_ENTRE_EMISSIONS = true; ///< `true` : entre deux émissions, le microcontrôleur dort jusqu'à la prochaine interruption (modifiable par la console : "VEILLE ON|OFF").
+
+// --- CONFIGURATION DU DÉMARRAGE ---
+const char LOCATOR_PAR_DEFAUT[] = ""; ///< Locator de la station, émis tant que le GPS n'a pas de position ("" : attendre la position avant la première émission).
+const unsigned long LOCATOR_STABLE_MS = 600000UL; ///< Durée pendant laquelle le locator calculé doit rester le même avant d'être retenu en EEPROM.
+
+// --- CONFIGURATION DE L'HORAIRE DES ÉMISSIONS ---
+const uint8_t DUREE_CRENEAU_MINUTES = 1; ///< Durée pendant laquelle une même balise émet, avant de céder la place à la suivante.
+const uint8_t DECALAGE_SITE = 0;         ///< Décalage de ce site dans la rotation, en créneaux (pour partager les bandes avec une autre balise).
 
 // --- CRÉATION DES OBJETS : On "fabrique" nos assistants logiciels ---
 // Chaque objet est un spécialiste dans son domaine.
 GestionnaireGPS gestionGPS(Serial1); // L'expert qui sait parler au module GPS.
-GestionnaireDDS gestionDDS(BROCHE_DDS_W_CLK, BROCHE_DDS_FQ_UD, BROCHE_DDS_DATA, BROCHE_DDS_RESET); // Le pilote du générateur de fréquence.
+PiloteDDS<PUCE_DDS, HORLOGE_REFERENCE_DDS_HZ, BROCHE_DDS_W_CLK, BROCHE_DDS_FQ_UD, BROCHE_DDS_DATA, BROCHE_DDS_RESET> piloteDDS; // Le pilote du générateur de fréquence, câblé par le compilateur.
 EmetteurMorse   emetteurMorse(BROCHE_PTT, BROCHE_LED_EMISSION, MORSE_MOT_PAR_MINUTE); // Le télégraphiste qui connaît le Morse.
+ManipulateurTimer manipulateurTimer; // Le métronome matériel qui peut manipuler à la place du télégraphiste.
+EmetteurFSK     emetteurFSK(piloteDDS); // Le chanteur qui émet en WSPR et en QRSS, en changeant de ton au rythme du métronome.
+GenerateurMessage generateurMessage; // Le secrétaire qui remplit les jetons (#LOCA#, #HHMM#...) des messages.
+GestionnaireLCD gestionLCD(ADRESSE_LCD, LCD_COLONNES, LCD_LIGNES); // L'afficheur qui tient l'opérateur au courant.
+Ordonnanceur ordonnanceur; // Le chef d'orchestre qui donne la parole à chaque tâche de la boucle principale.
+CommutateurFiltres commutateurFiltres; // L'aiguilleur qui change de filtre sans jamais en engager deux à la fois.
+MemoirePersistante memoire; // Le carnet de bord, rangé en EEPROM, qui survit aux coupures de courant.
+Journal journal(Serial); // Le secrétaire qui note tout dans un tampon, et ne fait jamais attendre la balise.
+Telemetrie telemetrie; // Le carnet de santé, envoyé en trames binaires pour surveiller la balise à distance.
+GestionnaireVeille veille; // Le veilleur de nuit, qui laisse la balise somnoler entre deux émissions.
 
 // --- LISTE DES EMISSIONS À FAIRE : Le programme de la balise ---
 // On définit ici chaque émission que la balise devra faire, l'une après l'autre.
-// Format : { "Message à envoyer", Fréquence en MHz, Broche du Filtre, Broche de la LED }
-Balise balises[] = {
-  //Balise("CQ DE F6KJU #LOCA#", 3.579,   BROCHE_FILTRE_80M),
-  //Balise("CQ DE F6KJU #LOCA#", 7.0475,  BROCHE_FILTRE_40M),
-  //Balise("CQ DE F6KJU #LOCA#", 10.140,  BROCHE_FILTRE_30M),
-  Balise("CQ DE F5ZHM #LOCA#", 14.099, BROCHE_FILTRE_20M),
-  Balise("CQ DE F5ZHK #LOCA#", 18.109, BROCHE_FILTRE_17M),
-  Balise("CQ DE F5ZHL #LOCA#", 21.149, BROCHE_FILTRE_15M),
-  Balise("CQ DE F5ZHJ #LOCA#", 24.929, BROCHE_FILTRE_12M),
-  Balise("CQ DE F5ZVM #LOCA#", 28.259, BROCHE_FILTRE_10M),
-  Balise("CQ DE F5ZHI #LOCA#", 50.059,  BROCHE_FILTRE_6M)
+// Jetons utilisables dans les messages : #LOCA#, #LOC8#, #HHMM#, #NSEQ# (voir GenerateurMessage).
+// Les messages sont rangés en mémoire flash, comme le plan de bandes qui les utilise.
+constexpr char MESSAGE_F6KJU[] PROGMEM = "CQ DE F6KJU #LOCA#";
+constexpr char MESSAGE_F5ZHM[] PROGMEM = "CQ DE F5ZHM #LOCA#";
+constexpr char MESSAGE_F5ZHK[] PROGMEM = "CQ DE F5ZHK #LOCA#";
+constexpr char MESSAGE_F5ZHL[] PROGMEM = "CQ DE F5ZHL #LOCA#";
+constexpr char MESSAGE_F5ZHJ[] PROGMEM = "CQ DE F5ZHJ #LOCA#";
+constexpr char MESSAGE_F5ZVM[] PROGMEM = "CQ DE F5ZVM #LOCA#";
+constexpr char MESSAGE_F5ZHI[] PROGMEM = "CQ DE F5ZHI #LOCA#";
+
+// Format : { Message à envoyer, Fréquence en Hz, Broche du Filtre [, false pour ne pas l'émettre [, mode]] }
+// En WSPR (MODE_WSPR), le message est l'indicatif seul et la fréquence celle du ton le plus bas.
+// Chaque balise émet pendant son créneau (voir PlanningBalises) ; une bande désactivée
+// est simplement sautée.
+// Le tableau est rempli par le compilateur, qui vérifie aussi chaque balise (voir plus
+// bas) : un message trop long ou une fréquence impossible empêchent la compilation.
+// Ce n'est que le plan de bandes du premier démarrage : il est ensuite gardé en EEPROM
+// (voir MemoirePersistante) et se modifie depuis la console ("BANDES", "BANDE ..."),
+// sans reprogrammer la carte.
+constexpr Balise PLAN_DE_BANDES[] PROGMEM = {
+  Balise(MESSAGE_F6KJU, 3579000UL,  BROCHE_FILTRE_80M, false),
+  Balise(MESSAGE_F6KJU, 7047500UL,  BROCHE_FILTRE_40M, false),
+  Balise(MESSAGE_F6KJU, 10140000UL, BROCHE_FILTRE_30M, false),
+  Balise(MESSAGE_F5ZHM, 14099000UL, BROCHE_FILTRE_20M),
+  Balise(MESSAGE_F5ZHK, 18109000UL, BROCHE_FILTRE_17M),
+  Balise(MESSAGE_F5ZHL, 21149000UL, BROCHE_FILTRE_15M),
+  Balise(MESSAGE_F5ZHJ, 24929000UL, BROCHE_FILTRE_12M),
+  Balise(MESSAGE_F5ZVM, 28259000UL, BROCHE_FILTRE_10M),
+  Balise(MESSAGE_F5ZHI, 50059000UL, BROCHE_FILTRE_6M)
 };
 // On compte automatiquement combien il y a de balises dans notre liste.
-const int NOMBRE_DE_BALISES = sizeof(balises) / sizeof(balises[0]);
+const int NOMBRE_DE_BALISES = sizeof(PLAN_DE_BANDES) / sizeof(PLAN_DE_BANDES[0]);
+
+// --- VÉRIFICATION DU PLAN DE BANDES, FAITE PAR LE COMPILATEUR ---
+// Chaque message est mesuré avec la plus longue valeur possible de ses jetons (voir
+// GenerateurMessage::unitesMorseMax()). Ces vérifications ne coûtent rien sur la carte.
+
+/// L'horloge de travail du DDS, PLL comprise.
+constexpr uint32_t HORLOGE_DDS_HZ = decltype(piloteDDS)::HORLOGE_HZ;
+
+/// `true` si la fréquence de la balise est à la portée du DDS : mot d'accord non nul, et moins de la moitié de son horloge.
+constexpr bool frequenceValide(const Balise& balise) {
+  return GestionnaireDDS::calculerMotAccord(balise.getFrequency(), HORLOGE_DDS_HZ) > 0 &&
+         GestionnaireDDS::calculerMotAccord(balise.getFrequency(), HORLOGE_DDS_HZ) < 0x80000000UL;
+}
+
+/// `true` si le message de la balise tient dans le carnet de l'EEPROM et, jetons remplacés, dans `TAILLE_MESSAGE_MAX`.
+constexpr bool longueurValide(const Balise& balise) {
+  return GenerateurMessage::longueurMax(balise.getMessage()) <= ConfigurationBalise::TAILLE_MESSAGE &&
+         GenerateurMessage::longueurMax(balise.getMessage()) < TAILLE_MESSAGE_MAX;
+}
+
+/**
+ * @brief `true` si le message de la balise, dans son mode, tient dans son créneau.
+ * @details En Morse, dans `DUREE_MAX_EMISSION_MS` ; en QRSS, dans tout le créneau de
+ * `DUREE_CRENEAU_MINUTES` ; le tout sans dépasser la capacité d'une SequenceMorse. En
+ * WSPR, la durée est fixe : le message doit seulement être un indicatif standard.
+ */
+constexpr bool messageTientDansLeCreneau(const Balise& balise) {
+  return balise.getMode() == MODE_WSPR
+    ? CodeurWSPR::indicatifValide(balise.getMessage())
+    : 2 * GenerateurMessage::elementsMorseMax(balise.getMessage()) <= SequenceMorse::TAILLE_MAX &&
+      (balise.getMode() == MODE_QRSS
+        ? (unsigned long)GenerateurMessage::unitesMorseMax(balise.getMessage()) * QRSS_DUREE_POINT_MS <=
+            DUREE_MAX_EMISSION_MS + 60000UL * (DUREE_CRENEAU_MINUTES - 1)
+        : GenerateurMessage::unitesMorseMax(balise.getMessage()) <=
+            SequenceMorse::unitesPourDuree(DUREE_MAX_EMISSION_MS, MORSE_MOT_PAR_MINUTE));
+}
+
+/// `true` si toutes les balises, à partir de la n° `i`, passent la vérification `verification`.
+constexpr bool toutesLesBalises(bool (*verification)(const Balise&), int i) {
+  return i >= NOMBRE_DE_BALISES || (verification(PLAN_DE_BANDES[i]) && toutesLesBalises(verification, i + 1));
+}
+
+static_assert(NOMBRE_DE_BALISES <= EnregistrementMemoire::NOMBRE_MAX_BALISES, "Trop de balises pour le carnet de l'EEPROM");
+static_assert(GestionnaireDDS::correctionValide(CORRECTION_HORLOGE_DDS_PPB), "Correction d'horloge du DDS hors limites");
+static_assert(toutesLesBalises(frequenceValide, 0), "Une frequence du plan de bandes est hors de portee du DDS");
+static_assert(toutesLesBalises(longueurValide, 0), "Un message du plan de bandes est trop long (voir TAILLE_MESSAGE_MAX)");
+static_assert(toutesLesBalises(messageTientDansLeCreneau, 0), "Un message du plan de bandes ne tient pas dans son creneau");
+
+// Les balises de travail : vierges au démarrage (aucun constructeur à exécuter), elles
+// sont remplies depuis le carnet de l'EEPROM (voir appliquerPlanDeBandes()).
+Balise balises[NOMBRE_DE_BALISES];
+// L'horaire qui déduit de l'heure UTC la balise à émettre : deux balises réglées pareil
+// tombent toujours sur la même bande à la même minute, même après un redémarrage.
+PlanningBalises planning(balises, NOMBRE_DE_BALISES, DUREE_CRENEAU_MINUTES, DECALAGE_SITE);
 // On crée des "marque-pages" pour savoir où on en est.
-int indexBaliseCourante = 0;      // Pour se souvenir de la prochaine balise à émettre.
-bool aEteTransmisCetteMinute = false; // Pour s'assurer de n'émettre qu'une fois par minute.
+const uint16_t AUCUNE_MINUTE = 0xFFFF;
+uint16_t minutePreparee = AUCUNE_MINUTE;  // La minute pour laquelle filtre et DDS ont été préparés.
+int8_t indexBalisePreparee = PlanningBalises::AUCUNE_BALISE; // La balise de cette minute.
+bool aEteTransmisCetteMinute = false; // Pour s'assurer de ne préparer qu'une émission par minute.
+bool emissionEnCours = false;         // Pour savoir qu'un message est en train d'être manipulé.
+bool emissionFSK = false;             // Pour savoir qui l'émet : le chanteur (WSPR, QRSS) ou le télégraphiste.
+uint16_t numeroEmission = 0;          // Le numéro de la prochaine émission, pour le jeton #NSEQ#.
 
 /**
- * @brief Fonction d'initialisation, exécutée une seule fois au démarrage de l'Arduino.
+ * @enum EtatDemarrage
+ * @brief Les étapes du démarrage, suivies par la tâche de démarrage.
  */
-void setup() {
-  // Ouvre la communication avec l'ordinateur pour pouvoir afficher des messages de statut.
-  Serial.begin(9600);
-  Serial.println(F("Initialisation de la balise Morse F6KJU..."));
+enum EtatDemarrage {
+  DEMARRAGE_ATTENTE_HEURE,    ///< Le GPS n'a pas encore donné l'heure : rien ne peut être émis.
+  DEMARRAGE_ATTENTE_POSITION, ///< L'heure est connue mais pas encore la position.
+  DEMARRAGE_TERMINE,          ///< L'heure et la position sont connues.
+};
+EtatDemarrage etatDemarrage = DEMARRAGE_ATTENTE_HEURE;
+// Les durées du démarrage, en millisecondes depuis la mise sous tension (0 : pas encore).
+unsigned long demarrageHeureMs = 0;     // Première heure valide.
+unsigned long demarragePositionMs = 0;  // Première position valide.
+unsigned long demarrageEmissionMs = 0;  // Début de la première émission.
+// Le locator qui attend d'être retenu dans le carnet (voir tacheMemoire()).
+char locatorCandidat[11] = "";
+unsigned long locatorCandidatMs = 0;    // Depuis quand il n'a pas changé.
 
-  
-  // On demande à notre pilote de DDS de préparer le composant.
-  gestionDDS.begin();
-  
-  // -- Attente de la synchronisation GPS --
-  Serial.println(F("En attente de la synchronisation GPS... (Ceci peut prendre quelques minutes)"));
-  // On boucle ici tant que le GPS ne nous a pas donné une heure et une position fiables.
-  while (!gestionGPS.hasValidTime() || !gestionGPS.hasValidLocation()) {
-    gestionGPS.update(); // On demande à notre expert GPS de continuer à écouter.
+/**
+ * @brief Calcule d'avance les mots d'accord du DDS de chaque balise, un par ton.
+ * @details À refaire à chaque changement de la correction d'horloge du DDS ou du mode
+ * d'une balise. Ensuite, changer de bande ou de ton ne demande plus aucun calcul : il
+ * suffit de charger le mot. Le ton 0 est la fréquence de la balise ; les suivants sont
+ * espacés de 12000 / 8192 Hz en WSPR, de `QRSS_ECART_TONS_256E_HZ` en QRSS.
+ */
+void calculerMotsAccord() {
+  for (int i = 0; i < NOMBRE_DE_BALISES; i++) {
+    uint64_t frequence256 = (uint64_t)balises[i].getFrequency() << 8;
+    uint16_t ecart = balises[i].getMode() == MODE_QRSS ? QRSS_ECART_TONS_256E_HZ : CodeurWSPR::ECART_TONS_256E_HZ;
+    for (uint8_t ton = 0; ton < Balise::NOMBRE_TONS; ton++) {
+      balises[i].setMotAccord(piloteDDS.calculerMotAccordPrecis(frequence256 + (uint32_t)ton * ecart), ton);
+    }
   }
-  
-  // Le GPS est prêt ! On allume la LED verte pour le signaler.
-  Serial.println(F("GPS synchronisé ! La balise est prête."));
 }
 
 /**
- * @brief Boucle principale, exécutée en continu après le setup().
+ * @brief Valide la fréquence préchargée dans le DDS.
+ * @details Passée à `startAt()` : elle est appelée à l'instant exact du début de la
+ * minute (depuis l'interruption du manipulateur), juste avant le premier élément. En
+ * WSPR et en QRSS, elle est rappelée au début de chaque symbole.
  */
-void loop() {
-  // À chaque passage, on demande à notre expert GPS d'écouter si de nouvelles infos sont arrivées.
-  gestionGPS.update();
-
-  /**
-   * @brief Bloc de rafraîchissement de l'écran.
-   * @details Pour ne pas surcharger l'écran en écrivant dessus constamment,
-   * on utilise un simple minuteur avec millis() pour ne le mettre à jour
-   * qu'une fois par seconde.
-   */
-  if (millis() - dernierRafraichissementEcran > 1000) {
-    dernierRafraichissementEcran = millis(); // On réinitialise le minuteur
-    
-    // Si le GPS a une heure valide, on met à jour l'écran.
-    if (gestionGPS.hasValidTime()) {
-      // On appelle la fonction d'affichage en lui fournissant toutes les données
-      // récupérées une par une depuis le gestionnaire GPS.
-      gestionLCD.afficherDateHeure(
-        gestionGPS.getJour(),
-        gestionGPS.getMois(),
-        gestionGPS.getAnnee(),
-        gestionGPS.getHeure(),
-        gestionGPS.getMinute(),
-        gestionGPS.getSeconde()
-      );
+void validerFrequenceDDS() {
+  piloteDDS.validerFrequence();
+}
+
+/**
+ * @brief Prépare la bande d'une minute à venir : filtre et mot d'accord du DDS.
+ * @details Le relais du filtre commence à commuter tout de suite (l'ancien est relâché
+ * avant que le nouveau ne soit engagé) et le mot d'accord est envoyé au DDS sans être
+ * validé : la fréquence ne change qu'au début de la minute. Au moment de manipuler, il
+ * ne reste donc plus rien à commuter.
+ * @param minuteDuJour La minute (depuis minuit UTC) à préparer.
+ */
+void preparerBande(uint16_t minuteDuJour) {
+  minutePreparee = minuteDuJour;
+  indexBalisePreparee = planning.baliseDeLaMinute(minuteDuJour);
+  if (indexBalisePreparee == PlanningBalises::AUCUNE_BALISE) return;
+  Balise& balise = balises[indexBalisePreparee];
+  commutateurFiltres.selectionner(balise.getFilterPin());
+  // En WSPR et en QRSS, c'est le ton du premier symbole que l'EmetteurFSK précharge, en
+  // programmant l'émission.
+  if (balise.getMode() == MODE_CW) piloteDDS.prechargerMotAccord(balise.getMotAccord());
+}
+
+/**
+ * @brief La condition du sommeil (voir GestionnaireVeille), vérifiée interruptions coupées.
+ * @details On reste éveillé pendant toute une émission, de sa programmation à sa fin,
+ * tant qu'un octet du GPS attend d'être lu, que l'image de l'écran n'est pas entièrement
+ * envoyée, ou qu'un relais de filtre est en train de commuter. Sans filtre engagé
+ * (attente de l'heure, minute sans balise), rien ne bouge : la balise peut dormir.
+ */
+bool balisePeutSomnoler() {
+  return !emissionEnCours && Serial1.available() == 0 && gestionLCD.estAJour() && commutateurFiltres.estStable();
+}
+
+/**
+ * @brief Permet de savoir si la balise peut émettre.
+ * @details Il faut l'heure, et un locator : celui du GPS, ou à défaut `LOCATOR_PAR_DEFAUT`.
+ */
+bool baliseAutorisee() {
+  return etatDemarrage != DEMARRAGE_ATTENTE_HEURE && gestionGPS.hasLocator();
+}
+
+/**
+ * @brief Affiche les durées du démarrage : premières heure et position valides, première émission.
+ */
+void afficherDemarrage() {
+  journal.print(F("Demarrage (ms), heure : "));
+  journal.print(demarrageHeureMs);
+  journal.print(F(" / position : "));
+  journal.print(demarragePositionMs);
+  journal.print(F(" / premiere emission : "));
+  journal.println(demarrageEmissionMs);
+}
+
+/**
+ * @brief Reporte le plan de bandes du carnet sur les balises, puis refait tous les calculs qui en dépendent.
+ */
+void appliquerPlanDeBandes() {
+  memoire.appliquerBalises(balises, NOMBRE_DE_BALISES);
+  calculerMotsAccord();
+  planning.setDureeCreneau(memoire.getDureeCreneau());
+  planning.setDecalageSite(memoire.getDecalageSite());
+  planning.calculer();
+  // La bande déjà préparée n'est peut-être plus la bonne.
+  minutePreparee = AUCUNE_MINUTE;
+}
+
+/// Le nom de chaque mode, dans l'ordre de `ModeBalise` (pour la console).
+const char* const NOMS_MODES[] = { "CW", "WSPR", "QRSS" };
+
+/**
+ * @brief Affiche le plan de bandes : numéro, état, fréquence, broche du filtre, mode et message de chaque balise.
+ */
+void afficherPlanDeBandes() {
+  for (int i = 0; i < NOMBRE_DE_BALISES; i++) {
+    journal.print(i + 1);
+    journal.print(balises[i].isActive() ? F(" ON  ") : F(" OFF "));
+    journal.print(balises[i].getFrequency());
+    journal.print(F(" Hz, filtre "));
+    journal.print(balises[i].getFilterPin());
+    journal.print(F(", "));
+    journal.print(NOMS_MODES[balises[i].getMode()]);
+    journal.print(F(" : "));
+    journal.println(balises[i].getMessage());
+  }
+  journal.print(F("Creneaux (min) : "));
+  journal.print(planning.getDureeCreneau());
+  journal.print(F(" / decalage : "));
+  journal.println(planning.getDecalageSite());
+}
+
+/**
+ * @brief Traite une commande "BANDE <n> ..." qui modifie une balise du plan de bandes.
+ * @param arguments Le texte qui suit "BANDE ".
+ * @return `false` si la commande est incorrecte.
+ */
+bool modifierBande(const char* arguments) {
+  char* suite;
+  long numero = strtol(arguments, &suite, 10);
+  if (numero < 1 || numero > NOMBRE_DE_BALISES || *suite != ' ') return false;
+  uint8_t balise = numero - 1;
+  suite++;
+
+  bool correct;
+  if (strcmp(suite, "ON") == 0 || strcmp(suite, "OFF") == 0) {
+    correct = memoire.setActive(balise, suite[1] == 'N');
+  } else if (strncmp(suite, "FREQ ", 5) == 0) {
+    unsigned long frequence = strtoul(suite + 5, nullptr, 10);
+    // Le DDS ne sait pas produire plus de la moitié de sa fréquence d'horloge.
+    correct = frequence > 0 && frequence < piloteDDS.getHorlogeHz() / 2 && memoire.setFrequence(balise, frequence);
+  } else if (strncmp(suite, "FILTRE ", 7) == 0) {
+    int broche = atoi(suite + 7);
+    correct = commutateurFiltres.connait(broche) && memoire.setBrocheFiltre(balise, broche);
+  } else if (strncmp(suite, "MSG ", 4) == 0) {
+    correct = memoire.setMessage(balise, suite + 4);
+  } else if (strncmp(suite, "MODE ", 5) == 0) {
+    correct = false;
+    for (uint8_t mode = MODE_CW; mode <= MODE_QRSS; mode++) {
+      if (strcmp(suite + 5, NOMS_MODES[mode]) == 0) correct = memoire.setMode(balise, (ModeBalise)mode);
+    }
+  } else {
+    correct = false;
+  }
+  if (correct) appliquerPlanDeBandes();
+  return correct;
+}
+
+/**
+ * @brief Rassemble les compteurs des différentes classes et envoie une trame de télémétrie.
+ */
+void envoyerTelemetrie() {
+  ReleveTelemetrie releve;
+  unsigned long passageMaxUs = ordonnanceur.getPassageMaxUs();
+  releve.passageMaxUs = passageMaxUs > 0xFFFFUL ? 0xFFFF : passageMaxUs;
+  releve.attenteMaxGPS = gestionGPS.getAttenteMax();
+  releve.phrasesNMEA = gestionGPS.getAnalyseur().getPhrasesValides();
+  releve.erreursNMEA = gestionGPS.getAnalyseur().getErreursSomme();
+  releve.famines = manipulateurTimer.getFamines();
+  releve.gigueMaxUs = manipulateurTimer.getGigueMaxUs();
+  releve.chargementsDDS = piloteDDS.getNombreChargements();
+  releve.octetsLCD = gestionLCD.getOctetsEnvoyes();
+  releve.octetsPerdusJournal = journal.getOctetsPerdus();
+  if (telemetrie.envoyer(releve, journal)) {
+    gestionGPS.effacerAttenteMax();
+  }
+}
+
+/**
+ * @brief Petite console de réglage sur le port série, servie régulièrement par la tâche console.
+ * @details Les caractères reçus sont accumulés jusqu'à la fin de ligne, sans jamais
+ * attendre. Commandes reconnues :
+ * - "PPB" : affiche la correction d'horloge du DDS ;
+ * - "PPB <valeur>" : change cette correction (en milliardièmes, 1000000 au plus dans un sens ou dans l'autre),
+ *   la garde en EEPROM et recalcule les mots d'accord ;
+ * - "TACHES" : affiche les durées et les retards de chaque tâche ("TACHES RAZ" les remet à zéro) ;
+ * - "DEMARRAGE" : affiche les durées du démarrage (heure, position, première émission) ;
+ * - "BANDES" : affiche le plan de bandes ;
+ * - "BANDE <n> ON" / "BANDE <n> OFF" : active ou désactive la balise numéro n ;
+ * - "BANDE <n> FREQ <Hz>", "BANDE <n> FILTRE <broche>", "BANDE <n> MSG <texte>" : change ses réglages ;
+ * - "BANDE <n> MODE CW|WSPR|QRSS" : change sa façon d'émettre ;
+ * - "CRENEAU <minutes>" / "DECALAGE <creneaux>" : change l'horaire des émissions ;
+ * - "JOURNAL" : affiche le remplissage du journal et ses pertes ("JOURNAL <0-3>" change son niveau de détail) ;
+ * - "TELEMETRIE" : envoie tout de suite une trame de télémétrie (à lire avec `outils/decoder_telemetrie.py`) ;
+ * - "VEILLE" : affiche le temps passé éveillé et endormi pendant la dernière minute ("VEILLE ON|OFF" autorise ou interdit le sommeil).
+ *
+ * Les changements du plan de bandes sont gardés en EEPROM : ils survivent aux coupures de courant.
+ */
+void traiterConsole() {
+  static char ligne[64];
+  static uint8_t longueur = 0;
+
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (longueur < sizeof(ligne) - 1) ligne[longueur++] = c;
+      continue;
+    }
+    if (longueur == 0) continue;
+    ligne[longueur] = '\0';
+    longueur = 0;
+
+    if (strncmp(ligne, "PPB", 3) == 0) {
+      if (ligne[3] == ' ') {
+        char* fin;
+        long ppb = strtol(ligne + 4, &fin, 10);
+        if (fin == ligne + 4 || *fin != '\0' || !piloteDDS.setCorrectionPpb(ppb)) {
+          journal.print(F("Usage : PPB <-"));
+          journal.print(GestionnaireDDS::CORRECTION_MAX_PPB);
+          journal.print(F(" a "));
+          journal.print(GestionnaireDDS::CORRECTION_MAX_PPB);
+          journal.println(F(">"));
+          continue;
+        }
+        memoire.setCorrectionPpb(ppb);
+        calculerMotsAccord();
+        // Le mot déjà préchargé n'est plus le bon : la bande sera préparée à nouveau.
+        minutePreparee = AUCUNE_MINUTE;
+      }
+      journal.print(F("Correction horloge DDS (ppb) : "));
+      journal.print(piloteDDS.getCorrectionPpb());
+      journal.print(F(" / horloge (Hz) : "));
+      journal.println(piloteDDS.getHorlogeHz());
+    } else if (strcmp(ligne, "TACHES") == 0) {
+      ordonnanceur.afficherStatistiques(journal);
+    } else if (strcmp(ligne, "TACHES RAZ") == 0) {
+      ordonnanceur.reinitialiserStatistiques();
+    } else if (strcmp(ligne, "DEMARRAGE") == 0) {
+      afficherDemarrage();
+    } else if (strncmp(ligne, "JOURNAL", 7) == 0) {
+      if (ligne[7] == ' ' && ligne[8] >= '0' && ligne[8] <= '3') {
+        journal.setNiveau((NiveauJournal)(ligne[8] - '0'));
+      }
+      journal.print(F("Journal, niveau : "));
+      journal.print(journal.getNiveau());
+      journal.print(F(" / remplissage max : "));
+      journal.print(journal.getRemplissageMax());
+      journal.print(F(" / octets perdus : "));
+      journal.println(journal.getOctetsPerdus());
+    } else if (strcmp(ligne, "TELEMETRIE") == 0) {
+      envoyerTelemetrie();
+    } else if (strncmp(ligne, "VEILLE", 6) == 0) {
+      if (strcmp(ligne + 6, " ON") == 0 || strcmp(ligne + 6, " OFF") == 0) veille.setActive(ligne[8] == 'N');
+      veille.afficherRapport(journal);
+    } else if (strcmp(ligne, "BANDES") == 0) {
+      afficherPlanDeBandes();
+    } else if (strncmp(ligne, "BANDE ", 6) == 0) {
+      if (modifierBande(ligne + 6)) afficherPlanDeBandes();
+      else journal.println(F("Usage : BANDE <n> ON|OFF|FREQ <Hz>|FILTRE <broche>|MSG <texte>|MODE CW|WSPR|QRSS"));
+    } else if (strncmp(ligne, "CRENEAU ", 8) == 0) {
+      int duree = atoi(ligne + 8);
+      if (duree >= 1 && duree <= 60) {
+        memoire.setPlanning(duree, memoire.getDecalageSite());
+        appliquerPlanDeBandes();
+      }
+      afficherPlanDeBandes();
+    } else if (strncmp(ligne, "DECALAGE ", 9) == 0) {
+      int decalage = atoi(ligne + 9);
+      if (decalage >= 0 && decalage <= 255) {
+        memoire.setPlanning(memoire.getDureeCreneau(), decalage);
+        appliquerPlanDeBandes();
+      }
+      afficherPlanDeBandes();
+    } else {
+      journal.print(F("Commande inconnue : "));
+      journal.println(ligne);
+    }
+  }
+}
+
+// --- LES TÂCHES DE LA BOUCLE PRINCIPALE ---
+// Chaque tâche est une petite fonction qui fait un peu de travail et rend vite la main.
+// C'est l'ordonnanceur qui les appelle, à leur rythme et par ordre de priorité.
+
+/**
+ * @brief Tâche GPS : écoute si de nouvelles infos sont arrivées.
+ * @details Son travail est limité à quelques octets : il ne retarde jamais le reste de la boucle.
+ */
+void tacheGPS() {
+  gestionGPS.update(BUDGET_OCTETS_GPS);
+}
+
+/**
+ * @brief Tâche console : regarde si l'opérateur a tapé une commande.
+ */
+void tacheConsole() {
+  traiterConsole();
+}
+
+/**
+ * @brief Tâche d'affichage, une fois par seconde : met à jour l'image de l'écran.
+ * @details Ces mises à jour n'écrivent qu'en mémoire : c'est la tâche écran qui
+ * envoie petit à petit les caractères changés à l'écran.
+ */
+void tacheAffichage() {
+  // Si le GPS a une heure valide, on met à jour l'écran.
+  if (gestionGPS.hasValidTime()) {
+    // On appelle la fonction d'affichage en lui fournissant toutes les données
+    // récupérées une par une depuis le gestionnaire GPS.
+    gestionLCD.afficherDateHeure(
+      gestionGPS.getJour(),
+      gestionGPS.getMois(),
+      gestionGPS.getAnnee(),
+      gestionGPS.getHeure(),
+      gestionGPS.getMinute(),
+      gestionGPS.getSeconde()
+    );
+  }
+  // Si le GPS a une position valide, on met à jour la ligne correspondante.
+  if (gestionGPS.hasValidLocation()) {
+    gestionLCD.mettreAJourPositionEtLocator(gestionGPS.getLatitude(), gestionGPS.getLongitude(), gestionGPS.getLocator());
+  }
+}
+
+/**
+ * @brief Tâche de démarrage : suit l'arrivée de l'heure puis de la position du GPS.
+ * @details Remplace l'attente bloquante d'autrefois dans setup() : pendant ce temps,
+ * l'écran montre le nombre de satellites et le temps écoulé, et les autres tâches
+ * tournent normalement. La balise démarre dès que l'heure est connue, avec le locator
+ * par défaut si la position n'est pas encore là.
+ */
+void tacheDemarrage() {
+  switch (etatDemarrage) {
+    case DEMARRAGE_ATTENTE_HEURE:
+      if (!gestionGPS.hasValidTime()) break;
+      demarrageHeureMs = millis();
+      journal.evenement(NIVEAU_INFO, EVT_HEURE_VALIDE, demarrageHeureMs);
+      etatDemarrage = DEMARRAGE_ATTENTE_POSITION;
+      if (gestionGPS.hasLocator()) {
+        journal.print(F("Locator en attendant la position : "));
+        journal.println(gestionGPS.getLocator());
+        gestionLCD.mettreAJourStatus(STATUT_PRET);
+        gestionLCD.clearBeaconInfo();
+      }
+      // Pas de break : la position est peut-être déjà là. La ligne suivante le dit au
+      // compilateur (-Wimplicit-fallthrough).
+      // fall through
+    case DEMARRAGE_ATTENTE_POSITION:
+      if (!gestionGPS.hasValidLocation() || !gestionGPS.locatorCalcule()) break;
+      demarragePositionMs = millis();
+      journal.evenement(NIVEAU_INFO, EVT_POSITION_VALIDE, demarragePositionMs);
+      etatDemarrage = DEMARRAGE_TERMINE;
+      if (!emissionEnCours) {
+        gestionLCD.mettreAJourStatus(STATUT_PRET);
+        gestionLCD.clearBeaconInfo();
+      }
+      return;
+    case DEMARRAGE_TERMINE:
+      return;
+  }
+  // Toujours en attente : on tient l'opérateur au courant.
+  if (!baliseAutorisee()) {
+    gestionLCD.afficherAttenteGPS(gestionGPS.getSatellites(), millis() / 1000);
+  }
+}
+
+/**
+ * @brief Tâche mémoire : tient le carnet de bord à jour et fait avancer son écriture en EEPROM.
+ * @details Le carnet ne demande une écriture que si une valeur a vraiment changé, et
+ * l'écriture se fait un octet à la fois, dès que l'EEPROM est libre. Les cases du locator
+ * à 10 caractères ne font qu'une vingtaine de mètres : le bruit du GPS le fait passer
+ * d'une case à l'autre. Il n'est donc retenu qu'après `LOCATOR_STABLE_MS` sans changer,
+ * soit au plus 144 écritures par jour.
+ */
+void tacheMemoire() {
+  if (gestionGPS.locatorCalcule()) {
+    const char* locator = gestionGPS.getLocatorPrecis();
+    if (strcmp(locator, locatorCandidat) != 0) {
+      strncpy(locatorCandidat, locator, sizeof(locatorCandidat) - 1);
+      locatorCandidatMs = millis();
+    } else if (millis() - locatorCandidatMs >= LOCATOR_STABLE_MS) {
+      memoire.setLocator(locatorCandidat);
     }
-    // Si le GPS a une position valide, on met à jour la ligne correspondante.
-    if (gestionGPS.hasValidLocation()) {
-      gestionLCD.updatePosition(gestionGPS.getLatitude(), gestionGPS.getLongitude(), gestionGPS.getLocator());
+  }
+  if (gestionGPS.hasValidTime()) {
+    memoire.setDerniereHeure(gestionGPS.getAnnee(), gestionGPS.getMois(), gestionGPS.getJour(),
+                             gestionGPS.getHeure() * 3600UL + gestionGPS.getMinute() * 60UL + gestionGPS.getSeconde());
+  }
+  memoire.mettreAJour();
+}
+
+/**
+ * @brief Tâche télémétrie : envoie une trame à intervalles réguliers.
+ */
+void tacheTelemetrie() {
+  envoyerTelemetrie();
+}
+
+/**
+ * @brief Tâche journal : passe au port série ce qui tient dans son tampon, sans attendre.
+ */
+void tacheJournal() {
+  journal.vider();
+}
+
+/**
+ * @brief Tâche filtres : fait avancer le changement de relais en cours.
+ */
+void tacheFiltres() {
+  commutateurFiltres.mettreAJour();
+}
+
+/**
+ * @brief Tâche écran : envoie à l'écran quelques caractères changés.
+ * @details Quelques octets seulement à chaque passage : l'écran ne retient jamais la boucle.
+ */
+void tacheEcran() {
+  gestionLCD.flush(BUDGET_OCTETS_LCD);
+}
+
+/**
+ * @brief Tâche de manipulation : fait avancer le message en cours, et range tout à la fin.
+ */
+void tacheManipulation() {
+  // Si un message est en cours, on laisse le télégraphiste avancer d'un élément
+  // si c'est l'heure. Cet appel ne bloque jamais : le GPS et l'écran continuent
+  // d'être servis pendant toute l'émission.
+  if (emissionEnCours && !(emissionFSK ? emetteurFSK.poll() : emetteurMorse.poll())) {
+    // -- Nettoyage et préparation pour la prochaine minute --
+    emissionEnCours = false;
+    journal.evenement(NIVEAU_INFO, EVT_FIN_EMISSION, numeroEmission - 1);
+    if (emissionFSK) {
+      // Un symbole émis sur le ton précédent gâche le décodage : on le signale.
+      uint16_t retards = emetteurFSK.getRetards();
+      journal.evenement(retards > 0 ? NIVEAU_ALERTE : NIVEAU_DETAIL, EVT_SYMBOLES_EN_RETARD, retards);
+    }
+    if (MANIPULATION_PAR_TIMER) {
+      // On rend compte de la qualité de la manipulation sous interruption.
+      journal.evenement(NIVEAU_DETAIL, EVT_FAMINES, manipulateurTimer.getFamines());
+      journal.evenement(NIVEAU_DETAIL, EVT_GIGUE_US, manipulateurTimer.getGigueMaxUs());
     }
+    // Et de la qualité de la liaison avec le GPS et l'écran.
+    const AnalyseurNMEA& nmea = gestionGPS.getAnalyseur();
+    journal.evenement(NIVEAU_DETAIL, EVT_NMEA_PHRASES, nmea.getPhrasesValides());
+    journal.evenement(NIVEAU_DETAIL, EVT_NMEA_ERREURS, nmea.getErreursSomme());
+    journal.evenement(NIVEAU_DETAIL, EVT_NMEA_PERDUS, nmea.getOctetsPerdus());
+    journal.evenement(NIVEAU_DETAIL, EVT_LCD_OCTETS, gestionLCD.getOctetsParSeconde());
+    gestionLCD.mettreAJourStatus(STATUT_PRET);
+    gestionLCD.clearBeaconInfo();
+    // Le filtre reste en place : il ne sera changé qu'en préparant la bande suivante.
   }
+}
 
-  // La condition principale : est-ce le bon moment pour émettre ?
-  // On vérifie si 1) l'heure est valide, 2) on est à la seconde "0" d'une minute, 3) on n'a pas déjà émis.
-  if (gestionGPS.hasValidTime() && gestionGPS.getSeconds() == 0 && !aEteTransmisCetteMinute) {
-    // C'est le bon moment ! On lève notre drapeau pour ne pas ré-émettre dans la même seconde.
+/**
+ * @brief Tâche de programmation : prépare l'émission de la minute suivante, au bon moment.
+ */
+void tacheProgrammation() {
+  // On demande l'heure exacte : la seconde en cours, et l'instant précis où elle a commencé.
+  unsigned long secondeDuJour, debutSeconde;
+  bool horlogeValide = gestionGPS.getHorloge(secondeDuJour, debutSeconde) && baliseAutorisee();
+
+  // Dès que le message précédent est fini, on prépare la bande de la minute suivante :
+  // le relais et le DDS ont ainsi tout le silence qui reste pour se mettre en place.
+  if (horlogeValide && !emissionEnCours) {
+    uint16_t minuteSuivante = (secondeDuJour / 60 + 1) % 1440;
+    if (minuteSuivante != minutePreparee) preparerBande(minuteSuivante);
+  }
+
+  // La condition principale : est-ce le bon moment pour préparer l'émission ?
+  // On vérifie si 1) l'heure est valide, 2) on est à la dernière seconde d'une minute, 3) on n'a pas déjà
+  // préparé d'émission, 4) le message précédent est bien terminé.
+  if (horlogeValide && secondeDuJour % 60 == 59 && !aEteTransmisCetteMinute && !emissionEnCours) {
+    // C'est le bon moment ! On lève notre drapeau pour ne pas préparer deux fois la même émission.
     aEteTransmisCetteMinute = true;
+    // L'émission commencera exactement au début de la minute suivante.
+    unsigned long debutMinute = debutSeconde + 1000000UL;
+    unsigned long secondeDepart = (secondeDuJour + 1) % 86400UL;
 
+    // La bande de la minute qui commence a été préparée d'avance (voir preparerBande()).
+    if (indexBalisePreparee == PlanningBalises::AUCUNE_BALISE) return; // Toutes les bandes sont désactivées.
     // On récupère la "fiche de réglages" de la balise à émettre cette minute.
-    Balise& baliseCourante = balises[indexBaliseCourante];
-    
-        
+    Balise& baliseCourante = balises[indexBalisePreparee];
+    ModeBalise mode = baliseCourante.getMode();
+    // Une émission WSPR commence une seconde après une minute paire et dure près de deux
+    // minutes : l'horaire lui réserve ces deux minutes (voir PlanningBalises).
+    if (mode == MODE_WSPR && !planning.peutCommencerWSPR(secondeDepart / 60)) return;
+    unsigned long debutEmission = mode == MODE_WSPR ? debutMinute + 1000000UL : debutMinute;
+
     // -- Préparation du message --
-    // On crée un objet "String" à partir du message de base.
-    String messageFinal = String(baliseCourante.getMessage());
-    // On utilise la méthode très pratique ".replace()" pour insérer le locator actuel.
-    messageFinal.replace("#LOCA#", gestionGPS.getLocator());
+    // On donne au secrétaire les valeurs du moment, puis il remplit les jetons du
+    // message dans un tableau de taille fixe (pas de String, donc pas de mémoire morcelée).
+    char messageFinal[TAILLE_MESSAGE_MAX];
+    telemetrie.noterMemoire(); // C'est ici que la pile descend le plus bas.
+    generateurMessage.setLocator(gestionGPS.getLocator());
+    generateurMessage.setLocatorEtendu(gestionGPS.getLocatorEtendu());
+    generateurMessage.setHeure(secondeDepart / 3600, (secondeDepart / 60) % 60);
+    generateurMessage.setNumeroSequence(numeroEmission);
+    if (generateurMessage.generer(baliseCourante.getMessage(), messageFinal, sizeof(messageFinal)) != MESSAGE_OK) {
+      // Plutôt qu'un message coupé n'importe où, on n'émet rien pendant cette minute.
+      journal.evenement(NIVEAU_ERREUR, EVT_MESSAGE_TROP_LONG, indexBalisePreparee + 1);
+      return;
+    }
     
+    // On fait traduire le message d'avance : on connaît ainsi sa durée exacte et on
+    // vérifie qu'il tient dans la minute, une fois le locator inséré.
+    unsigned long dureePrevueMs;
+    if (mode == MODE_WSPR) {
+      // Le message est l'indicatif : il est codé avec le locator et la puissance en 162 symboles.
+      if (!emetteurFSK.preparerWSPR(baliseCourante, messageFinal, gestionGPS.getLocator(), PUISSANCE_WSPR_DBM)) {
+        journal.evenement(NIVEAU_ERREUR, EVT_MODE_IMPOSSIBLE, indexBalisePreparee + 1);
+        return;
+      }
+      dureePrevueMs = emetteurFSK.getDureeMs();
+    } else {
+      // En QRSS, un message tient rarement dans une minute : il peut occuper tout le reste de son créneau.
+      unsigned long dureeMaxMs = DUREE_MAX_EMISSION_MS;
+      uint16_t unitesMax = SequenceMorse::unitesPourDuree(dureeMaxMs, MORSE_MOT_PAR_MINUTE);
+      if (mode == MODE_QRSS) {
+        uint8_t creneau = planning.getDureeCreneau();
+        dureeMaxMs += 60000UL * (creneau - 1 - (secondeDepart / 60) % creneau);
+        unitesMax = dureeMaxMs / QRSS_DUREE_POINT_MS;
+      }
+      if (!emetteurMorse.preparer(messageFinal, unitesMax)) {
+        journal.evenement(NIVEAU_ALERTE, EVT_MESSAGE_TRONQUE, indexBalisePreparee + 1);
+        if (!TRONQUER_MESSAGES_TROP_LONGS) {
+          // On n'émet rien cette minute : la balise suivante viendra à son créneau.
+          return;
+        }
+      }
+      dureePrevueMs = emetteurMorse.getSequence().getDureeMs(MORSE_MOT_PAR_MINUTE);
+      if (mode == MODE_QRSS) {
+        // Le chanteur rejoue la séquence du télégraphiste, qui se tait pendant ce temps.
+        if (!emetteurFSK.preparerQRSS(baliseCourante, emetteurMorse.getSequence(), QRSS_DUREE_POINT_MS)) {
+          journal.evenement(NIVEAU_ERREUR, EVT_MODE_IMPOSSIBLE, indexBalisePreparee + 1);
+          return;
+        }
+        dureePrevueMs = emetteurFSK.getDureeMs();
+      }
+    }
+
     // -- Préparation de l'émission radio --
-    // On active le bon filtre pour la bande choisie.
-    digitalWrite(baliseCourante.getFilterPin(), HIGH);
-    // On ordonne au pilote du DDS de générer la bonne fréquence.
-    gestionDDS.setFrequency(baliseCourante.getFrequency());
-    delay(100); // Petite pause pour laisser le temps aux composants de se stabiliser.
+    // Le filtre est déjà commuté (ou finit de l'être : un changement complet tient dans
+    // la seconde qui reste) et le mot d'accord attend dans le DDS. Il n'y a plus rien à
+    // attendre : la fréquence sera validée au tout début de la minute.
+    if (!commutateurFiltres.estPret()) {
+      journal.evenement(NIVEAU_ALERTE, EVT_FILTRE_PAS_PRET, indexBalisePreparee + 1);
+    }
 
     // -- ÉMISSION --
-    Serial.print(F("Emission du message : "));
-    Serial.println(messageFinal);
-    // On demande à notre télégraphiste d'envoyer le message final.
-    emetteurMorse.sendMessage(messageFinal.c_str());
-
-    // -- Nettoyage et préparation pour la prochaine minute --
-    // On désactive le filtre.
-    digitalWrite(baliseCourante.getFilterPin(), LOW);
-    // On passe à la balise suivante de notre liste (et on revient au début si on est à la fin).
-    indexBaliseCourante = (indexBaliseCourante + 1) % NOMBRE_DE_BALISES;
+    // Le journal ne fait que ranger ces lignes : rien ici ne retarde le départ.
+    journal.evenement(NIVEAU_INFO, EVT_EMISSION, indexBalisePreparee + 1);
+    journal.evenement(NIVEAU_DETAIL, EVT_DUREE_PREVUE, dureePrevueMs);
+    journal.message(NIVEAU_DETAIL).println(messageFinal);
+    // On programme la séquence préparée pour le début de la minute : le changement de
+    // fréquence, le départ et la suite de l'émission se feront au fil des passages dans
+    // la tâche de manipulation (ou sous interruption, avec le timer).
+    emissionFSK = mode != MODE_CW;
+    if (emissionFSK) emetteurFSK.startAt(debutEmission, validerFrequenceDDS);
+    else emetteurMorse.startAt(debutMinute, validerFrequenceDDS);
+    emissionEnCours = true;
+    gestionLCD.mettreAJourStatus(STATUT_EMISSION);
+    gestionLCD.displayBeaconInfo("TX", baliseCourante.getFrequency());
+    numeroEmission++;
+    if (demarrageEmissionMs == 0) {
+      // Première émission depuis la mise sous tension : on note quand elle commence.
+      demarrageEmissionMs = millis() + (debutEmission - micros()) / 1000;
+      journal.evenement(NIVEAU_INFO, EVT_PREMIERE_EMISSION, demarrageEmissionMs);
+    }
   }
 
-  // Dès qu'on passe à la seconde "1", on réinitialise notre drapeau.
-  // La balise est de nouveau prête à émettre quand la prochaine minute commencera.
-  if (gestionGPS.getSeconds() > 0) {
+  // Dès qu'on quitte la dernière seconde, on réinitialise notre drapeau.
+  // La balise est de nouveau prête à préparer l'émission de la minute suivante.
+  if (horlogeValide && secondeDuJour % 60 != 59) {
     aEteTransmisCetteMinute = false;
   }
+}
+
+/**
+ * @brief Fonction d'initialisation, exécutée une seule fois au démarrage de l'Arduino.
+ */
+void setup() {
+  // Ouvre la communication avec l'ordinateur pour pouvoir afficher des messages de statut.
+  Serial.begin(VITESSE_CONSOLE);
+  journal.setNiveau(NIVEAU_JOURNAL);
+  journal.println(F("Initialisation de la balise Morse F6KJU..."));
+
+  
+  if (MESURER_DDS_AU_DEMARRAGE) {
+    // Le pilote souple, branché un instant sur les mêmes broches, mesure ses transports puis le nôtre.
+    GestionnaireDDS banc(BROCHE_DDS_W_CLK, BROCHE_DDS_FQ_UD, BROCHE_DDS_DATA, BROCHE_DDS_RESET, PUCE_DDS, HORLOGE_REFERENCE_DDS_HZ);
+    banc.begin();
+    banc.mesurerTransports(Serial, &piloteDDS);
+  }
+  // On demande à notre pilote de DDS de préparer le composant (et de remettre son compteur à zéro).
+  piloteDDS.begin();
+  // On relit le carnet de bord. Au tout premier démarrage (ou si le nombre de balises
+  // du programme a changé), c'est le plan de bandes du programme qui y est recopié.
+  bool carnetLu = memoire.charger();
+  // L'étalonnage de l'horloge du DDS est celui du carnet, une fois qu'il y a été réglé.
+  if (!carnetLu) memoire.setCorrectionPpb(CORRECTION_HORLOGE_DDS_PPB);
+  if (!piloteDDS.setCorrectionPpb(memoire.getCorrectionPpb())) piloteDDS.setCorrectionPpb(CORRECTION_HORLOGE_DDS_PPB);
+  if (carnetLu && memoire.getEnregistrement().nombreBalises == NOMBRE_DE_BALISES) {
+    journal.println(F("Plan de bandes relu en EEPROM."));
+  } else {
+    memoire.importerBalises(PLAN_DE_BANDES, NOMBRE_DE_BALISES);
+    memoire.setPlanning(DUREE_CRENEAU_MINUTES, DECALAGE_SITE);
+  }
+  if (carnetLu && memoire.getEnregistrement().annee != 0) {
+    const EnregistrementMemoire& carnet = memoire.getEnregistrement();
+    // Chaque nombre est ramené à sa largeur, comme sur l'écran : "JJ/MM/AAAA HH:MM" tient toujours.
+    char derniereHeure[24];
+    snprintf(derniereHeure, sizeof(derniereHeure), "%02u/%02u/%04u %02u:%02u", carnet.jour % 100u, carnet.mois % 100u,
+             carnet.annee % 10000u, (unsigned)(carnet.secondeDuJour / 3600 % 24),
+             (unsigned)(carnet.secondeDuJour / 60 % 60));
+    journal.print(F("Derniere heure UTC connue : "));
+    journal.println(derniereHeure);
+  }
+  // Les mots d'accord de toutes les bandes et l'ordre de passage des balises actives
+  // sont calculés une fois pour toutes.
+  appliquerPlanDeBandes();
+
+  // On déclare les filtres et le temps de stabilisation de leur relais : tous les
+  // relais sont relâchés au départ.
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_80M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_40M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_30M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_20M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_17M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_15M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_12M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_10M, STABILISATION_RELAIS_MS);
+  commutateurFiltres.ajouterFiltre(BROCHE_FILTRE_6M, STABILISATION_RELAIS_MS);
+
+  // Si on le souhaite, on confie la manipulation au timer matériel.
+  if (MANIPULATION_PAR_TIMER && !emetteurMorse.utiliserTimer(manipulateurTimer)) {
+    journal.println(F("Timer de manipulation indisponible : manipulation depuis loop()."));
+  }
+  // Les modes WSPR et QRSS ont besoin du timer pour le rythme de leurs symboles.
+  if (!MANIPULATION_PAR_TIMER || !emetteurFSK.utiliserTimer(manipulateurTimer)) {
+    journal.println(F("Pas de timer : les balises WSPR et QRSS ne seront pas emises."));
+  }
+  
+  // On allume l'écran : il affichera l'état de la balise pendant toute l'attente du GPS.
+  gestionLCD.begin();
+  if (MESURER_LCD_AU_DEMARRAGE) {
+    gestionLCD.mesurerRafraichissement(Serial);
+  }
+  gestionLCD.mettreAJourStatus(STATUT_ATTENTE_GPS);
+
+  // Si le PPS du GPS est branché, on s'en sert pour caler les débuts de seconde.
+  if (UTILISER_PPS && !gestionGPS.activerPPS(BROCHE_PPS)) {
+    journal.println(F("Broche PPS sans interruption : horloge calee sur les phrases NMEA."));
+  }
+
+  // -- Attente de la synchronisation GPS --
+  // On n'attend plus ici : la tâche de démarrage suit l'arrivée de l'heure et de la
+  // position, pendant que les autres tâches tournent déjà.
+  // Le dernier locator calculé, s'il y en a un, vaut mieux que celui donné par défaut.
+  gestionGPS.setLocatorParDefaut(memoire.getLocator()[0] != '\0' ? memoire.getLocator() : LOCATOR_PAR_DEFAUT);
+  journal.println(F("En attente de la synchronisation GPS... (Ceci peut prendre quelques minutes)"));
+
+  // Entre deux émissions, la boucle pourra dormir entre deux interruptions.
+  veille.begin(balisePeutSomnoler, VEILLE_ENTRE_EMISSIONS);
+
+  // -- Les tâches de la boucle principale --
+  // Nom, fonction, période (us, 0 : à chaque passage), retard toléré (us), priorité (0 : la plus forte).
+  // La manipulation et le GPS passent en premier : un retard leur ferait rater un front
+  // ou perdre des octets du GPS (le tampon de réception déborde en 66 ms à 9600 bauds).
+  // Les relais des filtres suivent, pour que leur temps de stabilisation soit tenu à la milliseconde.
+  ordonnanceur.ajouterTache("manip", tacheManipulation, 0, 2000UL, 0);
+  ordonnanceur.ajouterTache("filtres", tacheFiltres, 1000UL, 5000UL, 1);
+  ordonnanceur.ajouterTache("gps", tacheGPS, 0, 20000UL, 2);
+  ordonnanceur.ajouterTache("programme", tacheProgrammation, 5000UL, 50000UL, 3);
+  ordonnanceur.ajouterTache("ecran", tacheEcran, 0, 100000UL, 4);
+  ordonnanceur.ajouterTache("affichage", tacheAffichage, 1000000UL, 200000UL, 5);
+  ordonnanceur.ajouterTache("demarrage", tacheDemarrage, 1000000UL, 500000UL, 6);
+  ordonnanceur.ajouterTache("memoire", tacheMemoire, 4000UL, 1000000UL, 7);
+  ordonnanceur.ajouterTache("console", tacheConsole, 50000UL, 1000000UL, 8);
+  if (PERIODE_TELEMETRIE_S > 0) {
+    ordonnanceur.ajouterTache("telemetrie", tacheTelemetrie, PERIODE_TELEMETRIE_S * 1000000UL, 5000000UL, 9);
+  }
+  // Le journal passe en dernier, avec le temps qui reste.
+  ordonnanceur.ajouterTache("journal", tacheJournal, 0, 1000000UL, 10);
+}
+
+/**
+ * @brief Boucle principale, exécutée en continu après le setup().
+ * @details Tout le travail est confié à l'ordonnanceur, qui lance les tâches prêtes.
+ */
+void loop() {
+  ordonnanceur.executer();
+  // Quelques instructions : la télémétrie peut rester active en service.
+  telemetrie.noterPassage(ordonnanceur.getDernierPassageUs());
+  // Si rien ne presse, on dort jusqu'à la prochaine interruption (1 ms au plus).
+  veille.somnoler();
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Décodeur des trames de télémétrie de la balise (voir Telemetrie.h et Telemetrie.cpp).
+
+Le flux du moniteur série mélange le texte du journal et les trames binaires :
+le texte est recopié tel quel, chaque trame valide est affichée en clair.
+
+Utilisation :
+    python3 decoder_telemetrie.py capture.bin               # une capture enregistrée
+    python3 decoder_telemetrie.py --port /dev/ttyACM0       # en direct (module pyserial)
+"""
+import argparse
+import struct
+import sys
+
+SYNCHRO = b"\xA5\x5A"
+TYPE_TELEMETRIE = ord("T")
+FORMAT_V1 = "<BII16HHHBIIHHIII"
+CHAMPS_V1 = ["passage max (us)", "memoire libre min (octets)", "attente max GPS (octets)",
+             "phrases NMEA", "erreurs NMEA", "famines", "gigue max (us)",
+             "mots DDS", "octets LCD", "octets perdus journal"]
+
+
+def crc_ccitt(donnees, crc=0xFFFF):
+    """Même calcul que _crc_ccitt_update() de avr-libc."""
+    for octet in donnees:
+        octet ^= crc & 0xFF
+        octet = (octet ^ (octet << 4)) & 0xFF
+        crc = (((octet << 8) | (crc >> 8)) ^ (octet >> 4) ^ (octet << 3)) & 0xFFFF
+    return crc
+
+
+def decoder(donnees):
+    """Décode les données d'une trame ; renvoie None si la version est inconnue."""
+    if not donnees or donnees[0] != 1 or len(donnees) != struct.calcsize(FORMAT_V1):
+        return None
+    valeurs = struct.unpack(FORMAT_V1, donnees)
+    return {"instant (ms)": valeurs[1], "passages": valeurs[2],
+            "histogramme": list(valeurs[3:19]), **dict(zip(CHAMPS_V1, valeurs[19:]))}
+
+
+def afficher(trame):
+    print("--- telemetrie a %d ms, %d passages" % (trame["instant (ms)"], trame["passages"]))
+    for numero, nombre in enumerate(trame["histogramme"]):
+        if nombre:
+            debut = 0 if numero == 0 else 1 << (numero - 1)
+            if numero == len(trame["histogramme"]) - 1:
+                print("  passage %6d us et plus : %d" % (debut, nombre))
+            else:
+                print("  passage %6d..%6d us : %d" % (debut, (1 << numero) - 1, nombre))
+    for champ in CHAMPS_V1:
+        print("  %s : %d" % (champ, trame[champ]))
+
+
+class Lecteur:
+    """Sépare le texte et les trames dans un flux d'octets arrivant par morceaux."""
+
+    def __init__(self):
+        self.tampon = bytearray()
+        self.trames_fausses = 0
+
+    def ajouter(self, morceau):
+        self.tampon += morceau
+        while True:
+            debut = self.tampon.find(SYNCHRO)
+            if debut < 0:
+                # On garde un éventuel premier octet de synchro en fin de tampon.
+                garde = 1 if self.tampon.endswith(SYNCHRO[:1]) else 0
+                sys.stdout.write(self.tampon[:len(self.tampon) - garde].decode("latin-1"))
+                del self.tampon[:len(self.tampon) - garde]
+                return
+            sys.stdout.write(self.tampon[:debut].decode("latin-1"))
+            del self.tampon[:debut]
+            if len(self.tampon) < 4:
+                return
+            longueur = self.tampon[3]
+            if len(self.tampon) < 4 + longueur + 2:
+                return
+            corps = bytes(self.tampon[2:4 + longueur])
+            (crc,) = struct.unpack("<H", self.tampon[4 + longueur:6 + longueur])
+            trame = decoder(corps[2:]) if corps[0] == TYPE_TELEMETRIE and crc == crc_ccitt(corps) else None
+            if trame is None:
+                # Fausse synchro ou trame abîmée : on saute le premier octet et on cherche plus loin.
+                self.trames_fausses += 1
+                sys.stdout.write(self.tampon[:1].decode("latin-1"))
+                del self.tampon[:1]
+                continue
+            afficher(trame)
+            del self.tampon[:6 + longueur]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("fichier", nargs="?", help="capture du moniteur série")
+    parser.add_argument("--port", help="port série de la balise")
+    parser.add_argument("--vitesse", type=int, default=115200, help="vitesse du port (VITESSE_CONSOLE)")
+    args = parser.parse_args()
+
+    lecteur = Lecteur()
+    if args.port:
+        import serial  # pyserial
+        with serial.Serial(args.port, args.vitesse, timeout=0.5) as port:
+            port.write(b"TELEMETRIE\n")
+            while True:
+                lecteur.ajouter(port.read(256))
+                sys.stdout.flush()
+    else:
+        with open(args.fichier, "rb") if args.fichier else sys.stdin.buffer as entree:
+            lecteur.ajouter(entree.read())
+    if lecteur.trames_fausses:
+        print("(%d trames abimees ou fausses synchros ignorees)" % lecteur.trames_fausses, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
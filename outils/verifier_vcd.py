@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+"""Vérificateur d'une trace VCD de la balise (simulateur --vcd, ou analyseur logique).
+
+Chaque émission commence par une validation de la fréquence (front montant de FQ_UD)
+et se poursuit par la manipulation du PTT. Pour chacune, on vérifie :
+  - le mot d'accord : les 40 derniers bits lus sur DATA aux fronts montants de W_CLK,
+    poids faible en premier, dont 40 exactement depuis la validation précédente ;
+    l'octet de contrôle doit être celui de la puce (--puce), la fréquence figurer dans --frequences si donnée ;
+  - le filtre : un seul relais engagé au moment de la validation ;
+  - le Morse : des éléments de 1 ou 3 unités, des espaces de 1, 3 ou 7 unités ;
+  - la durée : de la validation à la fin de la manipulation, pas plus que le créneau.
+
+Une émission WSPR ou QRSS se reconnaît aux validations qui tombent alors que le PTT est
+déjà appuyé : chacune commence un symbole. On vérifie les mots d'accord comme ci-dessus,
+que chaque ton est un multiple entier de l'écart entre tons, que chaque symbole dure un
+nombre entier de symboles élémentaires (tous 1 en WSPR ; 1, 3 ou 7 points en QRSS), à
+--tolerance de la durée élémentaire près (--symbole, sinon la plus courte), et, avec --tons,
+que la suite des tons est celle attendue.
+
+Utilisation :
+    python3 verifier_vcd.py balise.vcd
+    python3 verifier_vcd.py capture.vcd --mpm 15 --frequences 14099000,18109000
+    python3 verifier_vcd.py capture.vcd --ptt D3 --w-clk D0 --fq-ud D1 --data D2   # autres noms de signaux
+    python3 verifier_vcd.py wspr.vcd --symbole 682.6667 --tons 3320022010...          # émission WSPR
+    python3 verifier_vcd.py balise.vcd --puce AD9851                                  # module AD9851 (30 MHz x 6)
+
+Le code de sortie vaut 1 si une émission est fautive, 2 si la trace est inutilisable.
+"""
+import argparse
+import re
+import sys
+
+UNITES_ELEMENT = (1, 3)
+UNITES_ESPACE = (1, 3, 7)
+NS_PAR_UNITE_TEMPS = {"s": 1e9, "ms": 1e6, "us": 1e3, "ns": 1.0, "ps": 1e-3, "fs": 1e-6}
+# Pour chaque modèle de DDS : horloge de travail par défaut (Hz) et octet de contrôle attendu.
+# L'AD9851 multiplie par 6 sa référence de 30 MHz (bit W32 de l'octet de contrôle).
+PUCES = {"AD9850": (125e6, 0x00), "AD9851": (180e6, 0x01)}
+
+
+def lire_vcd(fichier):
+    """Renvoie {nom: [(instant_ns, niveau), ...]} pour les signaux d'un bit."""
+    noms = {}        # identifiant -> [noms]
+    changements = {}  # identifiant -> [(instant, niveau)]
+    echelle = 1.0
+    instant = 0.0
+    with open(fichier) as entree:
+        jetons = iter(entree.read().split())
+    for jeton in jetons:
+        if jeton == "$timescale":
+            texte = ""
+            for suite in jetons:
+                if suite == "$end":
+                    break
+                texte += suite
+            trouve = re.match(r"(\d+)\s*([a-z]+)", texte)
+            if not trouve:
+                raise ValueError("$timescale illisible : " + texte)
+            echelle = int(trouve.group(1)) * NS_PAR_UNITE_TEMPS[trouve.group(2)]
+        elif jeton == "$var":
+            champs = []
+            for suite in jetons:
+                if suite == "$end":
+                    break
+                champs.append(suite)
+            if len(champs) >= 4 and champs[1] == "1":
+                noms.setdefault(champs[2], []).append(champs[3])
+                changements.setdefault(champs[2], [])
+        elif jeton.startswith("$"):
+            # $dumpvars et $end encadrent des valeurs : on les lit comme les autres.
+            if jeton in ("$dumpvars", "$dumpon", "$dumpoff", "$dumpall", "$end"):
+                continue
+            for suite in jetons:
+                if suite == "$end":
+                    break
+        elif jeton[0] == "#":
+            instant = int(jeton[1:]) * echelle
+        elif jeton[0] in "01xzXZ" and jeton[1:] in changements:
+            niveau = 1 if jeton[0] == "1" else 0
+            liste = changements[jeton[1:]]
+            if not liste or liste[-1][1] != niveau:
+                liste.append((instant, niveau))
+        elif jeton[0] in "bBrR":
+            next(jetons, None)  # Valeur d'un vecteur : son identifiant suit.
+    signaux = {}
+    for identifiant, liste_noms in noms.items():
+        for nom in liste_noms:
+            signaux[nom] = changements[identifiant]
+    return signaux
+
+
+def fronts_montants(changements):
+    return [instant for instant, niveau in changements if niveau == 1]
+
+
+def niveau_a(changements, instant):
+    """Le niveau d'un signal juste avant un instant."""
+    niveau = 0
+    for moment, valeur in changements:
+        if moment >= instant:
+            break
+        niveau = valeur
+    return niveau
+
+
+def decoder_mots(w_clk, data, fq_ud):
+    """Pour chaque validation : (instant, mot de 40 bits, bits envoyés depuis la précédente)."""
+    validations = fronts_montants(fq_ud)
+    horloges = fronts_montants(w_clk)
+    resultats = []
+    bits = []
+    i_data = 0
+    niveau_data = 0
+    i_horloge = 0
+    for validation in validations:
+        envoyes = 0
+        while i_horloge < len(horloges) and horloges[i_horloge] < validation:
+            instant = horloges[i_horloge]
+            # DATA doit être stable avant le front de W_CLK : on prend sa valeur juste avant.
+            while i_data < len(data) and data[i_data][0] < instant:
+                niveau_data = data[i_data][1]
+                i_data += 1
+            bits.append(niveau_data)
+            envoyes += 1
+            i_horloge += 1
+        derniers = bits[-40:]
+        mot = sum(bit << rang for rang, bit in enumerate(derniers)) if len(derniers) == 40 else None
+        resultats.append((validation, mot, envoyes))
+    return resultats
+
+
+def durees(ptt, debut, fin):
+    """Les éléments et les espaces du PTT entre deux instants : [(niveau, debut, duree)]."""
+    fronts = [(instant, niveau) for instant, niveau in ptt if debut <= instant < fin]
+    morceaux = []
+    for (instant, niveau), (suivant, _) in zip(fronts, fronts[1:]):
+        morceaux.append((niveau, instant, suivant - instant))
+    return fronts, morceaux
+
+
+def classer(duree, unite, permis):
+    """Le nombre d'unités le plus proche parmi ceux permis, et l'écart en ns."""
+    unites = min(permis, key=lambda n: abs(duree - n * unite))
+    return unites, duree - unites * unite
+
+
+def verifier_mot(mot, envoyes, horloge, controle, permises, problemes):
+    """Contrôle un mot d'accord décodé ; renvoie sa fréquence en Hz (0 si illisible)."""
+    if mot is None:
+        problemes.append("moins de 40 bits envoyes au DDS")
+        return 0.0
+    if envoyes != 40:
+        problemes.append("%d bits envoyes depuis la validation precedente au lieu de 40" % envoyes)
+    if mot >> 32 != controle:
+        problemes.append("octet de controle 0x%02X au lieu de 0x%02X" % (mot >> 32, controle))
+    frequence = (mot & 0xFFFFFFFF) * horloge / 2 ** 32
+    if permises and not any(abs(frequence - f) <= 1.0 for f in permises):
+        problemes.append("frequence %.2f Hz hors de la liste" % frequence)
+    return frequence
+
+
+def verifier_fsk(numero, symboles, ptt, args, permises, engages):
+    """Une émission à déplacement de fréquence : [(instant, mot, envoyes)] pour chaque symbole."""
+    problemes = []
+    debut = symboles[0][0]
+    fins = [instant for instant, niveau in ptt if instant > debut and niveau == 0]
+    if not fins:
+        print("Emission %d a %.6f s : incomplete a la fin de la trace, ignoree" % (numero, debut / 1e9))
+        return False
+    instants = [instant for instant, _, _ in symboles] + [fins[0]]
+    durees_symboles = [b - a for a, b in zip(instants, instants[1:])]
+
+    mots = []
+    for instant, mot, envoyes in symboles:
+        avant = len(problemes)
+        verifier_mot(mot, envoyes, args.horloge, args.controle, None, problemes)
+        if len(problemes) > avant:
+            problemes[-1] += " (symbole a %.6f s)" % (instant / 1e9)
+        mots.append((mot or 0) & 0xFFFFFFFF)
+    # Chaque ton est arrondi séparément au mot d'accord le plus proche : l'écart entre deux
+    # mots voisins peut varier d'une unité. On l'estime sur le plus petit écart, puis entre
+    # les tons extrêmes, et chaque mot doit tomber à une unité près sur la grille.
+    base = min(mots)
+    ecarts = sorted(set(m - base for m in mots) - {0})
+    ecart = float(ecarts[0]) if ecarts else 1.0
+    tons = [int(round((mot - base) / ecart)) for mot in mots]
+    if any(tons):
+        ecart = (max(mots) - base) / float(max(tons))
+    for mot, ton in zip(mots, tons):
+        if abs(mot - base - ton * ecart) > 1.0:
+            problemes.append("mot 0x%08X hors de la grille des tons" % mot)
+            break
+    frequence = base * args.horloge / 2 ** 32
+    if permises and not any(abs(frequence - f) <= 1.0 for f in permises):
+        problemes.append("frequence %.2f Hz hors de la liste" % frequence)
+
+    # En WSPR, tous les symboles ont la même durée ; en QRSS, ce sont des points, des traits
+    # et des espaces : des multiples entiers de la durée du point.
+    if args.symbole:
+        symbole = args.symbole * 1e6
+    else:
+        courts = sorted(d for d in durees_symboles if d < 1.5 * min(durees_symboles))
+        symbole = courts[len(courts) // 2]
+    tolerance = args.tolerance * symbole
+    multiples = [max(1, int(round(d / symbole))) for d in durees_symboles]
+    ecarts_symboles = [d - m * symbole for d, m in zip(durees_symboles, multiples)]
+    ecart_max = max(abs(e) for e in ecarts_symboles)
+    if ecart_max > tolerance:
+        pire = max(range(len(durees_symboles)), key=lambda i: abs(ecarts_symboles[i]))
+        problemes.append("symbole %d de %.3f ms (%d x %.3f ms %+.1f us)"
+                         % (pire + 1, durees_symboles[pire] / 1e6, multiples[pire], symbole / 1e6, ecarts_symboles[pire] / 1e3))
+    texte_tons = "".join(str(ton) if ton < 10 else "?" for ton in tons)
+    if args.tons is not None and texte_tons != args.tons:
+        ecart_tons = next((i for i, (a, b) in enumerate(zip(texte_tons, args.tons)) if a != b), min(len(texte_tons), len(args.tons)))
+        problemes.append("tons differents de ceux attendus a partir du symbole %d (%d tons au lieu de %d)"
+                         % (ecart_tons + 1, len(texte_tons), len(args.tons)))
+
+    print("Emission %d a %.6f s : FSK, %.2f Hz + k x %.4f Hz, filtre %s, %d symboles de %s x %.3f ms, "
+          "ecart max %.1f us : %s"
+          % (numero, debut / 1e9, frequence, ecart * args.horloge / 2 ** 32, ",".join(engages) or "-",
+             len(symboles), ",".join(str(m) for m in sorted(set(multiples))), symbole / 1e6, ecart_max / 1e3,
+             "OK" if not problemes else "FAUTE"))
+    if args.afficher_tons:
+        print("  tons : " + texte_tons)
+    for probleme in problemes:
+        print("  - " + probleme)
+    return bool(problemes)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("fichier", help="trace VCD")
+    parser.add_argument("--ptt", default="PTT", help="nom du signal du PTT")
+    parser.add_argument("--w-clk", default="DDS_W_CLK", help="nom du signal W_CLK du DDS")
+    parser.add_argument("--fq-ud", default="DDS_FQ_UD", help="nom du signal FQ_UD du DDS")
+    parser.add_argument("--data", default="DDS_DATA", help="nom du signal DATA du DDS")
+    parser.add_argument("--filtres", default="FILTRE_", help="début du nom des signaux des filtres")
+    parser.add_argument("--puce", choices=sorted(PUCES), default="AD9850", help="modèle du DDS (AD9850)")
+    parser.add_argument("--horloge", type=float, help="horloge du DDS en Hz (125 MHz pour l'AD9850, 180 MHz pour l'AD9851)")
+    parser.add_argument("--mpm", type=float, help="rythme en mots par minute (sinon déduit du plus court élément)")
+    parser.add_argument("--tolerance", type=float, default=0.01, help="écart permis, en fraction d'unité (0,01)")
+    parser.add_argument("--creneau", type=float, default=60.0, help="durée du créneau en secondes (60)")
+    parser.add_argument("--frequences", help="fréquences permises en Hz, séparées par des virgules")
+    parser.add_argument("--symbole", type=float, help="durée d'un symbole WSPR ou QRSS en ms (sinon la médiane)")
+    parser.add_argument("--tons", help="suite des tons attendue pour les émissions à déplacement de fréquence")
+    parser.add_argument("--afficher-tons", action="store_true", help="affiche la suite des tons de chaque émission FSK")
+    args = parser.parse_args()
+    horloge, args.controle = PUCES[args.puce]
+    if args.horloge is None:
+        args.horloge = horloge
+
+    try:
+        signaux = lire_vcd(args.fichier)
+    except (OSError, ValueError, KeyError) as erreur:
+        print("Trace illisible : %s" % erreur, file=sys.stderr)
+        return 2
+    manquants = [nom for nom in (args.ptt, args.w_clk, args.fq_ud, args.data) if nom not in signaux]
+    if manquants:
+        print("Signaux absents de la trace : %s" % ", ".join(manquants), file=sys.stderr)
+        return 2
+    ptt = signaux[args.ptt]
+    filtres = {nom: changements for nom, changements in signaux.items() if nom.startswith(args.filtres)}
+    permises = [float(f) for f in args.frequences.split(",")] if args.frequences else None
+
+    validations = decoder_mots(signaux[args.w_clk], signaux[args.data], signaux[args.fq_ud])
+    # Une validation qui tombe PTT appuyé commence un symbole d'une émission FSK.
+    pendant_emission = [niveau_a(ptt, debut) == 1 for debut, _, _ in validations]
+
+    if args.mpm:
+        unite = 1.2e9 / args.mpm
+    else:
+        elements = []
+        for index, (debut, _, _) in enumerate(validations):
+            fin = validations[index + 1][0] if index + 1 < len(validations) else float("inf")
+            if not pendant_emission[index] and not (index + 1 < len(validations) and pendant_emission[index + 1]):
+                elements += [duree for niveau, _, duree in durees(ptt, debut, fin)[1] if niveau == 1]
+        if not elements and not any(pendant_emission):
+            print("Aucune manipulation dans la trace.")
+            return 2
+        plus_court = min(elements) if elements else 1.0
+        points = sorted(d for d in elements if d < 2 * plus_court) or [1.2e9 / 15]
+        unite = points[len(points) // 2]
+    tolerance = args.tolerance * unite
+    print("Unite Morse : %.3f ms (%.1f mots par minute), tolerance %.1f us"
+          % (unite / 1e6, 1.2e9 / unite, tolerance / 1e3))
+
+    fautes = 0
+    numero = 0
+    emissions_fsk = 0
+    for index, (debut, mot, envoyes) in enumerate(validations):
+        if pendant_emission[index]:
+            continue  # Déjà vue avec le début de son émission FSK.
+        fin = validations[index + 1][0] if index + 1 < len(validations) else float("inf")
+        fronts, morceaux = durees(ptt, debut, fin)
+        if not fronts:
+            continue
+        numero += 1
+        engages = [nom for nom, changements in sorted(filtres.items()) if niveau_a(changements, debut) == 1]
+
+        if index + 1 < len(validations) and pendant_emission[index + 1]:
+            suite = index + 1
+            while suite < len(validations) and pendant_emission[suite]:
+                suite += 1
+            problemes_filtre = filtres and len(engages) != 1
+            faute = verifier_fsk(numero, validations[index:suite], ptt, args, permises, engages)
+            emissions_fsk += 1
+            if problemes_filtre:
+                print("  - %d filtres engages a la validation" % len(engages))
+            fautes += bool(faute or problemes_filtre)
+            continue
+
+        problemes = []
+        frequence = verifier_mot(mot, envoyes, args.horloge, args.controle, permises, problemes)
+        if filtres and len(engages) != 1:
+            problemes.append("%d filtres engages a la validation" % len(engages))
+
+        if fronts[-1][1] == 1:
+            print("Emission %d a %.6f s : incomplete a la fin de la trace, ignoree" % (numero, debut / 1e9))
+            continue
+        ecart_max = 0.0
+        for niveau, instant, duree in morceaux:
+            if niveau == 0 and duree > 7 * unite + tolerance:
+                continue  # Le silence entre deux messages répétés dans la même validation.
+            unites, ecart = classer(duree, unite, UNITES_ELEMENT if niveau else UNITES_ESPACE)
+            ecart_max = max(ecart_max, abs(ecart))
+            if abs(ecart) > tolerance:
+                problemes.append("%s de %.3f ms a %.6f s (%d unites %+.1f us)"
+                                 % ("element" if niveau else "espace", duree / 1e6, instant / 1e9, unites, ecart / 1e3))
+        duree_totale = fronts[-1][0] - debut
+        if duree_totale > args.creneau * 1e9:
+            problemes.append("duree %.3f s au-dela du creneau de %.0f s" % (duree_totale / 1e9, args.creneau))
+
+        print("Emission %d a %.6f s : %.2f Hz (mot 0x%08X), filtre %s, %d elements, duree %.3f s, "
+              "ecart max %.1f us : %s"
+              % (numero, debut / 1e9, frequence, (mot or 0) & 0xFFFFFFFF, ",".join(engages) or "-",
+                 sum(1 for m in morceaux if m[0] == 1), duree_totale / 1e9, ecart_max / 1e3,
+                 "OK" if not problemes else "FAUTE"))
+        for probleme in problemes:
+            print("  - " + probleme)
+        fautes += bool(problemes)
+
+    if args.tons is not None and emissions_fsk == 0:
+        # Des tons attendus sans émission FSK : l'émission attendue n'a pas eu lieu.
+        print("Aucune emission FSK, alors que des tons sont attendus")
+        fautes += 1
+    print("%d emissions verifiees, %d fautives" % (numero, fautes))
+    return 1 if fautes else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
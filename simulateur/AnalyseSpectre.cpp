@@ -0,0 +1,115 @@
+/**
+ * @file AnalyseSpectre.cpp
+ * @brief Implémentation de la classe AnalyseSpectre.
+ */
+#include "AnalyseSpectre.h"
+#include <math.h>
+#include <string.h>
+
+/// Niveau plancher des rapports, en dB : en dessous, le spectre est tenu pour vide.
+static const double NIVEAU_PLANCHER_DB = -200;
+
+/// Les écarts au ton le plus fort donnés dans le rapport.
+static const double ECARTS_RAPPORT_HZ[] = { 50, 100, 200, 500, 1000 };
+
+AnalyseSpectre::AnalyseSpectre(unsigned long echantillonsParSeconde)
+  : _hertzParRaie((double)echantillonsParSeconde / TAILLE_TRANCHE), _tranche(TAILLE_TRANCHE), _remplissage(0),
+    _fenetre(TAILLE_TRANCHE), _tours(TAILLE_TRANCHE / 2), _calcul(TAILLE_TRANCHE), _cumul(TAILLE_TRANCHE / 2 + 1, 0.0),
+    _tranches(0) {
+  for (size_t n = 0; n < TAILLE_TRANCHE; n++) _fenetre[n] = (float)(0.5 - 0.5 * cos(2 * M_PI * n / TAILLE_TRANCHE));
+  for (size_t k = 0; k < TAILLE_TRANCHE / 2; k++) _tours[k] = std::polar(1.0, -2 * M_PI * k / TAILLE_TRANCHE);
+}
+
+void AnalyseSpectre::ecrire(const float* echantillons, size_t nombre) {
+  while (nombre > 0) {
+    size_t morceau = TAILLE_TRANCHE - _remplissage;
+    if (morceau > nombre) morceau = nombre;
+    memcpy(&_tranche[_remplissage], echantillons, morceau * sizeof(float));
+    _remplissage += morceau;
+    echantillons += morceau;
+    nombre -= morceau;
+    if (_remplissage == TAILLE_TRANCHE) {
+      analyserTranche();
+      // La tranche suivante reprend la seconde moitié de celle-ci.
+      memmove(&_tranche[0], &_tranche[TAILLE_TRANCHE / 2], TAILLE_TRANCHE / 2 * sizeof(float));
+      _remplissage = TAILLE_TRANCHE / 2;
+    }
+  }
+}
+
+void AnalyseSpectre::analyserTranche() {
+  bool silence = true;
+  for (size_t n = 0; n < TAILLE_TRANCHE && silence; n++) silence = _tranche[n] == 0;
+  if (silence) return;
+
+  // FFT en place, de base 2 : rangement en ordre de bits inversé, puis papillons.
+  for (size_t n = 0, j = 0; n < TAILLE_TRANCHE; n++) {
+    _calcul[j] = _tranche[n] * _fenetre[n];
+    size_t bit = TAILLE_TRANCHE >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j |= bit;
+  }
+  for (size_t longueur = 2; longueur <= TAILLE_TRANCHE; longueur <<= 1) {
+    size_t pas = TAILLE_TRANCHE / longueur;
+    for (size_t debut = 0; debut < TAILLE_TRANCHE; debut += longueur) {
+      for (size_t k = 0; k < longueur / 2; k++) {
+        std::complex<double> impair = _calcul[debut + k + longueur / 2] * _tours[k * pas];
+        _calcul[debut + k + longueur / 2] = _calcul[debut + k] - impair;
+        _calcul[debut + k] += impair;
+      }
+    }
+  }
+  for (size_t k = 0; k <= TAILLE_TRANCHE / 2; k++) _cumul[k] += std::norm(_calcul[k]);
+  _tranches++;
+}
+
+unsigned long AnalyseSpectre::getTranches() const { return _tranches; }
+
+size_t AnalyseSpectre::raiePic() const {
+  size_t pic = 0;
+  for (size_t k = 1; k < _cumul.size(); k++) {
+    if (_cumul[k] > _cumul[pic]) pic = k;
+  }
+  return pic;
+}
+
+double AnalyseSpectre::getFrequencePicHz() const { return raiePic() * _hertzParRaie; }
+
+double AnalyseSpectre::getNiveauAuDelaDb(double ecartHz) const {
+  size_t pic = raiePic();
+  double plusFort = 0;
+  for (size_t k = 0; k < _cumul.size(); k++) {
+    if (fabs(((double)k - (double)pic) * _hertzParRaie) >= ecartHz && _cumul[k] > plusFort) plusFort = _cumul[k];
+  }
+  if (plusFort <= 0 || _cumul[pic] <= 0) return NIVEAU_PLANCHER_DB;
+  double niveau = 10 * log10(plusFort / _cumul[pic]);
+  return niveau < NIVEAU_PLANCHER_DB ? NIVEAU_PLANCHER_DB : niveau;
+}
+
+double AnalyseSpectre::getBandeHz(double niveauDb) const {
+  size_t pic = raiePic();
+  double seuil = _cumul[pic] * pow(10, niveauDb / 10);
+  size_t bas = pic, haut = pic;
+  for (size_t k = 0; k < _cumul.size(); k++) {
+    if (_cumul[k] > seuil) {
+      if (k < bas) bas = k;
+      if (k > haut) haut = k;
+    }
+  }
+  return (haut - bas) * _hertzParRaie;
+}
+
+void AnalyseSpectre::rapport(FILE* sortie) const {
+  if (_tranches == 0) {
+    fprintf(sortie, "Spectre : aucun son a analyser\n");
+    return;
+  }
+  fprintf(sortie, "Spectre : %lu tranches de %u echantillons, %.2f Hz par raie, ton le plus fort a %.1f Hz\n", _tranches,
+          (unsigned)TAILLE_TRANCHE, _hertzParRaie, getFrequencePicHz());
+  fprintf(sortie, "Niveau le plus haut au-dela de l'ecart :");
+  const size_t nombreEcarts = sizeof(ECARTS_RAPPORT_HZ) / sizeof(ECARTS_RAPPORT_HZ[0]);
+  for (size_t i = 0; i < nombreEcarts; i++) {
+    fprintf(sortie, "%s %.0f Hz %.1f dB", i == 0 ? "" : ",", ECARTS_RAPPORT_HZ[i], getNiveauAuDelaDb(ECARTS_RAPPORT_HZ[i]));
+  }
+  fprintf(sortie, "\nBande occupee (clics de manipulation) : %.0f Hz a -40 dB, %.0f Hz a -60 dB\n", getBandeHz(-40), getBandeHz(-60));
+}
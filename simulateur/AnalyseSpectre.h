@@ -0,0 +1,69 @@
+/**
+ * @file AnalyseSpectre.h
+ * @brief La mesure du spectre du son rendu, et de la largeur qu'y occupent les clics de manipulation.
+ */
+#ifndef SIMULATEUR_ANALYSE_SPECTRE_H
+#define SIMULATEUR_ANALYSE_SPECTRE_H
+
+#include <complex>
+#include <vector>
+#include "RenduAudio.h"
+
+/**
+ * @class AnalyseSpectre
+ * @brief L'"analyseur de spectre" branché sur le haut-parleur, pour chiffrer les clics de manipulation.
+ * @details Une porteuse coupée net s'entend des centaines de hertz de part et d'autre
+ * de sa fréquence : ce sont les clics de manipulation, qui gênent les stations voisines.
+ * L'analyseur fait la moyenne des spectres de tranches de `TAILLE_TRANCHE` échantillons,
+ * pondérées par une fenêtre de Hann et chevauchées de moitié (méthode de Welch). Les
+ * tranches tout à fait silencieuses sont écartées : seul compte le son de la balise.
+ *
+ * Le rapport donne, par rapport au ton le plus fort, le niveau le plus haut trouvé au-delà
+ * de quelques écarts, et la largeur de bande occupée au-dessus de -40 et -60 dB.
+ */
+class AnalyseSpectre : public SortieAudio {
+public:
+  /// Nombre d'échantillons d'une tranche (une puissance de 2).
+  static const size_t TAILLE_TRANCHE = 8192;
+
+  explicit AnalyseSpectre(unsigned long echantillonsParSeconde);
+
+  void ecrire(const float* echantillons, size_t nombre) override;
+
+  /// Nombre de tranches prises en compte.
+  unsigned long getTranches() const;
+
+  /// La fréquence du ton le plus fort, en hertz.
+  double getFrequencePicHz() const;
+
+  /**
+   * @brief Donne le niveau le plus haut à `ecartHz` ou plus du ton le plus fort, en dB par rapport à lui.
+   */
+  double getNiveauAuDelaDb(double ecartHz) const;
+
+  /**
+   * @brief Donne la largeur de la bande où le spectre dépasse `niveauDb` (négatif) sous le ton le plus fort.
+   */
+  double getBandeHz(double niveauDb) const;
+
+  /// Écrit le rapport de la mesure.
+  void rapport(FILE* sortie) const;
+
+private:
+  /// Interne : ajoute au cumul le spectre de la tranche en attente.
+  void analyserTranche();
+
+  /// Interne : la raie la plus forte du cumul.
+  size_t raiePic() const;
+
+  double _hertzParRaie;
+  std::vector<float> _tranche;               ///< Les échantillons de la tranche en cours.
+  size_t _remplissage;                       ///< Nombre d'échantillons déjà dans la tranche.
+  std::vector<float> _fenetre;               ///< La fenêtre de Hann.
+  std::vector<std::complex<double>> _tours;  ///< Les facteurs de rotation de la FFT.
+  std::vector<std::complex<double>> _calcul; ///< La tranche pendant la FFT.
+  std::vector<double> _cumul;                ///< La somme des puissances, raie par raie (0 à TAILLE_TRANCHE / 2).
+  unsigned long _tranches;
+};
+
+#endif
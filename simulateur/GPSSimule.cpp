@@ -0,0 +1,166 @@
+/**
+ * @file GPSSimule.cpp
+ * @brief Implémentation de la classe GPSSimule.
+ * @details Contient la fabrication des phrases RMC et GGA (somme de contrôle comprise),
+ * la relecture d'un enregistrement et la programmation des impulsions PPS.
+ */
+#include "GPSSimule.h"
+#include <fstream>
+
+using namespace simulation;
+
+/// Durée d'un octet à 9600 bauds (10 bits).
+static const uint64_t NS_PAR_OCTET_GPS = 10ULL * NS_PAR_SECONDE / 9600;
+/// Nombre de débuts de minute retenus.
+static const size_t DEBUTS_MINUTE_RETENUS = 4;
+
+/**
+ * @brief Ajoute "*XX\r\n" à une phrase qui commence par '$'.
+ */
+static std::string terminerPhrase(const std::string& phrase) {
+  uint8_t somme = 0;
+  for (size_t i = 1; i < phrase.size(); i++) somme ^= (uint8_t)phrase[i];
+  char fin[8];
+  snprintf(fin, sizeof(fin), "*%02X\r\n", somme);
+  return phrase + fin;
+}
+
+/**
+ * @brief Écrit une coordonnée au format NMEA ("ddmm.mmmmm" ou "dddmm.mmmmm").
+ */
+static std::string coordonnee(long micro, int chiffresDegres, char positif, char negatif) {
+  unsigned long valeur = micro < 0 ? -micro : micro;
+  unsigned long degres = valeur / 1000000UL;
+  unsigned long centMillemesMinute = (valeur % 1000000UL) * 60UL / 10UL;
+  char texte[24];
+  snprintf(texte, sizeof(texte), "%0*lu%02lu.%05lu,%c", chiffresDegres, degres, centMillemesMinute / 100000UL,
+           centMillemesMinute % 100000UL, micro < 0 ? negatif : positif);
+  return texte;
+}
+
+/**
+ * @brief Avance une date d'un certain nombre de jours.
+ */
+static void ajouterJours(uint16_t& annee, uint8_t& mois, uint8_t& jour, unsigned long jours) {
+  static const uint8_t JOURS_PAR_MOIS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  while (jours-- > 0) {
+    bool bissextile = (annee % 4 == 0 && annee % 100 != 0) || annee % 400 == 0;
+    uint8_t dernier = JOURS_PAR_MOIS[mois - 1] + (mois == 2 && bissextile ? 1 : 0);
+    if (++jour > dernier) {
+      jour = 1;
+      if (++mois > 12) {
+        mois = 1;
+        annee++;
+      }
+    }
+  }
+}
+
+GPSSimule::GPSSimule(const Reglages& reglages)
+  : _reglages(reglages), _position(0), _debutSalve(0), _numeroSalve(0), _prochainPPS(1) {}
+
+bool GPSSimule::chargerEnregistrement(const char* fichier) {
+  std::ifstream entree(fichier);
+  if (!entree) return false;
+  _enregistrement.clear();
+  std::string ligne;
+  while (std::getline(entree, ligne)) {
+    while (!ligne.empty() && (ligne.back() == '\r' || ligne.back() == '\n')) ligne.pop_back();
+    if (ligne.size() < 6 || ligne[0] != '$') continue;
+    bool rmc = ligne.compare(3, 3, "RMC") == 0;
+    if (rmc || _enregistrement.empty()) _enregistrement.push_back(Salve{ std::string(), -1 });
+    if (rmc && ligne.size() > 13 && ligne[6] == ',' && ligne[7] != ',') {
+      int heure = atoi(ligne.substr(7, 2).c_str());
+      int minute = atoi(ligne.substr(9, 2).c_str());
+      int seconde = atoi(ligne.substr(11, 2).c_str());
+      _enregistrement.back().secondeDuJour = heure * 3600L + minute * 60L + seconde;
+    }
+    _enregistrement.back().texte += ligne + "\r\n";
+  }
+  // Tant qu'aucune RMC n'est venue, on n'a pas de quoi rythmer les secondes.
+  if (_enregistrement.size() == 1 && _enregistrement[0].secondeDuJour < 0) _enregistrement.clear();
+  return !_enregistrement.empty();
+}
+
+uint64_t GPSSimule::instantSeconde(uint32_t n) const {
+  return (uint64_t)n * NS_PAR_SECONDE - _reglages.phaseNs;
+}
+
+long GPSSimule::secondeUTC(uint32_t n) const {
+  if (!_enregistrement.empty()) {
+    return n >= 1 && n <= _enregistrement.size() ? _enregistrement[n - 1].secondeDuJour : -1;
+  }
+  if (n < _reglages.delaiHeureS) return -1;
+  return (_reglages.secondeDuJour + n) % 86400UL;
+}
+
+std::string GPSSimule::fabriquerSalve(uint32_t n) const {
+  long seconde = secondeUTC(n);
+  if (seconde < 0) {
+    // Démarrage à froid : ni heure ni position, mais déjà quelques satellites.
+    char gga[48];
+    snprintf(gga, sizeof(gga), "$GPGGA,,,,,,0,%02u,,,,,,,", (unsigned)(n / 8 > 3 ? 3 : n / 8));
+    return terminerPhrase("$GPRMC,,V,,,,,,,,,,N") + terminerPhrase(gga);
+  }
+
+  uint16_t annee = _reglages.annee;
+  uint8_t mois = _reglages.mois, jour = _reglages.jour;
+  ajouterJours(annee, mois, jour, (_reglages.secondeDuJour + n) / 86400UL);
+  char heure[24], date[12];
+  snprintf(heure, sizeof(heure), "%02ld%02ld%02ld.00", seconde / 3600, (seconde / 60) % 60, seconde % 60);
+  snprintf(date, sizeof(date), "%02u%02u%02u", jour, mois, annee % 100);
+
+  if (n < _reglages.delaiPositionS) {
+    return terminerPhrase(std::string("$GPRMC,") + heure + ",V,,,,,,," + date + ",,,N") +
+           terminerPhrase(std::string("$GPGGA,") + heure + ",,,,,0,04,,,,,,,");
+  }
+  std::string latitude = coordonnee(_reglages.latitudeMicro, 2, 'N', 'S');
+  std::string longitude = coordonnee(_reglages.longitudeMicro, 3, 'E', 'W');
+  return terminerPhrase(std::string("$GPRMC,") + heure + ",A," + latitude + "," + longitude + ",0.02,," + date + ",,,A") +
+         terminerPhrase(std::string("$GPGGA,") + heure + "," + latitude + "," + longitude + ",1,08,1.01,35.0,M,47.0,M,,");
+}
+
+bool GPSSimule::preparerSalve(uint32_t n) {
+  if (!_enregistrement.empty()) {
+    if (n > _enregistrement.size()) return false;
+    _salve = _enregistrement[n - 1].texte;
+  } else {
+    _salve = fabriquerSalve(n);
+  }
+  _numeroSalve = n;
+  _position = 0;
+  _debutSalve = instantSeconde(n) + _reglages.retardPhrasesNs;
+  return true;
+}
+
+bool GPSSimule::prochainOctet(uint64_t& instantNs, uint8_t& octet) {
+  while (_position >= _salve.size()) {
+    if (!preparerSalve(_numeroSalve + 1)) return false;
+  }
+  instantNs = _debutSalve + _position * NS_PAR_OCTET_GPS;
+  octet = (uint8_t)_salve[_position];
+  return true;
+}
+
+void GPSSimule::consommer() { _position++; }
+
+void GPSSimule::planifier(uint8_t interruption) {
+  // On regarde une seconde devant : l'impulsion précédente est alors forcément passée.
+  while (instantSeconde(_prochainPPS) <= maintenant() + NS_PAR_SECONDE) {
+    uint32_t n = _prochainPPS++;
+    long seconde = secondeUTC(n);
+    if (seconde < 0) continue; // Sans heure, un module GPS ne donne pas encore de PPS.
+    if (seconde % 60 == 0) {
+      _debutsMinute.push_back(instantSeconde(n));
+      if (_debutsMinute.size() > DEBUTS_MINUTE_RETENUS) _debutsMinute.pop_front();
+    }
+    if (_reglages.pps && instantSeconde(n) > maintenant()) programmerFront(interruption, instantSeconde(n));
+  }
+}
+
+uint64_t GPSSimule::debutMinuteAvant(uint64_t instantNs) const {
+  for (auto debut = _debutsMinute.rbegin(); debut != _debutsMinute.rend(); ++debut) {
+    if (*debut <= instantNs) return *debut;
+  }
+  return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file GPSSimule.h
+ * @brief Un module GPS virtuel : impulsions PPS et phrases NMEA, à leur heure, sur l'horloge du simulateur.
+ */
+#ifndef SIMULATEUR_GPS_SIMULE_H
+#define SIMULATEUR_GPS_SIMULE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "Simulation.h"
+
+/**
+ * @class GPSSimule
+ * @brief Le "comédien" qui joue le module GPS branché sur `Serial1` et sur la broche PPS.
+ * @details Chaque seconde UTC commence par une impulsion PPS, suivie un peu plus tard
+ * d'une salve de phrases qui annoncent cette seconde, envoyées octet par octet à 9600
+ * bauds. Les phrases sont :
+ * - soit fabriquées (RMC et GGA), avec une heure puis une position qui n'arrivent
+ *   qu'après un temps réglable, comme au démarrage à froid d'un vrai module ;
+ * - soit relues dans un enregistrement : une nouvelle salve commence à chaque phrase RMC.
+ *
+ * Le GPS virtuel connaît l'heure vraie : il retient l'instant exact de chaque début de
+ * minute, qui sert de référence aux mesures du simulateur.
+ */
+class GPSSimule : public simulation::SourceSerie {
+public:
+  /**
+   * @brief Les réglages du module fabriqué.
+   */
+  struct Reglages {
+    uint16_t annee = 2024;             ///< La date UTC à la mise sous tension.
+    uint8_t mois = 6;
+    uint8_t jour = 21;
+    uint32_t secondeDuJour = 12 * 3600UL + 58 * 60UL + 30; ///< L'heure UTC de la mise sous tension, en secondes.
+    uint32_t phaseNs = 300000000UL;    ///< Fraction de seconde déjà écoulée à la mise sous tension.
+    long latitudeMicro = 48856600L;    ///< Position, en millionièmes de degré.
+    long longitudeMicro = 2352200L;
+    uint32_t delaiHeureS = 25;         ///< Temps avant la première heure valide.
+    uint32_t delaiPositionS = 40;      ///< Temps avant la première position valide.
+    uint32_t retardPhrasesNs = 120000000UL; ///< Écart entre le PPS et le début de la salve de phrases.
+    bool pps = true;                   ///< `false` : aucune impulsion PPS.
+  };
+
+  explicit GPSSimule(const Reglages& reglages);
+
+  /**
+   * @brief Remplace les phrases fabriquées par celles d'un enregistrement.
+   * @return `false` si le fichier ne peut pas être lu ou ne contient aucune phrase RMC.
+   */
+  bool chargerEnregistrement(const char* fichier);
+
+  /**
+   * @brief Programme la prochaine impulsion PPS si nécessaire. À appeler régulièrement.
+   * @param interruption L'interruption externe reliée au PPS (INT0 pour la broche 2).
+   */
+  void planifier(uint8_t interruption);
+
+  /**
+   * @brief Donne le début de minute UTC le plus récent avant un instant, en ns (0 s'il n'y en a pas).
+   */
+  uint64_t debutMinuteAvant(uint64_t instantNs) const;
+
+  /// L'instant où commence la seconde UTC numéro `n` depuis la mise sous tension (la première est 1).
+  uint64_t instantSeconde(uint32_t n) const;
+
+  bool prochainOctet(uint64_t& instantNs, uint8_t& octet) override;
+  void consommer() override;
+
+private:
+  /**
+   * @brief Une seconde de l'enregistrement : ses phrases et la seconde UTC qu'elles annoncent.
+   */
+  struct Salve {
+    std::string texte;
+    long secondeDuJour; ///< -1 si l'heure n'est pas donnée.
+  };
+
+  /// Prépare la salve de la seconde `n`. @return `false` s'il n'y en a plus.
+  bool preparerSalve(uint32_t n);
+
+  /// La seconde UTC (depuis minuit) de la seconde numéro `n`, ou -1 si le GPS ne la connaît pas.
+  long secondeUTC(uint32_t n) const;
+
+  /// Fabrique les phrases RMC et GGA de la seconde numéro `n`.
+  std::string fabriquerSalve(uint32_t n) const;
+
+  Reglages _reglages;
+  std::vector<Salve> _enregistrement; ///< Vide : les phrases sont fabriquées.
+  std::string _salve;                 ///< La salve en cours d'envoi.
+  size_t _position;                   ///< Le prochain octet de la salve.
+  uint64_t _debutSalve;               ///< L'instant du premier octet de la salve.
+  uint32_t _numeroSalve;              ///< Le numéro de la seconde de la salve en cours.
+  uint32_t _prochainPPS;              ///< Le numéro de la seconde du prochain PPS à programmer.
+  std::deque<uint64_t> _debutsMinute; ///< Les derniers débuts de minute, du plus ancien au plus récent.
+};
+
+#endif
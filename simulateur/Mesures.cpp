@@ -0,0 +1,89 @@
+/**
+ * @file Mesures.cpp
+ * @brief Implémentation de la classe Mesures.
+ */
+#include "Mesures.h"
+
+using namespace simulation;
+
+/// Au-delà de ce retard sur le début de la minute, un front n'appartient plus au départ du créneau.
+static const uint64_t FENETRE_DEPART_NS = NS_PAR_SECONDE / 2;
+
+Mesures::Mesures(const GPSSimule& gps, uint8_t brochePTT, uint8_t brocheFqUd, int motsParMinute)
+  : _gps(gps), _brochePTT(brochePTT), _brocheFqUd(brocheFqUd),
+    _uniteNs(1200ULL * 1000000ULL / motsParMinute),
+    _derniereMinutePTT(0), _derniereMinuteFqUd(0), _passages(PASSAGE_MAX_US + 1, 0), _nombrePassages(0) {}
+
+void Mesures::Serie::ajouter(uint64_t valeur) {
+  nombre++;
+  somme += valeur;
+  if (valeur > max) max = valeur;
+  uint8_t classe = 0;
+  for (uint64_t limite = 4 * NS_PAR_US; classe < NOMBRE_CLASSES - 1 && valeur > limite; limite *= 4) classe++;
+  classes[classe]++;
+}
+
+void Mesures::Serie::ecrire(FILE* sortie, const char* titre) const {
+  fprintf(sortie, "%s : %lu mesures", titre, nombre);
+  if (nombre == 0) {
+    fprintf(sortie, "\n");
+    return;
+  }
+  fprintf(sortie, ", moyenne %.1f us, max %.1f us\n   ", somme / nombre / NS_PAR_US, (double)max / NS_PAR_US);
+  static const char* const LIMITES[NOMBRE_CLASSES] = { "<=4us", "<=16us", "<=64us", "<=256us", "<=1ms", "<=4ms", ">4ms" };
+  for (uint8_t i = 0; i < NOMBRE_CLASSES; i++) fprintf(sortie, " %s:%lu", LIMITES[i], classes[i]);
+  fprintf(sortie, "\n");
+}
+
+void Mesures::noterTransition(uint64_t instantNs, uint8_t broche, uint8_t niveau) {
+  if (broche != _brochePTT && broche != _brocheFqUd) return;
+  uint64_t debutMinute = _gps.debutMinuteAvant(instantNs);
+  if (debutMinute == 0) return; // Pas encore d'heure vraie.
+  uint64_t ecoule = instantNs - debutMinute;
+
+  if (broche == _brocheFqUd) {
+    // Seule la validation du début de la minute compte.
+    if (niveau == HIGH && ecoule < FENETRE_DEPART_NS && debutMinute != _derniereMinuteFqUd) {
+      _derniereMinuteFqUd = debutMinute;
+      _departsFqUd.ajouter(ecoule);
+    }
+    return;
+  }
+
+  if (niveau == HIGH && ecoule < FENETRE_DEPART_NS && debutMinute != _derniereMinutePTT) {
+    _derniereMinutePTT = debutMinute;
+    _departsPTT.ajouter(ecoule);
+  }
+  // Tout front devrait tomber sur un nombre entier d'unités depuis le début de la minute.
+  uint64_t reste = ecoule % _uniteNs;
+  _ecartsFronts.ajouter(reste <= _uniteNs / 2 ? reste : _uniteNs - reste);
+}
+
+void Mesures::noterPassage(unsigned long dureeUs) {
+  _passages[dureeUs < PASSAGE_MAX_US ? dureeUs : PASSAGE_MAX_US]++;
+  _nombrePassages++;
+}
+
+unsigned long Mesures::centile(double fraction) const {
+  if (_nombrePassages == 0) return 0;
+  unsigned long seuil = (unsigned long)(fraction * _nombrePassages);
+  if (seuil >= _nombrePassages) seuil = _nombrePassages - 1;
+  unsigned long cumul = 0;
+  for (size_t duree = 0; duree <= PASSAGE_MAX_US; duree++) {
+    cumul += _passages[duree];
+    if (cumul > seuil) return duree;
+  }
+  return PASSAGE_MAX_US;
+}
+
+void Mesures::rapport(FILE* sortie, uint64_t dureeSimuleeNs, double dureeReelleS) const {
+  double simuleeS = (double)dureeSimuleeNs / NS_PAR_SECONDE;
+  fprintf(sortie, "\n=== Banc d'essai : %.2f h simulees en %.1f s (%.0f fois le temps reel)\n", simuleeS / 3600,
+          dureeReelleS, dureeReelleS > 0 ? simuleeS / dureeReelleS : 0.0);
+  _departsFqUd.ecrire(sortie, "Depart des creneaux, validation de la frequence (FQ_UD)");
+  _departsPTT.ecrire(sortie, "Depart des creneaux, premier front du PTT");
+  _ecartsFronts.ecrire(sortie, "Manipulation, ecart des fronts du PTT a la grille des unites");
+  fprintf(sortie, "Passages dans loop() : %lu, en us : mediane %lu, 90%% %lu, 99%% %lu, 99,9%% %lu, max %lu%s\n",
+          _nombrePassages, centile(0.5), centile(0.9), centile(0.99), centile(0.999), centile(1.0),
+          _passages[PASSAGE_MAX_US] > 0 ? " (ou plus)" : "");
+}
@@ -0,0 +1,78 @@
+/**
+ * @file Mesures.h
+ * @brief Le banc d'essai du simulateur : précision de la manipulation, départ des créneaux, latence de la boucle.
+ */
+#ifndef SIMULATEUR_MESURES_H
+#define SIMULATEUR_MESURES_H
+
+#include <vector>
+#include "GPSSimule.h"
+
+/**
+ * @class Mesures
+ * @brief Le "chronométreur" qui juge la balise depuis l'extérieur, avec l'heure vraie du GPS virtuel.
+ * @details Trois mesures, sur toute la durée simulée :
+ * - l'écart de chaque front du PTT à la grille des unités Morse comptée depuis le début
+ *   de la minute : en Morse, tout front tombe sur un nombre entier d'unités ;
+ * - le retard du départ de chaque créneau : validation de la fréquence (FQ_UD) et
+ *   premier front du PTT, comptés depuis le début vrai de la minute ;
+ * - la répartition des durées de passage dans `loop()`, à la microseconde.
+ */
+class Mesures {
+public:
+  /**
+   * @param gps Le GPS virtuel, qui donne le début vrai de chaque minute.
+   * @param brochePTT La broche du PTT.
+   * @param brocheFqUd La broche FQ_UD du DDS.
+   * @param motsParMinute Le rythme de la manipulation.
+   */
+  Mesures(const GPSSimule& gps, uint8_t brochePTT, uint8_t brocheFqUd, int motsParMinute);
+
+  /// À brancher comme observateur des broches (voir `simulation::setObservateur()`).
+  void noterTransition(uint64_t instantNs, uint8_t broche, uint8_t niveau);
+
+  /// À appeler après chaque passage dans `loop()`, avec sa durée.
+  void noterPassage(unsigned long dureeUs);
+
+  /**
+   * @brief Écrit le rapport du banc d'essai.
+   * @param dureeSimuleeNs Le temps simulé.
+   * @param dureeReelleS Le temps qu'a pris la simulation, en secondes.
+   */
+  void rapport(FILE* sortie, uint64_t dureeSimuleeNs, double dureeReelleS) const;
+
+private:
+  /// Nombre de classes de la répartition d'une série : jusqu'à 4 µs, 16 µs, 64 µs... et au-delà de 4 ms.
+  static const uint8_t NOMBRE_CLASSES = 7;
+
+  /**
+   * @brief Une série de mesures en nanosecondes : nombre, somme, maximum et répartition grossière.
+   */
+  struct Serie {
+    unsigned long nombre = 0;
+    double somme = 0;
+    uint64_t max = 0;
+    unsigned long classes[NOMBRE_CLASSES] = {};
+    void ajouter(uint64_t valeur);
+    void ecrire(FILE* sortie, const char* titre) const;
+  };
+
+  /// Plus longue durée de passage classée à la microseconde près ; au-delà, tout va dans la dernière case.
+  static const size_t PASSAGE_MAX_US = 100000;
+
+  /// Donne la durée qu'au moins une fraction des passages dépasse, en µs.
+  unsigned long centile(double fraction) const;
+
+  const GPSSimule& _gps;
+  uint8_t _brochePTT, _brocheFqUd;
+  uint64_t _uniteNs;                  ///< La durée d'une unité Morse.
+  uint64_t _derniereMinutePTT;        ///< Le début de minute du dernier premier front du PTT.
+  uint64_t _derniereMinuteFqUd;       ///< Le début de minute de la dernière validation de fréquence.
+  Serie _ecartsFronts;                ///< Écart des fronts du PTT à la grille des unités.
+  Serie _departsPTT;                  ///< Retard du premier front du PTT.
+  Serie _departsFqUd;                 ///< Retard de la validation de fréquence.
+  std::vector<unsigned long> _passages; ///< Nombre de passages par durée, en µs.
+  unsigned long _nombrePassages;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file RenduAudio.cpp
+ * @brief Implémentation des classes RenduAudio et FichierWAV.
+ */
+#include "RenduAudio.h"
+#include <math.h>
+#include <string.h>
+
+/// Au-delà de ce nombre de tons différents, les tables sont recalculées à la demande.
+static const size_t TONS_EN_MEMOIRE = 64;
+
+void RenduAudio::Rotation::preparer(double pas) {
+  pasRadians = pas;
+  for (size_t n = 0; n < TAILLE_BLOC; n++) {
+    cosinus[n] = (float)cos(n * pas);
+    sinus[n] = (float)sin(n * pas);
+  }
+}
+
+RenduAudio::RenduAudio(unsigned long echantillonsParSeconde, double monteeS, float amplitude)
+  : _echantillonsParSeconde(echantillonsParSeconde), _montee(monteeS * echantillonsParSeconde), _amplitude(amplitude) {
+  _rotationMontee.preparer(_montee > 0 ? M_PI / _montee : 0);
+}
+
+const RenduAudio::Rotation& RenduAudio::rotationDuTon(double frequenceHz) {
+  double pas = 2 * M_PI * frequenceHz / _echantillonsParSeconde;
+  for (const Rotation& rotation : _rotationsTons) {
+    if (rotation.pasRadians == pas) return rotation;
+  }
+  if (_rotationsTons.size() >= TONS_EN_MEMOIRE) _rotationsTons.clear();
+  _rotationsTons.emplace_back();
+  _rotationsTons.back().preparer(pas);
+  return _rotationsTons.back();
+}
+
+bool RenduAudio::ajouterMontee(float* enveloppe, uint64_t debutBloc, size_t nombre, double centre, float sens) {
+  // La montée va de 0 à 1 entre centre - _montee / 2 et centre + _montee / 2 : les
+  // échantillons d'avant ne changent pas, ceux d'après prennent tout le front.
+  double debut = ceil(centre - _montee / 2) - (double)debutBloc;
+  double fin = ceil(centre + _montee / 2) - (double)debutBloc;
+  size_t n1 = debut <= 0 ? 0 : debut >= nombre ? nombre : (size_t)debut;
+  size_t n2 = fin <= 0 ? 0 : fin >= nombre ? nombre : (size_t)fin;
+
+  if (n2 > n1) {
+    // 0,5 + 0,5 × sin(π x), x allant de -1/2 à 1/2 : sin(a + kδ) par les tables.
+    double a = M_PI * ((double)(debutBloc + n1) - centre) / _montee;
+    const float sinA = (float)sin(a) * 0.5f * sens;
+    const float cosA = (float)cos(a) * 0.5f * sens;
+    const float demi = 0.5f * sens;
+    const float* __restrict c = _rotationMontee.cosinus;
+    const float* __restrict s = _rotationMontee.sinus;
+    float* __restrict e = enveloppe + n1;
+    for (size_t k = 0; k < n2 - n1; k++) e[k] += demi + sinA * c[k] + cosA * s[k];
+  }
+  for (size_t k = n2; k < nombre; k++) enveloppe[k] += sens;
+  return fin <= (double)nombre;
+}
+
+uint64_t RenduAudio::rendre(const std::vector<Front>& fronts, const std::vector<Ton>& tons, uint64_t finNs, SortieAudio& sortie) {
+  const double echantillonsParNs = _echantillonsParSeconde / 1e9;
+  const uint64_t total = (uint64_t)ceil(finNs * echantillonsParNs);
+
+  float enveloppe[TAILLE_BLOC];
+  float oscillateur[TAILLE_BLOC];
+  float echantillons[TAILLE_BLOC];
+
+  float niveau = 0;      // La somme des fronts dont la montée est finie.
+  size_t premierFront = 0; // Le premier front dont la montée n'est pas finie.
+  size_t ton = 0;
+  double frequence = tons.empty() ? 0 : tons[0].frequenceHz;
+  double phase = 0;
+
+  for (uint64_t debutBloc = 0; debutBloc < total; debutBloc += TAILLE_BLOC) {
+    const size_t nombre = total - debutBloc < TAILLE_BLOC ? (size_t)(total - debutBloc) : TAILLE_BLOC;
+
+    // L'enveloppe : le niveau acquis, plus les montées qui touchent ce bloc.
+    bool sonore = niveau != 0;
+    for (size_t n = 0; n < nombre; n++) enveloppe[n] = niveau;
+    for (size_t i = premierFront; i < fronts.size(); i++) {
+      double centre = fronts[i].instantNs * echantillonsParNs;
+      if (centre - _montee / 2 >= (double)(debutBloc + nombre)) break;
+      float sens = fronts[i].appui ? 1.0f : -1.0f;
+      bool fini = ajouterMontee(enveloppe, debutBloc, nombre, centre, sens);
+      sonore = true;
+      if (fini && i == premierFront) {
+        niveau += sens;
+        premierFront++;
+      }
+    }
+
+    // L'oscillateur, ton par ton : seule la phase avance pendant un bloc silencieux.
+    size_t n = 0;
+    while (n < nombre) {
+      size_t finTon = nombre;
+      while (ton + 1 < tons.size()) {
+        double changement = ceil(tons[ton + 1].instantNs * echantillonsParNs) - (double)debutBloc;
+        if (changement > (double)n) {
+          if (changement < (double)nombre) finTon = (size_t)changement;
+          break;
+        }
+        frequence = tons[++ton].frequenceHz;
+      }
+      if (sonore) {
+        const Rotation& rotation = rotationDuTon(frequence);
+        const float sinPhase = (float)sin(phase);
+        const float cosPhase = (float)cos(phase);
+        const float* __restrict c = rotation.cosinus;
+        const float* __restrict s = rotation.sinus;
+        float* __restrict o = oscillateur + n;
+        for (size_t k = 0; k < finTon - n; k++) o[k] = sinPhase * c[k] + cosPhase * s[k];
+      }
+      phase = fmod(phase + 2 * M_PI * frequence / _echantillonsParSeconde * (finTon - n), 2 * M_PI);
+      n = finTon;
+    }
+
+    if (sonore) {
+      const float amplitude = _amplitude;
+      for (size_t k = 0; k < nombre; k++) echantillons[k] = amplitude * enveloppe[k] * oscillateur[k];
+    } else {
+      memset(echantillons, 0, sizeof(echantillons));
+    }
+    sortie.ecrire(echantillons, nombre);
+  }
+  return total;
+}
+
+// --- FichierWAV ---
+
+/// Taille de l'en-tête d'un fichier WAV simple (RIFF, "fmt " et "data").
+static const long TAILLE_EN_TETE_WAV = 44;
+
+/// Range un entier en petit-boutiste, quel que soit l'ordinateur.
+static void ranger(uint8_t* destination, uint32_t valeur, int octets) {
+  for (int i = 0; i < octets; i++) destination[i] = (uint8_t)(valeur >> (8 * i));
+}
+
+/// L'en-tête d'un fichier WAV PCM 16 bits, une voie.
+static void preparerEnTete(uint8_t* enTete, unsigned long echantillonsParSeconde, uint32_t octetsDonnees) {
+  memcpy(enTete, "RIFF", 4);
+  ranger(enTete + 4, octetsDonnees + TAILLE_EN_TETE_WAV - 8, 4);
+  memcpy(enTete + 8, "WAVEfmt ", 8);
+  ranger(enTete + 16, 16, 4);                          // Taille du bloc "fmt ".
+  ranger(enTete + 20, 1, 2);                           // PCM.
+  ranger(enTete + 22, 1, 2);                           // Une voie.
+  ranger(enTete + 24, echantillonsParSeconde, 4);
+  ranger(enTete + 28, echantillonsParSeconde * 2, 4);  // Octets par seconde.
+  ranger(enTete + 32, 2, 2);                           // Octets par échantillon.
+  ranger(enTete + 34, 16, 2);                          // Bits par échantillon.
+  memcpy(enTete + 36, "data", 4);
+  ranger(enTete + 40, octetsDonnees, 4);
+}
+
+FichierWAV::FichierWAV() : _fichier(nullptr), _echantillonsParSeconde(0), _octets(0), _erreur(false) {}
+
+FichierWAV::~FichierWAV() { fermer(); }
+
+bool FichierWAV::ouvrir(const char* chemin, unsigned long echantillonsParSeconde) {
+  _fichier = fopen(chemin, "wb");
+  if (_fichier == nullptr) return false;
+  _echantillonsParSeconde = echantillonsParSeconde;
+  // L'en-tête est réécrit à la fermeture, quand la taille est connue.
+  uint8_t enTete[TAILLE_EN_TETE_WAV];
+  preparerEnTete(enTete, echantillonsParSeconde, 0);
+  _erreur = fwrite(enTete, 1, sizeof(enTete), _fichier) != sizeof(enTete);
+  _octets = 0;
+  return !_erreur;
+}
+
+void FichierWAV::ecrire(const float* echantillons, size_t nombre) {
+  if (_fichier == nullptr) return;
+  int16_t pcm[RenduAudio::TAILLE_BLOC];
+  while (nombre > 0) {
+    size_t morceau = nombre < RenduAudio::TAILLE_BLOC ? nombre : RenduAudio::TAILLE_BLOC;
+    for (size_t k = 0; k < morceau; k++) {
+      float v = echantillons[k] * 32767.0f;
+      v = v > 32767.0f ? 32767.0f : v < -32767.0f ? -32767.0f : v;
+      pcm[k] = (int16_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+    }
+    // Les échantillons sont petit-boutistes, comme sur les PC où tourne le simulateur.
+    if (fwrite(pcm, sizeof(int16_t), morceau, _fichier) != morceau) _erreur = true;
+    _octets += morceau * sizeof(int16_t);
+    echantillons += morceau;
+    nombre -= morceau;
+  }
+}
+
+bool FichierWAV::fermer() {
+  if (_fichier == nullptr) return !_erreur;
+  // Au-delà de 4 Go, la taille ne tient plus dans l'en-tête : les lecteurs lisent alors jusqu'au bout.
+  uint32_t octets = _octets > 0xFFFFFFFFULL - TAILLE_EN_TETE_WAV ? 0xFFFFFFFFUL - TAILLE_EN_TETE_WAV : (uint32_t)_octets;
+  uint8_t enTete[TAILLE_EN_TETE_WAV];
+  FILE* fichier = _fichier;
+  _fichier = nullptr;
+  preparerEnTete(enTete, _echantillonsParSeconde, octets);
+  if (fseek(fichier, 0, SEEK_SET) != 0 || fwrite(enTete, 1, sizeof(enTete), fichier) != sizeof(enTete)) _erreur = true;
+  if (fclose(fichier) != 0) _erreur = true;
+  return !_erreur;
+}
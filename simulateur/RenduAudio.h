@@ -0,0 +1,135 @@
+/**
+ * @file RenduAudio.h
+ * @brief Le rendu sonore d'une manipulation : fronts du PTT et tons, vers des échantillons audio.
+ */
+#ifndef SIMULATEUR_RENDU_AUDIO_H
+#define SIMULATEUR_RENDU_AUDIO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @class SortieAudio
+ * @brief Ce qui reçoit les échantillons rendus, bloc après bloc (fichier WAV, analyse du spectre...).
+ */
+class SortieAudio {
+public:
+  virtual ~SortieAudio() {}
+  /// Reçoit `nombre` échantillons, entre -1 et 1.
+  virtual void ecrire(const float* echantillons, size_t nombre) = 0;
+};
+
+/**
+ * @class RenduAudio
+ * @brief Le "haut-parleur" qui fait entendre la balise, telle qu'un récepteur BLU la restituerait.
+ * @details La manipulation est donnée sous forme de deux listes rangées par instant
+ * croissant : les fronts du PTT (appui, relâche) et les changements de ton (la hauteur
+ * audio à partir de cet instant). Les instants sont à la nanoseconde : le rendu garde
+ * le rythme exact de la balise, sans l'arrondir à l'échantillon.
+ *
+ * Chaque front est adouci par une montée en cosinus surélevé, centrée sur l'instant du
+ * front : mesurée à mi-hauteur, chaque durée reste celle de la manipulation. Les montées
+ * s'additionnent, si bien que deux fronts plus proches que la durée de montée donnent
+ * encore une enveloppe continue. Un changement de ton garde la phase, comme le DDS.
+ *
+ * Le calcul se fait par blocs de `TAILLE_BLOC` échantillons, en boucles simples sur des
+ * tableaux, que le compilateur traduit en instructions vectorielles :
+ * - l'oscillateur n'appelle `sin()` et `cos()` qu'une fois par bloc, pour la phase de
+ *   départ ; l'échantillon `n` vaut ensuite `sin φ × cos(nω) + cos φ × sin(nω)`, à partir
+ *   de tables calculées une fois par ton ;
+ * - les montées sont calculées de la même façon, avec leurs propres tables ;
+ * - un bloc sans son ni montée n'est pas calculé : une journée de balise, faite surtout
+ *   de silences, se rend en quelques secondes.
+ */
+class RenduAudio {
+public:
+  /// Nombre d'échantillons calculés ensemble.
+  static const size_t TAILLE_BLOC = 256;
+
+  /// Un front du PTT.
+  struct Front {
+    uint64_t instantNs;
+    bool appui;          ///< `true` : le PTT est appuyé à partir de cet instant.
+  };
+
+  /// Un changement de ton.
+  struct Ton {
+    uint64_t instantNs;
+    double frequenceHz;  ///< La hauteur audio à partir de cet instant.
+  };
+
+  /**
+   * @param echantillonsParSeconde La fréquence d'échantillonnage.
+   * @param monteeS La durée d'une montée ou d'une descente, de 0 à 100 % (0 : manipulation brute).
+   * @param amplitude L'amplitude du son, PTT appuyé (1 : pleine échelle).
+   */
+  RenduAudio(unsigned long echantillonsParSeconde, double monteeS, float amplitude);
+
+  /**
+   * @brief Rend toute la manipulation, de l'instant 0 à `finNs`.
+   * @param fronts Les fronts du PTT, par instant croissant ; le PTT est relâché à l'instant 0.
+   * @param tons Les changements de ton, par instant croissant ; avant le premier, le ton est celui du premier.
+   * @param sortie Ce qui reçoit les échantillons.
+   * @return Le nombre d'échantillons rendus.
+   */
+  uint64_t rendre(const std::vector<Front>& fronts, const std::vector<Ton>& tons, uint64_t finNs, SortieAudio& sortie);
+
+private:
+  /// Les tables d'un oscillateur : cos(nω) et sin(nω), pour n de 0 à TAILLE_BLOC - 1.
+  struct Rotation {
+    double pasRadians;
+    float cosinus[TAILLE_BLOC];
+    float sinus[TAILLE_BLOC];
+    void preparer(double pas);
+  };
+
+  /**
+   * @brief Interne : les tables d'un ton, calculées à sa première utilisation.
+   * @details La référence n'est valable que jusqu'à l'appel suivant.
+   */
+  const Rotation& rotationDuTon(double frequenceHz);
+
+  /**
+   * @brief Interne : ajoute à l'enveloppe du bloc la part d'un front.
+   * @param debutBloc Le rang du premier échantillon du bloc.
+   * @param nombre Le nombre d'échantillons du bloc.
+   * @param centre L'instant du front, en échantillons (non entier).
+   * @return `true` si la montée de ce front est finie à la fin du bloc.
+   */
+  bool ajouterMontee(float* enveloppe, uint64_t debutBloc, size_t nombre, double centre, float sens);
+
+  double _echantillonsParSeconde;
+  double _montee;                 ///< Durée d'une montée, en échantillons.
+  float _amplitude;
+  Rotation _rotationMontee;       ///< Les tables des montées : un demi-tour en `_montee` échantillons.
+  std::vector<Rotation> _rotationsTons; ///< Les tables des tons déjà rencontrés (quelques-uns par émission).
+};
+
+/**
+ * @class FichierWAV
+ * @brief Écrit les échantillons dans un fichier WAV : PCM 16 bits, une voie.
+ * @details À 12000 échantillons par seconde et avec un ton vers 1500 Hz, le fichier
+ * d'une émission WSPR peut être décodé par WSJT-X.
+ */
+class FichierWAV : public SortieAudio {
+public:
+  FichierWAV();
+  ~FichierWAV() override;
+
+  /// Crée le fichier ; `false` s'il ne peut pas l'être.
+  bool ouvrir(const char* chemin, unsigned long echantillonsParSeconde);
+
+  void ecrire(const float* echantillons, size_t nombre) override;
+
+  /// Complète l'en-tête (tailles) et ferme le fichier ; `false` si l'écriture a échoué.
+  bool fermer();
+
+private:
+  FILE* _fichier;
+  unsigned long _echantillonsParSeconde;
+  uint64_t _octets;     ///< Octets d'échantillons écrits.
+  bool _erreur;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file TraceVCD.cpp
+ * @brief Implémentation de la classe TraceVCD.
+ */
+#include "TraceVCD.h"
+#include <string.h>
+
+/// Nombre d'identifiants VCD disponibles : une lettre par signal, majuscule puis minuscule.
+static const size_t NOMBRE_IDENTIFIANTS = 52;
+
+/// L'identifiant VCD du signal numéro `i` ("A", "B"... puis "a", "b"...).
+static char identifiant(size_t i) { return i < 26 ? (char)('A' + i) : (char)('a' + i - 26); }
+
+TraceVCD::TraceVCD(size_t capacite) : _capacite(capacite), _perdus(0) {
+  _changements.reserve(capacite);
+  memset(_signalDeLaBroche, SANS_SIGNAL, sizeof(_signalDeLaBroche));
+}
+
+void TraceVCD::nommer(uint8_t broche, const char* nom) {
+  if (broche >= NOMBRE_BROCHES || _signaux.size() >= NOMBRE_IDENTIFIANTS) return;
+  if (_signalDeLaBroche[broche] != SANS_SIGNAL) return;
+  _signalDeLaBroche[broche] = (uint8_t)_signaux.size();
+  _signaux.push_back(Signal{ broche, nom });
+}
+
+void TraceVCD::noter(uint64_t instantNs, uint8_t broche, uint8_t niveau) {
+  if (broche >= NOMBRE_BROCHES || _signalDeLaBroche[broche] == SANS_SIGNAL) return;
+  if (_changements.size() >= _capacite) {
+    _perdus++;
+    return;
+  }
+  _changements.push_back(Changement{ instantNs, broche, niveau });
+}
+
+unsigned long TraceVCD::getPerdus() const { return _perdus; }
+
+void TraceVCD::ecrire(FILE* sortie, uint64_t finNs) const {
+  fprintf(sortie, "$version balise_hf, simulateur $end\n");
+  if (_perdus > 0) fprintf(sortie, "$comment %lu changements perdus, tampon plein $end\n", _perdus);
+  fprintf(sortie, "$timescale 1ns $end\n$scope module balise $end\n");
+  for (size_t i = 0; i < _signaux.size(); i++) {
+    fprintf(sortie, "$var wire 1 %c %s $end\n", identifiant(i), _signaux[i].nom);
+  }
+  fprintf(sortie, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+  // À la mise sous tension, toutes les broches sont au niveau bas.
+  for (size_t i = 0; i < _signaux.size(); i++) fprintf(sortie, "0%c\n", identifiant(i));
+  fprintf(sortie, "$end\n");
+
+  uint64_t dernierInstant = 0;
+  for (const Changement& changement : _changements) {
+    if (changement.instant != dernierInstant) {
+      fprintf(sortie, "#%llu\n", (unsigned long long)changement.instant);
+      dernierInstant = changement.instant;
+    }
+    fprintf(sortie, "%c%c\n", changement.niveau ? '1' : '0', identifiant(_signalDeLaBroche[changement.broche]));
+  }
+  if (finNs > dernierInstant) fprintf(sortie, "#%llu\n", (unsigned long long)finNs);
+}
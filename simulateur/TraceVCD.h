@@ -0,0 +1,75 @@
+/**
+ * @file TraceVCD.h
+ * @brief L'enregistreur des changements d'état des broches, écrits ensuite au format VCD.
+ */
+#ifndef SIMULATEUR_TRACE_VCD_H
+#define SIMULATEUR_TRACE_VCD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @class TraceVCD
+ * @brief Le "greffier" qui note chaque front des broches, pour GTKWave et les traces de référence.
+ * @details Branché sous `digitalWrite()` (voir `simulation::setObservateur()`), il range
+ * chaque changement d'état dans un tableau réservé d'avance : pendant la simulation, ni
+ * allocation ni écriture de fichier. Le fichier VCD (Value Change Dump) n'est écrit qu'à
+ * la fin, par `ecrire()`. Une fois le tableau plein, les changements suivants sont
+ * seulement comptés.
+ *
+ * Le fichier ne contient ni date ni chemin : deux simulations identiques donnent deux
+ * fichiers identiques, que l'on peut comparer à une trace de référence.
+ */
+class TraceVCD {
+public:
+  /**
+   * @param capacite Nombre de changements d'état retenus, réservés dès la construction.
+   */
+  explicit TraceVCD(size_t capacite);
+
+  /**
+   * @brief Donne un nom à une broche. Seules les broches nommées sont enregistrées.
+   * @details Les signaux apparaissent dans le fichier dans l'ordre où ils ont été nommés.
+   */
+  void nommer(uint8_t broche, const char* nom);
+
+  /// À brancher comme observateur des broches.
+  void noter(uint64_t instantNs, uint8_t broche, uint8_t niveau);
+
+  /// Nombre de changements d'état qui n'ont pas trouvé de place.
+  unsigned long getPerdus() const;
+
+  /**
+   * @brief Écrit le fichier VCD, à la nanoseconde.
+   * @param finNs L'instant de la fin de la simulation, noté en dernier.
+   */
+  void ecrire(FILE* sortie, uint64_t finNs) const;
+
+private:
+  /// Un changement d'état : 16 octets, rangés à la suite.
+  struct Changement {
+    uint64_t instant;
+    uint8_t broche;
+    uint8_t niveau;
+  };
+
+  /// Un signal du fichier VCD.
+  struct Signal {
+    uint8_t broche;
+    const char* nom;
+  };
+
+  /// Nombre de broches de la Mega, pour la table de correspondance broche → signal.
+  static const uint8_t NOMBRE_BROCHES = 70;
+  /// Valeur de la table pour une broche qui n'est pas enregistrée.
+  static const uint8_t SANS_SIGNAL = 0xFF;
+
+  std::vector<Changement> _changements; ///< Réservé une fois pour toutes.
+  size_t _capacite;
+  unsigned long _perdus;
+  std::vector<Signal> _signaux;
+  uint8_t _signalDeLaBroche[NOMBRE_BROCHES];
+};
+
+#endif
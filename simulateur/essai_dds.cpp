@@ -0,0 +1,179 @@
+/**
+ * @file essai_dds.cpp
+ * @brief Vérifie, sur PC, les ordres de 40 bits envoyés aux DDS AD9850 et AD9851.
+ * @details Les ordres sont relus sur les broches, bit par bit, comme le ferait le DDS :
+ * DATA au front montant de W_CLK, poids faible en premier, l'ordre étant complet au front
+ * montant de FQ_UD. On vérifie ainsi, pour les deux puces :
+ * - la version souple, GestionnaireDDS, avec et sans correction d'horloge ;
+ * - la version réglée à la compilation, PiloteDDS, celle du programme, avec et sans
+ *   correction d'horloge, directement et à travers LiaisonDDS ; ses mots sont aussi
+ *   vérifiés par le compilateur (voir les `static_assert` ci-dessous).
+ * On vérifie aussi que le petit banc des transports ne fausse pas le compte des mots envoyés.
+ */
+#include <Arduino.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "GestionnaireDDS.h"
+#include "PiloteDDS.h"
+
+namespace {
+
+const uint8_t W_CLK = 26, FQ_UD = 28, DATA = 30, RESET = 32;
+
+typedef PiloteDDS<PUCE_AD9850, 125000000UL, W_CLK, FQ_UD, DATA, RESET> PiloteAD9850;
+typedef PiloteDDS<PUCE_AD9851, 30000000UL, W_CLK, FQ_UD, DATA, RESET> PiloteAD9851;
+
+// 10 MHz : 10^7 × 2^32 / 125 MHz = 0x147AE148, et / 180 MHz = 0x0E38E38E.
+static_assert(PiloteAD9850::HORLOGE_HZ == 125000000UL && PiloteAD9851::HORLOGE_HZ == 180000000UL, "Horloges de travail");
+static_assert(PiloteAD9850::motAccord(10000000UL) == 0x147AE148UL, "Mot de 10 MHz sur AD9850");
+static_assert(PiloteAD9851::motAccord(10000000UL) == 0x0E38E38EUL, "Mot de 10 MHz sur AD9851");
+static_assert(PiloteAD9850::ordre(PiloteAD9850::motAccord(10000000UL)) == 0x00147AE148ULL, "Ordre de 10 MHz sur AD9850");
+static_assert(PiloteAD9851::ordre(PiloteAD9851::motAccord(10000000UL)) == 0x010E38E38EULL, "Ordre de 10 MHz sur AD9851 (PLL x6)");
+static_assert(GestionnaireDDS::correctionValide(GestionnaireDDS::CORRECTION_MAX_PPB) &&
+              GestionnaireDDS::correctionValide(-GestionnaireDDS::CORRECTION_MAX_PPB) &&
+              !GestionnaireDDS::correctionValide(GestionnaireDDS::CORRECTION_MAX_PPB + 1) &&
+              !GestionnaireDDS::correctionValide(-GestionnaireDDS::CORRECTION_MAX_PPB - 1), "Limites de la correction d'horloge");
+
+// Quelques broches de chaque sorte : ports bas (sbi/cbi), ports hauts (protégés).
+static_assert(BrocheRapide<26>::ADRESSE == 0x22 && BrocheRapide<26>::MASQUE == 0x10 && BrocheRapide<26>::ATOMIQUE, "Broche 26 : PA4");
+static_assert(BrocheRapide<30>::ADRESSE == 0x28 && BrocheRapide<30>::MASQUE == 0x80, "Broche 30 : PC7");
+static_assert(BrocheRapide<13>::ADRESSE == 0x25 && BrocheRapide<13>::MASQUE == 0x80, "Broche 13 : PB7");
+static_assert(BrocheRapide<4>::ADRESSE == 0x34 && BrocheRapide<4>::MASQUE == 0x20, "Broche 4 : PG5");
+static_assert(BrocheRapide<6>::ADRESSE == 0x102 && BrocheRapide<6>::MASQUE == 0x08 && !BrocheRapide<6>::ATOMIQUE, "Broche 6 : PH3");
+static_assert(BrocheRapide<14>::ADRESSE == 0x105 && BrocheRapide<14>::MASQUE == 0x02, "Broche 14 : PJ1");
+static_assert(BrocheRapide<49>::ADRESSE == 0x10B && BrocheRapide<49>::MASQUE == 0x01, "Broche 49 : PL0");
+static_assert(BrocheRapide<62>::ADRESSE == 0x108 && BrocheRapide<62>::MASQUE == 0x01, "Broche A8 : PK0");
+static_assert(BrocheRapide<54>::ADRESSE == 0x31 && BrocheRapide<54>::MASQUE == 0x01, "Broche A0 : PF0");
+
+int echecs = 0;
+
+void verifier(bool condition, const std::string& description) {
+  if (!condition) {
+    echecs++;
+    printf("ECHEC : %s\n", description.c_str());
+  }
+}
+
+/// Ce que le DDS a reçu, relu sur ses broches.
+uint8_t niveauData = 0;
+uint64_t registre = 0;
+unsigned bitsRecus = 0;
+std::vector<uint64_t> ordresValides;
+
+void observerBroche(uint64_t, uint8_t broche, uint8_t niveau) {
+  if (broche == DATA) niveauData = niveau;
+  if (broche == W_CLK && niveau == HIGH) {
+    registre = (registre >> 1) | ((uint64_t)niveauData << 39);
+    bitsRecus++;
+  }
+  if (broche == FQ_UD && niveau == HIGH) {
+    verifier(bitsRecus == 40, "ordre de " + std::to_string(bitsRecus) + " bits au lieu de 40");
+    ordresValides.push_back(registre);
+    bitsRecus = 0;
+  }
+}
+
+std::string hexa(uint64_t valeur) {
+  char texte[24];
+  snprintf(texte, sizeof(texte), "0x%010llX", (unsigned long long)valeur);
+  return texte;
+}
+
+/// L'ordre attendu, calculé autrement : en virgule flottante, arrondi au plus proche.
+uint64_t ordreAttendu(unsigned long frequence, double horlogeHz, uint8_t controle) {
+  return ((uint64_t)controle << 32) | (uint32_t)llroundl((long double)frequence * 4294967296.0L / horlogeHz);
+}
+
+const unsigned long FREQUENCES[] = { 137500UL, 1838000UL, 7040000UL, 10000000UL, 14097100UL, 28124600UL, 50293000UL };
+
+/// Charge chaque fréquence avec `charger`, et compare l'ordre relu à celui attendu.
+template <typename Charger>
+void verifierOrdres(const char* pilote, double horlogeHz, uint8_t controle, Charger charger) {
+  for (unsigned long frequence : FREQUENCES) {
+    ordresValides.clear();
+    charger(frequence);
+    uint64_t attendu = ordreAttendu(frequence, horlogeHz, controle);
+    verifier(ordresValides.size() == 1 && ordresValides[0] == attendu,
+             std::string(pilote) + ", " + std::to_string(frequence) + " Hz : " +
+               (ordresValides.empty() ? std::string("aucun ordre") : hexa(ordresValides[0])) + " au lieu de " + hexa(attendu));
+  }
+}
+
+} // namespace
+
+int main() {
+  simulation::setObservateur(observerBroche);
+
+  // La version souple, observée par digitalWrite().
+  GestionnaireDDS ad9850(W_CLK, FQ_UD, DATA, RESET);
+  ad9850.begin(TRANSPORT_DIGITALWRITE);
+  verifierOrdres("GestionnaireDDS AD9850", 125e6, 0x00, [&](unsigned long f) { ad9850.setFrequency(f); });
+
+  GestionnaireDDS ad9851(W_CLK, FQ_UD, DATA, RESET, PUCE_AD9851, 30000000UL);
+  ad9851.begin(TRANSPORT_DIGITALWRITE);
+  verifier(ad9851.getHorlogeHz() == 180000000UL, "horloge de l'AD9851 : " + std::to_string(ad9851.getHorlogeHz()));
+  verifierOrdres("GestionnaireDDS AD9851", 180e6, 0x01, [&](unsigned long f) { ad9851.setFrequency(f); });
+
+  // La correction d'horloge porte sur l'horloge de travail : 1 ppm de 180 MHz, 180 Hz.
+  ad9851.setCorrectionPpb(1000);
+  verifier(ad9851.getHorlogeHz() == 180000180UL, "horloge corrigee de l'AD9851 : " + std::to_string(ad9851.getHorlogeHz()));
+  verifierOrdres("GestionnaireDDS AD9851 a +1 ppm", 180000180.0, 0x01, [&](unsigned long f) { ad9851.setFrequency(f); });
+
+  // Le petit banc des transports ne compte pas dans les mots envoyés (télémétrie).
+  struct : Print {
+    size_t write(uint8_t) override { return 1; }
+  } muet;
+  unsigned long chargements = ad9851.getNombreChargements();
+  ad9851.mesurerTransports(muet);
+  verifier(ad9851.getNombreChargements() == chargements,
+           "mesurerTransports() compte " + std::to_string(ad9851.getNombreChargements() - chargements) + " chargements");
+
+  // Le mot d'accord au 1/256 de hertz suit la même horloge.
+  verifier(ad9851.calculerMotAccordPrecis(10000000ULL << 8) == ad9851.calculerMotAccord(10000000UL),
+           "mot precis et mot entier de 10 MHz differents sur l'AD9851");
+
+  // La version réglée à la compilation.
+  PiloteAD9850 piloteAD9850;
+  piloteAD9850.begin();
+  verifierOrdres("PiloteDDS AD9850", 125e6, 0x00, [&](unsigned long f) { piloteAD9850.setFrequency(f); });
+
+  PiloteAD9851 piloteAD9851;
+  piloteAD9851.begin();
+  verifierOrdres("PiloteDDS AD9851", 180e6, 0x01, [&](unsigned long f) { piloteAD9851.setFrequency(f); });
+
+  // Un mot préchargé n'est pris qu'à la validation.
+  ordresValides.clear();
+  piloteAD9851.prechargerMotAccord(PiloteAD9851::motAccord(10000000UL));
+  verifier(ordresValides.empty(), "mot precharge valide trop tot");
+  piloteAD9851.validerFrequence();
+  verifier(ordresValides.size() == 1 && ordresValides[0] == 0x010E38E38EULL, "mot precharge de l'AD9851 mal valide");
+
+  // La correction d'horloge du pilote du programme : les mêmes calculs que la version souple.
+  verifier(piloteAD9851.setCorrectionPpb(1000) && piloteAD9851.getHorlogeHz() == 180000180UL,
+           "horloge corrigee du pilote de l'AD9851 : " + std::to_string(piloteAD9851.getHorlogeHz()));
+  verifierOrdres("PiloteDDS AD9851 a +1 ppm", 180000180.0, 0x01, [&](unsigned long f) { piloteAD9851.setFrequency(f); });
+  verifier(piloteAD9851.calculerMotAccordPrecis(14097100ULL << 8) == ad9851.calculerMotAccordPrecis(14097100ULL << 8),
+           "mots precis du pilote et de la version souple differents");
+  verifier(!piloteAD9851.setCorrectionPpb(GestionnaireDDS::CORRECTION_MAX_PPB + 1) && piloteAD9851.getCorrectionPpb() == 1000,
+           "correction hors limites acceptee par le pilote");
+
+  // À travers LiaisonDDS, comme l'EmetteurFSK, et avec le compte des mots envoyés.
+  piloteAD9851.begin();
+  LiaisonDDS& liaison = piloteAD9851;
+  ordresValides.clear();
+  liaison.chargerMotAccord(PiloteAD9851::motAccord(10000000UL));
+  verifier(ordresValides.size() == 1 && ordresValides[0] == 0x010E38E38EULL, "mot de l'AD9851 mal charge par LiaisonDDS");
+  verifier(piloteAD9851.getNombreChargements() == 1,
+           "pilote : " + std::to_string(piloteAD9851.getNombreChargements()) + " chargements comptes au lieu de 1");
+
+  // Le banc des transports mesure aussi le pilote branché sur les mêmes broches.
+  ordresValides.clear();
+  ad9851.mesurerTransports(muet, &piloteAD9851);
+  verifier(!ordresValides.empty() && ordresValides.back() == PiloteAD9851::ordre(ad9851.calculerMotAccord(10000000UL)),
+           "le pilote n'a pas ete mesure par mesurerTransports()");
+
+  printf("Essai DDS : %s\n", echecs == 0 ? "OK" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file essai_locator.cpp
+ * @brief Compare, sur PC, le calcul du locator en entiers à l'ancien calcul en virgule flottante.
+ * @details Avant `GestionnaireGPS::calculerLocator()`, le locator était calculé en `double`
+ * avec `floor()` et `fmod()`. Cet ancien calcul est recopié ici (et prolongé aux 10
+ * caractères de la même façon), puis les deux sont comparés pour 6, 8 et 10 caractères
+ * sur une grille qui couvre toute la Terre, pôles et antiméridien compris, et sur des
+ * positions tirées au hasard. Deux sortes d'écarts sont attendues, et vérifiées :
+ * - aux pôles et sur l'antiméridien, l'ancien calcul sortait de la grille ("S" après
+ *   "R") : le nouveau reste dans la dernière case, celle de l'ancien calcul un
+ *   nanodegré plus tôt ;
+ * - sur une frontière exacte entre deux cases, l'ancien calcul pouvait tomber d'un côté
+ *   ou de l'autre selon l'arrondi des `double` : le nouveau prend toujours la case du
+ *   dessus, celle de l'ancien calcul un nanodegré plus loin.
+ * Toute autre différence fait échouer l'essai. Les durées des deux calculs sont données à
+ * titre de comparaison.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "GestionnaireGPS.h"
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const std::string& description) {
+  if (!condition) {
+    echecs++;
+    printf("ECHEC : %s\n", description.c_str());
+  }
+}
+
+/**
+ * @brief L'ancien `calculateLocator()`, en degrés, prolongé jusqu'à 10 caractères.
+ */
+void ancienLocator(double lat, double lon, char* sortie, uint8_t longueur) {
+  char locator[11];
+  lon += 180;
+  lat += 90;
+  locator[0] = (char)('A' + floor(lon / 20));
+  locator[1] = (char)('A' + floor(lat / 10));
+  locator[2] = (char)('0' + floor(fmod(lon, 20) / 2));
+  locator[3] = (char)('0' + floor(fmod(lat, 10)));
+  locator[4] = (char)('a' + floor(fmod(lon / 2, 1) * 24));
+  locator[5] = (char)('a' + floor(fmod(lat, 1) * 24));
+  locator[6] = (char)('0' + floor(fmod(lon * 120, 10)));
+  locator[7] = (char)('0' + floor(fmod(lat * 240, 10)));
+  locator[8] = (char)('a' + floor(fmod(lon * 120, 1) * 24));
+  locator[9] = (char)('a' + floor(fmod(lat * 240, 1) * 24));
+  memcpy(sortie, locator, longueur);
+  sortie[longueur] = '\0';
+}
+
+/// Le nombre de cases par degré au dernier caractère de chaque longueur : { longitude, latitude }.
+unsigned long casesParDegre(uint8_t longueur, bool latitude) {
+  switch (longueur) {
+    case 6: return latitude ? 24 : 12;
+    case 8: return latitude ? 240 : 120;
+    default: return latitude ? 5760 : 2880;
+  }
+}
+
+/// `true` si la coordonnée (déjà ramenée à partir de 0) tombe exactement sur une frontière de case.
+bool surFrontiere(long long microDegres, unsigned long cases) {
+  return (microDegres * (long long)cases) % 1000000LL == 0;
+}
+
+const double NANODEGRE = 1e-9;
+
+struct Bilan {
+  unsigned long identiques = 0;
+  unsigned long bords = 0;      ///< Pôles et antiméridien.
+  unsigned long frontieres = 0; ///< Frontières exactes entre deux cases.
+};
+
+/// Compare les deux calculs en un point, pour une longueur de locator.
+void comparer(long latitudeMicro, long longitudeMicro, uint8_t longueur, Bilan& bilan) {
+  char nouveau[11], ancien[11];
+  GestionnaireGPS::calculerLocator(latitudeMicro, longitudeMicro, nouveau, longueur);
+  double lat = latitudeMicro / 1000000.0, lon = longitudeMicro / 1000000.0;
+  ancienLocator(lat, lon, ancien, longueur);
+  if (strcmp(nouveau, ancien) == 0) {
+    bilan.identiques++;
+    return;
+  }
+
+  std::string ou = std::to_string(latitudeMicro) + " " + std::to_string(longitudeMicro) + " (" +
+                   std::to_string(longueur) + " caracteres) : " + nouveau + " au lieu de " + ancien;
+  // Aux bords, la dernière case ; sur une frontière, la case du dessus.
+  bool bordLatitude = latitudeMicro >= 90000000L, bordLongitude = longitudeMicro >= 180000000L;
+  bool bord = bordLatitude || bordLongitude;
+  bool frontiere = surFrontiere(latitudeMicro + 90000000LL, casesParDegre(longueur, true)) ||
+                   surFrontiere(longitudeMicro + 180000000LL, casesParDegre(longueur, false));
+  char attendu[11];
+  ancienLocator(lat + (bordLatitude ? -NANODEGRE : NANODEGRE), lon + (bordLongitude ? -NANODEGRE : NANODEGRE), attendu,
+                longueur);
+  verifier((bord || frontiere) && strcmp(nouveau, attendu) == 0, ou);
+  if (bord) bilan.bords++;
+  else bilan.frontieres++;
+}
+
+/// Un tirage pseudo-aléatoire reproductible (générateur congruentiel 64 bits).
+uint64_t graine = 0x2545F4914F6CDD1DULL;
+long auHasard(long minimum, long maximum) {
+  graine = graine * 6364136223846793005ULL + 1442695040888963407ULL;
+  return minimum + (long)((graine >> 33) % (uint64_t)(maximum - minimum + 1));
+}
+
+/// Répétitions de chaque mesure, pour dépasser largement la résolution de l'horloge du PC.
+const unsigned REPETITIONS = 20;
+
+/// Somme des caractères, pour que le compilateur ne supprime pas les boucles mesurées.
+volatile unsigned long puits = 0;
+
+/// Durée moyenne de `calcul(lat, lon, sortie)` sur tous les points, en nanosecondes par locator.
+template <typename Calcul>
+double mesurer(const std::vector<std::pair<long, long> >& points, Calcul calcul) {
+  auto debut = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < REPETITIONS; r++) {
+    unsigned long somme = 0;
+    for (const auto& point : points) {
+      char sortie[11];
+      calcul(point.first, point.second, sortie);
+      somme += sortie[5] + sortie[9];
+    }
+    puits = puits + somme;
+  }
+  std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+  return duree.count() / (REPETITIONS * points.size());
+}
+
+} // namespace
+
+int main() {
+  // La grille : des pas qui ne tombent pas juste, les deux bords de chaque coordonnée,
+  // des frontières exactes (tous les quarts de degré) et quelques lieux connus.
+  std::vector<long> latitudes, longitudes;
+  for (long lat = -90000000L; lat < 90000000L; lat += 1234567L) latitudes.push_back(lat);
+  for (long lon = -180000000L; lon < 180000000L; lon += 2345671L) longitudes.push_back(lon);
+  for (long frontiere = -90000000L; frontiere <= 90000000L; frontiere += 250000L) latitudes.push_back(frontiere);
+  for (long frontiere = -180000000L; frontiere <= 180000000L; frontiere += 250000L) longitudes.push_back(frontiere);
+  for (long lieu : { 48856602L, 89999999L, -89999999L, 0L, -1L, 1L }) latitudes.push_back(lieu);
+  for (long lieu : { 2352201L, 179999999L, -179999999L, 0L, -1L, 1L }) longitudes.push_back(lieu);
+
+  std::vector<std::pair<long, long> > points;
+  for (long lat : latitudes) {
+    for (long lon : longitudes) points.push_back(std::make_pair(lat, lon));
+  }
+  for (unsigned i = 0; i < 200000; i++) {
+    points.push_back(std::make_pair(auHasard(-90000000L, 90000000L), auHasard(-180000000L, 180000000L)));
+  }
+
+  const uint8_t LONGUEURS[] = { 6, 8, 10 };
+  for (uint8_t longueur : LONGUEURS) {
+    Bilan bilan;
+    for (const auto& point : points) comparer(point.first, point.second, longueur, bilan);
+    printf("Locator a %2u caracteres : %lu identiques, %lu aux poles ou sur l'antimeridien, %lu sur une frontiere\n",
+           (unsigned)longueur, bilan.identiques, bilan.bords, bilan.frontieres);
+    verifier(bilan.bords > 0, "la grille devrait toucher les poles et l'antimeridien");
+  }
+
+  // Un locator connu, pour ne pas seulement comparer les deux calculs entre eux.
+  char paris[11];
+  GestionnaireGPS::calculerLocator(48856602L, 2352201L, paris, 10);
+  verifier(strcmp(paris, "JN18eu25go") == 0, std::string("Paris : ") + paris);
+
+  double ancien = mesurer(points, [](long lat, long lon, char* sortie) {
+    ancienLocator(lat / 1000000.0, lon / 1000000.0, sortie, 10);
+  });
+  double nouveau = mesurer(points, [](long lat, long lon, char* sortie) {
+    GestionnaireGPS::calculerLocator(lat, lon, sortie, 10);
+  });
+  printf("Ancien calcul (double, floor et fmod) : %6.1f ns par locator\n", ancien);
+  printf("calculerLocator() (entiers)           : %6.1f ns par locator (ancien / nouveau : %.2f)\n", nouveau,
+         ancien / nouveau);
+  printf("Essai locator : %s\n", echecs == 0 ? "OK" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
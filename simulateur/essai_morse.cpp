@@ -0,0 +1,221 @@
+/**
+ * @file essai_morse.cpp
+ * @brief Compare, sur PC, la séquence Morse précompilée à l'ancien télégraphiste qui lisait le texte.
+ * @details Avant SequenceMorse, `EmetteurMorse::sendMessage()` relisait à chaque point ou
+ * trait le texte, le dictionnaire de chaînes ("." et "-") et le caractère en cours. Cet
+ * ancien télégraphiste est recopié ici tel quel (sans les broches) pour deux contrôles :
+ * - la manipulation : pour chaque message, les deux donnent la même suite de sons et de
+ *   silences, unité pour unité (l'ancien dictionnaire ne connaît que les lettres et les
+ *   chiffres : les messages d'essai s'y limitent) ;
+ * - le coût : la traduction puis la relecture de la séquence, face au parcours du texte
+ *   élément par élément. Les durées sont mesurées sur le PC, dont les caches et la
+ *   prédiction de branchement gomment une bonne part du coût des chaînes lues sur la
+ *   carte : elles sont données à titre de comparaison, et seul le premier contrôle peut
+ *   faire échouer l'essai.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SequenceMorse.h"
+
+namespace {
+
+/// Le dictionnaire de l'ancien télégraphiste, indexé par le code ASCII.
+const char* const ANCIEN_MORSE_CODE[] = {
+  "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "",
+  "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "",
+  "-----", ".----", "..---", "...--", "....-", ".....", "-....", "--...", "---..", "----.",
+  "", "", "", "", "", "", "",
+  ".-", "-...", "-.-.", "-..", ".", "..-.", "--.", "....", "..", ".---", "-.-", ".-..", "--",
+  "-.", "---", ".--.", "--.-", ".-.", "...", "-", "..-", "...-", ".--", "-..-", "-.--", "--.."
+};
+
+/**
+ * @brief L'ancien télégraphiste : `elementSuivant()` de l'EmetteurMorse d'avant SequenceMorse.
+ * @details Seules les commandes du PTT sont remplacées par un simple état.
+ */
+class AncienTelegraphiste {
+public:
+  explicit AncienTelegraphiste(const char* message)
+    : _message(message), _position(0), _code(nullptr), _sonEnCours(false), _unites(0) {}
+
+  bool elementSuivant() {
+    if (_sonEnCours) {
+      _sonEnCours = false;
+      _unites += 1;
+      return true;
+    }
+    if (_code != nullptr && *_code) {
+      _sonEnCours = true;
+      _unites += (*_code == '-') ? 3 : 1;
+      _code++;
+      return true;
+    }
+    if (_code != nullptr) {
+      _code = nullptr;
+      _unites += 2;
+      return true;
+    }
+    while (_message[_position]) {
+      char c = toupper(_message[_position++]);
+      if (c == ' ') {
+        _unites += 4;
+        return true;
+      } else if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z')) {
+        _code = ANCIEN_MORSE_CODE[(int)c];
+        return elementSuivant();
+      }
+    }
+    return false;
+  }
+
+  bool sonEnCours() const { return _sonEnCours; }
+  unsigned long unites() const { return _unites; }
+
+private:
+  const char* _message;
+  uint8_t _position;
+  const char* _code;
+  bool _sonEnCours;
+  unsigned long _unites;
+};
+
+/// Une manipulation : (son ?, durée en unités) pour chaque étape, silence final retiré.
+typedef std::vector<std::pair<bool, unsigned long> > Manipulation;
+
+/// Ajoute une étape, fusionnée avec la précédente si elle est du même genre.
+void ajouter(Manipulation& manipulation, bool son, unsigned long unites) {
+  if (unites == 0) return;
+  if (!manipulation.empty() && manipulation.back().first == son) manipulation.back().second += unites;
+  else manipulation.push_back(std::make_pair(son, unites));
+}
+
+void retirerSilenceFinal(Manipulation& manipulation) {
+  if (!manipulation.empty() && !manipulation.back().first) manipulation.pop_back();
+}
+
+Manipulation manipulationAncienne(const char* message) {
+  Manipulation manipulation;
+  AncienTelegraphiste telegraphiste(message);
+  unsigned long avant = 0;
+  while (telegraphiste.elementSuivant()) {
+    ajouter(manipulation, telegraphiste.sonEnCours(), telegraphiste.unites() - avant);
+    avant = telegraphiste.unites();
+  }
+  retirerSilenceFinal(manipulation);
+  return manipulation;
+}
+
+Manipulation manipulationSequence(const SequenceMorse& sequence) {
+  Manipulation manipulation;
+  for (uint16_t i = 0; i < sequence.getNombreEtapes(); i++) {
+    uint8_t etape = sequence.getEtape(i);
+    ajouter(manipulation, SequenceMorse::estSon(etape), SequenceMorse::getDuree(etape));
+  }
+  retirerSilenceFinal(manipulation);
+  return manipulation;
+}
+
+std::string texte(const Manipulation& manipulation) {
+  std::string resultat;
+  for (const auto& etape : manipulation) resultat += (etape.first ? "+" : "-") + std::to_string(etape.second) + " ";
+  return resultat;
+}
+
+int echecs = 0;
+
+void verifier(bool condition, const std::string& description) {
+  if (!condition) {
+    echecs++;
+    printf("ECHEC : %s\n", description.c_str());
+  }
+}
+
+/// Les messages d'essai : ceux de la balise, jetons remplacés, et de quoi parcourir tout l'ancien dictionnaire.
+const char* const MESSAGES[] = {
+  "CQ DE F5ZHM JN18EU",
+  "VVV DE F6KJU F6KJU JN18EU88QK",
+  "cq de f5zhk jn18eu",
+  "  DEUX  ESPACES  ",
+  "ABCDEFGHIJKLM NOPQRSTUVWXYZ",
+  "0123456789 73",
+  "TEST 5NN 599 73 GL",
+};
+const size_t NOMBRE_MESSAGES = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+
+/// Répétitions de chaque mesure, pour dépasser largement la résolution de l'horloge du PC.
+const unsigned REPETITIONS = 20000;
+
+/// Somme des durées, pour que le compilateur ne supprime pas les boucles mesurées.
+volatile unsigned long puits = 0;
+
+/// Durée moyenne de `travail(m)` sur tous les messages `m`, en nanosecondes par message.
+template <typename Travail>
+double mesurer(Travail travail) {
+  auto debut = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < REPETITIONS; r++) {
+    for (size_t m = 0; m < NOMBRE_MESSAGES; m++) travail(m);
+  }
+  std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+  return duree.count() / (REPETITIONS * NOMBRE_MESSAGES);
+}
+
+} // namespace
+
+int main() {
+  // Même manipulation, étape par étape, et durée annoncée juste.
+  SequenceMorse sequence;
+  unsigned long elements = 0;
+  for (const char* message : MESSAGES) {
+    verifier(sequence.compiler(message), std::string("\"") + message + "\" tronque");
+    Manipulation ancienne = manipulationAncienne(message);
+    Manipulation nouvelle = manipulationSequence(sequence);
+    verifier(ancienne == nouvelle, std::string("\"") + message + "\" : " + texte(nouvelle) + "au lieu de " + texte(ancienne));
+    unsigned long unites = 0;
+    for (const auto& etape : ancienne) unites += etape.second;
+    verifier(sequence.getDureeUnites() == unites, std::string("\"") + message + "\" : duree annoncee " +
+                                                    std::to_string(sequence.getDureeUnites()) + " unites au lieu de " +
+                                                    std::to_string(unites));
+    for (const auto& etape : ancienne) elements += etape.first;
+  }
+
+  // Le travail de sendMessage() hors attente : trouver l'élément suivant et sa durée. La
+  // conversion de l'échéance en microsecondes, la même des deux côtés, n'est pas comptée.
+  double ancien = mesurer([](size_t m) {
+    AncienTelegraphiste telegraphiste(MESSAGES[m]);
+    unsigned long sons = 0;
+    while (telegraphiste.elementSuivant()) sons += telegraphiste.sonEnCours();
+    puits = puits + sons + telegraphiste.unites();
+  });
+  double traduction = mesurer([&](size_t m) { sequence.compiler(MESSAGES[m]); });
+
+  // La relecture, comme dans poll() : le genre et la durée de chaque étape.
+  std::vector<SequenceMorse> sequences(NOMBRE_MESSAGES);
+  unsigned long etapes = 0;
+  for (size_t m = 0; m < NOMBRE_MESSAGES; m++) {
+    sequences[m].compiler(MESSAGES[m]);
+    etapes += sequences[m].getNombreEtapes();
+  }
+  double relecture = mesurer([&](size_t m) {
+    const SequenceMorse& aRejouer = sequences[m];
+    unsigned long unites = 0, sons = 0;
+    for (uint16_t i = 0; i < aRejouer.getNombreEtapes(); i++) {
+      uint8_t etape = aRejouer.getEtape(i);
+      sons += SequenceMorse::estSon(etape);
+      unites += SequenceMorse::getDuree(etape);
+    }
+    puits = puits + sons + unites;
+  });
+
+  printf("Morse : %lu points et traits dans %u messages, %.0f etapes par message en moyenne\n", elements,
+         (unsigned)NOMBRE_MESSAGES, (double)etapes / NOMBRE_MESSAGES);
+  printf("Ancien sendMessage(), texte relu a chaque element : %8.0f ns par message\n", ancien);
+  printf("SequenceMorse : traduction une fois               : %8.0f ns par message\n", traduction);
+  printf("                relecture pendant l'emission      : %8.0f ns par message (ancien / relecture : %.2f)\n", relecture,
+         ancien / relecture);
+  printf("                traduction et relecture           : %8.0f ns par message\n", traduction + relecture);
+  printf("Essai Morse : %s\n", echecs == 0 ? "OK" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+/**
+ * @file essai_nmea.cpp
+ * @brief Rejoue, sur PC, un enregistrement NMEA dans AnalyseurNMEA, et compare ce qu'il en retient.
+ * @details AnalyseurNMEA a remplacé TinyGPS++ : il ne lit que les phrases RMC et GGA, et
+ * leurs champs sans passer par la virgule flottante. L'enregistrement
+ * (references/neo6m_demarrage.nmea) est celui d'un démarrage à froid : ni heure ni
+ * position, puis l'heure seule, puis la position ; avec toutes les phrases d'un module
+ * NEO-6M (RMC, VTG, GGA, GSA, GSV, GLL), une somme de contrôle fausse, une ligne coupée et
+ * quelques octets de bruit. Quelques phrases écrites à la main s'y ajoutent : hémisphères
+ * sud et ouest, pôle, antiméridien, autre constellation.
+ *
+ * Après chaque phrase, ce qu'AnalyseurNMEA a retenu (heure, date, position, satellites)
+ * est comparé à un décodeur de référence écrit ici tout autrement : la phrase entière,
+ * découpée en champs, puis les coordonnées lues avec `strtod()`. Si TinyGPS++ est
+ * disponible (variable TINYGPS du Makefile), la même comparaison est faite avec lui, et
+ * son coût est mesuré à côté de celui d'AnalyseurNMEA. Les durées sont mesurées sur le
+ * PC : elles sont données à titre de comparaison, seules les différences font échouer
+ * l'essai.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AnalyseurNMEA.h"
+#ifdef AVEC_TINYGPS
+#include <TinyGPS++.h>
+#endif
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const std::string& description) {
+  if (!condition) {
+    echecs++;
+    printf("ECHEC : %s\n", description.c_str());
+  }
+}
+
+/// Ajoute à une phrase sans "$" ni somme de contrôle ce qui lui manque.
+std::string terminer(const std::string& corps) {
+  uint8_t somme = 0;
+  for (char c : corps) somme ^= (uint8_t)c;
+  char fin[8];
+  snprintf(fin, sizeof(fin), "*%02X\r\n", somme);
+  return "$" + corps + fin;
+}
+
+/// Les phrases écrites à la main, rejouées après l'enregistrement.
+const char* const PHRASES_A_LA_MAIN[] = {
+  "GNRMC,235959.00,A,3351.12345,S,15112.54321,W,0.012,,311224,,,A",
+  "GNGGA,000000.00,0000.00001,S,00000.00001,W,1,12,0.71,3.0,M,0.0,M,,",
+  "GPGGA,000001.00,8959.99999,N,17959.99999,E,1,05,1.20,2.0,M,0.0,M,,",
+  "GPGGA,000002.00,9000.00000,S,18000.00000,W,2,04,1.80,2.0,M,0.0,M,,",
+  "GPRMC,000003.00,V,4851.39612,N,00221.13201,E,,,010125,,,N", // Position sans fix : pas retenue.
+  "GPGGA,000004.00,4851.39612,N,00221.13201,E,0,03,,,,,,,",   // Idem.
+  "GPRMC,000005.00,A,0130.50000,N,17959.50000,W,,,010125,,,A",
+};
+
+/**
+ * @brief Ce qu'un décodeur a retenu, pour comparer.
+ */
+struct Etat {
+  bool heureValide = false;
+  bool positionValide = false;
+  int heure = 0, minute = 0, seconde = 0;
+  int jour = 0, mois = 0, annee = 0;
+  long latitudeMicro = 0, longitudeMicro = 0;
+  int satellites = 0;
+};
+
+/**
+ * @brief Le décodeur de référence : lent et simple, une phrase entière à la fois.
+ */
+class DecodeurReference {
+public:
+  Etat etat;
+  unsigned long phrasesValides = 0;
+  unsigned long erreursSomme = 0;
+
+  /**
+   * @brief Lit une phrase, depuis son "$" jusqu'au suivant (exclu).
+   * @return `true` si c'est une phrase RMC ou GGA valide, et qu'elle a donc été retenue.
+   */
+  bool lire(const std::string& morceau) {
+    std::string ligne = morceau.substr(0, morceau.find_first_of("\r\n"));
+    size_t etoile = ligne.find('*');
+    if (etoile == std::string::npos || etoile + 3 > ligne.size() || !isxdigit((unsigned char)ligne[etoile + 1]) ||
+        !isxdigit((unsigned char)ligne[etoile + 2])) {
+      return false; // Phrase coupée ou mal formée.
+    }
+    std::string corps = ligne.substr(1, etoile - 1);
+    uint8_t somme = 0;
+    for (char c : corps) somme ^= (uint8_t)c;
+    if (somme != strtoul(ligne.substr(etoile + 1, 2).c_str(), nullptr, 16)) {
+      erreursSomme++;
+      return false;
+    }
+
+    std::vector<std::string> champs;
+    std::stringstream lecteur(corps);
+    std::string champ;
+    while (std::getline(lecteur, champ, ',')) champs.push_back(champ);
+    if (!corps.empty() && corps.back() == ',') champs.push_back("");
+    champs.resize(16);
+    bool rmc = champs[0].size() == 5 && champs[0].compare(2, 3, "RMC") == 0;
+    bool gga = champs[0].size() == 5 && champs[0].compare(2, 3, "GGA") == 0;
+    if (!rmc && !gga) return false;
+
+    phrasesValides++;
+    if (!champs[1].empty()) {
+      etat.heureValide = true;
+      etat.heure = atoi(champs[1].substr(0, 2).c_str());
+      etat.minute = atoi(champs[1].substr(2, 2).c_str());
+      etat.seconde = atoi(champs[1].substr(4, 2).c_str());
+    }
+    if (rmc && !champs[9].empty()) {
+      etat.jour = atoi(champs[9].substr(0, 2).c_str());
+      etat.mois = atoi(champs[9].substr(2, 2).c_str());
+      etat.annee = 2000 + atoi(champs[9].substr(4, 2).c_str());
+    }
+    if (gga && !champs[7].empty()) etat.satellites = atoi(champs[7].c_str());
+    bool fix = rmc ? champs[2] == "A" : !champs[6].empty() && champs[6] != "0";
+    size_t premier = rmc ? 3 : 2;
+    bool coordonnees = true;
+    for (size_t i = premier; i < premier + 4; i++) coordonnees = coordonnees && !champs[i].empty();
+    if (fix && coordonnees) {
+      etat.positionValide = true;
+      etat.latitudeMicro = microDegres(champs[premier], champs[premier + 1] == "S");
+      etat.longitudeMicro = microDegres(champs[premier + 2], champs[premier + 3] == "W");
+    }
+    return true;
+  }
+
+private:
+  /**
+   * @brief "ddmm.mmmmm" (ou "dddmm.mmmmm") en millionièmes de degré, arrondis au plus proche.
+   * @details Avec 5 décimales de minute, le résultat exact tombe sur un multiple de 1/6 de
+   * millionième : les demis sont exacts, et arrondis vers le haut comme dans AnalyseurNMEA.
+   * Le petit décalage ajouté les y pousse malgré les erreurs de la virgule flottante.
+   */
+  static long microDegres(const std::string& champ, bool negatif) {
+    double valeur = strtod(champ.c_str(), nullptr);
+    double degres = floor(valeur / 100);
+    long micro = (long)floor((degres + (valeur - degres * 100) / 60) * 1e6 + 0.5 + 1e-4);
+    return negatif ? -micro : micro;
+  }
+};
+
+Etat etatAnalyseur(const AnalyseurNMEA& analyseur) {
+  Etat etat;
+  etat.heureValide = analyseur.heureValide();
+  etat.positionValide = analyseur.positionValide();
+  etat.heure = analyseur.getHeure();
+  etat.minute = analyseur.getMinute();
+  etat.seconde = analyseur.getSeconde();
+  etat.jour = analyseur.getJour();
+  etat.mois = analyseur.getMois();
+  etat.annee = analyseur.getAnnee();
+  etat.latitudeMicro = analyseur.getLatitudeMicro();
+  etat.longitudeMicro = analyseur.getLongitudeMicro();
+  etat.satellites = analyseur.getSatellites();
+  return etat;
+}
+
+#ifdef AVEC_TINYGPS
+long microDegres(const RawDegrees& brut) {
+  long micro = (long)brut.deg * 1000000L + (long)((brut.billionths + 500) / 1000);
+  return brut.negative ? -micro : micro;
+}
+
+Etat etatTinyGPS(TinyGPSPlus& gps) {
+  Etat etat;
+  etat.heureValide = gps.time.isValid();
+  etat.positionValide = gps.location.isValid();
+  etat.heure = gps.time.hour();
+  etat.minute = gps.time.minute();
+  etat.seconde = gps.time.second();
+  etat.jour = gps.date.day();
+  etat.mois = gps.date.month();
+  etat.annee = gps.date.year();
+  if (etat.positionValide) {
+    etat.latitudeMicro = microDegres(gps.location.rawLat());
+    etat.longitudeMicro = microDegres(gps.location.rawLng());
+  }
+  etat.satellites = gps.satellites.value();
+  return etat;
+}
+#endif
+
+/// Compare ce que `nom` a retenu à ce que la référence a retenu, après la phrase `numero`.
+void comparer(const char* nom, const Etat& obtenu, const Etat& attendu, size_t numero) {
+  std::string ou = std::string(nom) + ", phrase " + std::to_string(numero) + " : ";
+  verifier(obtenu.heureValide == attendu.heureValide, ou + "validite de l'heure");
+  if (attendu.heureValide) {
+    verifier(obtenu.heure == attendu.heure && obtenu.minute == attendu.minute && obtenu.seconde == attendu.seconde,
+             ou + "heure " + std::to_string(obtenu.heure) + ":" + std::to_string(obtenu.minute) + ":" +
+               std::to_string(obtenu.seconde));
+    verifier(obtenu.jour == attendu.jour && obtenu.mois == attendu.mois && obtenu.annee == attendu.annee,
+             ou + "date " + std::to_string(obtenu.jour) + "/" + std::to_string(obtenu.mois) + "/" +
+               std::to_string(obtenu.annee));
+  }
+  verifier(obtenu.positionValide == attendu.positionValide, ou + "validite de la position");
+  if (attendu.positionValide) {
+    verifier(obtenu.latitudeMicro == attendu.latitudeMicro && obtenu.longitudeMicro == attendu.longitudeMicro,
+             ou + "position " + std::to_string(obtenu.latitudeMicro) + " " + std::to_string(obtenu.longitudeMicro) +
+               " au lieu de " + std::to_string(attendu.latitudeMicro) + " " + std::to_string(attendu.longitudeMicro));
+  }
+  verifier(obtenu.satellites == attendu.satellites, ou + std::to_string(obtenu.satellites) + " satellites au lieu de " +
+                                                      std::to_string(attendu.satellites));
+}
+
+/// Découpe le flot en morceaux commençant chacun par "$" (le premier peut ne pas en avoir).
+std::vector<std::string> decouper(const std::string& flot) {
+  std::vector<std::string> morceaux;
+  size_t debut = 0;
+  while (debut < flot.size()) {
+    size_t suivant = flot.find('$', debut + 1);
+    if (suivant == std::string::npos) suivant = flot.size();
+    morceaux.push_back(flot.substr(debut, suivant - debut));
+    debut = suivant;
+  }
+  return morceaux;
+}
+
+/// Répétitions de chaque mesure, pour dépasser largement la résolution de l'horloge du PC.
+const unsigned REPETITIONS = 200;
+
+/// Durée moyenne de `travail()` (un passage sur tout le flot), en nanosecondes.
+template <typename Travail>
+double mesurer(Travail travail) {
+  auto debut = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < REPETITIONS; r++) travail();
+  std::chrono::duration<double, std::nano> duree = std::chrono::steady_clock::now() - debut;
+  return duree.count() / REPETITIONS;
+}
+
+/// Somme des valeurs lues, pour que le compilateur ne supprime pas les boucles mesurées.
+volatile long puits = 0;
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* fichier = argc > 1 ? argv[1] : "references/neo6m_demarrage.nmea";
+  std::ifstream entree(fichier, std::ios::binary);
+  if (!entree) {
+    printf("Impossible de lire %s\n", fichier);
+    return 1;
+  }
+  std::stringstream contenu;
+  contenu << entree.rdbuf();
+  std::string flot = contenu.str();
+  for (const char* phrase : PHRASES_A_LA_MAIN) flot += terminer(phrase);
+  std::vector<std::string> morceaux = decouper(flot);
+
+  // Phrase par phrase : mêmes phrases retenues, et ensuite mêmes valeurs.
+  AnalyseurNMEA analyseur;
+  DecodeurReference reference;
+#ifdef AVEC_TINYGPS
+  TinyGPSPlus gps;
+#endif
+  unsigned long positions = 0;
+  for (size_t n = 0; n < morceaux.size(); n++) {
+    const std::string& morceau = morceaux[n];
+    unsigned retenues = 0;
+    for (char c : morceau) retenues += analyseur.encoder(c);
+    bool retenue = reference.lire(morceau);
+    verifier(retenues == (retenue ? 1u : 0u), "phrase " + std::to_string(n) + (retenue ? " perdue : " : " retenue a tort : ") +
+                                                morceau.substr(0, morceau.find_first_of("\r\n")));
+    comparer("AnalyseurNMEA", etatAnalyseur(analyseur), reference.etat, n);
+    positions += retenue && reference.etat.positionValide;
+#ifdef AVEC_TINYGPS
+    for (char c : morceau) gps.encode(c);
+    // TinyGPS++ valide aussi un champ d'heure vide (00:00:00) : on attend la première heure annoncée.
+    if (reference.etat.heureValide) comparer("TinyGPS++", etatTinyGPS(gps), reference.etat, n);
+#endif
+  }
+  verifier(analyseur.getPhrasesValides() == reference.phrasesValides,
+           std::to_string(analyseur.getPhrasesValides()) + " phrases retenues au lieu de " +
+             std::to_string(reference.phrasesValides));
+  verifier(analyseur.getErreursSomme() == reference.erreursSomme,
+           std::to_string(analyseur.getErreursSomme()) + " sommes de controle fausses au lieu de " +
+             std::to_string(reference.erreursSomme));
+  // L'enregistrement contient bien ce qu'il doit contenir.
+  verifier(reference.erreursSomme == 1, "l'enregistrement devrait contenir une somme de controle fausse");
+  verifier(positions > 100, "trop peu de positions dans l'enregistrement : " + std::to_string(positions));
+#ifdef AVEC_TINYGPS
+  verifier(gps.failedChecksum() == reference.erreursSomme, "TinyGPS++ : " + std::to_string(gps.failedChecksum()) +
+                                                              " sommes de controle fausses");
+#endif
+
+  // Le coût du décodage, sur tout le flot.
+  double nouveau = mesurer([&]() {
+    AnalyseurNMEA aMesurer;
+    for (char c : flot) aMesurer.encoder(c);
+    puits = puits + aMesurer.getLatitudeMicro() + aMesurer.getPhrasesValides();
+  });
+  double lent = mesurer([&]() {
+    DecodeurReference aMesurer;
+    for (const std::string& morceau : morceaux) aMesurer.lire(morceau);
+    puits = puits + aMesurer.etat.latitudeMicro + aMesurer.phrasesValides;
+  });
+
+  printf("NMEA : %lu octets, %u morceaux, %lu phrases RMC et GGA retenues, %lu positions\n", (unsigned long)flot.size(),
+         (unsigned)morceaux.size(), reference.phrasesValides, positions);
+  printf("AnalyseurNMEA                   : %8.1f ns par octet\n", nouveau / flot.size());
+  printf("Reference (champs et strtod)    : %8.1f ns par octet\n", lent / flot.size());
+#ifdef AVEC_TINYGPS
+  double tiny = mesurer([&]() {
+    TinyGPSPlus aMesurer;
+    for (char c : flot) aMesurer.encode(c);
+    puits = puits + aMesurer.location.lat() + aMesurer.passedChecksum();
+  });
+  printf("TinyGPS++                       : %8.1f ns par octet (TinyGPS++ / AnalyseurNMEA : %.2f)\n", tiny / flot.size(),
+         tiny / nouveau);
+#else
+  printf("TinyGPS++                       : non mesure (voir la variable TINYGPS du Makefile)\n");
+#endif
+  printf("Essai NMEA : %s\n", echecs == 0 ? "OK" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file essai_wspr.cpp
+ * @brief Vérifie, sur PC, le codage WSPR de la balise et les mots d'accord de ses tons.
+ * @details Trois familles de contrôles :
+ * - les symboles d'un message de référence, comparés à ceux publiés avec le protocole ;
+ * - un aller-retour : chaque message codé est décodé (désentrelacement, inversion du code
+ *   convolutif, décompression) et doit redonner l'indicatif, le locator et la puissance ;
+ * - les mots d'accord des quatre tons, comparés à un calcul indépendant, avec les deux
+ *   pilotes du DDS.
+ *
+ * Il vérifie aussi que `CodeurWSPR::indicatifValide()`, utilisée par le compilateur pour
+ * le plan de bandes, accepte exactement les indicatifs que `coder()` sait coder.
+ *
+ * `./essai_wspr --symboles F5ZHM JN18 30` écrit seulement les 162 symboles d'un message,
+ * pour comparer une trace VCD de la balise avec `outils/verifier_vcd.py --tons`.
+ */
+#include <Arduino.h>
+#include <algorithm>
+#include <string>
+#include "CodeurWSPR.h"
+#include "GestionnaireDDS.h"
+#include "PiloteDDS.h"
+
+namespace {
+
+/// Symboles de "K1ABC FN42 37", l'exemple publié avec le protocole WSPR (sortie de wsprcode).
+const char SYMBOLES_K1ABC_FN42_37[] =
+  "3 3 0 0 2 0 0 0 1 0 2 0 1 3 1 2 2 2 1 0 0 3 2 3 1 3 3 2 2 0 2 0 0 0 3 2 0 1 2 3 2 2 0 0 2 2 3 2 1 1 0 2 3 3 "
+  "2 1 0 2 2 1 3 2 1 2 2 2 0 3 3 0 3 0 3 0 1 2 1 0 2 1 2 0 3 2 1 3 2 0 0 3 3 2 3 0 3 2 2 0 3 0 2 0 2 0 1 0 2 3 "
+  "0 2 1 1 1 2 3 3 0 2 3 1 2 1 2 2 2 1 3 3 2 0 0 0 0 1 0 3 2 0 1 3 2 2 2 2 2 0 2 3 3 2 3 2 3 3 2 0 0 3 1 2 2 2";
+
+/// Premier et second polynômes du code convolutif, écrits ici indépendamment du codeur.
+const uint32_t POLYNOMES[2] = { 0xF2D05351UL, 0xE4613C47UL };
+
+int echecs = 0;
+
+void verifier(bool condition, const std::string& description) {
+  if (!condition) {
+    echecs++;
+    printf("ECHEC : %s\n", description.c_str());
+  }
+}
+
+std::string symboles(const CodeurWSPR& codeur) {
+  std::string texte;
+  for (int i = 0; i < CodeurWSPR::NOMBRE_SYMBOLES; i++) texte += (char)('0' + codeur.getSymbole(i));
+  return texte;
+}
+
+int parite(uint32_t mot) { return __builtin_parity(mot); }
+
+/// Le rang `i` sur 8 bits, écrit à l'envers (l'entrelacement du protocole).
+int rangInverse(int i) {
+  int j = 0;
+  for (int b = 0; b < 8; b++) j |= ((i >> b) & 1) << (7 - b);
+  return j;
+}
+
+/**
+ * @brief Décode les 162 symboles d'un message WSPR de type 1.
+ * @details Sans bruit, le code convolutif s'inverse bit par bit : le bit de données le
+ * plus récent est le seul inconnu de la parité du premier polynôme (dont le bit 0 vaut 1).
+ * Le second bit de chaque paire et les 31 zéros de fin servent de contrôle.
+ */
+bool decoder(const CodeurWSPR& codeur, std::string& indicatif, std::string& locator, int& puissance) {
+  // Désentrelacement : le bit codé `p` a été rangé au symbole `rangInverse(i)`.
+  int codes[CodeurWSPR::NOMBRE_SYMBOLES];
+  int p = 0;
+  for (int i = 0; i < 256 && p < CodeurWSPR::NOMBRE_SYMBOLES; i++) {
+    int j = rangInverse(i);
+    if (j < CodeurWSPR::NOMBRE_SYMBOLES) codes[p++] = codeur.getSymbole(j) >> 1;
+  }
+
+  uint32_t registre = 0;
+  uint64_t donnees = 0;
+  for (int rang = 0; rang < 81; rang++) {
+    uint32_t sansBit = registre << 1;
+    int bit = codes[2 * rang] ^ parite(sansBit & POLYNOMES[0]);
+    registre = sansBit | bit;
+    if (codes[2 * rang + 1] != parite(registre & POLYNOMES[1])) return false;
+    if (rang >= 50 && bit != 0) return false;
+    if (rang < 50) donnees = (donnees << 1) | bit;
+  }
+
+  uint32_t n = donnees >> 22;
+  uint32_t m = donnees & 0x3FFFFF;
+  const char* alphabet = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
+  char c[7] = {};
+  for (int i = 5; i >= 3; i--) {
+    c[i] = alphabet[n % 27 + 10];
+    n /= 27;
+  }
+  c[2] = alphabet[n % 10];
+  n /= 10;
+  c[1] = alphabet[n % 36];
+  n /= 36;
+  if (n > 36) return false;
+  c[0] = alphabet[n];
+  indicatif = c;
+  indicatif.erase(0, indicatif.find_first_not_of(' '));
+  indicatif.erase(indicatif.find_last_not_of(' ') + 1);
+
+  puissance = (int)(m % 128) - 64;
+  uint32_t m1 = m / 128;
+  int l1 = (m1 % 180) / 10, l3 = (m1 % 180) % 10;
+  int l0 = (179 - m1 / 180) / 10, l2 = (179 - m1 / 180) % 10;
+  locator = std::string() + (char)('A' + l0) + (char)('A' + l1) + (char)('0' + l2) + (char)('0' + l3);
+  return true;
+}
+
+void verifierAllerRetour(const char* indicatif, const char* locator, int puissance, const char* indicatifAttendu) {
+  CodeurWSPR codeur;
+  std::string message = std::string(indicatif) + " " + locator + " " + std::to_string(puissance);
+  if (!codeur.coder(indicatif, locator, puissance)) {
+    verifier(false, message + " : refuse par le codeur");
+    return;
+  }
+  std::string indicatifLu, locatorLu;
+  int puissanceLue;
+  bool lu = decoder(codeur, indicatifLu, locatorLu, puissanceLue);
+  verifier(lu, message + " : symboles indecodables");
+  if (!lu) return;
+  verifier(indicatifLu == indicatifAttendu, message + " : indicatif relu " + indicatifLu);
+  std::string locatorAttendu = std::string(locator).substr(0, 4);
+  std::transform(locatorAttendu.begin(), locatorAttendu.end(), locatorAttendu.begin(), ::toupper);
+  verifier(locatorLu == locatorAttendu, message + " : locator relu " + locatorLu);
+  verifier(puissanceLue == puissance, message + " : puissance relue " + std::to_string(puissanceLue));
+}
+
+/// Les mots des tons, pour l'un ou l'autre pilote du DDS (GestionnaireDDS ou PiloteDDS).
+template <typename Pilote>
+void verifierMotsAccord(Pilote& dds, long ppb) {
+  dds.setCorrectionPpb(ppb);
+  const unsigned long frequences[] = { 137500UL, 474200UL, 1838000UL, 3570000UL, 7040000UL, 10140100UL,
+                                       14097000UL, 18104600UL, 21094600UL, 24924600UL, 28124600UL, 50293000UL };
+  for (unsigned long frequence : frequences) {
+    verifier(dds.calculerMotAccordPrecis((uint64_t)frequence << 8) == dds.calculerMotAccord(frequence),
+             "ton 0 de " + std::to_string(frequence) + " Hz different du mot d'accord de la bande");
+    for (int ton = 0; ton < CodeurWSPR::NOMBRE_TONS; ton++) {
+      // mot = (f + ton × 12000 / 8192) × 2^32 / horloge, arrondi au plus proche. Le produit
+      // dépasse 64 bits : la division se fait en deux fois 16 bits, comme à la main.
+      uint64_t numerateur = (uint64_t)frequence * 8192 + ton * 12000;
+      uint64_t denominateur = (uint64_t)dds.getHorlogeHz() * 8192;
+      uint64_t quotient = (numerateur << 16) / denominateur;
+      uint64_t reste = (numerateur << 16) % denominateur;
+      uint32_t attendu = (uint32_t)((quotient << 16) + ((reste << 16) + denominateur / 2) / denominateur);
+      uint32_t mot = dds.calculerMotAccordPrecis(((uint64_t)frequence << 8) + ton * CodeurWSPR::ECART_TONS_256E_HZ);
+      verifier(mot == attendu, "ton " + std::to_string(ton) + " de " + std::to_string(frequence) + " Hz a " +
+                               std::to_string(ppb) + " ppb : mot " + std::to_string(mot) + " au lieu de " +
+                               std::to_string(attendu));
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc == 5 && std::string(argv[1]) == "--symboles") {
+    CodeurWSPR codeur;
+    if (!codeur.coder(argv[2], argv[3], atoi(argv[4]))) {
+      fprintf(stderr, "Message impossible a coder : %s %s %s\n", argv[2], argv[3], argv[4]);
+      return 2;
+    }
+    printf("%s\n", symboles(codeur).c_str());
+    return 0;
+  }
+
+  // Le message de référence : tous les symboles, au rang près.
+  CodeurWSPR reference;
+  verifier(reference.coder("K1ABC", "FN42", 37), "K1ABC FN42 37 refuse par le codeur");
+  std::string attendus = SYMBOLES_K1ABC_FN42_37;
+  attendus.erase(std::remove(attendus.begin(), attendus.end(), ' '), attendus.end());
+  verifier(symboles(reference) == attendus, "K1ABC FN42 37 : " + symboles(reference));
+
+  // Aller-retour, avec les deux places possibles du chiffre de l'indicatif.
+  verifierAllerRetour("K1ABC", "FN42", 37, "K1ABC");
+  verifierAllerRetour("F5ZHM", "JN18eu", 30, "F5ZHM");
+  verifierAllerRetour("g4jnt", "io90", 10, "G4JNT");
+  verifierAllerRetour("VK2XYZ", "QF56", 0, "VK2XYZ");
+  verifierAllerRetour("9A1A", "AA00", 60, "9A1A");
+  verifierAllerRetour("3D2AG", "RR99", 23, "3D2AG");
+
+  // Ce qu'un message de type 1 ne sait pas dire.
+  CodeurWSPR codeur;
+  verifier(!codeur.coder("F/G4JNT", "JN18", 30), "indicatif compose accepte");
+  verifier(!codeur.coder("FRANCE", "JN18", 30), "indicatif sans chiffre accepte");
+  verifier(!codeur.coder("F5ZHM1", "JN18", 30), "chiffre dans le suffixe accepte");
+  verifier(!codeur.coder("F5ZHM", "SN18", 30), "locator hors de la grille accepte");
+  verifier(!codeur.coder("F5ZHM", "JN1", 30), "locator trop court accepte");
+  verifier(!codeur.coder("F5ZHM", "JN18", 31), "puissance de 31 dBm acceptee");
+  verifier(!codeur.coder("F5ZHM", "JN18", 61), "puissance de 61 dBm acceptee");
+  verifier(symboles(codeur) == std::string(CodeurWSPR::NOMBRE_SYMBOLES, '0'), "symboles modifies par un message refuse");
+
+  // La vérification faite par le compilateur sur le plan de bandes doit suivre le codeur.
+  for (const char* indicatif : { "K1ABC", "F5ZHM", "g4jnt", "VK2XYZ", "9A1A", "3D2AG", "F/G4JNT", "FRANCE", "F5ZHM1", "K1", "F5ZHM #LOCA#" }) {
+    verifier(CodeurWSPR::indicatifValide(indicatif) == codeur.coder(indicatif, "JN18", 30),
+             std::string("indicatifValide() et coder() en desaccord sur ") + indicatif);
+  }
+
+  // Les mots d'accord des tons, avec et sans correction de l'horloge du DDS.
+  GestionnaireDDS dds(26, 28, 30, 32);
+  for (long ppb : { 0L, 12345L, -98765L }) verifierMotsAccord(dds, ppb);
+  PiloteDDS<PUCE_AD9851, 30000000UL, 26, 28, 30, 32> pilote; // Celui du programme, ici sur un AD9851.
+  for (long ppb : { 0L, 12345L, -98765L }) verifierMotsAccord(pilote, ppb);
+
+  printf("Essai WSPR : %s\n", echecs == 0 ? "OK" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
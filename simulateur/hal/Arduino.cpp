@@ -0,0 +1,607 @@
+/**
+ * @file Arduino.cpp
+ * @brief Implémentation du décor Arduino : horloge virtuelle, broches, interruptions, Timer3 et ports série.
+ * @details Tout l'état est fait de variables simples, initialisées avant tout
+ * constructeur : les objets globaux de la balise (dont certains touchent aux broches
+ * et aux ports série dès leur construction) peuvent s'en servir sans précaution.
+ */
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "Simulation.h"
+
+extern "C" void vecteur_TIMER3_COMPA();
+
+namespace simulation {
+
+namespace {
+
+// --- Correspondance des broches de la Mega 2560 (comme pins_arduino.h) ---
+enum { PA = 1, PB, PC, PD, PE, PF, PG, PH, PJ, PK, PL, NOMBRE_PORTS };
+const uint8_t NOMBRE_BROCHES = 70;
+
+const uint8_t PORT_DE_LA_BROCHE[NOMBRE_BROCHES] = {
+  PE, PE, PE, PE, PG, PE, PH, PH, PH, PH, PB, PB, PB, PB, PJ, PJ, PH, PH, PD, PD, PD, PD, // 0-21
+  PA, PA, PA, PA, PA, PA, PA, PA,                                                         // 22-29
+  PC, PC, PC, PC, PC, PC, PC, PC,                                                         // 30-37
+  PD, PG, PG, PG,                                                                         // 38-41
+  PL, PL, PL, PL, PL, PL, PL, PL,                                                         // 42-49
+  PB, PB, PB, PB,                                                                         // 50-53
+  PF, PF, PF, PF, PF, PF, PF, PF,                                                         // A0-A7
+  PK, PK, PK, PK, PK, PK, PK, PK,                                                         // A8-A15
+};
+
+const uint8_t BIT_DE_LA_BROCHE[NOMBRE_BROCHES] = {
+  0, 1, 4, 5, 5, 3, 3, 4, 5, 6, 4, 5, 6, 7, 1, 0, 1, 0, 3, 2, 1, 0,
+  0, 1, 2, 3, 4, 5, 6, 7,
+  7, 6, 5, 4, 3, 2, 1, 0,
+  7, 2, 1, 0,
+  7, 6, 5, 4, 3, 2, 1, 0,
+  3, 2, 1, 0,
+  0, 1, 2, 3, 4, 5, 6, 7,
+  0, 1, 2, 3, 4, 5, 6, 7,
+};
+
+/// Les broches des interruptions externes INT0 à INT5.
+const uint8_t BROCHE_INTERRUPTION[] = { 2, 3, 21, 20, 19, 18 };
+const uint8_t NOMBRE_INTERRUPTIONS = sizeof(BROCHE_INTERRUPTION);
+
+/// Taille des tampons de la classe HardwareSerial d'Arduino.
+const uint8_t TAILLE_TAMPON_SERIE = 64;
+const uint8_t NOMBRE_PORTS_SERIE = 4;
+
+// --- L'état de la carte virtuelle ---
+uint64_t horloge = 0;
+bool interruptionsActives = true;  ///< Le bit I du registre d'état : le cœur Arduino l'a mis avant setup().
+bool dansInterruption = false;
+unsigned long interruptionsServies = 0; ///< Compte les routines servies (pour le réveil du sommeil).
+unsigned long serviesAvantSommeil = 0;  ///< Leur nombre à `sleep_enable()`.
+
+uint8_t ports[NOMBRE_PORTS];          ///< Les registres PORTx, écrits directement par le programme.
+uint8_t portsSignales[NOMBRE_PORTS];   ///< L'état des ports déjà signalé à l'observateur.
+ObservateurBroche observateur = nullptr;
+unsigned long nombreTransitions = 0;
+
+void (*routinesExternes[NOMBRE_INTERRUPTIONS])() = {};
+uint64_t frontsExternes[NOMBRE_INTERRUPTIONS] = { UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX };
+/// Le plus tôt des événements programmés, tenu à jour à chaque changement (voir `recalculerProchain()`).
+uint64_t prochainConnu = UINT64_MAX;
+bool attenteExterne[NOMBRE_INTERRUPTIONS] = {};
+
+/**
+ * @brief Le Timer3, en mode CTC seulement (le seul dont se sert ManipulateurTimer).
+ */
+struct Timer3 {
+  uint8_t tccrA, tccrB, tifr, timsk;
+  uint16_t ocrA;
+  uint16_t compteurArrete;  ///< La valeur du compteur quand le timer est arrêté.
+  uint64_t debutCycle;      ///< L'instant où le compteur valait 0, quand le timer tourne.
+  bool attente;             ///< Une interruption de comparaison attend d'être servie.
+  uint64_t comparaison;     ///< L'instant de la prochaine comparaison (`UINT64_MAX` : jamais).
+} timer3 = { 0, 0, 0, 0, 0, 0, 0, false, UINT64_MAX };
+
+struct EtatSerie {
+  unsigned long vitesse;
+  uint8_t reception[TAILLE_TAMPON_SERIE];
+  uint8_t tete, queue;
+  SourceSerie* source;
+  unsigned long perdus;
+  FILE* sortie;
+  uint64_t finEmission;  ///< L'instant où le tampon d'émission sera vide.
+} etatsSerie[NOMBRE_PORTS_SERIE] = {};
+
+// --- Timer3 ---
+
+/// Le diviseur d'horloge choisi par les bits CS3x (0 : arrêté).
+uint16_t diviseurTimer3() {
+  static const uint16_t DIVISEURS[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+  return DIVISEURS[timer3.tccrB & 0x07];
+}
+
+uint64_t dureeTicks(uint64_t ticks, uint16_t diviseur) {
+  // Un cycle à 16 MHz dure 62,5 ns.
+  return ticks * diviseur * 1000ULL / (F_CPU / 1000000UL);
+}
+
+uint16_t compteurTimer3() {
+  uint16_t diviseur = diviseurTimer3();
+  if (diviseur == 0) return timer3.compteurArrete;
+  return (uint16_t)(((horloge - timer3.debutCycle) * (F_CPU / 1000000UL)) / (1000ULL * diviseur));
+}
+
+/// Met à jour `prochainConnu` : à appeler dès qu'un événement est programmé, servi ou déplacé.
+void recalculerProchain() {
+  prochainConnu = timer3.comparaison;
+  for (uint8_t i = 0; i < NOMBRE_INTERRUPTIONS; i++) {
+    if (frontsExternes[i] < prochainConnu) prochainConnu = frontsExternes[i];
+  }
+}
+
+/**
+ * @brief Calcule l'instant de la prochaine comparaison, après tout changement du Timer3.
+ * @details Il est gardé de côté : l'horloge est avancée à chaque appel d'une fonction
+ * Arduino, et refaire ce calcul à chaque fois ralentissait toute la simulation.
+ */
+void recalculerComparaison() {
+  uint16_t diviseur = diviseurTimer3();
+  if (diviseur == 0) {
+    timer3.comparaison = UINT64_MAX;
+    recalculerProchain();
+    return;
+  }
+  uint64_t instant = timer3.debutCycle + dureeTicks(timer3.ocrA + 1UL, diviseur);
+  // OCR3A écrit plus bas que le compteur : celui-ci fait le tour complet avant de le retrouver.
+  while (instant < horloge) instant += dureeTicks(65536UL, diviseur);
+  timer3.comparaison = instant;
+  recalculerProchain();
+}
+
+uint64_t comparaisonTimer3() { return timer3.comparaison; }
+
+
+// --- Broches ---
+
+void signalerTransition(uint8_t broche, uint8_t etat) {
+  nombreTransitions++;
+  if (observateur != nullptr) observateur(horloge, broche, etat);
+}
+
+/// Signale les changements faits directement dans les registres de port depuis le dernier appel.
+void signalerPorts() {
+  // Appelée à chaque fonction Arduino : le cas courant, rien de changé, doit coûter peu.
+  if (memcmp(ports, portsSignales, sizeof(ports)) == 0) return;
+  for (uint8_t port = 1; port < NOMBRE_PORTS; port++) {
+    uint8_t changes = ports[port] ^ portsSignales[port];
+    if (changes == 0) continue;
+    for (uint8_t broche = 0; broche < NOMBRE_BROCHES; broche++) {
+      uint8_t masque = 1 << BIT_DE_LA_BROCHE[broche];
+      if (PORT_DE_LA_BROCHE[broche] == port && (changes & masque)) {
+        signalerTransition(broche, (ports[port] & masque) ? HIGH : LOW);
+      }
+    }
+    portsSignales[port] = ports[port];
+  }
+}
+
+// --- Interruptions ---
+
+/**
+ * @brief Sert les interruptions en attente, par ordre de priorité, si elles sont permises.
+ */
+void servirInterruptions() {
+  while (interruptionsActives && !dansInterruption) {
+    void (*routine)() = nullptr;
+    for (uint8_t i = 0; i < NOMBRE_INTERRUPTIONS && routine == nullptr; i++) {
+      if (attenteExterne[i]) {
+        attenteExterne[i] = false;
+        routine = routinesExternes[i];
+      }
+    }
+    if (routine == nullptr && timer3.attente) {
+      // Le drapeau est effacé par le matériel quand la routine démarre.
+      timer3.attente = false;
+      timer3.tifr &= ~(1 << OCF3A);
+      routine = vecteur_TIMER3_COMPA;
+    }
+    if (routine == nullptr) return;
+
+    signalerPorts();
+    interruptionsServies++;
+    dansInterruption = true;
+    interruptionsActives = false;
+    avancer(couts().interruption);
+    routine();
+    signalerPorts();
+    interruptionsActives = true;
+    dansInterruption = false;
+  }
+}
+
+/**
+ * @brief Fait arriver tous les événements matériels dont l'instant est atteint.
+ */
+void traiterEvenements() {
+  for (uint8_t i = 0; i < NOMBRE_INTERRUPTIONS; i++) {
+    if (frontsExternes[i] <= horloge) {
+      frontsExternes[i] = UINT64_MAX;
+      if (routinesExternes[i] != nullptr) attenteExterne[i] = true;
+    }
+  }
+  uint64_t comparaison = comparaisonTimer3();
+  if (comparaison <= horloge) {
+    // Mode CTC : le compteur repart de zéro à l'instant même de la comparaison.
+    timer3.debutCycle = comparaison;
+    recalculerComparaison();
+    timer3.tifr |= (1 << OCF3A);
+    if (timer3.timsk & (1 << OCIE3A)) timer3.attente = true;
+  }
+  recalculerProchain();
+}
+
+EtatSerie& etatSerie(const HardwareSerial& port) {
+  return etatsSerie[port.getNumero() % NOMBRE_PORTS_SERIE];
+}
+
+/// Range dans le tampon de réception les octets arrivés jusqu'à maintenant.
+void recevoir(EtatSerie& etat) {
+  if (etat.source == nullptr) return;
+  uint64_t instant;
+  uint8_t octet;
+  while (etat.source->prochainOctet(instant, octet) && instant <= horloge) {
+    etat.source->consommer();
+    uint8_t suivante = (etat.tete + 1) % TAILLE_TAMPON_SERIE;
+    if (suivante == etat.queue || etat.vitesse == 0) {
+      etat.perdus++;
+      continue;
+    }
+    etat.reception[etat.tete] = octet;
+    etat.tete = suivante;
+  }
+}
+
+uint64_t nsParOctet(const EtatSerie& etat) {
+  // 10 bits par octet (départ, 8 bits, arrêt).
+  return etat.vitesse == 0 ? 0 : (10ULL * NS_PAR_SECONDE) / etat.vitesse;
+}
+
+/// Nombre d'octets encore dans le tampon d'émission.
+uint16_t octetsEnEmission(const EtatSerie& etat) {
+  uint64_t duree = nsParOctet(etat);
+  if (duree == 0 || etat.finEmission <= horloge) return 0;
+  return (uint16_t)((etat.finEmission - horloge + duree - 1) / duree);
+}
+
+} // namespace
+
+// --- Interface du simulateur ---
+
+CoutsAVR& couts() {
+  static CoutsAVR valeurs;
+  return valeurs;
+}
+
+uint64_t maintenant() { return horloge; }
+
+uint64_t prochainEvenement() { return prochainConnu; }
+
+void avancerJusqua(uint64_t cible) {
+  if (!dansInterruption) signalerPorts();
+  for (;;) {
+    uint64_t evenement = prochainEvenement();
+    if (evenement > cible) break;
+    if (evenement > horloge) horloge = evenement;
+    traiterEvenements();
+    // Le temps passé dans les interruptions s'ajoute à celui de l'appel en cours.
+    uint64_t avant = horloge;
+    servirInterruptions();
+    cible += horloge - avant;
+  }
+  if (horloge < cible) horloge = cible;
+}
+
+void avancer(uint64_t dureeNs) { avancerJusqua(horloge + dureeNs); }
+
+uint8_t niveau(uint8_t broche) {
+  if (broche >= NOMBRE_BROCHES) return LOW;
+  return (ports[PORT_DE_LA_BROCHE[broche]] >> BIT_DE_LA_BROCHE[broche]) & 1;
+}
+
+void setObservateur(ObservateurBroche fonction) { observateur = fonction; }
+unsigned long getNombreTransitions() { return nombreTransitions; }
+
+void programmerFront(uint8_t interruption, uint64_t instantNs) {
+  if (interruption < NOMBRE_INTERRUPTIONS) frontsExternes[interruption] = instantNs;
+  recalculerProchain();
+}
+
+uint64_t frontProgramme(uint8_t interruption) {
+  return interruption < NOMBRE_INTERRUPTIONS ? frontsExternes[interruption] : UINT64_MAX;
+}
+
+void brancherSource(HardwareSerial& port, SourceSerie* source) { etatSerie(port).source = source; }
+void setSortie(HardwareSerial& port, FILE* sortie) { etatSerie(port).sortie = sortie; }
+unsigned long getOctetsPerdus(HardwareSerial& port) { return etatSerie(port).perdus; }
+
+uint16_t lireRegistre(NumeroRegistre numero) {
+  switch (numero) {
+    case REG_TCCR3A: return timer3.tccrA;
+    case REG_TCCR3B: return timer3.tccrB;
+    case REG_TCNT3: return compteurTimer3();
+    case REG_OCR3A: return timer3.ocrA;
+    case REG_TIFR3: return timer3.tifr;
+    case REG_TIMSK3: return timer3.timsk;
+  }
+  return 0;
+}
+
+void ecrireRegistre(NumeroRegistre numero, uint16_t valeur) {
+  switch (numero) {
+    case REG_TCCR3A:
+      timer3.tccrA = valeur;
+      break;
+    case REG_TCCR3B: {
+      uint16_t compteur = compteurTimer3();
+      timer3.tccrB = valeur;
+      // Le compteur reprend là où il en était.
+      uint16_t diviseur = diviseurTimer3();
+      if (diviseur == 0) timer3.compteurArrete = compteur;
+      else timer3.debutCycle = horloge - dureeTicks(compteur, diviseur);
+      break;
+    }
+    case REG_TCNT3:
+      if (diviseurTimer3() == 0) timer3.compteurArrete = valeur;
+      else timer3.debutCycle = horloge - dureeTicks(valeur, diviseurTimer3());
+      break;
+    case REG_OCR3A:
+      timer3.ocrA = valeur;
+      break;
+    case REG_TIFR3:
+      // Un 1 écrit efface le drapeau correspondant.
+      timer3.tifr &= ~valeur;
+      if (valeur & (1 << OCF3A)) timer3.attente = false;
+      break;
+    case REG_TIMSK3:
+      timer3.timsk = valeur;
+      if ((timer3.timsk & (1 << OCIE3A)) && (timer3.tifr & (1 << OCF3A))) timer3.attente = true;
+      break;
+  }
+  recalculerComparaison();
+}
+
+SectionAtomique::SectionAtomique() : _etaient(interruptionsActives), _premierTour(true) {
+  interruptionsActives = false;
+}
+
+SectionAtomique::~SectionAtomique() {
+  interruptionsActives = _etaient;
+  servirInterruptions();
+}
+
+} // namespace simulation
+
+using namespace simulation;
+
+// --- Broches ---
+
+void pinMode(uint8_t, uint8_t) { avancer(couts().pinMode); }
+
+void digitalWrite(uint8_t broche, uint8_t etat) {
+  avancer(couts().digitalWrite);
+  if (broche >= NOMBRE_BROCHES) return;
+  uint8_t port = PORT_DE_LA_BROCHE[broche];
+  uint8_t masque = 1 << BIT_DE_LA_BROCHE[broche];
+  if (etat) ports[port] |= masque;
+  else ports[port] &= ~masque;
+  if ((ports[port] ^ portsSignales[port]) & masque) {
+    portsSignales[port] ^= masque;
+    signalerTransition(broche, etat ? HIGH : LOW);
+  }
+}
+
+int digitalRead(uint8_t broche) {
+  avancer(couts().digitalRead);
+  return niveau(broche);
+}
+
+uint8_t digitalPinToPort(uint8_t broche) { return broche < NOMBRE_BROCHES ? PORT_DE_LA_BROCHE[broche] : NOT_A_PORT; }
+uint8_t digitalPinToBitMask(uint8_t broche) { return broche < NOMBRE_BROCHES ? 1 << BIT_DE_LA_BROCHE[broche] : 0; }
+volatile uint8_t* portOutputRegister(uint8_t port) { return &ports[port < NOMBRE_PORTS ? port : 0]; }
+
+int digitalPinToInterrupt(uint8_t broche) {
+  for (uint8_t i = 0; i < NOMBRE_INTERRUPTIONS; i++) {
+    if (BROCHE_INTERRUPTION[i] == broche) return i;
+  }
+  return NOT_AN_INTERRUPT;
+}
+
+// --- Temps ---
+
+unsigned long micros() {
+  avancer(couts().micros);
+  // Comme sur la carte à 16 MHz, micros() avance par pas de 4 µs.
+  return (unsigned long)(horloge / NS_PAR_US) & ~3UL;
+}
+
+unsigned long millis() {
+  avancer(couts().micros);
+  return (unsigned long)(horloge / (NS_PAR_SECONDE / 1000));
+}
+
+void delay(unsigned long ms) { avancer(ms * (NS_PAR_SECONDE / 1000)); }
+void delayMicroseconds(unsigned int us) { avancer(us * NS_PAR_US); }
+
+// --- Interruptions ---
+
+void attachInterrupt(uint8_t interruption, void (*routine)(), int) {
+  if (interruption < NOMBRE_INTERRUPTIONS) routinesExternes[interruption] = routine;
+}
+
+void detachInterrupt(uint8_t interruption) {
+  if (interruption < NOMBRE_INTERRUPTIONS) routinesExternes[interruption] = nullptr;
+}
+
+void noInterrupts() { interruptionsActives = false; }
+
+void interrupts() {
+  interruptionsActives = true;
+  servirInterruptions();
+}
+
+/// Sans ManipulateurTimer dans le programme, la comparaison du Timer3 n'a pas de routine.
+extern "C" __attribute__((weak)) void vecteur_TIMER3_COMPA() {}
+
+// --- Ports série ---
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+HardwareSerial Serial3(3);
+
+void HardwareSerial::begin(unsigned long vitesse) {
+  EtatSerie& etat = etatSerie(*this);
+  etat.vitesse = vitesse;
+  etat.tete = etat.queue = 0;
+}
+
+void HardwareSerial::end() {
+  flush();
+  etatSerie(*this).vitesse = 0;
+}
+
+int HardwareSerial::available() {
+  avancer(couts().serieDisponible);
+  EtatSerie& etat = etatSerie(*this);
+  recevoir(etat);
+  return (etat.tete + TAILLE_TAMPON_SERIE - etat.queue) % TAILLE_TAMPON_SERIE;
+}
+
+int HardwareSerial::peek() {
+  avancer(couts().serieDisponible);
+  EtatSerie& etat = etatSerie(*this);
+  recevoir(etat);
+  return etat.tete == etat.queue ? -1 : etat.reception[etat.queue];
+}
+
+int HardwareSerial::read() {
+  avancer(couts().serieLecture);
+  EtatSerie& etat = etatSerie(*this);
+  recevoir(etat);
+  if (etat.tete == etat.queue) return -1;
+  uint8_t octet = etat.reception[etat.queue];
+  etat.queue = (etat.queue + 1) % TAILLE_TAMPON_SERIE;
+  return octet;
+}
+
+size_t HardwareSerial::write(uint8_t octet) {
+  EtatSerie& etat = etatSerie(*this);
+  uint64_t duree = nsParOctet(etat);
+  if (duree > 0) {
+    // Tampon plein : on attend, comme la vraie classe, qu'un octet soit parti.
+    if (octetsEnEmission(etat) >= TAILLE_TAMPON_SERIE - 1) {
+      avancerJusqua(etat.finEmission - (TAILLE_TAMPON_SERIE - 2) * duree);
+    }
+    etat.finEmission = (etat.finEmission > horloge ? etat.finEmission : horloge) + duree;
+  }
+  avancer(couts().serieEcriture);
+  if (etat.sortie != nullptr) fputc(octet, etat.sortie);
+  return 1;
+}
+
+int HardwareSerial::availableForWrite() {
+  const EtatSerie& etat = etatSerie(*this);
+  if (etat.vitesse == 0) return TAILLE_TAMPON_SERIE - 1;
+  return TAILLE_TAMPON_SERIE - 1 - octetsEnEmission(etat);
+}
+
+void HardwareSerial::flush() {
+  EtatSerie& etat = etatSerie(*this);
+  avancerJusqua(etat.finEmission);
+  if (etat.sortie != nullptr) fflush(etat.sortie);
+}
+
+// --- Sommeil ---
+
+void set_sleep_mode(uint8_t) {}
+void sleep_enable() { serviesAvantSommeil = interruptionsServies; }
+void sleep_disable() {}
+
+void sleep_cpu() {
+  // Réveillé d'avance par une interruption servie juste après le sei().
+  if (interruptionsServies != serviesAvantSommeil) return;
+  // Le Timer0 de millis() déborde toutes les 1024 µs depuis la mise sous tension.
+  const uint64_t PERIODE_TIMER0 = 1024 * NS_PAR_US;
+  uint64_t reveil = (horloge / PERIODE_TIMER0 + 1) * PERIODE_TIMER0;
+  if (prochainEvenement() < reveil) reveil = prochainEvenement();
+  for (uint8_t i = 0; i < NOMBRE_PORTS_SERIE; i++) {
+    EtatSerie& etat = etatsSerie[i];
+    uint64_t instant;
+    uint8_t octet;
+    // Un octet reçu (interruption RX), ou un octet parti du tampon d'émission (interruption UDRE).
+    if (etat.vitesse != 0 && etat.source != nullptr && etat.source->prochainOctet(instant, octet) && instant < reveil) {
+      reveil = instant;
+    }
+    uint16_t enEmission = octetsEnEmission(etat);
+    if (enEmission > 0) {
+      uint64_t depart = etat.finEmission - (enEmission - 1) * nsParOctet(etat);
+      if (depart < reveil) reveil = depart;
+    }
+  }
+  avancerJusqua(reveil > horloge ? reveil : horloge);
+}
+
+// --- Print ---
+
+size_t Print::write(const uint8_t* octets, size_t nombre) {
+  size_t ecrits = 0;
+  while (nombre--) ecrits += write(*octets++);
+  return ecrits;
+}
+
+size_t Print::printNombre(unsigned long nombre, int base) {
+  char texte[8 * sizeof(long) + 1];
+  ultoa(nombre, texte, base < 2 ? 10 : base);
+  return write(texte);
+}
+
+size_t Print::print(const __FlashStringHelper* texte) { return write(reinterpret_cast<const char*>(texte)); }
+size_t Print::print(const char* texte) { return write(texte); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char nombre, int base) { return printNombre(nombre, base); }
+size_t Print::print(int nombre, int base) { return print((long)nombre, base); }
+size_t Print::print(unsigned int nombre, int base) { return printNombre(nombre, base); }
+size_t Print::print(unsigned long nombre, int base) { return printNombre(nombre, base); }
+
+size_t Print::print(long nombre, int base) {
+  // Comme Arduino : le signe n'est écrit qu'en décimal.
+  if (base == DEC && nombre < 0) return print('-') + printNombre(-(unsigned long)nombre, base);
+  return printNombre((unsigned long)nombre, base);
+}
+
+size_t Print::print(double nombre, int decimales) {
+  char texte[48];
+  snprintf(texte, sizeof(texte), "%.*f", decimales, nombre);
+  return write(texte);
+}
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const __FlashStringHelper* texte) { return print(texte) + println(); }
+size_t Print::println(const char* texte) { return print(texte) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char nombre, int base) { return print(nombre, base) + println(); }
+size_t Print::println(int nombre, int base) { return print(nombre, base) + println(); }
+size_t Print::println(unsigned int nombre, int base) { return print(nombre, base) + println(); }
+size_t Print::println(long nombre, int base) { return print(nombre, base) + println(); }
+size_t Print::println(unsigned long nombre, int base) { return print(nombre, base) + println(); }
+size_t Print::println(double nombre, int decimales) { return print(nombre, decimales) + println(); }
+
+// --- Bibliothèque AVR ---
+
+char* ultoa(unsigned long valeur, char* texte, int base) {
+  char chiffres[8 * sizeof(long) + 1];
+  int n = 0;
+  do {
+    int chiffre = valeur % base;
+    chiffres[n++] = chiffre < 10 ? '0' + chiffre : 'A' + chiffre - 10;
+    valeur /= base;
+  } while (valeur > 0);
+  for (int i = 0; i < n; i++) texte[i] = chiffres[n - 1 - i];
+  texte[n] = '\0';
+  return texte;
+}
+
+char* ltoa(long valeur, char* texte, int base) {
+  if (base == 10 && valeur < 0) {
+    texte[0] = '-';
+    ultoa(-(unsigned long)valeur, texte + 1, base);
+    return texte;
+  }
+  return ultoa((unsigned long)valeur, texte, base);
+}
+
+char* itoa(int valeur, char* texte, int base) { return ltoa(valeur, texte, base); }
+char* utoa(unsigned int valeur, char* texte, int base) { return ultoa(valeur, texte, base); }
+
+char* dtostrf(double valeur, signed char largeur, unsigned char decimales, char* texte) {
+  sprintf(texte, "%*.*f", largeur, decimales, valeur);
+  return texte;
+}
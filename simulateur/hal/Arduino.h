@@ -0,0 +1,226 @@
+/**
+ * @file Arduino.h
+ * @brief Le "décor de théâtre" qui remplace le cœur Arduino pour faire tourner la balise sur un PC.
+ * @details Seul ce que le programme de la balise utilise est imité : broches, temps,
+ * interruptions, ports série, registres du Timer3 et mémoire flash. Tout se passe sur
+ * une horloge virtuelle (voir Simulation.h) : le temps n'avance que lorsque le
+ * programme appelle une fonction de ce fichier, du coût qu'elle aurait sur une vraie
+ * Mega 2560. Le reste du code (les calculs) est considéré comme instantané.
+ *
+ * Différence à garder en tête : sur le PC, un `int` fait 32 bits et un
+ * `unsigned long` 64 bits (au lieu de 16 et 32 sur l'AVR).
+ */
+#ifndef SIMULATEUR_ARDUINO_H
+#define SIMULATEUR_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+
+// --- Constantes de la carte (Arduino Mega 2560) ---
+#define F_CPU 16000000UL
+#define ARDUINO_AVR_MEGA2560 1
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+#define NOT_AN_INTERRUPT -1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// --- Mémoire flash : sur le PC, tout est en mémoire vive ---
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(adresse) (*(const uint8_t*)(adresse))
+#define pgm_read_word(adresse) (*(const uint16_t*)(adresse))
+#define pgm_read_dword(adresse) (*(const uint32_t*)(adresse))
+#define pgm_read_ptr(adresse) (*(void* const*)(adresse))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+
+class __FlashStringHelper;
+#define F(texte) (reinterpret_cast<const __FlashStringHelper*>(PSTR(texte)))
+
+// --- Broches ---
+void pinMode(uint8_t broche, uint8_t mode);
+void digitalWrite(uint8_t broche, uint8_t niveau);
+int digitalRead(uint8_t broche);
+
+/// Correspondance broche -> port et bit, la même que sur la Mega 2560.
+uint8_t digitalPinToPort(uint8_t broche);
+uint8_t digitalPinToBitMask(uint8_t broche);
+volatile uint8_t* portOutputRegister(uint8_t port);
+int digitalPinToInterrupt(uint8_t broche);
+
+// --- Temps ---
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// --- Interruptions ---
+void attachInterrupt(uint8_t interruption, void (*routine)(), int mode);
+void detachInterrupt(uint8_t interruption);
+void noInterrupts();
+void interrupts();
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+/// Une routine d'interruption devient une fonction ordinaire, appelée par l'horloge virtuelle.
+#define ISR(vecteur) extern "C" void vecteur()
+#define TIMER3_COMPA_vect vecteur_TIMER3_COMPA
+
+// --- Registres du Timer3 (seuls ceux dont se sert ManipulateurTimer) ---
+namespace simulation {
+
+/// Les registres imités : leur lecture et leur écriture passent par le modèle du timer.
+enum NumeroRegistre { REG_TCCR3A, REG_TCCR3B, REG_TCNT3, REG_OCR3A, REG_TIFR3, REG_TIMSK3 };
+
+uint16_t lireRegistre(NumeroRegistre numero);
+void ecrireRegistre(NumeroRegistre numero, uint16_t valeur);
+
+/**
+ * @brief Un registre matériel vu par le programme : un entier, dont chaque accès prévient le modèle du timer.
+ */
+class Registre {
+public:
+  explicit Registre(NumeroRegistre numero) : _numero(numero) {}
+  operator uint16_t() const { return lireRegistre(_numero); }
+  Registre& operator=(uint16_t valeur) { ecrireRegistre(_numero, valeur); return *this; }
+  Registre& operator|=(uint16_t valeur) { return *this = lireRegistre(_numero) | valeur; }
+  Registre& operator&=(uint16_t valeur) { return *this = lireRegistre(_numero) & valeur; }
+
+private:
+  NumeroRegistre _numero;
+};
+
+} // namespace simulation
+
+#define TCCR3A (simulation::Registre(simulation::REG_TCCR3A))
+#define TCCR3B (simulation::Registre(simulation::REG_TCCR3B))
+#define TCNT3  (simulation::Registre(simulation::REG_TCNT3))
+#define OCR3A  (simulation::Registre(simulation::REG_OCR3A))
+#define TIFR3  (simulation::Registre(simulation::REG_TIFR3))
+#define TIMSK3 (simulation::Registre(simulation::REG_TIMSK3))
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define WGM32 3
+#define OCIE3A 1
+#define OCF3A 1
+
+// --- Petites fonctions de la bibliothèque AVR ---
+char* dtostrf(double valeur, signed char largeur, unsigned char decimales, char* texte);
+char* ltoa(long valeur, char* texte, int base);
+char* ultoa(unsigned long valeur, char* texte, int base);
+char* itoa(int valeur, char* texte, int base);
+char* utoa(unsigned int valeur, char* texte, int base);
+
+// --- Affichage ---
+
+/**
+ * @class Print
+ * @brief La même interface que la classe Print d'Arduino : tout ce qui sait écrire un octet sait afficher un nombre.
+ */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t octet) = 0;
+  virtual size_t write(const uint8_t* octets, size_t nombre);
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+  size_t write(const char* texte) { return texte == nullptr ? 0 : write((const uint8_t*)texte, strlen(texte)); }
+  size_t write(const char* texte, size_t nombre) { return write((const uint8_t*)texte, nombre); }
+
+  size_t print(const __FlashStringHelper* texte);
+  size_t print(const char* texte);
+  size_t print(char c);
+  size_t print(unsigned char nombre, int base = DEC);
+  size_t print(int nombre, int base = DEC);
+  size_t print(unsigned int nombre, int base = DEC);
+  size_t print(long nombre, int base = DEC);
+  size_t print(unsigned long nombre, int base = DEC);
+  size_t print(double nombre, int decimales = 2);
+
+  size_t println();
+  size_t println(const __FlashStringHelper* texte);
+  size_t println(const char* texte);
+  size_t println(char c);
+  size_t println(unsigned char nombre, int base = DEC);
+  size_t println(int nombre, int base = DEC);
+  size_t println(unsigned int nombre, int base = DEC);
+  size_t println(long nombre, int base = DEC);
+  size_t println(unsigned long nombre, int base = DEC);
+  size_t println(double nombre, int decimales = 2);
+
+private:
+  size_t printNombre(unsigned long nombre, int base);
+};
+
+/**
+ * @class Stream
+ * @brief Un Print qu'on peut aussi lire.
+ */
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Un port série de la Mega, avec ses tampons de 64 octets et sa vitesse réelle.
+ * @details Les octets reçus sont fournis par le simulateur (phrases NMEA, commandes de
+ * console) à leur heure d'arrivée ; un octet qui arrive tampon plein est perdu. En
+ * émission, le tampon se vide au rythme de la vitesse choisie, et `write()` attend
+ * qu'une place se libère, comme sur la carte.
+ */
+class HardwareSerial : public Stream {
+public:
+  constexpr explicit HardwareSerial(uint8_t numero) : _numero(numero) {}
+
+  void begin(unsigned long vitesse);
+  void end();
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t octet) override;
+  int availableForWrite() override;
+  void flush() override;
+  operator bool() const { return true; }
+  using Print::write;
+
+  uint8_t getNumero() const { return _numero; }
+
+private:
+  uint8_t _numero;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
+
+#endif
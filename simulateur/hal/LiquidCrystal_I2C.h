@@ -0,0 +1,41 @@
+/**
+ * @file LiquidCrystal_I2C.h
+ * @brief L'écran LCD I2C, imité : il garde ce qu'il affiche et coûte le temps de l'I2C.
+ */
+#ifndef SIMULATEUR_LIQUIDCRYSTAL_I2C_H
+#define SIMULATEUR_LIQUIDCRYSTAL_I2C_H
+
+#include <Arduino.h>
+
+/**
+ * @class LiquidCrystal_I2C
+ * @brief Un écran de 4 lignes de 20 caractères au plus, avec son curseur qui avance tout seul.
+ */
+class LiquidCrystal_I2C : public Print {
+public:
+  static const uint8_t COLONNES_MAX = 20;
+  static const uint8_t LIGNES_MAX = 4;
+
+  LiquidCrystal_I2C(uint8_t adresse, uint8_t colonnes, uint8_t lignes);
+
+  void init();
+  void begin() { init(); }
+  void backlight();
+  void noBacklight();
+  void clear();
+  void home();
+  void setCursor(uint8_t colonne, uint8_t ligne);
+  size_t write(uint8_t octet) override;
+  using Print::write;
+
+  /// Ce que montre l'écran, une ligne à la fois (pour le simulateur).
+  const char* getLigne(uint8_t ligne) const;
+  uint8_t getLignes() const { return _lignes; }
+
+private:
+  uint8_t _colonnes, _lignes;
+  uint8_t _curseurColonne, _curseurLigne;
+  char _texte[LIGNES_MAX][COLONNES_MAX + 1];
+};
+
+#endif
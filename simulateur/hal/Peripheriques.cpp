@@ -0,0 +1,153 @@
+/**
+ * @file Peripheriques.cpp
+ * @brief Implémentation des périphériques imités : SPI, EEPROM et écran LCD I2C.
+ */
+#include <Arduino.h>
+#include <SPI.h>
+#include <LiquidCrystal_I2C.h>
+#include <avr/eeprom.h>
+#include "Simulation.h"
+
+using namespace simulation;
+
+namespace {
+
+/// Le contenu de l'EEPROM ; une EEPROM neuve ne contient que des 0xFF.
+uint8_t contenuEEPROM[E2END + 1];
+bool eepromPreparee = false;
+/// L'instant où l'écriture en cours se termine.
+uint64_t finEcritureEEPROM = 0;
+
+/// Le dernier écran construit, pour `afficherLCD()`.
+const LiquidCrystal_I2C* ecranActif = nullptr;
+
+uint8_t* caseEEPROM(const void* adresse) {
+  if (!eepromPreparee) {
+    memset(contenuEEPROM, 0xFF, sizeof(contenuEEPROM));
+    eepromPreparee = true;
+  }
+  return &contenuEEPROM[(uintptr_t)adresse & E2END];
+}
+
+void attendreEEPROM() { avancerJusqua(finEcritureEEPROM); }
+
+} // namespace
+
+// --- SPI ---
+
+SPIClass SPI;
+
+void SPIClass::begin() {}
+void SPIClass::end() {}
+void SPIClass::beginTransaction(SPISettings) {}
+void SPIClass::endTransaction() {}
+
+uint8_t SPIClass::transfer(uint8_t octet) {
+  avancer(couts().octetSPI);
+  return octet;
+}
+
+// --- EEPROM ---
+
+uint8_t eeprom_read_byte(const uint8_t* adresse) {
+  attendreEEPROM();
+  avancer(couts().lectureEEPROM);
+  return *caseEEPROM(adresse);
+}
+
+void eeprom_write_byte(uint8_t* adresse, uint8_t valeur) {
+  attendreEEPROM();
+  *caseEEPROM(adresse) = valeur;
+  finEcritureEEPROM = maintenant() + couts().ecritureEEPROM;
+}
+
+void eeprom_update_byte(uint8_t* adresse, uint8_t valeur) {
+  if (eeprom_read_byte(adresse) != valeur) eeprom_write_byte(adresse, valeur);
+}
+
+void eeprom_read_block(void* destination, const void* source, size_t nombre) {
+  for (size_t i = 0; i < nombre; i++) {
+    ((uint8_t*)destination)[i] = eeprom_read_byte((const uint8_t*)source + i);
+  }
+}
+
+void eeprom_update_block(const void* source, void* destination, size_t nombre) {
+  for (size_t i = 0; i < nombre; i++) {
+    eeprom_update_byte((uint8_t*)destination + i, ((const uint8_t*)source)[i]);
+  }
+}
+
+bool eeprom_is_ready() { return maintenant() >= finEcritureEEPROM; }
+
+namespace simulation {
+
+bool chargerEEPROM(const char* fichier) {
+  FILE* entree = fopen(fichier, "rb");
+  if (entree == nullptr) return false;
+  size_t lus = fread(caseEEPROM(0), 1, sizeof(contenuEEPROM), entree);
+  fclose(entree);
+  return lus == sizeof(contenuEEPROM);
+}
+
+bool sauverEEPROM(const char* fichier) {
+  FILE* sortie = fopen(fichier, "wb");
+  if (sortie == nullptr) return false;
+  size_t ecrits = fwrite(caseEEPROM(0), 1, sizeof(contenuEEPROM), sortie);
+  fclose(sortie);
+  return ecrits == sizeof(contenuEEPROM);
+}
+
+void afficherLCD(FILE* sortie) {
+  if (ecranActif == nullptr) return;
+  for (uint8_t ligne = 0; ligne < ecranActif->getLignes(); ligne++) {
+    fprintf(sortie, "|%s|\n", ecranActif->getLigne(ligne));
+  }
+}
+
+} // namespace simulation
+
+// --- Écran LCD ---
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t, uint8_t colonnes, uint8_t lignes)
+  : _colonnes(colonnes > COLONNES_MAX ? COLONNES_MAX : colonnes), _lignes(lignes > LIGNES_MAX ? LIGNES_MAX : lignes),
+    _curseurColonne(0), _curseurLigne(0) {
+  for (uint8_t ligne = 0; ligne < LIGNES_MAX; ligne++) {
+    memset(_texte[ligne], ' ', _colonnes);
+    _texte[ligne][_colonnes] = '\0';
+  }
+  ecranActif = this;
+}
+
+void LiquidCrystal_I2C::init() {
+  // Les délais imposés par l'initialisation du HD44780 en mode 4 bits.
+  avancer(60 * (NS_PAR_SECONDE / 1000));
+  clear();
+}
+
+void LiquidCrystal_I2C::backlight() { avancer(couts().octetLCD); }
+void LiquidCrystal_I2C::noBacklight() { avancer(couts().octetLCD); }
+
+void LiquidCrystal_I2C::clear() {
+  avancer(couts().effacementLCD);
+  for (uint8_t ligne = 0; ligne < _lignes; ligne++) memset(_texte[ligne], ' ', _colonnes);
+  _curseurColonne = _curseurLigne = 0;
+}
+
+void LiquidCrystal_I2C::home() { setCursor(0, 0); }
+
+void LiquidCrystal_I2C::setCursor(uint8_t colonne, uint8_t ligne) {
+  avancer(couts().octetLCD);
+  _curseurColonne = colonne;
+  _curseurLigne = ligne;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t octet) {
+  avancer(couts().octetLCD);
+  if (_curseurLigne < _lignes && _curseurColonne < _colonnes) {
+    _texte[_curseurLigne][_curseurColonne] = (char)octet;
+  }
+  _curseurColonne++;
+  return 1;
+}
+
+const char* LiquidCrystal_I2C::getLigne(uint8_t ligne) const { return _texte[ligne < _lignes ? ligne : 0]; }
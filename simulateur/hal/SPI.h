@@ -0,0 +1,44 @@
+/**
+ * @file SPI.h
+ * @brief Le SPI matériel de la Mega, réduit à son coût en temps.
+ */
+#ifndef SIMULATEUR_SPI_H
+#define SIMULATEUR_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/// Les broches du SPI matériel de la Mega 2560.
+static const uint8_t MOSI = 51;
+static const uint8_t MISO = 50;
+static const uint8_t SCK = 52;
+static const uint8_t SS = 53;
+
+/**
+ * @brief Les réglages d'une transaction (ignorés : seul le temps compte ici).
+ */
+struct SPISettings {
+  SPISettings() {}
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+/**
+ * @class SPIClass
+ * @brief Le SPI matériel : chaque octet transféré coûte son temps, rien de plus.
+ */
+class SPIClass {
+public:
+  void begin();
+  void end();
+  void beginTransaction(SPISettings reglages);
+  void endTransaction();
+  uint8_t transfer(uint8_t octet);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file Simulation.h
+ * @brief Les commandes du "régisseur" : ce que le simulateur peut faire du décor Arduino.
+ * @details Le programme de la balise ne voit que Arduino.h. Le simulateur, lui, se sert
+ * de ce fichier pour faire avancer l'horloge virtuelle, fournir les octets reçus par
+ * les ports série, déclencher les fronts des interruptions externes (le PPS du GPS)
+ * et observer chaque changement d'état des broches.
+ */
+#ifndef SIMULATEUR_SIMULATION_H
+#define SIMULATEUR_SIMULATION_H
+
+#include <Arduino.h>
+
+namespace simulation {
+
+/// Nanosecondes par seconde, pour écrire les instants lisiblement.
+const uint64_t NS_PAR_SECONDE = 1000000000ULL;
+/// Nanosecondes par microseconde.
+const uint64_t NS_PAR_US = 1000ULL;
+
+/**
+ * @struct CoutsAVR
+ * @brief Le temps que prendrait chaque appel sur une Mega 2560 à 16 MHz, en nanosecondes.
+ * @details Ce sont des ordres de grandeur mesurés sur la carte : ils suffisent à rendre
+ * compte des retards de la boucle, pas à compter les cycles.
+ */
+struct CoutsAVR {
+  uint32_t micros = 3500;          ///< micros() et millis() (interruptions coupées, division...).
+  uint32_t digitalWrite = 4000;    ///< digitalWrite() : tables en flash, lecture-modification-écriture.
+  uint32_t digitalRead = 3500;     ///< digitalRead().
+  uint32_t pinMode = 4000;         ///< pinMode().
+  uint32_t serieDisponible = 1000; ///< available() d'un port série.
+  uint32_t serieLecture = 4000;    ///< read() d'un port série, analyse NMEA comprise.
+  uint32_t serieEcriture = 3000;   ///< write() d'un port série, quand le tampon a de la place.
+  uint32_t octetLCD = 550000;      ///< Un caractère ou un déplacement de curseur de l'écran I2C (100 kHz).
+  uint32_t effacementLCD = 2500000;///< clear() de l'écran.
+  uint32_t octetSPI = 1500;        ///< Un octet par le SPI matériel à 8 MHz.
+  uint32_t lectureEEPROM = 1000;   ///< Lecture d'un octet de l'EEPROM.
+  uint32_t ecritureEEPROM = 3400000; ///< Durée d'écriture d'un octet de l'EEPROM (l'EEPROM est occupée pendant ce temps).
+  uint32_t interruption = 3000;    ///< Entrée et sortie d'une routine d'interruption.
+  uint32_t boucle = 2000;          ///< Le reste d'un passage dans loop() : appels, tests, calculs des tâches.
+};
+
+/// Les coûts en vigueur, modifiables par le simulateur avant le démarrage.
+CoutsAVR& couts();
+
+// --- Horloge virtuelle ---
+
+/// L'instant présent, en nanosecondes depuis la mise sous tension.
+uint64_t maintenant();
+
+/**
+ * @brief Fait avancer l'horloge, en servant au passage les interruptions qui tombent.
+ * @details Une interruption est servie à son instant exact, sauf si le programme les a
+ * coupées (`noInterrupts()`, `ATOMIC_BLOCK`) : elle attend alors leur retour, comme sur la carte.
+ */
+void avancer(uint64_t dureeNs);
+
+/// Fait avancer l'horloge jusqu'à un instant donné (rien si on y est déjà).
+void avancerJusqua(uint64_t instantNs);
+
+/// Plus tôt des événements déjà programmés (comparaison du Timer3, front externe), ou `UINT64_MAX`.
+uint64_t prochainEvenement();
+
+// --- Broches ---
+
+/// Le niveau actuel d'une broche de sortie.
+uint8_t niveau(uint8_t broche);
+
+/// Appelée à chaque changement d'état d'une broche de sortie.
+typedef void (*ObservateurBroche)(uint64_t instantNs, uint8_t broche, uint8_t niveau);
+
+/**
+ * @brief Choisit la fonction prévenue de chaque changement d'état d'une broche.
+ * @details Les écritures par `digitalWrite()` sont vues immédiatement. Les écritures
+ * directes dans les registres de port (depuis une interruption, par exemple) sont vues
+ * à la fin de l'interruption ou au prochain appel d'une fonction Arduino : une
+ * impulsion écrite directement dans un port, sans appel entre les deux fronts, est invisible.
+ */
+void setObservateur(ObservateurBroche observateur);
+
+/// Nombre de changements d'état observés depuis le démarrage.
+unsigned long getNombreTransitions();
+
+// --- Interruptions externes ---
+
+/**
+ * @brief Programme un front sur une interruption externe (INT0 pour la broche 2...).
+ * @details La routine attachée par `attachInterrupt()` sera appelée à cet instant. Un
+ * seul front peut être en attente par interruption : le suivant se programme une fois
+ * celui-ci passé.
+ */
+void programmerFront(uint8_t interruption, uint64_t instantNs);
+
+/// L'instant du front en attente sur cette interruption, ou `UINT64_MAX`.
+uint64_t frontProgramme(uint8_t interruption);
+
+// --- Ports série ---
+
+/**
+ * @class SourceSerie
+ * @brief Ce qui "parle" à un port série : un module GPS, un opérateur au clavier...
+ */
+class SourceSerie {
+public:
+  virtual ~SourceSerie() {}
+  /**
+   * @brief Donne le prochain octet à recevoir et son instant d'arrivée, sans le retirer.
+   * @return `false` s'il n'y a plus rien à envoyer.
+   */
+  virtual bool prochainOctet(uint64_t& instantNs, uint8_t& octet) = 0;
+  /// Retire l'octet donné par `prochainOctet()`.
+  virtual void consommer() = 0;
+};
+
+/// Branche une source sur un port série (`nullptr` pour la débrancher).
+void brancherSource(HardwareSerial& port, SourceSerie* source);
+
+/// Choisit où vont les octets envoyés par un port série (`nullptr` : nulle part).
+void setSortie(HardwareSerial& port, FILE* sortie);
+
+/// Nombre d'octets reçus alors que le tampon de réception du port était plein.
+unsigned long getOctetsPerdus(HardwareSerial& port);
+
+// --- EEPROM et écran ---
+
+/// Relit le contenu de l'EEPROM depuis un fichier (`false` s'il n'existe pas).
+bool chargerEEPROM(const char* fichier);
+
+/// Sauve le contenu de l'EEPROM dans un fichier.
+bool sauverEEPROM(const char* fichier);
+
+/// Écrit ce que montre l'écran LCD, ligne par ligne.
+void afficherLCD(FILE* sortie);
+
+} // namespace simulation
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file eeprom.h
+ * @brief Les 4 Ko d'EEPROM de la Mega, avec la durée d'écriture d'un octet.
+ */
+#ifndef SIMULATEUR_AVR_EEPROM_H
+#define SIMULATEUR_AVR_EEPROM_H
+
+#include <Arduino.h>
+
+/// Dernière adresse de l'EEPROM de l'ATmega2560.
+#define E2END 0x0FFF
+
+uint8_t eeprom_read_byte(const uint8_t* adresse);
+void eeprom_write_byte(uint8_t* adresse, uint8_t valeur);
+void eeprom_update_byte(uint8_t* adresse, uint8_t valeur);
+void eeprom_read_block(void* destination, const void* source, size_t nombre);
+void eeprom_update_block(const void* source, void* destination, size_t nombre);
+/// `false` tant que l'écriture précédente n'est pas finie (3,4 ms par octet).
+bool eeprom_is_ready();
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file sleep.h
+ * @brief Le sommeil de avr-libc : l'horloge virtuelle saute jusqu'à la prochaine interruption.
+ */
+#ifndef SIMULATEUR_AVR_SLEEP_H
+#define SIMULATEUR_AVR_SLEEP_H
+
+#include <Arduino.h>
+
+/// Le seul mode imité : IDLE, où le cœur s'arrête et tous les périphériques continuent.
+#define SLEEP_MODE_IDLE 0
+
+void set_sleep_mode(uint8_t mode);
+/// Autorise le sommeil (bit SE) et note les interruptions déjà servies.
+void sleep_enable();
+void sleep_disable();
+/**
+ * @brief Dort jusqu'à la prochaine interruption : débordement du Timer0 (toutes les
+ * 1024 µs, celui de millis()), comparaison du Timer3, front externe, octet reçu ou
+ * parti d'un port série.
+ * @details Comme sur la carte, une interruption servie entre `sleep_enable()` et
+ * `sleep_cpu()` (après le `sei()` qui les sépare) réveille aussitôt.
+ */
+void sleep_cpu();
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file atomic.h
+ * @brief ATOMIC_BLOCK de avr-libc : les interruptions de l'horloge virtuelle attendent la fin du bloc.
+ */
+#ifndef SIMULATEUR_UTIL_ATOMIC_H
+#define SIMULATEUR_UTIL_ATOMIC_H
+
+#include <Arduino.h>
+
+namespace simulation {
+
+/**
+ * @brief Coupe les interruptions le temps d'un bloc, puis remet l'état d'avant.
+ */
+class SectionAtomique {
+public:
+  SectionAtomique();
+  ~SectionAtomique();
+  /// Vrai au premier tour seulement : le bloc s'exécute une fois.
+  bool encore() {
+    bool premier = _premierTour;
+    _premierTour = false;
+    return premier;
+  }
+
+private:
+  bool _etaient;
+  bool _premierTour;
+};
+
+} // namespace simulation
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) for (simulation::SectionAtomique sectionAtomique_; sectionAtomique_.encore();)
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @file crc16.h
+ * @brief La somme de contrôle CRC-16 CCITT de avr-libc, au bit près.
+ */
+#ifndef SIMULATEUR_UTIL_CRC16_H
+#define SIMULATEUR_UTIL_CRC16_H
+
+#include <stdint.h>
+
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t donnee) {
+  donnee ^= (uint8_t)(crc & 0xFF);
+  donnee ^= (uint8_t)(donnee << 4);
+  return (uint16_t)((((uint16_t)donnee << 8) | (crc >> 8)) ^ (uint8_t)(donnee >> 4) ^ ((uint16_t)donnee << 3));
+}
+
+#endif
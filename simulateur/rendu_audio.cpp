@@ -0,0 +1,359 @@
+/**
+ * @file rendu_audio.cpp
+ * @brief Fait entendre la balise : sa manipulation, rendue en fichier WAV, et la mesure de ses clics.
+ * @details Deux sources possibles :
+ * - `--message` : le message est traduit par la vraie classe SequenceMorse, puis rythmé
+ *   comme le fait le ManipulateurTimer, au tick de 4 µs près (voir `partitionMessage()`) ;
+ * - `--vcd` : une trace du simulateur (ou d'un analyseur logique) est rejouée : fronts du
+ *   PTT, et mots d'accord du DDS relus sur W_CLK, DATA et FQ_UD. Le ton le plus bas de
+ *   chaque émission sort à la hauteur `--audio` ; en WSPR et en QRSS, les autres tons
+ *   s'entendent au-dessus, à leur écart exact. Une journée de trace, toutes bandes
+ *   confondues, se rend ainsi telle que la balise l'a manipulée.
+ *
+ * Exemples :
+ * - `./rendu_audio --message "VVV DE F5ZHM" --mpm 15 --wav vvv.wav` ;
+ * - `./rendu_audio --vcd balise.vcd --wav balise.wav --silence-max 2 --clics` ;
+ * - `./rendu_audio --vcd wspr.vcd --audio 1500 --wav wspr.wav` : à décoder avec WSJT-X ;
+ * - `./rendu_audio --message "VVV" --montee 0 --clics` : la manipulation brute, pour comparer.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "GestionnaireDDS.h"
+#include "SequenceMorse.h"
+#include "AnalyseSpectre.h"
+#include "RenduAudio.h"
+
+namespace {
+
+/// Le Timer3 compte à 250 kHz (16 MHz divisés par 64) : un tick dure 4 µs.
+const unsigned long TICKS_PAR_SECONDE = 250000UL;
+const uint64_t NS_PAR_TICK = 4000;
+const uint64_t NS_PAR_SECONDE = 1000000000ULL;
+/// Silence laissé avant et après un message rendu seul.
+const uint64_t MARGE_MESSAGE_NS = 500000000ULL;
+/// Un silence plus long que ceci sépare deux émissions (un espace de mots QRSS reste plus court, PTT appuyé).
+const uint64_t SEPARATION_EMISSIONS_NS = 5 * NS_PAR_SECONDE;
+
+/**
+ * @brief Les réglages du rendu, lus sur la ligne de commande.
+ */
+struct Options {
+  const char* message = nullptr;
+  int motsParMinute = 15;
+  const char* vcd = nullptr;
+  const char* wav = nullptr;
+  unsigned long echantillonsParSeconde = 12000;
+  double audioHz = 700;
+  double monteeMs = 5;
+  double silenceMaxS = 0;
+  bool clics = false;
+  double bandeMaxHz = 0;
+};
+
+/// La manipulation à rendre.
+struct Partition {
+  std::vector<RenduAudio::Front> fronts;
+  std::vector<RenduAudio::Ton> tons;
+  uint64_t finNs = 0;
+};
+
+/**
+ * @brief Rythme un message comme l'EmetteurMorse et son ManipulateurTimer.
+ * @details L'EmetteurMorse règle l'unité à 6 / (5 × mpm) s (`setDureeUnite(6, 5 * wpm)`),
+ * que le timer compte en ticks entiers : chaque unité dure `ticksParUnite` ticks, plus un
+ * de temps en temps pour rattraper le reste de la division. Chaque étape commence à une
+ * interruption, c'est-à-dire à une frontière d'unité.
+ */
+bool partitionMessage(const char* message, int motsParMinute, double audioHz, Partition& partition) {
+  SequenceMorse sequence;
+  if (!sequence.compiler(message) || sequence.getNombreEtapes() == 0) return false;
+
+  const unsigned long numerateur = 6, denominateur = 5UL * motsParMinute;
+  const unsigned long ticksParUnite = (TICKS_PAR_SECONDE * numerateur) / denominateur;
+  const unsigned long resteParUnite = (TICKS_PAR_SECONDE * numerateur) % denominateur;
+  unsigned long cumulReste = 0;
+  bool premiereUnite = true;
+  bool appui = false;
+  uint64_t instant = MARGE_MESSAGE_NS;
+
+  for (uint16_t i = 0; i < sequence.getNombreEtapes(); i++) {
+    uint8_t etape = sequence.getEtape(i);
+    if (SequenceMorse::estSon(etape) != appui) {
+      appui = SequenceMorse::estSon(etape);
+      partition.fronts.push_back(RenduAudio::Front{ instant, appui });
+    }
+    for (uint8_t unite = 0; unite < SequenceMorse::getDuree(etape); unite++) {
+      unsigned long ticks = ticksParUnite;
+      // Comme ManipulateurTimer::interruption() : la première unité n'a pas de rattrapage.
+      if (!premiereUnite) {
+        cumulReste += resteParUnite;
+        if (cumulReste >= denominateur) {
+          cumulReste -= denominateur;
+          ticks++;
+        }
+      }
+      premiereUnite = false;
+      instant += ticks * NS_PAR_TICK;
+    }
+  }
+  // La file vide, le timer relâche le PTT.
+  if (appui) partition.fronts.push_back(RenduAudio::Front{ instant, false });
+  partition.tons.push_back(RenduAudio::Ton{ 0, audioHz });
+  partition.finNs = instant + MARGE_MESSAGE_NS;
+  return true;
+}
+
+/// Une validation de fréquence lue dans la trace.
+struct Validation {
+  uint64_t instantNs;
+  double frequenceHz;
+};
+
+/**
+ * @brief Lit une trace VCD : les fronts du PTT et la fréquence de chaque validation du DDS.
+ * @details Comme `outils/verifier_vcd.py` : le mot d'accord est fait des 40 derniers bits
+ * lus sur DATA aux fronts montants de W_CLK, poids faible en premier, la valeur de DATA
+ * étant prise juste avant le front.
+ */
+bool lireVCD(const char* chemin, std::vector<RenduAudio::Front>& fronts, std::vector<Validation>& validations, uint64_t& finNs) {
+  FILE* fichier = fopen(chemin, "r");
+  if (fichier == nullptr) return false;
+  enum Signal { AUTRE, PTT, W_CLK, DATA, FQ_UD };
+  std::vector<std::pair<std::string, Signal>> identifiants;
+  char jeton[256];
+  uint64_t instant = 0;
+  uint8_t niveaux[5] = {};
+  uint8_t dataAvant = 0;        // DATA juste avant l'instant en cours.
+  uint64_t instantData = 0;
+  uint64_t registre = 0;        // Les 40 derniers bits envoyés au DDS.
+  bool entete = true;
+
+  while (fscanf(fichier, "%255s", jeton) == 1) {
+    if (entete) {
+      if (strcmp(jeton, "$var") == 0) {
+        char type[64], taille[16], identifiant[64], nom[128];
+        if (fscanf(fichier, "%63s %15s %63s %127s", type, taille, identifiant, nom) != 4) break;
+        Signal signal = strcmp(nom, "PTT") == 0 ? PTT : strcmp(nom, "DDS_W_CLK") == 0 ? W_CLK
+                      : strcmp(nom, "DDS_DATA") == 0 ? DATA : strcmp(nom, "DDS_FQ_UD") == 0 ? FQ_UD : AUTRE;
+        if (strcmp(taille, "1") == 0 && signal != AUTRE) identifiants.push_back(std::make_pair(std::string(identifiant), signal));
+      } else if (strcmp(jeton, "$enddefinitions") == 0) {
+        entete = false;
+      }
+      continue;
+    }
+    if (jeton[0] == '#') {
+      instant = strtoull(jeton + 1, nullptr, 10);
+      finNs = instant;
+      continue;
+    }
+    if (jeton[0] != '0' && jeton[0] != '1') continue; // $dumpvars, $end...
+    Signal signal = AUTRE;
+    for (const auto& paire : identifiants) {
+      if (paire.first == jeton + 1) signal = paire.second;
+    }
+    uint8_t niveau = jeton[0] == '1';
+    if (signal == AUTRE || niveaux[signal] == niveau) continue;
+    niveaux[signal] = niveau;
+
+    if (signal == PTT) {
+      fronts.push_back(RenduAudio::Front{ instant, niveau == 1 });
+    } else if (signal == DATA) {
+      if (instantData != instant) dataAvant = 1 - niveau;
+      instantData = instant;
+    } else if (signal == W_CLK && niveau == 1) {
+      uint64_t bit = instantData == instant ? dataAvant : niveaux[DATA];
+      registre = (registre >> 1) | (bit << 39);
+    } else if (signal == FQ_UD && niveau == 1) {
+      uint32_t mot = (uint32_t)registre;
+      validations.push_back(Validation{ instant, mot * (double)GestionnaireDDS::HORLOGE_NOMINALE_HZ / 4294967296.0 });
+    }
+  }
+  fclose(fichier);
+  return !entete && !identifiants.empty();
+}
+
+/**
+ * @brief Donne à chaque émission ses tons : le plus bas à `audioHz`, les autres à leur écart.
+ * @details Comme un opérateur qui accorde son récepteur sur chaque balise tour à tour.
+ */
+void placerTons(const std::vector<Validation>& validations, double audioHz, Partition& partition) {
+  const std::vector<RenduAudio::Front>& fronts = partition.fronts;
+  partition.tons.push_back(RenduAudio::Ton{ 0, audioHz });
+  size_t suivante = 0; // La première validation pas encore passée.
+  size_t i = 0;
+  while (i < fronts.size()) {
+    if (!fronts[i].appui) {
+      i++;
+      continue;
+    }
+    // L'émission : les fronts jusqu'au premier silence assez long pour séparer deux émissions.
+    size_t fin = i + 1;
+    while (fin + 1 < fronts.size() && fronts[fin + 1].instantNs - fronts[fin].instantNs < SEPARATION_EMISSIONS_NS) fin += 2;
+    uint64_t debutNs = fronts[i].instantNs;
+    uint64_t finNs = fin < fronts.size() ? fronts[fin].instantNs : partition.finNs;
+
+    // La fréquence au début de l'émission est celle de la dernière validation passée.
+    while (suivante < validations.size() && validations[suivante].instantNs <= debutNs) suivante++;
+    size_t premiere = suivante > 0 ? suivante - 1 : suivante;
+    size_t derniere = suivante;
+    while (derniere < validations.size() && validations[derniere].instantNs <= finNs) derniere++;
+    if (premiere < derniere) {
+      double plusBas = validations[premiere].frequenceHz;
+      for (size_t v = premiere; v < derniere; v++) {
+        if (validations[v].frequenceHz < plusBas) plusBas = validations[v].frequenceHz;
+      }
+      for (size_t v = premiere; v < derniere; v++) {
+        uint64_t instant = v == premiere ? debutNs : validations[v].instantNs;
+        partition.tons.push_back(RenduAudio::Ton{ instant, audioHz + validations[v].frequenceHz - plusBas });
+      }
+    }
+    suivante = derniere;
+    i = fin + 1;
+  }
+}
+
+/**
+ * @brief Raccourcit à `maxNs` les silences plus longs, pour écouter une journée sans ses attentes.
+ */
+void raccourcirSilences(uint64_t maxNs, Partition& partition) {
+  // Les coupures [debut, fin[ du temps, rangées par instant croissant.
+  std::vector<std::pair<uint64_t, uint64_t>> coupures;
+  uint64_t relache = 0;
+  for (const RenduAudio::Front& front : partition.fronts) {
+    if (front.appui && front.instantNs > relache + maxNs) coupures.push_back(std::make_pair(relache + maxNs, front.instantNs));
+    if (!front.appui) relache = front.instantNs;
+  }
+  if (partition.finNs > relache + maxNs && (partition.fronts.empty() || !partition.fronts.back().appui)) {
+    coupures.push_back(std::make_pair(relache + maxNs, partition.finNs));
+  }
+
+  // Un instant recule de la longueur des coupures qui le précèdent ; dans une coupure, il en prend le début.
+  auto deplacer = [&coupures](uint64_t instant, size_t& coupure, uint64_t& retire) {
+    while (coupure < coupures.size() && coupures[coupure].second <= instant) {
+      retire += coupures[coupure].second - coupures[coupure].first;
+      coupure++;
+    }
+    if (coupure < coupures.size() && coupures[coupure].first < instant) instant = coupures[coupure].first;
+    return instant - retire;
+  };
+  size_t coupure = 0;
+  uint64_t retire = 0;
+  for (RenduAudio::Front& front : partition.fronts) front.instantNs = deplacer(front.instantNs, coupure, retire);
+  coupure = 0;
+  retire = 0;
+  for (RenduAudio::Ton& ton : partition.tons) ton.instantNs = deplacer(ton.instantNs, coupure, retire);
+  partition.finNs = deplacer(partition.finNs, coupure, retire);
+}
+
+/// Envoie les échantillons à plusieurs sorties à la fois.
+class Sorties : public SortieAudio {
+public:
+  void ajouter(SortieAudio* sortie) { _sorties.push_back(sortie); }
+  void ecrire(const float* echantillons, size_t nombre) override {
+    for (SortieAudio* sortie : _sorties) sortie->ecrire(echantillons, nombre);
+  }
+
+private:
+  std::vector<SortieAudio*> _sorties;
+};
+
+void usage(const char* programme) {
+  fprintf(stderr,
+          "Usage : %s (--message TEXTE | --vcd FICHIER) [options]\n"
+          "  --message TEXTE        manipule TEXTE comme l'EmetteurMorse\n"
+          "  --mpm N                rythme du message, en mots par minute (15 par defaut)\n"
+          "  --vcd FICHIER          rejoue une trace : PTT et mots d'accord du DDS\n"
+          "  --wav FICHIER          ecrit le son (PCM 16 bits, une voie)\n"
+          "  --echantillons N       echantillons par seconde (12000 par defaut)\n"
+          "  --audio HZ             hauteur du ton le plus bas de chaque emission (700 par defaut)\n"
+          "  --montee MS            duree des fronts en cosinus sureleve (5 par defaut, 0 : manipulation brute)\n"
+          "  --silence-max S        raccourcit a S secondes les silences plus longs\n"
+          "  --clics                mesure le spectre et la bande occupee par les clics de manipulation\n"
+          "  --bande-max HZ         avec --clics : echec si la bande occupee a -60 dB depasse HZ\n",
+          programme);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    const char* valeur = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (option == "--message" && valeur) options.message = valeur;
+    else if (option == "--mpm" && valeur) options.motsParMinute = atoi(valeur);
+    else if (option == "--vcd" && valeur) options.vcd = valeur;
+    else if (option == "--wav" && valeur) options.wav = valeur;
+    else if (option == "--echantillons" && valeur) options.echantillonsParSeconde = strtoul(valeur, nullptr, 10);
+    else if (option == "--audio" && valeur) options.audioHz = atof(valeur);
+    else if (option == "--montee" && valeur) options.monteeMs = atof(valeur);
+    else if (option == "--silence-max" && valeur) options.silenceMaxS = atof(valeur);
+    else if (option == "--bande-max" && valeur) {
+      options.bandeMaxHz = atof(valeur);
+      options.clics = true;
+    } else {
+      if (option == "--clics") options.clics = true;
+      else {
+        usage(argv[0]);
+        return option == "--aide" || option == "-h" ? 0 : 2;
+      }
+      continue;
+    }
+    i++;
+  }
+  if ((options.message == nullptr) == (options.vcd == nullptr) || options.motsParMinute <= 0 ||
+      options.echantillonsParSeconde < 1000 || options.monteeMs < 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  Partition partition;
+  if (options.message != nullptr) {
+    if (!partitionMessage(options.message, options.motsParMinute, options.audioHz, partition)) {
+      fprintf(stderr, "Message sans aucun caractere Morse : %s\n", options.message);
+      return 2;
+    }
+  } else {
+    std::vector<Validation> validations;
+    if (!lireVCD(options.vcd, partition.fronts, validations, partition.finNs)) {
+      fprintf(stderr, "Trace VCD illisible ou sans signal PTT : %s\n", options.vcd);
+      return 2;
+    }
+    placerTons(validations, options.audioHz, partition);
+  }
+  if (options.silenceMaxS > 0) raccourcirSilences((uint64_t)(options.silenceMaxS * NS_PAR_SECONDE), partition);
+
+  Sorties sorties;
+  FichierWAV wav;
+  if (options.wav != nullptr) {
+    if (!wav.ouvrir(options.wav, options.echantillonsParSeconde)) {
+      fprintf(stderr, "Impossible d'ecrire %s\n", options.wav);
+      return 2;
+    }
+    sorties.ajouter(&wav);
+  }
+  AnalyseSpectre spectre(options.echantillonsParSeconde);
+  if (options.clics) sorties.ajouter(&spectre);
+
+  RenduAudio rendu(options.echantillonsParSeconde, options.monteeMs / 1000, 0.5f);
+  auto debutReel = std::chrono::steady_clock::now();
+  uint64_t echantillons = rendu.rendre(partition.fronts, partition.tons, partition.finNs, sorties);
+  double dureeReelle = std::chrono::duration<double>(std::chrono::steady_clock::now() - debutReel).count();
+  if (options.wav != nullptr && !wav.fermer()) {
+    fprintf(stderr, "Erreur d'ecriture de %s\n", options.wav);
+    return 2;
+  }
+
+  double dureeSon = (double)echantillons / options.echantillonsParSeconde;
+  printf("Rendu : %zu fronts, %.1f s de son en %.2f s (%.0f fois le temps reel)\n", partition.fronts.size(), dureeSon,
+         dureeReelle, dureeReelle > 0 ? dureeSon / dureeReelle : 0.0);
+  if (!options.clics) return 0;
+  spectre.rapport(stdout);
+  if (options.bandeMaxHz > 0 && spectre.getBandeHz(-60) > options.bandeMaxHz) {
+    printf("Clics de manipulation : bande occupee a -60 dB au-dela de %.0f Hz\n", options.bandeMaxHz);
+    return 1;
+  }
+  return 0;
+}
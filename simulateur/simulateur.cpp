@@ -0,0 +1,236 @@
+/**
+ * @file simulateur.cpp
+ * @brief Fait tourner le programme de la balise, sans aucune modification, sur un PC.
+ * @details Le fichier balise_hf.ino est inclus tel quel, avec les vraies classes du
+ * projet ; seul le cœur Arduino est remplacé par le décor du dossier `hal/`. Le GPS
+ * virtuel envoie ses phrases NMEA et son PPS, l'horloge virtuelle avance bien plus vite
+ * que le temps réel, et chaque changement d'état des broches est observé.
+ *
+ * Exemples :
+ * - `./simulateur --minutes 10` : dix minutes de fonctionnement, avec la console ;
+ * - `./simulateur --banc` : 24 heures simulées, puis le rapport du banc d'essai ;
+ * - `./simulateur --nmea capture.nmea --commande 90:TACHES` : rejoue un enregistrement du GPS ;
+ * - `./simulateur --minutes 3 --vcd balise.vcd` : les fronts du PTT, des filtres et du DDS, pour GTKWave.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "GPSSimule.h"
+#include "Mesures.h"
+#include "TraceVCD.h"
+
+#include "../balise_hf.ino"
+
+namespace {
+
+/**
+ * @brief Les commandes tapées par un opérateur virtuel sur la console, chacune à son heure.
+ */
+class ConsoleSimulee : public simulation::SourceSerie {
+public:
+  /// Ajoute une commande, tapée `seconde` secondes après la mise sous tension.
+  void ajouter(double seconde, const std::string& commande) {
+    uint64_t instant = (uint64_t)(seconde * simulation::NS_PAR_SECONDE);
+    // À 115200 bauds, un octet toutes les 87 µs.
+    for (char c : commande + "\n") {
+      _octets.push_back(Octet{ instant, (uint8_t)c });
+      instant += 10ULL * simulation::NS_PAR_SECONDE / VITESSE_CONSOLE;
+    }
+  }
+
+  bool prochainOctet(uint64_t& instantNs, uint8_t& octet) override {
+    if (_suivant >= _octets.size()) return false;
+    instantNs = _octets[_suivant].instant;
+    octet = _octets[_suivant].valeur;
+    return true;
+  }
+
+  void consommer() override { _suivant++; }
+
+private:
+  struct Octet {
+    uint64_t instant;
+    uint8_t valeur;
+  };
+  std::vector<Octet> _octets; ///< Rangés par instant croissant (les commandes sont données dans l'ordre).
+  size_t _suivant = 0;
+};
+
+/**
+ * @brief Les réglages de la simulation, lus sur la ligne de commande.
+ */
+struct Options {
+  double dureeS = 600;
+  bool banc = false;
+  bool muet = false;
+  bool ecran = false;
+  const char* nmea = nullptr;
+  const char* eeprom = nullptr;
+  const char* vcd = nullptr;
+  size_t capaciteVCD = 1UL << 20;
+};
+
+Mesures* mesuresActives = nullptr;
+TraceVCD* traceActive = nullptr;
+
+/// L'observateur des broches : le banc d'essai et, si demandé, la trace VCD.
+void observerBroche(uint64_t instantNs, uint8_t broche, uint8_t etat) {
+  if (mesuresActives != nullptr) mesuresActives->noterTransition(instantNs, broche, etat);
+  if (traceActive != nullptr) traceActive->noter(instantNs, broche, etat);
+}
+
+/// Les broches enregistrées dans la trace VCD, sous le nom de leur constante.
+void nommerSignaux(TraceVCD& trace) {
+  trace.nommer(BROCHE_PTT, "PTT");
+  trace.nommer(BROCHE_LED_EMISSION, "LED_EMISSION");
+  trace.nommer(BROCHE_DDS_W_CLK, "DDS_W_CLK");
+  trace.nommer(BROCHE_DDS_FQ_UD, "DDS_FQ_UD");
+  trace.nommer(BROCHE_DDS_DATA, "DDS_DATA");
+  trace.nommer(BROCHE_DDS_RESET, "DDS_RESET");
+  trace.nommer(BROCHE_FILTRE_80M, "FILTRE_80M");
+  trace.nommer(BROCHE_FILTRE_40M, "FILTRE_40M");
+  trace.nommer(BROCHE_FILTRE_30M, "FILTRE_30M");
+  trace.nommer(BROCHE_FILTRE_20M, "FILTRE_20M");
+  trace.nommer(BROCHE_FILTRE_17M, "FILTRE_17M");
+  trace.nommer(BROCHE_FILTRE_15M, "FILTRE_15M");
+  trace.nommer(BROCHE_FILTRE_12M, "FILTRE_12M");
+  trace.nommer(BROCHE_FILTRE_10M, "FILTRE_10M");
+  trace.nommer(BROCHE_FILTRE_6M, "FILTRE_6M");
+}
+
+void usage(const char* programme) {
+  fprintf(stderr,
+          "Usage : %s [options]\n"
+          "  --secondes S, --minutes M, --heures H   duree simulee (10 minutes par defaut)\n"
+          "  --banc                 banc d'essai : 24 h par defaut, console muette, rapport a la fin\n"
+          "  --nmea FICHIER         rejoue un enregistrement du GPS au lieu de phrases fabriquees\n"
+          "  --debut HH:MM:SS       heure UTC a la mise sous tension (phrases fabriquees)\n"
+          "  --fix-heure S          secondes avant la premiere heure valide (25 par defaut)\n"
+          "  --fix-position S       secondes avant la premiere position valide (40 par defaut)\n"
+          "  --sans-pps             le GPS ne donne pas d'impulsion PPS\n"
+          "  --commande S:TEXTE     tape TEXTE sur la console S secondes apres la mise sous tension\n"
+          "  --eeprom FICHIER       relit puis sauve le contenu de l'EEPROM\n"
+          "  --vcd FICHIER          ecrit les fronts du PTT, de la LED, des filtres et du DDS (format VCD)\n"
+          "  --vcd-capacite N       nombre de fronts retenus pour la trace VCD (1048576 par defaut)\n"
+          "  --ecran                affiche l'ecran LCD a la fin\n"
+          "  --muet                 n'affiche pas la console de la balise\n"
+          "  --console              affiche la console de la balise, meme avec --banc\n",
+          programme);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  GPSSimule::Reglages reglagesGPS;
+  ConsoleSimulee console;
+  bool dureeDonnee = false;
+  bool consoleVisible = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    const char* valeur = i + 1 < argc ? argv[i + 1] : nullptr;
+    bool avecValeur = true;
+    if (option == "--secondes" && valeur) options.dureeS = atof(valeur);
+    else if (option == "--minutes" && valeur) options.dureeS = atof(valeur) * 60;
+    else if (option == "--heures" && valeur) options.dureeS = atof(valeur) * 3600;
+    else if (option == "--nmea" && valeur) options.nmea = valeur;
+    else if (option == "--eeprom" && valeur) options.eeprom = valeur;
+    else if (option == "--vcd" && valeur) options.vcd = valeur;
+    else if (option == "--vcd-capacite" && valeur) options.capaciteVCD = strtoul(valeur, nullptr, 10);
+    else if (option == "--fix-heure" && valeur) reglagesGPS.delaiHeureS = atol(valeur);
+    else if (option == "--fix-position" && valeur) reglagesGPS.delaiPositionS = atol(valeur);
+    else if (option == "--debut" && valeur) {
+      unsigned h = 0, m = 0, s = 0;
+      if (sscanf(valeur, "%u:%u:%u", &h, &m, &s) < 2) {
+        usage(argv[0]);
+        return 2;
+      }
+      reglagesGPS.secondeDuJour = (h * 3600UL + m * 60UL + s) % 86400UL;
+    } else if (option == "--commande" && valeur && strchr(valeur, ':')) {
+      console.ajouter(atof(valeur), strchr(valeur, ':') + 1);
+    } else {
+      avecValeur = false;
+      if (option == "--banc") options.banc = true;
+      else if (option == "--muet") options.muet = true;
+      else if (option == "--sans-pps") reglagesGPS.pps = false;
+      else if (option == "--ecran") options.ecran = true;
+      else if (option == "--console") consoleVisible = true;
+      else if (option == "--aide" || option == "-h") {
+        usage(argv[0]);
+        return 0;
+      } else {
+        usage(argv[0]);
+        return 2;
+      }
+    }
+    if (avecValeur) {
+      if (option == "--secondes" || option == "--minutes" || option == "--heures") dureeDonnee = true;
+      i++;
+    }
+  }
+  if (options.banc) {
+    if (!dureeDonnee) options.dureeS = 24 * 3600.0;
+    if (!consoleVisible) options.muet = true;
+  }
+
+  GPSSimule gps(reglagesGPS);
+  if (options.nmea != nullptr && !gps.chargerEnregistrement(options.nmea)) {
+    fprintf(stderr, "Impossible de lire les phrases RMC de %s\n", options.nmea);
+    return 1;
+  }
+  if (options.eeprom != nullptr) simulation::chargerEEPROM(options.eeprom);
+
+  Mesures mesures(gps, BROCHE_PTT, BROCHE_DDS_FQ_UD, MORSE_MOT_PAR_MINUTE);
+  if (options.banc) mesuresActives = &mesures;
+  // Le fichier est ouvert dès maintenant, pour ne pas découvrir une erreur après des heures simulées.
+  FILE* fichierVCD = nullptr;
+  if (options.vcd != nullptr && (fichierVCD = fopen(options.vcd, "w")) == nullptr) {
+    fprintf(stderr, "Impossible d'ecrire %s\n", options.vcd);
+    return 1;
+  }
+  TraceVCD trace(fichierVCD != nullptr ? options.capaciteVCD : 0);
+  if (fichierVCD != nullptr) {
+    nommerSignaux(trace);
+    traceActive = &trace;
+  }
+  simulation::setObservateur(observerBroche);
+  simulation::brancherSource(Serial1, &gps);
+  simulation::brancherSource(Serial, &console);
+  simulation::setSortie(Serial, options.muet ? nullptr : stdout);
+
+  int interruptionPPS = digitalPinToInterrupt(BROCHE_PPS);
+  uint64_t fin = (uint64_t)(options.dureeS * simulation::NS_PAR_SECONDE);
+  auto debutReel = std::chrono::steady_clock::now();
+
+  gps.planifier(interruptionPPS);
+  setup();
+
+  while (simulation::maintenant() < fin) {
+    gps.planifier(interruptionPPS);
+    loop();
+    simulation::avancer(simulation::couts().boucle);
+    if (options.banc) mesures.noterPassage(ordonnanceur.getDernierPassageUs());
+  }
+  Serial.flush();
+
+  double dureeReelle = std::chrono::duration<double>(std::chrono::steady_clock::now() - debutReel).count();
+  if (options.ecran) simulation::afficherLCD(stdout);
+  if (options.banc) {
+    mesures.rapport(stdout, simulation::maintenant(), dureeReelle);
+    fprintf(stdout, "Octets du GPS perdus (tampon de reception plein) : %lu\n", simulation::getOctetsPerdus(Serial1));
+  }
+  if (options.eeprom != nullptr && !simulation::sauverEEPROM(options.eeprom)) {
+    fprintf(stderr, "Impossible d'ecrire %s\n", options.eeprom);
+  }
+  if (fichierVCD != nullptr) {
+    trace.ecrire(fichierVCD, simulation::maintenant());
+    fclose(fichierVCD);
+    if (trace.getPerdus() > 0) {
+      fprintf(stderr, "Trace VCD pleine : %lu fronts perdus (voir --vcd-capacite)\n", trace.getPerdus());
+    }
+  }
+  return 0;
+}